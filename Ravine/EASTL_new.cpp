@@ -1,11 +1,27 @@
 #include "EASTL_new.h"
-#include <eastl/numeric.h>
 
-void* __cdecl operator new[](size_t size, size_t a, size_t b, const char* name, int flags, unsigned int debugFlags, const char* file, int line)
+//Ravine Includes
+#include "RvHeap.h"
+
+void* __cdecl operator new[](size_t size, size_t alignment, size_t alignmentOffset, const char*, int, unsigned int, const char*, int)
 {
-	return new uint8_t[size];
+	return RvHeap::allocate(size, alignment, alignmentOffset);
 }
-void* __cdecl operator new[](size_t size, const char* name, int flags, unsigned int debugFlags, const char* file, int line)
+void* __cdecl operator new[](size_t size, const char*, int, unsigned int, const char*, int)
 {
-	return new uint8_t[size];
-}
\ No newline at end of file
+	return RvHeap::allocate(size);
+}
+
+//EASTL frees with a plain delete[], so array new/delete are replaced as a whole to keep both ends on the same heap
+void* __cdecl operator new[](size_t size)
+{
+	return RvHeap::allocate(size);
+}
+void __cdecl operator delete[](void* pointer) noexcept
+{
+	RvHeap::free(pointer);
+}
+void __cdecl operator delete[](void* pointer, size_t) noexcept
+{
+	RvHeap::free(pointer);
+}
@@ -2,9 +2,11 @@
 
 //STD Includes
 #include <stdexcept>
+#include <cstdio>
 
 //EASTL Includes
 #include <eastl/set.h>
+#include <eastl/algorithm.h>
 #include <eastl/string.h>
 
 //GLM Includes
@@ -18,6 +20,12 @@
 #include "RvTime.h"
 #include "RvConfig.h"
 #include "RvDebug.h"
+#include "RvAssetCache.h"
+#include "RvTools.h"
+#include "RvPackingTools.h"
+#include "RvMeshOptimizer.h"
+#include "RvConversionTools.h"
+#include "RvAssimpIOSystem.h"
 
 //Types dependencies
 #include "RvUniformTypes.h"
@@ -36,11 +44,13 @@
 
 //Assimp Includes
 #include <assimp/Importer.hpp>      // C++ importer interface
-#include <assimp/postprocess.h>     // Post processing flags
 
 //Specific usages of Assimp library
 using Assimp::Importer;
 
+//Specific usages of Ravine tools
+using namespace rvTools::optimizer;
+
 Ravine::Ravine()
 {
 }
@@ -101,59 +111,59 @@ void Ravine::initVulkan() {
 	window->CreateSurface(instance);
 	pickPhysicalDevice();
 
-	//Load Scene
-	string modelName = "guard.fbx";
-	if (loadScene("../data/" + modelName))
-	{
-		fmt::print(stdout, "{0} loaded!\n", modelName.c_str());
-	}
-	else
+	//Workers for scene processing
+	threadPool = new RvThreadPool();
+
+	//Scene data streams in with at most 8MB (or 2ms of recording) uploaded per frame
+	uploadScheduler = new RvUploadScheduler(*device, 8 * 1024 * 1024, 2.0);
+
+	//Serve data files from the packed archive when there is one
+	dataArchive = new RvArchive();
+	if (dataArchive->open("../data/data.rvpak"))
 	{
-		fmt::print(stdout, "File not fount at path: {0}\n", modelName.c_str());
-		return;
+		RvFileSystem::mount(dataArchive, "../data/", threadPool);
 	}
 
+	//Scene is loaded in background, frames are drawn while it streams in
+	sceneHandle = loadSceneAsync("../data/guard.fbx", RV_IMPORT_PROFILE_SKINNED_CHARACTER);
+
 	//Rendering pipeline
 	swapChain = new RvSwapChain(*device, window->surface, window->extent.width, window->extent.height, NULL);
 	swapChain->createImageViews();
 	swapChain->createSyncObjects();
-	renderPass = RvRenderPass::defaultRenderPass(*device, *swapChain);
+	createRenderGraph();
 	createDescriptorSetLayout();
 
 	//Shaders Loading
-	skinnedTexColCode = rvTools::readFile("../data/shaders/skinned_tex_color.vert");
-	skinnedWireframeCode = rvTools::readFile("../data/shaders/skinned_wireframe.vert");
-	staticTexColCode = rvTools::readFile("../data/shaders/static_tex_color.vert");
-	staticWireframeCode = rvTools::readFile("../data/shaders/static_wireframe.vert");
+	const string vertexSuffix = vertexFormat == RV_VERTEX_FORMAT_FULL ? ".vert" : "_packed.vert";
+	skinnedTexColCode = rvTools::readFile("../data/shaders/skinned_tex_color" + vertexSuffix);
+	skinnedWireframeCode = rvTools::readFile("../data/shaders/skinned_wireframe" + vertexSuffix);
+	staticTexColCode = rvTools::readFile("../data/shaders/static_tex_color" + vertexSuffix);
+	staticWireframeCode = rvTools::readFile("../data/shaders/static_wireframe" + vertexSuffix);
 	phongTexColCode = rvTools::readFile("../data/shaders/phong_tex_color.frag");
 	solidColorCode = rvTools::readFile("../data/shaders/solid_color.frag");
 
-	VkDescriptorSetLayout* descriptorSetLayouts = new VkDescriptorSetLayout[3]
+	VkDescriptorSetLayout descriptorSetLayouts[3] =
 	{
 		globalDescriptorSetLayout,
 		materialDescriptorSetLayout,
 		modelDescriptorSetLayout
 	};
+	const RvVertexInputDescription vertexInput = RvVertexInputDescription::create(vertexFormat);
 	skinnedGraphicsPipeline = new RvPolygonPipeline(*device, swapChain->extent, device->getMaxUsableSampleCount(),
-		descriptorSetLayouts, 3, renderPass->handle, skinnedTexColCode, phongTexColCode);
+		descriptorSetLayouts, 3, renderPass->handle, vertexInput, skinnedTexColCode, phongTexColCode);
 	skinnedWireframeGraphicsPipeline = new RvWireframePipeline(*device, swapChain->extent, device->getMaxUsableSampleCount(),
-		descriptorSetLayouts, 3, renderPass->handle, skinnedWireframeCode, solidColorCode);
+		descriptorSetLayouts, 3, renderPass->handle, vertexInput, skinnedWireframeCode, solidColorCode);
 	staticGraphicsPipeline = new RvPolygonPipeline(*device, swapChain->extent, device->getMaxUsableSampleCount(),
-		descriptorSetLayouts, 3, renderPass->handle, staticTexColCode, phongTexColCode);
+		descriptorSetLayouts, 3, renderPass->handle, vertexInput, staticTexColCode, phongTexColCode);
 	staticWireframeGraphicsPipeline = new RvWireframePipeline(*device, swapChain->extent, device->getMaxUsableSampleCount(),
-		descriptorSetLayouts, 3, renderPass->handle, staticWireframeCode, solidColorCode);
+		descriptorSetLayouts, 3, renderPass->handle, vertexInput, staticWireframeCode, solidColorCode);
 	staticLineGraphicsPipeline = new RvLinePipeline(*device, swapChain->extent, device->getMaxUsableSampleCount(),
-		descriptorSetLayouts, 3, renderPass->handle, staticWireframeCode, solidColorCode);
+		descriptorSetLayouts, 3, renderPass->handle, vertexInput, staticWireframeCode, solidColorCode);
 	gui = new RvGui(device, swapChain, window, renderPass);
 	gui->init(device->getMaxUsableSampleCount());
 
-	loadTextureImages();
 	createTextureSampler();
-	createVertexBuffer();
-	createIndexBuffer();
-	createUniformBuffers();
-	createDescriptorPool();
-	createDescriptorSets();
 	allocateCommandBuffers();
 }
 
@@ -179,7 +189,7 @@ void Ravine::createInstance() {
 	appInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
 	appInfo.pEngineName = "Ravine";
 	appInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
-	appInfo.apiVersion = VK_API_VERSION_1_0;
+	appInfo.apiVersion = VK_API_VERSION_1_1;
 
 	//Information for VkInstance creation
 	VkInstanceCreateInfo createInfo = {};
@@ -304,61 +314,46 @@ bool Ravine::checkDeviceExtensionSupport(const VkPhysicalDevice device) {
 
 void Ravine::recreateSwapChain() {
 
-	int width = 0, height = 0;
-	//If the window is minimized, wait for it to come back to the foreground.
-	//TODO: We probably want to handle that another way, which we should probably discuss.
-	while (width == 0 || height == 0) {
-		width = window->extent.width;
-		height = window->extent.height;
-		glfwWaitEvents();
+	//Minimized in the meantime, rebuilt once the window comes back
+	if (window->extent.width == 0 || window->extent.height == 0) {
+		window->framebufferResized = true;
+		return;
 	}
 
-	vkDeviceWaitIdle(device->handle);
-
-	//Storing handle
+	//Frames in flight keep presenting from the old swapchain, the new one is built from it without waiting for them
+	//Command buffers, uniform ranges, descriptor sets and GUI buffers exist per frame in flight, so the image count may change freely
 	RvSwapChain* oldSwapchain = swapChain;
-	swapChain = new RvSwapChain(*device, window->surface, WIDTH, HEIGHT, oldSwapchain->handle);
-	swapChain->createSyncObjects();
+	swapChain = new RvSwapChain(*device, window->surface, window->extent.width, window->extent.height, oldSwapchain->handle);
 	swapChain->createImageViews();
-	const VkExtent3D extent = { swapChain->extent.width, swapChain->extent.height, 1 };
-	renderPass->resizeAttachments(swapChain->imageViews.size(), extent, swapChain->imageViews.data());
-
-	//swapChain->createFramebuffers();
-	allocateCommandBuffers();
 
-	//Deleting old swapchain
-	//oldSwapchain->renderPass = VK_NULL_HANDLE;
-	oldSwapchain->clear();
+	//Fences and semaphores carry over, the old images and views are destroyed once the frames using them completed
+	oldSwapchain->retire(*swapChain);
 	delete oldSwapchain;
+	gui->swapChain = swapChain;
+
+	//Render passes are kept, so are the pipelines built on them (viewport and scissor are dynamic), framebuffers follow the new images
+	renderGraph->setImportedImages(presentTarget, swapChain->images, swapChain->imageViews);
+	renderGraph->resize(swapChain->extent, static_cast<uint32_t>(swapChain->images.size()));
 }
 
 void Ravine::createDescriptorPool()
 {
-	array<VkDescriptorPoolSize, 5> poolSizes = {};
-	//Global Uniforms
-	poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-	poolSizes[0].descriptorCount = static_cast<uint32_t>(swapChain->images.size());
-
-	//TODO: Change descriptor count accordingly to materials count instead of meshes count
-	//Material Uniforms
-	poolSizes[1].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-	poolSizes[1].descriptorCount = static_cast<uint32_t>(swapChain->images.size() * meshesCount);
-	//Image Uniforms
-	poolSizes[2].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-	poolSizes[2].descriptorCount = static_cast<uint32_t>(swapChain->images.size() * meshesCount);
+	//Material sets exist per texture, so the pool grows with textures but not with meshes
+	const uint32_t materialSetsCount = RV_MAX_FRAMES_IN_FLIGHT * texturesSize;
 
-	//Model Uniforms
-	poolSizes[3].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-	poolSizes[3].descriptorCount = static_cast<uint32_t>(swapChain->images.size() * meshesCount);
-	//Animation Uniforms
-	poolSizes[4].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-	poolSizes[4].descriptorCount = static_cast<uint32_t>(swapChain->images.size() * meshesCount);
+	array<VkDescriptorPoolSize, 2> poolSizes = {};
+	//Global, Model and Animation Uniforms (shared sets) and Material Uniforms (per texture)
+	poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+	poolSizes[0].descriptorCount = 3 + materialSetsCount;
+	//Image Uniforms
+	poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	poolSizes[1].descriptorCount = materialSetsCount;
 
 	VkDescriptorPoolCreateInfo poolInfo = {};
 	poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
 	poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
 	poolInfo.pPoolSizes = poolSizes.data();
-	poolInfo.maxSets = swapChain->images.size() * (1 + meshesCount * 2);/*Global, Material (per mesh), Model (per mesh)*/
+	poolInfo.maxSets = 2 + materialSetsCount;/*Global, Model, Material (per texture per frame)*/
 
 	if (vkCreateDescriptorPool(device->handle, &poolInfo, nullptr, &descriptorPool) != VK_SUCCESS) {
 		throw std::runtime_error("Failed to create descriptor pool!");
@@ -367,133 +362,108 @@ void Ravine::createDescriptorPool()
 
 void Ravine::createDescriptorSets()
 {
-	//Descriptor Sets Count
-	size_t setsPerFrame = (1 + meshesCount * 2)/*Global, Material (per mesh), Model (per mesh)*/;
-	size_t framesCount = swapChain->images.size();
-	size_t descriptorSetsCount = framesCount * setsPerFrame;
-	vector<VkDescriptorSetLayout> layouts(descriptorSetsCount);
-	for (size_t i = 0; i < framesCount; i++)
-	{
-		layouts[i * setsPerFrame + 0] = globalDescriptorSetLayout;
-		for (size_t meshId = 0; meshId < meshesCount; meshId++)
-		{
-			layouts[i * setsPerFrame + meshId * 2 + 1] = materialDescriptorSetLayout;
-			layouts[i * setsPerFrame + meshId * 2 + 2] = modelDescriptorSetLayout;
-		}
-	}
+	//Global and Model sets are shared by every frame (dynamic offsets select the frame range), Material sets are per texture per frame
+	const size_t framesCount = RV_MAX_FRAMES_IN_FLIGHT;
+	const size_t materialSetsCount = framesCount * texturesSize;
+	RvFrameVector<VkDescriptorSetLayout> layouts(2 + materialSetsCount, materialDescriptorSetLayout);
+	layouts[0] = globalDescriptorSetLayout;
+	layouts[1] = modelDescriptorSetLayout;
+
 	VkDescriptorSetAllocateInfo allocInfo = {};
 	allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
 	allocInfo.descriptorPool = descriptorPool;
-	allocInfo.descriptorSetCount = static_cast<uint32_t>(descriptorSetsCount);
+	allocInfo.descriptorSetCount = static_cast<uint32_t>(layouts.size());
 	allocInfo.pSetLayouts = layouts.data();
 
-	// Setting descriptor sets vector to count of SwapChain images
-	descriptorSets.resize(descriptorSetsCount);
-	if (vkAllocateDescriptorSets(device->handle, &allocInfo, descriptorSets.data()) != VK_SUCCESS) {
+	RvFrameVector<VkDescriptorSet> sets(layouts.size());
+	if (vkAllocateDescriptorSets(device->handle, &allocInfo, sets.data()) != VK_SUCCESS) {
 		throw std::runtime_error("Failed to allocate descriptor sets!");
 	}
-
-	//For each frame
-	for (size_t i = 0; i < framesCount; i++)
-	{
-		VkDescriptorBufferInfo globalUniformsInfo = {};
-		globalUniformsInfo.buffer = globalBuffers[i].handle;
-		globalUniformsInfo.offset = 0;
-		globalUniformsInfo.range = sizeof(RvGlobalBufferObject);
-
-		//Offset per frame iteration
-		size_t frameSetOffset = (i * setsPerFrame);
-		size_t writesPerFrame = (1 + meshesCount * 4);
-		vector<VkWriteDescriptorSet> descriptorWrites(writesPerFrame);
-
-		//Global Uniform Buffer Info
-		descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-		descriptorWrites[0].dstSet = descriptorSets[frameSetOffset + 0/*Frame Global Uniform Set*/];
-		descriptorWrites[0].dstBinding = 0;
-		descriptorWrites[0].dstArrayElement = 0;
-		descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-		descriptorWrites[0].descriptorCount = 1;
-		descriptorWrites[0].pBufferInfo = &globalUniformsInfo;
-
-		//For each mesh
-		VkDescriptorBufferInfo* materialsInfo = new VkDescriptorBufferInfo[meshesCount]{};
-		VkDescriptorImageInfo* imageInfo = new VkDescriptorImageInfo[meshesCount]{};
-		VkDescriptorBufferInfo* modelsInfo = new VkDescriptorBufferInfo[meshesCount]{};
-		VkDescriptorBufferInfo* animationsInfo = new VkDescriptorBufferInfo[meshesCount]{};
-		for (size_t meshId = 0; meshId < meshesCount; meshId++)
-		{
-			//Offset per mesh iteration
-			size_t meshSetOffset = meshId * 2;
-			size_t meshWritesOffset = meshId * 4;
-
-			//Materials Uniform Buffer Info
-			materialsInfo[meshId] = {};
-			materialsInfo[meshId].buffer = materialsBuffers[i].handle;
-			materialsInfo[meshId].offset = 0;
-			materialsInfo[meshId].range = sizeof(RvMaterialBufferObject);
-
-			descriptorWrites[meshWritesOffset + 1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-			descriptorWrites[meshWritesOffset + 1].dstSet = descriptorSets[frameSetOffset + meshSetOffset + 1];
-			descriptorWrites[meshWritesOffset + 1].dstBinding = 0;
-			descriptorWrites[meshWritesOffset + 1].dstArrayElement = 0;
-			descriptorWrites[meshWritesOffset + 1].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-			descriptorWrites[meshWritesOffset + 1].descriptorCount = 1;
-			descriptorWrites[meshWritesOffset + 1].pBufferInfo = &materialsInfo[meshId];
-
-			//Image Info
-			imageInfo[meshId] = {};
-			imageInfo[meshId].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-			RvSkinnedMeshColored& mesh = meshes[meshId];
-			uint32_t textureId = mesh.texturesCount > 0 ? 1 + mesh.textureIds[0] : 0/*Missing Texture (Pink)*/;
-			imageInfo[meshId].imageView = textures[textureId].view;
-			imageInfo[meshId].sampler = textureSampler;
-
-			descriptorWrites[meshWritesOffset + 2].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-			descriptorWrites[meshWritesOffset + 2].dstSet = descriptorSets[frameSetOffset + meshSetOffset + 1];
-			descriptorWrites[meshWritesOffset + 2].dstBinding = 1;
-			descriptorWrites[meshWritesOffset + 2].dstArrayElement = 0;
-			descriptorWrites[meshWritesOffset + 2].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-			descriptorWrites[meshWritesOffset + 2].descriptorCount = 1;
-			descriptorWrites[meshWritesOffset + 2].pImageInfo = &imageInfo[meshId];
-
-			//Models Uniform Buffer Info
-			modelsInfo[meshId] = {};
-			modelsInfo[meshId].buffer = modelsBuffers[i * meshesCount + meshId].handle;
-			modelsInfo[meshId].offset = 0;
-			modelsInfo[meshId].range = sizeof(RvModelBufferObject);
-
-			descriptorWrites[meshWritesOffset + 3].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-			descriptorWrites[meshWritesOffset + 3].dstSet = descriptorSets[frameSetOffset + meshSetOffset + 2];
-			descriptorWrites[meshWritesOffset + 3].dstBinding = 0;
-			descriptorWrites[meshWritesOffset + 3].dstArrayElement = 0;
-			descriptorWrites[meshWritesOffset + 3].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-			descriptorWrites[meshWritesOffset + 3].descriptorCount = 1;
-			descriptorWrites[meshWritesOffset + 3].pBufferInfo = &modelsInfo[meshId];
-
-			//Animations Uniform Buffer Info
-			animationsInfo[meshId] = {};
-			animationsInfo[meshId].buffer = animationsBuffers[i * meshesCount + meshId].handle;
-			animationsInfo[meshId].offset = 0;
-			animationsInfo[meshId].range = sizeof(RvBoneBufferObject);
-
-			descriptorWrites[meshWritesOffset + 4].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-			descriptorWrites[meshWritesOffset + 4].dstSet = descriptorSets[frameSetOffset + meshSetOffset + 2];
-			descriptorWrites[meshWritesOffset + 4].dstBinding = 1;
-			descriptorWrites[meshWritesOffset + 4].dstArrayElement = 0;
-			descriptorWrites[meshWritesOffset + 4].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-			descriptorWrites[meshWritesOffset + 4].descriptorCount = 1;
-			descriptorWrites[meshWritesOffset + 4].pBufferInfo = &animationsInfo[meshId];
-		}
-
-		//Update the sets for this frame
-		vkUpdateDescriptorSets(device->handle, writesPerFrame, descriptorWrites.data(), 0, nullptr);
-
-		delete[] materialsInfo;
-		delete[] imageInfo;
-		delete[] modelsInfo;
-		delete[] animationsInfo;
-	}
-
+	globalDescriptorSet = sets[0];
+	modelDescriptorSet = sets[1];
+	materialDescriptorSets.assign(sets.begin() + 2, sets.end());
+
+	//Every uniform descriptor covers one value at the start of the ring, the offset bound with the set moves it
+	VkDescriptorBufferInfo globalUniformsInfo = {};
+	globalUniformsInfo.buffer = uniformRing->buffer.handle;
+	globalUniformsInfo.offset = 0;
+	globalUniformsInfo.range = sizeof(RvGlobalBufferObject);
+
+	VkDescriptorBufferInfo materialsInfo = {};
+	materialsInfo.buffer = uniformRing->buffer.handle;
+	materialsInfo.offset = 0;
+	materialsInfo.range = sizeof(RvMaterialBufferObject);
+
+	VkDescriptorBufferInfo modelsInfo = {};
+	modelsInfo.buffer = uniformRing->buffer.handle;
+	modelsInfo.offset = 0;
+	modelsInfo.range = sizeof(RvModelBufferObject);
+
+	VkDescriptorBufferInfo animationsInfo = {};
+	animationsInfo.buffer = uniformRing->buffer.handle;
+	animationsInfo.offset = 0;
+	animationsInfo.range = sizeof(RvBoneBufferObject);
+
+	RvFrameVector<VkWriteDescriptorSet> descriptorWrites(3 + materialSetsCount * 2);
+	RvFrameVector<VkDescriptorImageInfo> imageInfo(materialSetsCount);
+
+	//Global Uniform Buffer Info
+	descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	descriptorWrites[0].dstSet = globalDescriptorSet;
+	descriptorWrites[0].dstBinding = 0;
+	descriptorWrites[0].dstArrayElement = 0;
+	descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+	descriptorWrites[0].descriptorCount = 1;
+	descriptorWrites[0].pBufferInfo = &globalUniformsInfo;
+
+	//Models Uniform Buffer Info
+	descriptorWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	descriptorWrites[1].dstSet = modelDescriptorSet;
+	descriptorWrites[1].dstBinding = 0;
+	descriptorWrites[1].dstArrayElement = 0;
+	descriptorWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+	descriptorWrites[1].descriptorCount = 1;
+	descriptorWrites[1].pBufferInfo = &modelsInfo;
+
+	//Animations Uniform Buffer Info
+	descriptorWrites[2].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	descriptorWrites[2].dstSet = modelDescriptorSet;
+	descriptorWrites[2].dstBinding = 1;
+	descriptorWrites[2].dstArrayElement = 0;
+	descriptorWrites[2].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+	descriptorWrites[2].descriptorCount = 1;
+	descriptorWrites[2].pBufferInfo = &animationsInfo;
+
+	//For each frame and texture
+	for (size_t setId = 0; setId < materialSetsCount; setId++)
+	{
+		const size_t writesOffset = 3 + setId * 2;
+
+		//Materials Uniform Buffer Info
+		descriptorWrites[writesOffset].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		descriptorWrites[writesOffset].dstSet = materialDescriptorSets[setId];
+		descriptorWrites[writesOffset].dstBinding = 0;
+		descriptorWrites[writesOffset].dstArrayElement = 0;
+		descriptorWrites[writesOffset].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+		descriptorWrites[writesOffset].descriptorCount = 1;
+		descriptorWrites[writesOffset].pBufferInfo = &materialsInfo;
+
+		//Image Info
+		imageInfo[setId] = {};
+		imageInfo[setId].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		imageInfo[setId].imageView = textureView(static_cast<uint32_t>(setId % texturesSize));
+		imageInfo[setId].sampler = textureSampler;
+
+		descriptorWrites[writesOffset + 1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		descriptorWrites[writesOffset + 1].dstSet = materialDescriptorSets[setId];
+		descriptorWrites[writesOffset + 1].dstBinding = 1;
+		descriptorWrites[writesOffset + 1].dstArrayElement = 0;
+		descriptorWrites[writesOffset + 1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		descriptorWrites[writesOffset + 1].descriptorCount = 1;
+		descriptorWrites[writesOffset + 1].pImageInfo = &imageInfo[setId];
+	}
+
+	vkUpdateDescriptorSets(device->handle, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
 }
 
 void Ravine::createDescriptorSetLayout()
@@ -501,14 +471,14 @@ void Ravine::createDescriptorSetLayout()
 	//Global Uniforms layout
 	VkDescriptorSetLayoutBinding uboLayoutBinding = {};
 	uboLayoutBinding.binding = 0;
-	uboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+	uboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
 	uboLayoutBinding.descriptorCount = 1;
 	uboLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
 
 	//Materials layout
 	VkDescriptorSetLayoutBinding materialLayoutBinding = {};
 	materialLayoutBinding.binding = 0;
-	materialLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+	materialLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
 	materialLayoutBinding.descriptorCount = 1;
 	materialLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
 
@@ -523,14 +493,14 @@ void Ravine::createDescriptorSetLayout()
 	//Models Data layout
 	VkDescriptorSetLayoutBinding modelDataLayoutBinding = {};
 	modelDataLayoutBinding.binding = 0;
-	modelDataLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+	modelDataLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
 	modelDataLayoutBinding.descriptorCount = 1;
 	modelDataLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
 
 	//Animations layout
 	VkDescriptorSetLayoutBinding animationLayoutBinding = {};
 	animationLayoutBinding.binding = 1;
-	animationLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+	animationLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
 	animationLayoutBinding.descriptorCount = 1;
 	animationLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
 
@@ -582,24 +552,113 @@ void Ravine::createDescriptorSetLayout()
 
 #pragma region ANIMATION STUFF
 
-bool Ravine::loadScene(const string& filePath)
+bool Ravine::loadScene(const string& filePath, const RvImportProfile& profile)
+{
+	RvImportTimer timer;
+
+	//Source file is fingerprinted along with the import profile and the vertex layout it is converted to
+	const uint32_t importSettings[] = { static_cast<uint32_t>(profile.type), profile.postProcessSteps, profile.removedComponents, profile.vertexAttributes,
+		static_cast<uint32_t>(profile.loadMaterials) | static_cast<uint32_t>(profile.loadAnimations) << 1, static_cast<uint32_t>(sizeof(RvSkinnedVertexColored)) };
+	RvAssetFingerprint fingerprint;
+	const bool fingerprinted = RvAssetCache::fingerprintFile(filePath, importSettings, sizeof(importSettings), fingerprint);
+	timer.lap("Fingerprint");
+
+	//Reuse cooked scene when the source didn't change
+	if (fingerprinted && RvAssetCache::loadScene(fingerprint, meshes, meshesCount, texturesToLoad))
+	{
+		timer.lap("Cooked scene");
+		fmt::print(stdout, "Loaded cooked scene {0} with {1} animations.\n", fingerprint.toString().c_str(), meshes[0].animations.size());
+		timer.print(filePath);
+		meshes[0].curAnimId = 0;
+		return true;
+	}
+
+	//glTF files skip Assimp and its generic post-processing
+	fmt::print(stdout, "Importing {0} as {1}\n", filePath.c_str(), profile.name);
+	if (RvGltfLoader::isGltf(filePath))
+	{
+		if (!RvGltfLoader::load(filePath, profile, meshes, meshesCount, texturesToLoad, timer))
+		{
+			return false;
+		}
+		fmt::print(stdout, "Loaded glTF file with {0} animations.\n", meshes[0].animations.size());
+	}
+	else if (!importScene(filePath, profile, timer))
+	{
+		return false;
+	}
+
+	//Optimize for post-transform cache, overdraw and vertex fetch (each step preserves the previous one), meshes in parallel
+	vector<RvVertexCacheStats> statsBefore(meshesCount);
+	vector<RvVertexCacheStats> statsAfter(meshesCount);
+	threadPool->parallelFor(meshesCount, [&](uint32_t i)
+	{
+		RvSkinnedMeshColored& mesh = meshes[i];
+		statsBefore[i] = analyzeVertexCache(mesh.indices, mesh.indexCount, mesh.vertexCount);
+		optimizeVertexCache(mesh.indices, mesh.indexCount, mesh.vertexCount);
+		optimizeOverdraw(mesh.indices, mesh.indexCount, mesh.vertices, mesh.vertexCount);
+		mesh.vertexCount = optimizeVertexFetch(mesh.vertices, mesh.vertexCount, mesh.indices, mesh.indexCount);
+		statsAfter[i] = analyzeVertexCache(mesh.indices, mesh.indexCount, mesh.vertexCount);
+
+		//Detail levels are appended after the original triangles
+		buildLodChain(mesh);
+
+		//Meshlets follow the optimized triangle order of LOD 0
+		buildMeshlets(mesh.indices, mesh.lods[0].indexCount, mesh.vertices, mesh.vertexCount, mesh.meshlets);
+	});
+	timer.lap("Optimize, LODs and meshlets");
+
+	for (uint32_t i = 0; i < meshesCount; i++)
+	{
+		const RvSkinnedMeshColored& mesh = meshes[i];
+		fmt::print(stdout, "Mesh {0}: ACMR {1:.3f} -> {2:.3f}, ATVR {3:.3f} -> {4:.3f}\n", i, statsBefore[i].acmr, statsAfter[i].acmr, statsBefore[i].atvr, statsAfter[i].atvr);
+		for (uint32_t lod = 1; lod < mesh.lods.size(); lod++)
+		{
+			fmt::print(stdout, "Mesh {0}: LOD {1} with {2} triangles (error {3:.5f})\n", i, lod, mesh.lods[lod].indexCount / 3, mesh.lods[lod].error);
+		}
+		fmt::print(stdout, "Mesh {0}: {1} meshlets\n", i, mesh.meshlets.size());
+	}
+
+	//Meshes with identical geometry (e.g. exported under different names) share their buffers
+	vector<RvAssetFingerprint> geometryFingerprints(meshesCount);
+	for (uint32_t i = 0; i < meshesCount; i++)
+	{
+		geometryFingerprints[i] = RvAssetCache::fingerprint(meshes[i].vertices, sizeof(RvSkinnedVertexColored) * meshes[i].vertexCount,
+			meshes[i].indices, sizeof(uint32_t) * meshes[i].indexCount);
+		meshes[i].geometryId = i;
+		for (uint32_t j = 0; j < i; j++)
+		{
+			//Counts are compared first so the byte comparisons stay within both meshes
+			if (geometryFingerprints[j] == geometryFingerprints[i] &&
+				meshes[j].vertexCount == meshes[i].vertexCount && meshes[j].indexCount == meshes[i].indexCount &&
+				memcmp(meshes[j].vertices, meshes[i].vertices, sizeof(RvSkinnedVertexColored) * meshes[i].vertexCount) == 0 &&
+				memcmp(meshes[j].indices, meshes[i].indices, sizeof(uint32_t) * meshes[i].indexCount) == 0)
+			{
+				meshes[i].geometryId = j;
+				break;
+			}
+		}
+	}
+	timer.lap("Deduplicate geometry");
+
+	//Cook scene so next runs skip Assimp
+	if (fingerprinted && !RvAssetCache::storeScene(fingerprint, meshes, meshesCount, texturesToLoad))
+	{
+		fmt::print(stderr, "Failed to write cooked scene for {0}\n", filePath.c_str());
+	}
+	timer.lap("Cook");
+	timer.print(filePath);
+
+	//Return success
+	return true;
+}
+
+bool Ravine::importScene(const string& filePath, const RvImportProfile& profile, RvImportTimer& timer)
 {
 	Importer importer;
-	importer.ReadFile(filePath.c_str(), aiProcess_CalcTangentSpace | \
-		aiProcess_GenNormals | \
-		aiProcess_JoinIdenticalVertices | \
-		aiProcess_ImproveCacheLocality | \
-		aiProcess_LimitBoneWeights | \
-		aiProcess_RemoveRedundantMaterials | \
-		aiProcess_Triangulate | \
-		aiProcess_GenUVCoords | \
-		aiProcess_SortByPType | \
-		aiProcess_FindDegenerates | \
-		aiProcess_FindInvalidData | \
-		aiProcess_FindInstances | \
-		aiProcess_ValidateDataStructure | \
-		aiProcess_OptimizeMeshes | \
-		0);
+	//Owned (and deleted) by the importer
+	importer.SetIOHandler(new RvAssimpIOSystem());
+	profile.readScene(importer, filePath, timer);
 	scene = importer.GetOrphanedScene();
 
 	// If the import failed, report it
@@ -610,130 +669,44 @@ bool Ravine::loadScene(const string& filePath)
 
 	//Load mesh
 	meshesCount = scene->mNumMeshes;
-	meshes = new RvSkinnedMeshColored[scene->mNumMeshes];
+	meshes = new RvSkinnedMeshColored[scene->mNumMeshes]{};
 	aiMatrix4x4 animGlobalInverseTransform = scene->mRootNode->mTransformation;
 	animGlobalInverseTransform.Inverse();
 
-	//Load each mesh
+	//Allocate data structures
 	for (uint32_t i = 0; i < meshesCount; i++)
 	{
-		//Hold reference
 		const aiMesh* mesh = scene->mMeshes[i];
-
 		meshes[i].animGlobalInverseTransform = animGlobalInverseTransform;
-
-		//Allocate data structures
 		meshes[i].vertexCount = mesh->mNumVertices;
 		meshes[i].vertices = new RvSkinnedVertexColored[mesh->mNumVertices];
 		meshes[i].indexCount = mesh->mNumFaces * 3;
 		meshes[i].indices = new uint32_t[mesh->mNumFaces * 3];
+	}
 
-		//Setup vertices
-		const aiVector3D* verts = mesh->mVertices;
-		bool hasCoords = mesh->HasTextureCoords(0);
-		const aiVector3D* uvs = mesh->mTextureCoords[0];
-		bool hasColors = mesh->HasVertexColors(0);
-		const aiColor4D* cols = mesh->mColors[0];
-		bool hasNormals = mesh->HasNormals();
-		const aiVector3D* norms = &mesh->mNormals[0];
-
-		//Treat each case for optimal performance
-		if (hasCoords && hasColors && hasNormals)
-		{
-			for (uint32_t j = 0; j < mesh->mNumVertices; j++)
-			{
-				//Vertices
-				meshes[i].vertices[j].pos = { verts[j].x, verts[j].y, verts[j].z };
-
-				//Texture coordinates
-				meshes[i].vertices[j].texCoord = { uvs[j].x, uvs[j].y };
-
-				//Vertex colors
-				meshes[i].vertices[j].color = { cols[j].r, cols[j].g, cols[j].b };
-
-				//Normals
-				meshes[i].vertices[j].normal = { norms[j].x , norms[j].y, norms[j].z };
-			}
-		}
-		else if (hasCoords && hasNormals)
-		{
-			for (uint32_t j = 0; j < mesh->mNumVertices; j++)
-			{
-				//Vertices
-				meshes[i].vertices[j].pos = { verts[j].x, verts[j].y, verts[j].z };
-
-				//Texture coordinates
-				meshes[i].vertices[j].texCoord = { uvs[j].x, uvs[j].y };
-
-				//Vertex colors
-				meshes[i].vertices[j].color = { 1, 1, 1 };
-
-				//Normals
-				meshes[i].vertices[j].normal = { norms[j].x , norms[j].y, norms[j].z };
-			}
-		}
-		else if (hasNormals)
-		{
-			for (uint32_t j = 0; j < mesh->mNumVertices; j++)
-			{
-				//Vertices
-				meshes[i].vertices[j].pos = { verts[j].x, verts[j].y, verts[j].z };
-
-				//Texture coordinates
-				meshes[i].vertices[j].texCoord = { 0, 0 };
-
-				//Vertex colors
-				meshes[i].vertices[j].color = { 1, 1, 1 };
-
-				//Normals
-				meshes[i].vertices[j].normal = { norms[j].x , norms[j].y, norms[j].z };
-			}
-		}
-		else if (hasCoords)
-		{
-			for (uint32_t j = 0; j < mesh->mNumVertices; j++)
-			{
-				//Vertices
-				meshes[i].vertices[j].pos = { verts[j].x, verts[j].y, verts[j].z };
-
-				//Texture coordinates
-				meshes[i].vertices[j].texCoord = { uvs[j].x, uvs[j].y };
+	//Convert vertex streams and face indices of every mesh in parallel
+	threadPool->parallelFor(meshesCount, [this, &profile](uint32_t i)
+	{
+		rvTools::conversion::convertVertices(scene->mMeshes[i], meshes[i].vertices, profile.vertexAttributes);
+		rvTools::conversion::convertIndices(scene->mMeshes[i], meshes[i].indices);
+	});
+	timer.lap("Convert vertices");
 
-				//Vertex colors
-				meshes[i].vertices[j].color = { 1, 1, 1 };
+	//Load each mesh materials and bones (bones are shared by the whole scene, so this stays serial)
+	for (uint32_t i = 0; i < meshesCount; i++)
+	{
+		//Hold reference
+		const aiMesh* mesh = scene->mMeshes[i];
 
-				//Normals
-				meshes[i].vertices[j].normal = { 0, 0, 0 };
-			}
-		}
-		else
+		if (profile.vertexAttributes & RV_VERTEX_ATTRIBUTE_BONES)
 		{
-			for (uint32_t j = 0; j < mesh->mNumVertices; j++)
-			{
-				//Vertices
-				meshes[i].vertices[j].pos = { verts[j].x, verts[j].y, verts[j].z };
-
-				//Texture coordinates
-				meshes[i].vertices[j].texCoord = { 0, 0 };
-
-				//Vertex colors
-				meshes[i].vertices[j].color = { 1, 1, 1 };
-
-				//Normals
-				meshes[i].vertices[j].normal = { 0, 0, 0 };
-			}
+			loadBones(mesh, meshes[i]);
 		}
 
-		//Setup face indices
-		for (uint32_t j = 0; j < mesh->mNumFaces; j++)
+		if (!profile.loadMaterials)
 		{
-			//Make sure it's triangulated
-			assert(mesh->mFaces[j].mNumIndices == 3);
-
-			//Copy each index (the mesh was triangulated on import)
-			meshes[i].indices[j * 3 + 0] = mesh->mFaces[j].mIndices[0];
-			meshes[i].indices[j * 3 + 1] = mesh->mFaces[j].mIndices[1];
-			meshes[i].indices[j * 3 + 2] = mesh->mFaces[j].mIndices[2];
+			meshes[i].textureIds = new uint32_t[0];
+			continue;
 		}
 
 		//Register textures for late-loading (and generate texture Ids)
@@ -778,17 +751,17 @@ bool Ravine::loadScene(const string& filePath)
 				}
 			}
 		}
-
-		loadBones(mesh, meshes[i]);
 	}
+	timer.lap("Materials and bones");
 
-	fmt::print(stdout, "Loaded file with {0} animations.\n", scene->mNumAnimations);
+	const uint32_t animationsCount = profile.loadAnimations ? scene->mNumAnimations : 0;
+	fmt::print(stdout, "Loaded file with {0} animations.\n", animationsCount);
 
-	meshes[0].animations.reserve(scene->mNumAnimations);
-	if (scene->mNumAnimations > 0)
+	meshes[0].animations.reserve(animationsCount);
+	if (animationsCount > 0)
 	{
 		//Record animation parameters
-		for (uint32_t i = 0; i < scene->mNumAnimations; i++)
+		for (uint32_t i = 0; i < animationsCount; i++)
 		{
 			meshes[0].animations.push_back(new RvAnimation({ scene->mAnimations[i] }));
 		}
@@ -797,8 +770,8 @@ bool Ravine::loadScene(const string& filePath)
 		meshes[0].curAnimId = 0;
 	}
 	meshes[0].rootNode = new aiNode(*scene->mRootNode);
+	timer.lap("Animations and nodes");
 
-	//Return success
 	return true;
 }
 
@@ -848,7 +821,8 @@ void Ravine::boneTransform(double timeInSeconds, vector<aiMatrix4x4>& transforms
 void Ravine::readNodeHierarchy(double animationTime, double curDuration, double otherDuration, const aiNode* pNode,
 	const aiMatrix4x4& parentTransform)
 {
-	string nodeName(pNode->mName.data);
+	//Compared in place, building a string per node would allocate every frame
+	const char* nodeName = pNode->mName.data;
 
 	aiMatrix4x4 nodeTransformation(pNode->mTransformation);
 
@@ -878,9 +852,10 @@ void Ravine::readNodeHierarchy(double animationTime, double curDuration, double
 
 	aiMatrix4x4 globalTransformation = parentTransform * nodeTransformation;
 
-	if (meshes[0].boneMapping.find(nodeName) != meshes[0].boneMapping.end())
+	const auto boneIt = meshes[0].boneMapping.find_as(nodeName, eastl::less_2<string, const char*>());
+	if (boneIt != meshes[0].boneMapping.end())
 	{
-		uint32_t BoneIndex = meshes[0].boneMapping[nodeName];
+		uint32_t BoneIndex = boneIt->second;
 		meshes[0].boneInfo[BoneIndex].FinalTransformation = meshes[0].animGlobalInverseTransform *
 			globalTransformation * meshes[0].boneInfo[BoneIndex].BoneOffset;
 	}
@@ -893,67 +868,415 @@ void Ravine::readNodeHierarchy(double animationTime, double curDuration, double
 
 #pragma endregion
 
-void Ravine::createVertexBuffer()
+RvSceneHandle* Ravine::loadSceneAsync(const string& filePath, RvImportProfileType profileType)
+{
+	RvSceneHandle* handle = new RvSceneHandle();
+	handle->filePath = filePath;
+	handle->profileType = profileType;
+
+	//Import, processing and texture decoding run on a loader thread, GPU uploads are done by streamScene
+	handle->loader = std::thread([this, handle]()
+	{
+		RvHeapScope heapScope(RV_HEAP_ASSETS);
+		vector<RvAssetFingerprint> textureFingerprints;
+		vector<RvFileView> textureSources;
+		if (!loadScene(handle->filePath, RvImportProfile::get(handle->profileType)))
+		{
+			handle->state = RV_SCENE_LOAD_FAILED;
+			return;
+		}
+		prepareTextures(textureFingerprints, textureSources);
+
+		//Scene data is read by the render thread from here on
+		handle->state = RV_SCENE_LOAD_IMPORTED;
+		decodeTextures(*handle, textureFingerprints, textureSources);
+	});
+
+	return handle;
+}
+
+void Ravine::createSceneResources()
+{
+	createTextureImages();
+	createGeometryPool();
+	createMeshletBuffers();
+	createUniformBuffers();
+	createDescriptorPool();
+	createDescriptorSets();
+
+	//Sets were written with the textures resident at creation
+	descriptorTexturesVersions.assign(RV_MAX_FRAMES_IN_FLIGHT, texturesVersion);
+	sceneResourcesCreated = true;
+}
+
+void Ravine::streamScene()
+{
+	//Owners of finished uploads are notified before the frame is recorded
+	uploadScheduler->update();
+
+	if (!sceneHandle)
+	{
+		return;
+	}
+
+	switch (sceneHandle->state)
+	{
+	case RV_SCENE_LOAD_IMPORTED:
+		createSceneResources();
+
+		//Every mesh is queued at once, the scheduler spreads them over frames and the rest keep drawing as proxies
+		for (uint32_t meshIndex = 0; meshIndex < meshesCount; meshIndex++)
+		{
+			uploadMeshGeometry(meshIndex);
+		}
+		sceneHandle->state = RV_SCENE_LOAD_STREAMING;
+		break;
+	case RV_SCENE_LOAD_STREAMING:
+	{
+		//Hand every decoded texture to the scheduler, they are swapped in as they become resident
+		deque<RvDecodedTexture> decodedTextures;
+		{
+			std::unique_lock<std::mutex> lock(sceneHandle->decodedMutex);
+			decodedTextures.swap(sceneHandle->decodedTextures);
+		}
+		for (RvDecodedTexture& decoded : decodedTextures)
+		{
+			const uint32_t textureId = decoded.textureId;
+			auto onResident = [this, textureId](const RvTexture& texture)
+			{
+				textures[textureId] = texture;
+				texturesResident[textureId] = 1;
+				texturesVersion++;
+			};
+			if (decoded.cooked.isValid())
+			{
+				uploadScheduler->uploadTexture(eastl::move(decoded.cooked), decoded.cookedOffset, decoded.width, decoded.height, VK_FORMAT_R8G8B8A8_UNORM, onResident);
+			}
+			else
+			{
+				uploadScheduler->uploadTexture(eastl::move(decoded.pixels), decoded.width, decoded.height, VK_FORMAT_R8G8B8A8_UNORM, onResident);
+			}
+		}
+
+		//Decoded flag is read before the queue, so nothing pushed before it was set can be missed
+		const bool texturesDecoded = sceneHandle->texturesDecoded;
+		bool queueEmpty;
+		{
+			std::unique_lock<std::mutex> lock(sceneHandle->decodedMutex);
+			queueEmpty = sceneHandle->decodedTextures.empty();
+		}
+		if (residentMeshesCount == meshesCount && texturesDecoded && queueEmpty && uploadScheduler->isIdle())
+		{
+			sceneHandle->loader.join();
+			sceneHandle->state = RV_SCENE_LOAD_READY;
+			fmt::print(stdout, "{0} loaded!\n", sceneHandle->filePath.c_str());
+			device->allocator->printStats();
+			renderGraph->printStats();
+			RvHeap::printStats();
+		}
+		break;
+	}
+	case RV_SCENE_LOAD_FAILED:
+		if (sceneHandle->loader.joinable())
+		{
+			sceneHandle->loader.join();
+			fmt::print(stdout, "File not fount at path: {0}\n", sceneHandle->filePath.c_str());
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+void Ravine::updateTextureDescriptors(uint32_t frameSlot)
+{
+	RvFrameVector<VkDescriptorImageInfo> imageInfos(texturesSize);
+	RvFrameVector<VkWriteDescriptorSet> descriptorWrites(texturesSize);
+	for (uint32_t textureId = 0; textureId < texturesSize; textureId++)
+	{
+		imageInfos[textureId] = {};
+		imageInfos[textureId].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		imageInfos[textureId].imageView = textureView(textureId);
+		imageInfos[textureId].sampler = textureSampler;
+
+		descriptorWrites[textureId] = {};
+		descriptorWrites[textureId].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		descriptorWrites[textureId].dstSet = materialDescriptorSets[frameSlot * texturesSize + textureId];
+		descriptorWrites[textureId].dstBinding = 1;
+		descriptorWrites[textureId].dstArrayElement = 0;
+		descriptorWrites[textureId].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		descriptorWrites[textureId].descriptorCount = 1;
+		descriptorWrites[textureId].pImageInfo = &imageInfos[textureId];
+	}
+	vkUpdateDescriptorSets(device->handle, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
+	descriptorTexturesVersions[frameSlot] = texturesVersion;
+}
+
+void Ravine::createGeometryPool()
 {
 	/*
-	The vertex buffer should use "VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT",
-	which is a more optimal memory but it's not accessible by CPU.
-	That's why we use a staging buffer to transfer vertex data to the vertex buffer.
+	Every mesh lives in the same pair of "VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT" buffers,
+	sub-allocated by the geometry pool, so drawing binds them only once.
+	Data is transferred through staging buffers since device local memory isn't accessible by CPU.
 	*/
-	vertexBuffers.reserve(meshesCount);
+	uint32_t vertexCapacity = 0;
+	uint32_t indexCapacity = 0;
 	for (size_t i = 0; i < meshesCount; i++)
 	{
-		vertexBuffers.push_back(device->createPersistentBuffer(meshes[i].vertices, sizeof(RvSkinnedVertexColored) * meshes[i].vertexCount, sizeof(RvSkinnedVertexColored),
-			(VkBufferUsageFlagBits)(VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT), VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
-		);
-		delete[] meshes[i].vertices;
-		meshes[i].vertexCount = 0;
+		//Bounds are kept after upload to dequantize positions
+		rvTools::packing::computeBounds(meshes[i].vertices, meshes[i].vertexCount, meshes[i].aabbMin, meshes[i].aabbMax);
+
+		//Duplicated geometry only takes room once
+		if (meshes[i].geometryId == i)
+		{
+			vertexCapacity += meshes[i].vertexCount;
+			indexCapacity += meshes[i].indexCount;
+		}
+	}
+
+	//Room for the bounding box proxies drawn while meshes are uploaded (8 corners, 12 lines)
+	vertexCapacity += static_cast<uint32_t>(meshesCount) * 8;
+	indexCapacity += static_cast<uint32_t>(meshesCount) * 24;
+
+	const size_t vertexStride = RvVertexInputDescription::create(vertexFormat).binding.stride;
+	geometryPool = new RvGeometryPool(*device, vertexStride, vertexCapacity, indexCapacity);
+	geometryAllocations.resize(meshesCount);
+
+	//Proxies are uploaded right away (all of them in one submission), they are tiny
+	proxyAllocations.resize(meshesCount);
+	uint32_t proxyIndices[24];
+	uint32_t edge = 0;
+	for (uint32_t corner = 0; corner < 8; corner++)
+	{
+		for (uint32_t axis = 1; axis < 8; axis <<= 1)
+		{
+			if ((corner & axis) == 0)
+			{
+				proxyIndices[edge++] = corner;
+				proxyIndices[edge++] = corner | axis;
+			}
+		}
+	}
+
+	RvUploadContext upload(*device);
+	vector<char> vertexData;
+	for (size_t i = 0; i < meshesCount; i++)
+	{
+		const RvSkinnedMeshColored& mesh = meshes[i];
+		RvSkinnedVertexColored corners[8] = {};
+		for (uint32_t corner = 0; corner < 8; corner++)
+		{
+			corners[corner].pos = glm::vec3(corner & 1 ? mesh.aabbMax.x : mesh.aabbMin.x,
+				corner & 2 ? mesh.aabbMax.y : mesh.aabbMin.y,
+				corner & 4 ? mesh.aabbMax.z : mesh.aabbMin.z);
+			corners[corner].color = glm::vec3(1.0f);
+		}
+
+		packVertexData(corners, 8, mesh, vertexData);
+		if (!geometryPool->allocate(upload, vertexData.data(), 8, proxyIndices, 24, proxyAllocations[i]))
+		{
+			throw std::runtime_error("Failed to allocate proxy geometry in the geometry pool!");
+		}
+	}
+	upload.wait();
+}
+
+void Ravine::packVertexData(const RvSkinnedVertexColored* vertices, uint32_t vertexCount, const RvSkinnedMeshColored& mesh, vector<char>& vertexData) const
+{
+	vertexData.resize(RvVertexInputDescription::create(vertexFormat).binding.stride * vertexCount);
+	if (vertexFormat == RV_VERTEX_FORMAT_PACKED)
+	{
+		rvTools::packing::packVertices(vertices, vertexCount, reinterpret_cast<RvSkinnedVertexPacked*>(vertexData.data()));
+	}
+	else if (vertexFormat == RV_VERTEX_FORMAT_QUANTIZED)
+	{
+		rvTools::packing::packVertices(vertices, vertexCount, mesh.aabbMin, mesh.aabbMax, reinterpret_cast<RvSkinnedVertexQuantized*>(vertexData.data()));
+	}
+	else
+	{
+		memcpy(vertexData.data(), vertices, vertexData.size());
 	}
+}
 
+void Ravine::uploadMeshGeometry(uint32_t meshIndex)
+{
+	RvSkinnedMeshColored& mesh = meshes[meshIndex];
+
+	//Uploads finish in the order they were queued, so every mesh before this one is resident too
+	auto onResident = [this, meshIndex]()
+	{
+		residentMeshesCount = meshIndex + 1;
+	};
+
+	//Duplicated geometry shares the range of its first occurrence (always queued before)
+	if (mesh.geometryId != meshIndex)
+	{
+		geometryAllocations[meshIndex] = geometryAllocations[mesh.geometryId];
+		uploadScheduler->notify(onResident);
+	}
+	else
+	{
+		RvGeometryAllocation& allocation = geometryAllocations[meshIndex];
+		if (!geometryPool->reserve(mesh.vertexCount, mesh.indexCount, allocation))
+		{
+			throw std::runtime_error("Failed to allocate mesh geometry in the geometry pool!");
+		}
+
+		vector<char> vertexData;
+		packVertexData(mesh.vertices, mesh.vertexCount, mesh, vertexData);
+		uploadScheduler->uploadBuffer(eastl::move(vertexData), geometryPool->vertexBuffer.handle,
+			geometryPool->vertexBuffer.sizeOfDataType * allocation.vertexOffset, nullptr);
+		uploadScheduler->uploadBuffer(mesh.indices, sizeof(uint32_t) * mesh.indexCount, geometryPool->indexBuffer.handle,
+			sizeof(uint32_t) * allocation.firstIndex, onResident);
+	}
+	delete[] mesh.vertices;
+	delete[] mesh.indices;
+	mesh.vertexCount = 0;
+	mesh.indexCount = 0;
 }
 
-void Ravine::createIndexBuffer()
+void Ravine::createMeshletBuffers()
 {
-	indexBuffers.reserve(meshesCount);
+	//Meshlets are kept for cluster culling (index ranges are relative to the mesh range in the geometry pool)
+	meshletBuffers.reserve(meshesCount);
 	for (size_t i = 0; i < meshesCount; i++)
 	{
-		indexBuffers.push_back(device->createPersistentBuffer(meshes[i].indices, sizeof(uint32_t) * meshes[i].indexCount, sizeof(uint32_t),
-			(VkBufferUsageFlagBits)(VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT), VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
-		);
-		delete[] meshes[i].indices;
-		meshes[i].indexCount = 0;
+		if (meshes[i].geometryId != i)
+		{
+			meshletBuffers.push_back(meshletBuffers[meshes[i].geometryId]);
+		}
+		else if (meshes[i].meshlets.empty())
+		{
+			//Zero sized buffers are invalid, the handle stays null
+			meshletBuffers.push_back(RvPersistentBuffer());
+		}
+		else
+		{
+			//Filled by the upload scheduler, ahead of the geometry queued after it
+			const VkDeviceSize meshletsSize = sizeof(RvMeshlet) * meshes[i].meshlets.size();
+			meshletBuffers.push_back(device->createPersistentBuffer(meshletsSize, sizeof(RvMeshlet),
+				(VkBufferUsageFlagBits)(VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT), VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
+			);
+			uploadScheduler->uploadBuffer(meshes[i].meshlets.data(), meshletsSize, meshletBuffers.back().handle, 0, nullptr);
+		}
 	}
 }
 
 void Ravine::createUniformBuffers()
 {
-	//Setting size of uniform buffers vector to count of SwapChain's images.
-	size_t framesCount = swapChain->images.size();
-	globalBuffers.resize(framesCount);
-	materialsBuffers.resize(framesCount * meshesCount);
-	modelsBuffers.resize(framesCount * meshesCount);
-	animationsBuffers.resize(framesCount * meshesCount);
-
-	for (size_t i = 0; i < framesCount; i++) {
-		globalBuffers[i] = device->createDynamicBuffer(sizeof(RvGlobalBufferObject), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, (VkMemoryPropertyFlagBits)(VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT));
-		for (size_t j = 0; j < meshesCount; j++)
+	//One range per frame in flight (the fence of its slot guards it), large enough for the global uniforms and the ones of every mesh
+	const uint32_t framesCount = RV_MAX_FRAMES_IN_FLIGHT;
+	const VkDeviceSize alignment = device->deviceProperties.limits.minUniformBufferOffsetAlignment;
+	const auto alignedSize = [alignment](VkDeviceSize size) { return (size + alignment - 1) / alignment * alignment; };
+	const VkDeviceSize frameCapacity = alignedSize(sizeof(RvGlobalBufferObject)) + meshesCount *
+		(alignedSize(sizeof(RvMaterialBufferObject)) + alignedSize(sizeof(RvModelBufferObject)) + alignedSize(sizeof(RvBoneBufferObject)));
+
+	uniformRing = new RvUniformRing(*device, framesCount, frameCapacity);
+}
+
+void Ravine::prepareTextures(vector<RvAssetFingerprint>& fingerprints, vector<RvFileView>& sources)
+{
+	//Textures are identified by their content, so the same image under different paths is loaded once
+	const uint32_t textureSettings[] = { STBI_rgb_alpha };
+	vector<uint32_t> textureRemap(texturesToLoad.size());
+
+	//Queue every read at once so the disk works while earlier files are hashed
+	vector<RvFileRequest*> requests(texturesToLoad.size());
+	for (uint32_t i = 0; i < texturesToLoad.size(); i++)
+	{
+		requests[i] = RvFileSystem::readAsync(*threadPool, "../data/" + texturesToLoad[i]);
+	}
+
+	for (uint32_t i = 0; i < texturesToLoad.size(); i++)
+	{
+		fmt::print(stdout, "{0}\n", texturesToLoad[i].c_str());
+		RvFileView source = eastl::move(RvFileSystem::wait(*requests[i]));
+		delete requests[i];
+		if (!source.isValid())
+		{
+			//Runs on the loader thread, meshes keep the missing texture instead (its slot is never decoded)
+			fmt::print(stderr, "Failed to open file at ../data/{0}\n", texturesToLoad[i].c_str());
+		}
+		RvAssetFingerprint fingerprint = RvAssetCache::fingerprint(source.data(), source.size(), textureSettings, sizeof(textureSettings));
+
+		//Check whether the same content was already listed, bytes are compared so a hash collision can't swap textures
+		uint32_t loaded = 0;
+		for (; loaded < fingerprints.size(); loaded++)
+		{
+			if (fingerprints[loaded] == fingerprint && sources[loaded].size() == source.size() &&
+				(source.size() == 0 || memcmp(sources[loaded].data(), source.data(), source.size()) == 0))
+			{
+				break;
+			}
+		}
+		if (loaded < fingerprints.size())
 		{
-			size_t frameOffset = i * meshesCount;
-			materialsBuffers[frameOffset + j] = device->createDynamicBuffer(sizeof(RvMaterialBufferObject), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, (VkMemoryPropertyFlagBits)(VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT));
-			modelsBuffers[frameOffset + j] = device->createDynamicBuffer(sizeof(RvModelBufferObject), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, (VkMemoryPropertyFlagBits)(VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT));
-			animationsBuffers[frameOffset + j] = device->createDynamicBuffer(sizeof(RvBoneBufferObject), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, (VkMemoryPropertyFlagBits)(VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT));
+			textureRemap[i] = loaded;
+			continue;
+		}
+
+		textureRemap[i] = static_cast<uint32_t>(fingerprints.size());
+		fingerprints.push_back(fingerprint);
+		sources.push_back(eastl::move(source));
+	}
+
+	//Normal plus undefined texture
+	texturesSize = 1 + static_cast<uint32_t>(fingerprints.size());
+
+	//Point meshes to the deduplicated textures
+	for (uint32_t i = 0; i < meshesCount; i++)
+	{
+		for (uint32_t t = 0; t < meshes[i].texturesCount; t++)
+		{
+			meshes[i].textureIds[t] = textureRemap[meshes[i].textureIds[t]];
 		}
 	}
 }
 
-void Ravine::loadTextureImages()
+void Ravine::decodeTextures(RvSceneHandle& handle, const vector<RvAssetFingerprint>& fingerprints, const vector<RvFileView>& sources)
+{
+	threadPool->parallelFor(static_cast<uint32_t>(sources.size()), [&](uint32_t i)
+	{
+		if (!sources[i].isValid())
+		{
+			return;
+		}
+
+		//Reuse decoded pixels when available, decode and cook them otherwise
+		RvDecodedTexture decoded;
+		decoded.textureId = 1 + i;
+		if (!RvAssetCache::loadTexture(fingerprints[i], decoded.cooked, decoded.cookedOffset, decoded.width, decoded.height))
+		{
+			int texWidth, texHeight, texChannels;
+			stbi_uc* pixels = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(sources[i].data()), static_cast<int>(sources[i].size()),
+				&texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
+			if (!pixels)
+			{
+				//Meshes keep the missing texture
+				fmt::print(stderr, "Failed to load texture image {0}!\n", fingerprints[i].toString().c_str());
+				return;
+			}
+
+			decoded.width = static_cast<uint32_t>(texWidth);
+			decoded.height = static_cast<uint32_t>(texHeight);
+			decoded.pixels.assign(reinterpret_cast<char*>(pixels), reinterpret_cast<char*>(pixels) + texWidth * texHeight * 4);
+			RvAssetCache::storeTexture(fingerprints[i], pixels, texWidth, texHeight);
+			stbi_image_free(pixels);
+		}
+
+		std::unique_lock<std::mutex> lock(handle.decodedMutex);
+		handle.decodedTextures.push_back(eastl::move(decoded));
+	});
+	handle.texturesDecoded = true;
+}
+
+void Ravine::createTextureImages()
 {
 	//Allocate RvTexture(s)
-	texturesSize = 1;
-	texturesSize += texturesToLoad.size(); //Normal plus undefined texture
 	textures = new RvTexture[texturesSize];
+	texturesResident.assign(texturesSize, 0);
 
-	//Generate Pink 2x2 image for missing texture
+	//Generate Pink 2x2 image for missing texture (also shown while textures are streaming)
 	char* pinkTexture = new char[16]; //2x2 = 4 pixels <= 4 * RGBA = 4 * 4 char = 32 char
 	for (uint32_t i = 0; i < 4; i++)
 	{
@@ -963,19 +1286,19 @@ void Ravine::loadTextureImages()
 		pinkTexture[i * 4 + 3] = 255;	//Alpha
 	}
 	textures[0] = device->createTexture(pinkTexture, 2, 2);
+	texturesResident[0] = 1;
+	delete[] pinkTexture;
+}
 
-	for (uint32_t i = 1; i < texturesSize; i++)
-	{
-		//Loading image
-		int texWidth, texHeight, texChannels;
-
-		fmt::print(stdout, "{0}\n", texturesToLoad[i - 1].c_str());
-		stbi_uc* pixels = stbi_load(("../data/" + texturesToLoad[i - 1]).c_str(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
-
-		textures[i] = device->createTexture(pixels, texWidth, texHeight);
+uint32_t Ravine::meshTextureId(uint32_t meshId) const
+{
+	const RvSkinnedMeshColored& mesh = meshes[meshId];
+	return mesh.texturesCount > 0 ? 1 + mesh.textureIds[0] : 0/*Missing Texture (Pink)*/;
+}
 
-		stbi_image_free(pixels);
-	}
+VkImageView Ravine::textureView(uint32_t textureId) const
+{
+	return texturesResident[textureId] ? textures[textureId].view : textures[0].view;
 }
 
 void Ravine::createTextureSampler()
@@ -1020,11 +1343,51 @@ void Ravine::createTextureSampler()
 	}
 }
 
+void Ravine::createRenderGraph()
+{
+	renderGraph = new RvRenderGraph(*device);
+
+	//Scene is drawn multi-sampled and resolved into the swapchain image, the GUI is drawn on top before the resolve
+	presentTarget = renderGraph->importImage("Swapchain", swapChain->imageFormat, swapChain->images, swapChain->imageViews);
+	RvGraphImageInfo colorInfo;
+	colorInfo.format = swapChain->imageFormat;
+	colorInfo.samples = device->sampleCount;
+	const uint32_t sceneColor = renderGraph->createImage("Scene Color", colorInfo);
+	RvGraphImageInfo depthInfo;
+	depthInfo.format = device->findDepthFormat();
+	depthInfo.samples = device->sampleCount;
+	const uint32_t sceneDepth = renderGraph->createImage("Scene Depth", depthInfo);
+
+	RvGraphPass& scenePass = renderGraph->addPass("Scene");
+	const VkClearColorValue clearColor = { 0.0f, 0.0f, 0.0f, 1.0f };
+	scenePass.addColorOutput(sceneColor, &clearColor, presentTarget);
+	const VkClearDepthStencilValue clearDepth = { 1.0f, 0 };	//Depth goes from [1,0] - being 1 the furthest possible
+	scenePass.setDepthOutput(sceneDepth, &clearDepth);
+	scenePass.contents = VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS;
+	scenePass.record = [this](VkCommandBuffer commandBuffer, uint32_t)
+	{
+		//Secondary command buffers belong to the frame in flight, not to the swapchain image
+		const uint32_t frameSlot = swapChain->frameSlot();
+
+		//Execute Skinned Mesh Pipeline - Secondary Command Buffer
+		vkCmdExecuteCommands(commandBuffer, 1, &secondaryCmdBuffers[frameSlot]);
+
+		//Execute GUI Pipeline - Secondary Command Buffer
+		vkCmdExecuteCommands(commandBuffer, 1, &gui->cmdBuffers[frameSlot]);
+	};
+
+	renderGraph->setOutput(presentTarget);
+	renderGraph->compile(swapChain->extent, static_cast<uint32_t>(swapChain->images.size()));
+
+	//Pipelines and the GUI record into the scene subpass
+	renderPass = renderGraph->getRenderPass(renderGraph->getPass("Scene"));
+}
+
 void Ravine::allocateCommandBuffers() {
 
-	//Allocate command buffers
-	primaryCmdBuffers.resize(renderPass->framebuffers.size());
-	secondaryCmdBuffers.resize(renderPass->framebuffers.size());
+	//Allocate command buffers, one per frame in flight (re-recorded once its fence was waited on)
+	primaryCmdBuffers.resize(RV_MAX_FRAMES_IN_FLIGHT);
+	secondaryCmdBuffers.resize(RV_MAX_FRAMES_IN_FLIGHT);
 
 	//Primary Command Buffers
 	VkCommandBufferAllocateInfo allocInfo = {};
@@ -1043,7 +1406,15 @@ void Ravine::allocateCommandBuffers() {
 	}
 }
 
-void Ravine::recordCommandBuffers(const uint32_t currentFrame)
+void Ravine::bindMeshDescriptorSets(VkCommandBuffer commandBuffer, VkPipelineLayout layout, uint32_t frameSlot, size_t meshIndex)
+{
+	//Material set of the mesh texture, the dynamic offsets pick its material, model and bones uniforms
+	const array<VkDescriptorSet, 2> sets = { materialDescriptorSets[frameSlot * texturesSize + meshTextureId(static_cast<uint32_t>(meshIndex))], modelDescriptorSet };
+	vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 1, static_cast<uint32_t>(sets.size()), sets.data(),
+		static_cast<uint32_t>(meshUniformOffsets[meshIndex].size()), meshUniformOffsets[meshIndex].data());
+}
+
+void Ravine::recordCommandBuffers(const uint32_t frameSlot, const uint32_t frameIndex)
 {
 
 	VkCommandBufferBeginInfo beginInfo = {};
@@ -1056,132 +1427,164 @@ void Ravine::recordCommandBuffers(const uint32_t currentFrame)
 	VkCommandBufferInheritanceInfo inheritanceInfo = {};
 	inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
 	inheritanceInfo.renderPass = renderPass->handle;
-	//inheritanceInfo.subpass = 0;
+	inheritanceInfo.subpass = renderGraph->getPass("Scene").subpass;
 	inheritanceInfo.occlusionQueryEnable = VK_FALSE;
-	inheritanceInfo.framebuffer = renderPass->framebuffers[currentFrame];
+	inheritanceInfo.framebuffer = renderPass->framebuffers[frameIndex];
 	inheritanceInfo.pipelineStatistics = 0;
 	beginInfo.pInheritanceInfo = &inheritanceInfo;
 
 	//Begin recording Command Buffer
-	if (vkBeginCommandBuffer(secondaryCmdBuffers[currentFrame], &beginInfo) != VK_SUCCESS) {
+	if (vkBeginCommandBuffer(secondaryCmdBuffers[frameSlot], &beginInfo) != VK_SUCCESS) {
 		throw std::runtime_error("Failed to begin recording command buffer!");
 	}
 
+	//Pipelines take viewport and scissor as dynamic state, they cover the current swapchain extent
+	VkViewport viewport = {};
+	viewport.width = static_cast<float>(swapChain->extent.width);
+	viewport.height = static_cast<float>(swapChain->extent.height);
+	viewport.minDepth = 0.0f;
+	viewport.maxDepth = 1.0f;
+	vkCmdSetViewport(secondaryCmdBuffers[frameSlot], 0, 1, &viewport);
+
+	VkRect2D scissor = {};
+	scissor.extent = swapChain->extent;
+	vkCmdSetScissor(secondaryCmdBuffers[frameSlot], 0, 1, &scissor);
+
 	//Basic Drawing Commands
 	//Reference: https://vulkan-tutorial.com/Drawing_a_triangle/Drawing/Command_buffers#page_Basic_drawing_commands
-	const size_t setsPerFrame = 1 + (meshesCount * 2);
-	const VkDeviceSize offsets[] = { 0 };
+	//Nothing but the GUI is drawn until the scene resources exist
+	const uint32_t drawnMeshesCount = sceneResourcesCreated ? meshesCount : 0;
+	const uint32_t residentCount = sceneResourcesCreated ? residentMeshesCount : 0;
+
+	//Every mesh draws from the pool buffers
+	if (sceneResourcesCreated)
+	{
+		geometryPool->bind(secondaryCmdBuffers[frameSlot]);
+	}
+
+	//Detail level of each mesh for this frame
+	RvFrameVector<uint32_t> meshLods(residentCount);
+	for (size_t meshIndex = 0; meshIndex < residentCount; meshIndex++)
+	{
+		meshLods[meshIndex] = selectLod(meshes[meshIndex]);
+	}
 
-	if (staticSolidPipelineEnabled)
+	//Meshes still being uploaded are drawn as their bounding boxes
+	if (residentCount < drawnMeshesCount)
+	{
+		vkCmdBindPipeline(secondaryCmdBuffers[frameSlot], VK_PIPELINE_BIND_POINT_GRAPHICS, *staticLineGraphicsPipeline);
+		vkCmdBindDescriptorSets(secondaryCmdBuffers[frameSlot], VK_PIPELINE_BIND_POINT_GRAPHICS,
+			staticLineGraphicsPipeline->layout, 0, 1, &globalDescriptorSet, 1, &globalUniformOffset);
+
+		for (size_t meshIndex = residentCount; meshIndex < drawnMeshesCount; meshIndex++)
+		{
+			bindMeshDescriptorSets(secondaryCmdBuffers[frameSlot], staticLineGraphicsPipeline->layout, frameSlot, meshIndex);
+
+			const RvGeometryAllocation& proxy = proxyAllocations[meshIndex];
+			vkCmdDrawIndexed(secondaryCmdBuffers[frameSlot], proxy.indexCount, 1, proxy.firstIndex, proxy.vertexOffset, 0);
+		}
+	}
+
+	if (staticSolidPipelineEnabled && residentCount > 0)
 	{
 		//Bind Correct Graphics Pipeline
-		vkCmdBindPipeline(secondaryCmdBuffers[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS, *staticGraphicsPipeline);
+		vkCmdBindPipeline(secondaryCmdBuffers[frameSlot], VK_PIPELINE_BIND_POINT_GRAPHICS, *staticGraphicsPipeline);
 
 		//Global, Material and Model Descriptor Sets
-		vkCmdBindDescriptorSets(secondaryCmdBuffers[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS, staticGraphicsPipeline->layout, 0, 1, &descriptorSets[currentFrame * setsPerFrame], 0, nullptr);
+		vkCmdBindDescriptorSets(secondaryCmdBuffers[frameSlot], VK_PIPELINE_BIND_POINT_GRAPHICS, staticGraphicsPipeline->layout, 0, 1, &globalDescriptorSet, 1, &globalUniformOffset);
 
 		//Call drawing
-		for (size_t meshIndex = 0; meshIndex < meshesCount; meshIndex++)
+		for (size_t meshIndex = 0; meshIndex < residentCount; meshIndex++)
 		{
-			const size_t meshSetOffset = meshIndex * 2;
-			vkCmdBindDescriptorSets(secondaryCmdBuffers[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS,
-				staticGraphicsPipeline->layout, 1, 2, &descriptorSets[currentFrame * setsPerFrame + meshSetOffset + 1], 0, nullptr);
+			bindMeshDescriptorSets(secondaryCmdBuffers[frameSlot], staticGraphicsPipeline->layout, frameSlot, meshIndex);
 
-			vkCmdBindVertexBuffers(secondaryCmdBuffers[currentFrame], 0, 1, &vertexBuffers[meshIndex].handle, offsets);
-			vkCmdBindIndexBuffer(secondaryCmdBuffers[currentFrame], indexBuffers[meshIndex].handle, 0, VK_INDEX_TYPE_UINT32);
-			vkCmdDrawIndexed(secondaryCmdBuffers[currentFrame], static_cast<uint32_t>(indexBuffers[meshIndex].instancesCount), 1, 0, 0, 0);
+			const RvGeometryAllocation& geometry = geometryAllocations[meshIndex];
+			const RvMeshLod& lod = meshes[meshIndex].lods[meshLods[meshIndex]];
+			vkCmdDrawIndexed(secondaryCmdBuffers[frameSlot], lod.indexCount, 1, geometry.firstIndex + lod.firstIndex, geometry.vertexOffset, 0);
 		}
 	}
 
-	if (staticWiredPipelineEnabled)
+	if (staticWiredPipelineEnabled && residentCount > 0)
 	{
 		//Bind Correct Graphics Pipeline
-		vkCmdBindPipeline(secondaryCmdBuffers[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS, *staticWireframeGraphicsPipeline);
+		vkCmdBindPipeline(secondaryCmdBuffers[frameSlot], VK_PIPELINE_BIND_POINT_GRAPHICS, *staticWireframeGraphicsPipeline);
 
 		//Global, Material and Model Descriptor Sets
-		vkCmdBindDescriptorSets(secondaryCmdBuffers[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS, staticWireframeGraphicsPipeline->layout, 0, 1, &descriptorSets[currentFrame * setsPerFrame], 0, nullptr);
+		vkCmdBindDescriptorSets(secondaryCmdBuffers[frameSlot], VK_PIPELINE_BIND_POINT_GRAPHICS, staticWireframeGraphicsPipeline->layout, 0, 1, &globalDescriptorSet, 1, &globalUniformOffset);
 
 		//Call drawing
-		for (size_t meshIndex = 0; meshIndex < meshesCount; meshIndex++)
+		for (size_t meshIndex = 0; meshIndex < residentCount; meshIndex++)
 		{
-			const size_t meshSetOffset = meshIndex * 2;
-			vkCmdBindDescriptorSets(secondaryCmdBuffers[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS,
-				staticWireframeGraphicsPipeline->layout, 1, 2, &descriptorSets[currentFrame * setsPerFrame + meshSetOffset + 1], 0, nullptr);
+			bindMeshDescriptorSets(secondaryCmdBuffers[frameSlot], staticWireframeGraphicsPipeline->layout, frameSlot, meshIndex);
 
-			vkCmdBindVertexBuffers(secondaryCmdBuffers[currentFrame], 0, 1, &vertexBuffers[meshIndex].handle, offsets);
-			vkCmdBindIndexBuffer(secondaryCmdBuffers[currentFrame], indexBuffers[meshIndex].handle, 0, VK_INDEX_TYPE_UINT32);
-			vkCmdDrawIndexed(secondaryCmdBuffers[currentFrame], static_cast<uint32_t>(indexBuffers[meshIndex].instancesCount), 1, 0, 0, 0);
+			const RvGeometryAllocation& geometry = geometryAllocations[meshIndex];
+			const RvMeshLod& lod = meshes[meshIndex].lods[meshLods[meshIndex]];
+			vkCmdDrawIndexed(secondaryCmdBuffers[frameSlot], lod.indexCount, 1, geometry.firstIndex + lod.firstIndex, geometry.vertexOffset, 0);
 		}
 	}
 
-	if (skinnedSolidPipelineEnabled)
+	if (skinnedSolidPipelineEnabled && residentCount > 0)
 	{
 		//Bind Correct Graphics Pipeline
-		vkCmdBindPipeline(secondaryCmdBuffers[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS, *skinnedGraphicsPipeline);
+		vkCmdBindPipeline(secondaryCmdBuffers[frameSlot], VK_PIPELINE_BIND_POINT_GRAPHICS, *skinnedGraphicsPipeline);
 
 		//Global, Material and Model Descriptor Sets
-		vkCmdBindDescriptorSets(secondaryCmdBuffers[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS,
-			skinnedGraphicsPipeline->layout, 0, 1, &descriptorSets[currentFrame * setsPerFrame], 0, nullptr);
+		vkCmdBindDescriptorSets(secondaryCmdBuffers[frameSlot], VK_PIPELINE_BIND_POINT_GRAPHICS,
+			skinnedGraphicsPipeline->layout, 0, 1, &globalDescriptorSet, 1, &globalUniformOffset);
 
 		//Call drawing
-		for (size_t meshIndex = 0; meshIndex < meshesCount; meshIndex++)
+		for (size_t meshIndex = 0; meshIndex < residentCount; meshIndex++)
 		{
-			const size_t meshSetOffset = meshIndex * 2;
-			vkCmdBindDescriptorSets(secondaryCmdBuffers[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS,
-				skinnedGraphicsPipeline->layout, 1, 2, &descriptorSets[currentFrame * setsPerFrame + meshSetOffset + 1], 0, nullptr);
+			bindMeshDescriptorSets(secondaryCmdBuffers[frameSlot], skinnedGraphicsPipeline->layout, frameSlot, meshIndex);
 
-			vkCmdBindVertexBuffers(secondaryCmdBuffers[currentFrame], 0, 1, &vertexBuffers[meshIndex].handle, offsets);
-			vkCmdBindIndexBuffer(secondaryCmdBuffers[currentFrame], indexBuffers[meshIndex].handle, 0, VK_INDEX_TYPE_UINT32);
-			vkCmdDrawIndexed(secondaryCmdBuffers[currentFrame], static_cast<uint32_t>(indexBuffers[meshIndex].instancesCount), 1, 0, 0, 0);
+			const RvGeometryAllocation& geometry = geometryAllocations[meshIndex];
+			const RvMeshLod& lod = meshes[meshIndex].lods[meshLods[meshIndex]];
+			vkCmdDrawIndexed(secondaryCmdBuffers[frameSlot], lod.indexCount, 1, geometry.firstIndex + lod.firstIndex, geometry.vertexOffset, 0);
 		}
 	}
 
 
-	if (skinnedSolidPipelineEnabled)
+	if (skinnedSolidPipelineEnabled && residentCount > 0)
 	{
 		//Bind Correct Graphics Pipeline
-		vkCmdBindPipeline(secondaryCmdBuffers[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS, *skinnedGraphicsPipeline);
+		vkCmdBindPipeline(secondaryCmdBuffers[frameSlot], VK_PIPELINE_BIND_POINT_GRAPHICS, *skinnedGraphicsPipeline);
 
 		//Global, Material and Model Descriptor Sets
-		vkCmdBindDescriptorSets(secondaryCmdBuffers[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS,
-			skinnedGraphicsPipeline->layout, 0, 1, &descriptorSets[currentFrame * setsPerFrame], 0, nullptr);
+		vkCmdBindDescriptorSets(secondaryCmdBuffers[frameSlot], VK_PIPELINE_BIND_POINT_GRAPHICS,
+			skinnedGraphicsPipeline->layout, 0, 1, &globalDescriptorSet, 1, &globalUniformOffset);
 
 		//Call drawing
-		for (size_t meshIndex = 0; meshIndex < meshesCount; meshIndex++)
+		for (size_t meshIndex = 0; meshIndex < residentCount; meshIndex++)
 		{
-			const size_t meshSetOffset = meshIndex * 2;
-			vkCmdBindDescriptorSets(secondaryCmdBuffers[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS,
-				skinnedGraphicsPipeline->layout, 1, 2, &descriptorSets[currentFrame * setsPerFrame + meshSetOffset + 1], 0, nullptr);
+			bindMeshDescriptorSets(secondaryCmdBuffers[frameSlot], skinnedGraphicsPipeline->layout, frameSlot, meshIndex);
 
-			vkCmdBindVertexBuffers(secondaryCmdBuffers[currentFrame], 0, 1, &vertexBuffers[meshIndex].handle, offsets);
-			vkCmdBindIndexBuffer(secondaryCmdBuffers[currentFrame], indexBuffers[meshIndex].handle, 0, VK_INDEX_TYPE_UINT32);
-			vkCmdDrawIndexed(secondaryCmdBuffers[currentFrame], static_cast<uint32_t>(indexBuffers[meshIndex].instancesCount), 1, 0, 0, 0);
+			const RvGeometryAllocation& geometry = geometryAllocations[meshIndex];
+			const RvMeshLod& lod = meshes[meshIndex].lods[meshLods[meshIndex]];
+			vkCmdDrawIndexed(secondaryCmdBuffers[frameSlot], lod.indexCount, 1, geometry.firstIndex + lod.firstIndex, geometry.vertexOffset, 0);
 		}
 	}
 
-	if (skinnedWiredPipelineEnabled)
+	if (skinnedWiredPipelineEnabled && residentCount > 0)
 	{
 		//Perform the same with wireframe rendering
-		vkCmdBindPipeline(secondaryCmdBuffers[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS, *skinnedWireframeGraphicsPipeline);
+		vkCmdBindPipeline(secondaryCmdBuffers[frameSlot], VK_PIPELINE_BIND_POINT_GRAPHICS, *skinnedWireframeGraphicsPipeline);
 
 		//Global, Material and Model Descriptor Sets
-		vkCmdBindDescriptorSets(secondaryCmdBuffers[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS,
-			skinnedWireframeGraphicsPipeline->layout, 0, 1, &descriptorSets[currentFrame * setsPerFrame], 0, nullptr);
+		vkCmdBindDescriptorSets(secondaryCmdBuffers[frameSlot], VK_PIPELINE_BIND_POINT_GRAPHICS,
+			skinnedWireframeGraphicsPipeline->layout, 0, 1, &globalDescriptorSet, 1, &globalUniformOffset);
 
-		for (size_t meshIndex = 0; meshIndex < meshesCount; meshIndex++)
+		for (size_t meshIndex = 0; meshIndex < residentCount; meshIndex++)
 		{
-			const size_t meshSetOffset = meshIndex * 2;
-			vkCmdBindDescriptorSets(secondaryCmdBuffers[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS,
-				skinnedWireframeGraphicsPipeline->layout, 1, 2, &descriptorSets[currentFrame * setsPerFrame + meshSetOffset + 1], 0, nullptr);
+			bindMeshDescriptorSets(secondaryCmdBuffers[frameSlot], skinnedWireframeGraphicsPipeline->layout, frameSlot, meshIndex);
 
-			vkCmdBindVertexBuffers(secondaryCmdBuffers[currentFrame], 0, 1, &vertexBuffers[meshIndex].handle, offsets);
-			vkCmdBindIndexBuffer(secondaryCmdBuffers[currentFrame], indexBuffers[meshIndex].handle, 0, VK_INDEX_TYPE_UINT32);
-			vkCmdDrawIndexed(secondaryCmdBuffers[currentFrame], static_cast<uint32_t>(indexBuffers[meshIndex].instancesCount), 1, 0, 0, 0);
+			const RvGeometryAllocation& geometry = geometryAllocations[meshIndex];
+			const RvMeshLod& lod = meshes[meshIndex].lods[meshLods[meshIndex]];
+			vkCmdDrawIndexed(secondaryCmdBuffers[frameSlot], lod.indexCount, 1, geometry.firstIndex + lod.firstIndex, geometry.vertexOffset, 0);
 		}
 	}
 
 	//Stop recording Command Buffer
-	if (vkEndCommandBuffer(secondaryCmdBuffers[currentFrame]) != VK_SUCCESS) {
+	if (vkEndCommandBuffer(secondaryCmdBuffers[frameSlot]) != VK_SUCCESS) {
 		throw std::runtime_error("Failed to record command buffer!");
 	}
 #pragma endregion
@@ -1190,39 +1593,15 @@ void Ravine::recordCommandBuffers(const uint32_t currentFrame)
 	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
 
 	//Begin recording command buffer
-	if (vkBeginCommandBuffer(primaryCmdBuffers[currentFrame], &beginInfo) != VK_SUCCESS) {
+	if (vkBeginCommandBuffer(primaryCmdBuffers[frameSlot], &beginInfo) != VK_SUCCESS) {
 		throw std::runtime_error("Failed to begin recording command buffer!");
 	}
 
-	//Starting a Render Pass
-	//Reference: https://vulkan-tutorial.com/Drawing_a_triangle/Drawing/Command_buffers#page_Starting_a_render_pass
-	VkRenderPassBeginInfo renderPassInfo = {};
-	renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-	renderPassInfo.renderPass = renderPass->handle;
-	renderPassInfo.framebuffer = renderPass->framebuffers[currentFrame];
-	renderPassInfo.renderArea.offset = { 0, 0 };
-	renderPassInfo.renderArea.extent = swapChain->extent;
-
-	//Clearing values
-	array<VkClearValue, 2> clearValues = {};
-	clearValues[0].color = { 0.0f, 0.0f, 0.0f, 1.0f };
-	clearValues[1].depthStencil = { 1.0f, 0 };	//Depth goes from [1,0] - being 1 the furthest possible
-	renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
-	renderPassInfo.pClearValues = clearValues.data();
-
-	vkCmdBeginRenderPass(primaryCmdBuffers[currentFrame], &renderPassInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
-
-	//Execute Skinned Mesh Pipeline - Secondary Command Buffer
-	vkCmdExecuteCommands(primaryCmdBuffers[currentFrame], 1, &secondaryCmdBuffers[currentFrame]);
-
-	//Execute GUI Pipeline - Secondary Command Buffer
-	vkCmdExecuteCommands(primaryCmdBuffers[currentFrame], 1, &gui->cmdBuffers[currentFrame]);
-
-	//Finishing Render Pass
-	vkCmdEndRenderPass(primaryCmdBuffers[currentFrame]);
+	//Render passes, their barriers and subpass contents come from the render graph
+	renderGraph->execute(primaryCmdBuffers[frameSlot], frameIndex);
 
 	//Stop recording Command Buffer
-	if (vkEndCommandBuffer(primaryCmdBuffers[currentFrame]) != VK_SUCCESS) {
+	if (vkEndCommandBuffer(primaryCmdBuffers[frameSlot]) != VK_SUCCESS) {
 		throw std::runtime_error("Failed to record command buffer!");
 	}
 #pragma endregion
@@ -1238,10 +1617,17 @@ void Ravine::mainLoop() {
 
 	while (!glfwWindowShouldClose(*window)) {
 		RvTime::update();
+		RvHeap::update(RvTime::deltaTime());
 
 		glfwSetWindowTitle(*window, "Ravine 1.0a");
 
-		glfwPollEvents();
+		//Sleep while minimized instead of spinning on frames that are skipped
+		if (window->extent.width == 0 || window->extent.height == 0) {
+			glfwWaitEvents();
+		}
+		else {
+			glfwPollEvents();
+		}
 
 		drawFrame();
 	}
@@ -1252,6 +1638,7 @@ void Ravine::mainLoop() {
 void Ravine::drawGuiElements()
 {
 	static bool showPipelinesMenu = false;
+	static bool showMemoryMenu = false;
 	ImGui::BeginMainMenuBar();
 	ImGui::TextUnformatted("Ravine Vulkan Prototype - Version 0.1a");
 	ImGui::Separator();
@@ -1262,15 +1649,26 @@ void Ravine::drawGuiElements()
 	}
 	ImGui::Separator();
 
+	if (ImGui::MenuItem("Memory Menu", 0, false, !showMemoryMenu))
+	{
+		showMemoryMenu = !showMemoryMenu;
+	}
+	ImGui::Separator();
+
 	static double lastUpdateTime = 0;
 	lastUpdateTime += RvTime::deltaTime();
-	static string lastFps = "0";
+	static char lastFps[32] = "0";
 	if (lastUpdateTime > 0.1)
 	{
 		lastUpdateTime = 0;
-		lastFps = "FPS - " + eastl::to_string(RvTime::framesPerSecond());
+		snprintf(lastFps, sizeof(lastFps), "FPS - %d", RvTime::framesPerSecond());
+	}
+	ImGui::TextUnformatted(lastFps);
+	if (sceneHandle && !sceneHandle->isResident())
+	{
+		ImGui::Separator();
+		ImGui::TextUnformatted(sceneHandle->state == RV_SCENE_LOAD_FAILED ? "Scene failed to load" : "Loading scene...");
 	}
-	ImGui::TextUnformatted(lastFps.c_str());
 	if (ImGui::MenuItem("Exit Ravine", 0, false))
 	{
 		glfwSetWindowShouldClose(*window, true);
@@ -1295,6 +1693,56 @@ void Ravine::drawGuiElements()
 				ImGui::DragFloat3("Position", value_ptr(uniformPosition), 0.01f);
 				ImGui::DragFloat3("Scale", value_ptr(uniformScale), 0.001f, 0.00001f, 1000.0f);
 				ImGui::DragFloat3("Rotation", value_ptr(uniformRotation), 1.f, -180.f, 180.f);
+				ImGui::DragFloat("LOD Pixel Error", &lodPixelError, 0.05f, 0.0f, 64.0f);
+				ImGui::Separator();
+			}
+
+			ImGui::End();
+		}
+	}
+
+	if (showMemoryMenu)
+	{
+		if (ImGui::Begin("Memory Menu", &showMemoryMenu, { 420, 360 }, -1, ImGuiWindowFlags_NoCollapse))
+		{
+			const float megabyte = 1024.0f * 1024.0f;
+			char overlay[64];
+
+			ImGui::TextUnformatted(device->allocator->isBudgetSupported() ? "Heap Budgets" : "Heap Budgets (estimated)");
+			{
+				for (uint32_t heapIndex = 0; heapIndex < device->allocator->heapCount(); heapIndex++)
+				{
+					const RvMemoryBudget budget = device->allocator->getBudget(heapIndex);
+					ImGui::Text("Heap %u%s - %.1fMB allocated here", heapIndex, budget.deviceLocal ? " (device local)" : "",
+						budget.allocatedBytes / megabyte);
+					snprintf(overlay, sizeof(overlay), "%.1f / %.1f MB", budget.usage / megabyte, budget.budget / megabyte);
+					ImGui::ProgressBar(budget.pressure(), ImVec2(-1, 0), overlay);
+				}
+				ImGui::Separator();
+			}
+
+			ImGui::TextUnformatted("Device Allocations");
+			{
+				for (uint32_t category = 0; category < RV_ALLOCATION_CATEGORY_COUNT; category++)
+				{
+					const RvCategoryStats stats = device->allocator->getCategoryStats(static_cast<RvAllocationCategory>(category));
+					ImGui::Text("%-12s %6u allocations %9.1fMB", RvMemoryAllocator::categoryName(static_cast<RvAllocationCategory>(category)),
+						stats.allocationCount, stats.bytes / megabyte);
+				}
+				ImGui::Text("%u of %u device allocations", device->allocator->deviceAllocationCount(), device->deviceProperties.limits.maxMemoryAllocationCount);
+				ImGui::Text("Render graph attachments %.1fMB (%.1fMB unaliased)", renderGraph->transientBytes() / megabyte,
+					renderGraph->unaliasedTransientBytes() / megabyte);
+				ImGui::Separator();
+			}
+
+			ImGui::TextUnformatted("CPU Heap");
+			{
+				for (uint32_t category = 0; category < RV_HEAP_CATEGORY_COUNT; category++)
+				{
+					const RvHeapStats stats = RvHeap::getStats(static_cast<RvHeapCategory>(category));
+					ImGui::Text("%-12s %9.1fKB (peak %.1fKB) %8.0f allocs/s", RvHeap::categoryName(static_cast<RvHeapCategory>(category)),
+						stats.liveBytes / 1024.0f, stats.peakBytes / 1024.0f, stats.allocationRate);
+				}
 				ImGui::Separator();
 			}
 
@@ -1314,44 +1762,79 @@ void Ravine::drawFrame()
 	//Fences are best fitted to syncronize the application itself with the renderization operations, while
 	//semaphores are used to syncronize operations within or across command queues - thus our best fit.
 
-	//Handle resize and such
+	//Scratch memory of the previous frame is no longer referenced
+	RvFrameArena::local().reset();
+
+	//Heap allocations of the frame are accounted to the renderer unless a system below says otherwise
+	RvHeapScope heapScope(RV_HEAP_RENDERER);
+
+	//Budgets also include what other processes use, refresh them once per frame (shown in the memory menu)
+	device->allocator->updateBudget();
+
+	//A minimized window has nothing to present to, frames are skipped until it comes back
+	if (window->extent.width == 0 || window->extent.height == 0)
+	{
+		return;
+	}
+
+	//Rebuild before acquiring so this frame already renders at the new size
 	if (window->framebufferResized)
 	{
-		swapChain->framebufferResized = true;
 		window->framebufferResized = false;
+		recreateSwapChain();
 	}
 	uint32_t frameIndex;
 	if (!swapChain->acquireNextFrame(frameIndex)) {
 		recreateSwapChain();
+		return;
+	}
+
+	//Resources written by the CPU exist per frame in flight, only framebuffers follow the swapchain image
+	const uint32_t frameSlot = swapChain->frameSlot();
+
+	//Create and upload whatever the scene loader made available
+	{
+		RvHeapScope assetsScope(RV_HEAP_ASSETS);
+		streamScene();
+	}
+
+	//Point this frame sets to textures that became resident since they were last written
+	if (sceneResourcesCreated && descriptorTexturesVersions[frameSlot] != texturesVersion) {
+		updateTextureDescriptors(frameSlot);
 	}
 
 	//Update bone transforms
-	if (!meshes[0].animations.empty()) {
+	if (sceneResourcesCreated && !meshes[0].animations.empty()) {
+		RvHeapScope animationScope(RV_HEAP_ANIMATION);
 		boneTransform(RvTime::elapsedTime(), meshes[0].boneTransforms);
 	}
 
-	//Start GUI recording
-	gui->acquireFrame();
-	//DRAW THE GUI HERE
+	{
+		RvHeapScope guiScope(RV_HEAP_GUI);
+
+		//Start GUI recording
+		gui->acquireFrame();
+		//DRAW THE GUI HERE
 
-	drawGuiElements();
+		drawGuiElements();
 
-	//BUT NOT AFTER HERE
-	gui->submitFrame();
+		//BUT NOT AFTER HERE
+		gui->submitFrame();
 
-	//Update GUI Buffers
-	gui->updateBuffers(frameIndex);
+		//Update GUI Buffers
+		gui->updateBuffers(frameSlot);
 
-	//Record GUI Draw Commands into CMD Buffers
-	gui->recordCmdBuffers(frameIndex);
+		//Record GUI Draw Commands into CMD Buffers
+		gui->recordCmdBuffers(frameSlot, frameIndex);
+	}
 
 	//Update the uniforms for the given frame
-	updateUniformBuffer(frameIndex);
+	updateUniformBuffer(frameSlot);
 
 	//Make sure to record all new Commands
-	recordCommandBuffers(frameIndex);
+	recordCommandBuffers(frameSlot, frameIndex);
 
-	if (!swapChain->submitNextFrame(primaryCmdBuffers.data(), frameIndex)) {
+	if (!swapChain->submitNextFrame(primaryCmdBuffers[frameSlot], frameIndex)) {
 		recreateSwapChain();
 	}
 }
@@ -1369,7 +1852,7 @@ void Ravine::setupFpsCam()
 
 }
 
-void Ravine::updateUniformBuffer(uint32_t currentFrame)
+void Ravine::updateUniformBuffer(uint32_t frameSlot)
 {
 	/*
 	Using a UBO this way is not the most efficient way to pass frequently changing values to the shader.
@@ -1453,14 +1936,14 @@ void Ravine::updateUniformBuffer(uint32_t currentFrame)
 		fmt::print(stdout, "{0}\n", animInterpolation);
 	}
 	// SWAP ANIMATIONS
-	if (glfwGetKey(*window, GLFW_KEY_RIGHT) == GLFW_PRESS && !keyUpPressed) {
+	if (sceneResourcesCreated && !meshes[0].animations.empty() && glfwGetKey(*window, GLFW_KEY_RIGHT) == GLFW_PRESS && !keyUpPressed) {
 		keyUpPressed = true;
 		meshes[0].curAnimId = (meshes[0].curAnimId + 1) % meshes[0].animations.size();
 	}
 	if (glfwGetKey(*window, GLFW_KEY_RIGHT) == GLFW_RELEASE) {
 		keyUpPressed = false;
 	}
-	if (glfwGetKey(*window, GLFW_KEY_LEFT) == GLFW_PRESS && !keyDownPressed) {
+	if (sceneResourcesCreated && !meshes[0].animations.empty() && glfwGetKey(*window, GLFW_KEY_LEFT) == GLFW_PRESS && !keyDownPressed) {
 		keyDownPressed = true;
 		meshes[0].curAnimId = (meshes[0].curAnimId - 1) % meshes[0].animations.size();
 	}
@@ -1472,6 +1955,12 @@ void Ravine::updateUniformBuffer(uint32_t currentFrame)
 
 #pragma endregion
 
+	//Scene uniforms only exist once the scene started streaming
+	if (!sceneResourcesCreated)
+	{
+		return;
+	}
+
 #pragma region Global Uniforms
 	RvGlobalBufferObject ubo = {};
 
@@ -1487,11 +1976,10 @@ void Ravine::updateUniformBuffer(uint32_t currentFrame)
 	//Flipping coordinates (because glm was designed for openGL, with fliped Y coordinate)
 	ubo.proj[1][1] *= -1;
 
-	//Transfering uniform data to uniform buffer
-	void* data;
-	vkMapMemory(device->handle, globalBuffers[currentFrame].memory, 0, sizeof(ubo), 0, &data);
-	memcpy(data, &ubo, sizeof(ubo));
-	vkUnmapMemory(device->handle, globalBuffers[currentFrame].memory);
+	//Offsets are bound with the descriptor sets when recording this frame
+	uniformRing->begin(frameSlot);
+	globalUniformOffset = static_cast<uint32_t>(uniformRing->push(ubo));
+	meshUniformOffsets.resize(meshesCount);
 #pragma endregion
 
 	//TODO: Change this to a per-material basis instead of per-mesh
@@ -1502,27 +1990,29 @@ void Ravine::updateUniformBuffer(uint32_t currentFrame)
 
 		materialsUbo.customColor = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
 
-		void* materialsData;
-		vkMapMemory(device->handle, materialsBuffers[currentFrame * meshesCount + meshId].memory, 0, sizeof(materialsUbo), 0, &materialsData);
-		memcpy(materialsData, &materialsUbo, sizeof(materialsUbo));
-		vkUnmapMemory(device->handle, materialsBuffers[currentFrame * meshesCount + meshId].memory);
+		meshUniformOffsets[meshId][0] = static_cast<uint32_t>(uniformRing->push(materialsUbo));
 #pragma endregion
 
 #pragma region Models
 		RvModelBufferObject modelsUbo = {};
 
 		//Model matrix updates
-		modelsUbo.model = glm::translate(glm::mat4(1.0f), uniformPosition);
-		modelsUbo.model = glm::rotate(modelsUbo.model, glm::radians(uniformRotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
-		modelsUbo.model = glm::rotate(modelsUbo.model, glm::radians(uniformRotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
-		modelsUbo.model = glm::rotate(modelsUbo.model, glm::radians(uniformRotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
-		modelsUbo.model = glm::scale(modelsUbo.model, uniformScale);
+		modelsUbo.model = modelMatrix();
+
+		//Quantized positions are stored relative to the mesh bounds
+		if (vertexFormat == RV_VERTEX_FORMAT_QUANTIZED)
+		{
+			modelsUbo.positionScale = glm::vec4(glm::max(meshes[meshId].aabbMax - meshes[meshId].aabbMin, glm::vec3(1e-6f)), 0.0f);
+			modelsUbo.positionOffset = glm::vec4(meshes[meshId].aabbMin, 0.0f);
+		}
+		else
+		{
+			modelsUbo.positionScale = glm::vec4(1.0f, 1.0f, 1.0f, 0.0f);
+			modelsUbo.positionOffset = glm::vec4(0.0f);
+		}
 
 		//Transfering model data to gpu buffer
-		void* modelData;
-		vkMapMemory(device->handle, modelsBuffers[currentFrame * meshesCount + meshId].memory, 0, sizeof(modelsUbo), 0, &modelData);
-		memcpy(modelData, &modelsUbo, sizeof(modelsUbo));
-		vkUnmapMemory(device->handle, modelsBuffers[currentFrame * meshesCount + meshId].memory);
+		meshUniformOffsets[meshId][1] = static_cast<uint32_t>(uniformRing->push(modelsUbo));
 #pragma endregion
 
 #pragma region Animations
@@ -1533,26 +2023,71 @@ void Ravine::updateUniformBuffer(uint32_t currentFrame)
 			bonesUbo.transformMatrixes[i] = glm::transpose(glm::make_mat4(&meshes[0].boneTransforms[i].a1));
 		}
 
-		void* bonesData;
-		vkMapMemory(device->handle, animationsBuffers[currentFrame * meshesCount + meshId].memory, 0, sizeof(bonesUbo), 0, &bonesData);
-		memcpy(bonesData, &bonesUbo, sizeof(bonesUbo));
-		vkUnmapMemory(device->handle, animationsBuffers[currentFrame * meshesCount + meshId].memory);
+		meshUniformOffsets[meshId][2] = static_cast<uint32_t>(uniformRing->push(bonesUbo));
 #pragma endregion
 	}
 
 }
 
+glm::mat4 Ravine::modelMatrix() const
+{
+	glm::mat4 model = glm::translate(glm::mat4(1.0f), uniformPosition);
+	model = glm::rotate(model, glm::radians(uniformRotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
+	model = glm::rotate(model, glm::radians(uniformRotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
+	model = glm::rotate(model, glm::radians(uniformRotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
+	return glm::scale(model, uniformScale);
+}
+
+uint32_t Ravine::selectLod(const RvSkinnedMeshColored& mesh) const
+{
+	//Bounding sphere in world space (non-uniform scales use their largest axis)
+	const float scale = glm::max(glm::abs(uniformScale.x), glm::max(glm::abs(uniformScale.y), glm::abs(uniformScale.z)));
+	const glm::vec3 center = glm::vec3(modelMatrix() * glm::vec4((mesh.aabbMin + mesh.aabbMax) * 0.5f, 1.0f));
+	const float radius = glm::length(mesh.aabbMax - mesh.aabbMin) * 0.5f * scale;
+	const float distance = glm::length(center - glm::vec3(camera->pos)) - radius;
+	if (distance <= 0.0f)
+	{
+		return 0;
+	}
+
+	//Pixels per world unit at one unit of distance (same 45 degrees FOV as the projection)
+	const float projectionScale = swapChain->extent.height / (2.0f * glm::tan(glm::radians(45.0f) * 0.5f));
+
+	//Coarsest level whose projected error stays under the threshold
+	for (uint32_t lod = static_cast<uint32_t>(mesh.lods.size()) - 1; lod > 0; lod--)
+	{
+		const float projectedError = mesh.lods[lod].error * scale / distance * projectionScale;
+		if (projectedError <= lodPixelError)
+		{
+			return lod;
+		}
+	}
+	return 0;
+}
+
 void Ravine::cleanup()
 {
+	//Wait for the scene loader (it may still be importing if the window was closed early)
+	if (sceneHandle)
+	{
+		if (sceneHandle->loader.joinable())
+		{
+			sceneHandle->loader.join();
+		}
+		delete sceneHandle;
+		sceneHandle = nullptr;
+	}
+
+	//Uploads in flight are waited on, queued ones are dropped
+	uploadScheduler->clear();
+	delete uploadScheduler;
+
 	//Cleanup RvGui data
 	delete gui;
 
-	//Hold number of swapchain images
-	const uint32_t swapImagesCount = swapChain->images.size();
-
-	//Cleanup render-pass
-	renderPass->clear();
-	delete renderPass;
+	//Cleanup render graph (and its render passes)
+	renderGraph->clear();
+	delete renderGraph;
 
 	//Cleanup swap-chain related data
 	swapChain->clear();
@@ -1560,33 +2095,27 @@ void Ravine::cleanup()
 
 	//Cleaning up texture related objects
 	vkDestroySampler(device->handle, textureSampler, nullptr);
-	for (uint32_t i = 0; i < texturesSize; i++)
+	for (uint32_t i = 0; i < texturesResident.size(); i++)
 	{
-		textures[i].free();
+		if (texturesResident[i])
+		{
+			textures[i].free();
+		}
 	}
 	delete[] textures;
 	texturesSize = 0;
 
 	//Destroy descriptor pool
-	vkDestroyDescriptorPool(device->handle, descriptorPool, nullptr);
-
-	for (uint32_t i = 0; i < swapImagesCount; i++)
+	if (sceneResourcesCreated)
 	{
-		//Destroying global buffers
-		vkDestroyBuffer(device->handle, globalBuffers[i].handle, nullptr);
-		vkFreeMemory(device->handle, globalBuffers[i].memory, nullptr);
-
-		//Destroying materials buffers
-		vkDestroyBuffer(device->handle, materialsBuffers[i].handle, nullptr);
-		vkFreeMemory(device->handle, materialsBuffers[i].memory, nullptr);
-
-		//Destroying models buffers
-		vkDestroyBuffer(device->handle, modelsBuffers[i].handle, nullptr);
-		vkFreeMemory(device->handle, modelsBuffers[i].memory, nullptr);
+		vkDestroyDescriptorPool(device->handle, descriptorPool, nullptr);
+	}
 
-		//Destroying animations buffers
-		vkDestroyBuffer(device->handle, animationsBuffers[i].handle, nullptr);
-		vkFreeMemory(device->handle, animationsBuffers[i].memory, nullptr);
+	//Destroying uniform buffers
+	if (uniformRing)
+	{
+		uniformRing->clear();
+		delete uniformRing;
 	}
 
 	//Destroy descriptor set layout (uniform bind)
@@ -1595,15 +2124,27 @@ void Ravine::cleanup()
 	vkDestroyDescriptorSetLayout(device->handle, modelDescriptorSetLayout, nullptr);
 
 	//TODO: FIX HERE!
-	for (uint32_t meshIndex = 0; meshIndex < meshesCount; meshIndex++)
+	for (uint32_t meshIndex = 0; sceneResourcesCreated && meshIndex < meshesCount; meshIndex++)
 	{
-		//Destroy Vertex and Index Buffer Objects
-		vkDestroyBuffer(device->handle, vertexBuffers[meshIndex].handle, nullptr);
-		vkDestroyBuffer(device->handle, indexBuffers[meshIndex].handle, nullptr);
+		//Shared geometry is destroyed by its owner
+		if (meshes[meshIndex].geometryId != meshIndex)
+		{
+			continue;
+		}
 
-		//Free device memory for Vertex and Index Buffers
-		vkFreeMemory(device->handle, vertexBuffers[meshIndex].memory, nullptr);
-		vkFreeMemory(device->handle, indexBuffers[meshIndex].memory, nullptr);
+		//Destroy Meshlet Buffer Objects
+		if (meshletBuffers[meshIndex].handle != VK_NULL_HANDLE)
+		{
+			vkDestroyBuffer(device->handle, meshletBuffers[meshIndex].handle, nullptr);
+			device->allocator->free(meshletBuffers[meshIndex].allocation);
+		}
+	}
+
+	//Destroy Vertex and Index Buffers of every mesh
+	if (geometryPool)
+	{
+		geometryPool->clear();
+		delete geometryPool;
 	}
 
 	//Destroy pipelines
@@ -1613,6 +2154,11 @@ void Ravine::cleanup()
 	delete staticWireframeGraphicsPipeline;
 	delete staticLineGraphicsPipeline;
 
+	//Join scene processing workers
+	RvFileSystem::unmountAll();
+	delete dataArchive;
+	delete threadPool;
+
 	//Destroy vulkan logical device and validation layer
 	device->clear();
 	delete device;
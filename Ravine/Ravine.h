@@ -22,6 +22,18 @@ using eastl::array;
 #include "RvDataTypes.h"
 #include "RvAnimationTools.h"
 #include "RvDevice.h"
+#include "RvGeometryPool.h"
+#include "RvUploadScheduler.h"
+#include "RvUniformRing.h"
+#include "RvFrameArena.h"
+#include "RvHeap.h"
+#include "RvThreadPool.h"
+#include "RvFileSystem.h"
+#include "RvArchive.h"
+#include "RvGltfLoader.h"
+#include "RvImportProfile.h"
+#include "RvSceneHandle.h"
+#include "RvAssetCache.h"
 #include "RvSwapChain.h"
 #include "RvPolygonPipeline.h"
 #include "RvWireframePipeline.h"
@@ -31,6 +43,7 @@ using eastl::array;
 #include "RvCamera.h"
 #include "RvGui.h"
 #include "RvRenderPass.h"
+#include "RvRenderGraph.h"
 
 //Math defines
 #define F_MAX(a,b)            (((a) > (b)) ? (a) : (b))
@@ -62,15 +75,28 @@ private:
 	//Todo: Move to VULKAN APP
 	RvDevice* device;
 	RvSwapChain* swapChain;
+	RvRenderGraph* renderGraph;
+	//Render pass of the scene pass, owned by the render graph
 	RvRenderPass* renderPass;
+	uint32_t presentTarget;
+	RvThreadPool* threadPool = nullptr;
+
+	//Runtime uploads, spread over frames instead of stalling the queue
+	RvUploadScheduler* uploadScheduler = nullptr;
+
+	//Packed data files, mounted over the loose ones when present
+	RvArchive* dataArchive = nullptr;
+
+	//Vertex layout the scene is uploaded with (selects *_packed shaders when compressed)
+	RvVertexFormat vertexFormat = RV_VERTEX_FORMAT_QUANTIZED;
 
 	//TODO: Fix Creation flow with shaders integration
-	vector<char> skinnedTexColCode;
-	vector<char> skinnedWireframeCode;
-	vector<char> staticTexColCode;
-	vector<char> staticWireframeCode;
-	vector<char> phongTexColCode;
-	vector<char> solidColorCode;
+	RvFileView skinnedTexColCode;
+	RvFileView skinnedWireframeCode;
+	RvFileView staticTexColCode;
+	RvFileView staticWireframeCode;
+	RvFileView phongTexColCode;
+	RvFileView solidColorCode;
 	RvPolygonPipeline* skinnedGraphicsPipeline;
 	RvWireframePipeline* skinnedWireframeGraphicsPipeline;
 	RvPolygonPipeline* staticGraphicsPipeline;
@@ -96,12 +122,20 @@ private:
 	glm::vec3 uniformPosition = glm::vec3(0);
 	glm::vec3 uniformScale = glm::vec3(0.01f, 0.01f, 0.01f);
 	glm::vec3 uniformRotation = glm::vec3(0, 0, 0);
+	float lodPixelError = 1.0f;
 	//PROTOTYPE PRESENTATION STUFF
 
+	//Scene loaded in background, the render thread only touches the scene data after it was imported
+	RvSceneHandle* sceneHandle = nullptr;
+	//GPU resources of the scene were created (placeholders included)
+	bool sceneResourcesCreated = false;
+	//Meshes become resident in order, the ones past this count are drawn as bounding box proxies
+	uint32_t residentMeshesCount = 0;
+
 	const aiScene* scene;
 	//Todo: Move to MESH
 	RvSkinnedMeshColored* meshes;
-	uint32_t meshesCount;
+	uint32_t meshesCount = 0;
 	vector<string> texturesToLoad;
 
 	// Animation interpolation helper
@@ -123,35 +157,42 @@ private:
 	VkDescriptorSetLayout materialDescriptorSetLayout;
 	VkDescriptorSetLayout modelDescriptorSetLayout;
 	VkDescriptorPool descriptorPool;
-	vector<VkDescriptorSet> descriptorSets; //Automatically freed with descriptor pool
+	//Automatically freed with descriptor pool
+	VkDescriptorSet globalDescriptorSet;
+	VkDescriptorSet modelDescriptorSet;
+	vector<VkDescriptorSet> materialDescriptorSets; //Per frame in flight per texture
 
 	//Commands Buffers and it's Pool
 	//TODO: Move to COMMAND BUFFER
 	vector<VkCommandBuffer> primaryCmdBuffers;
 	vector<VkCommandBuffer> secondaryCmdBuffers;
 
-	//TODO: Optimally we should use a single buffer with offsets for vertices and indices
-	//Reference: https://developer.nvidia.com/vulkan-memory-management
-
-	//TODO: Move vertex and index buffer in MESH class
-	//Verter buffer
-	vector<RvPersistentBuffer> vertexBuffers;
-	//Index buffer
-	vector<RvPersistentBuffer> indexBuffers;
-
-	//Uniform buffers (per swap chain image)
-	//TODO: Move to UNIFORM
-	vector<RvDynamicBuffer> globalBuffers;
-	vector<RvDynamicBuffer> materialsBuffers;
-	vector<RvDynamicBuffer> modelsBuffers;
-	vector<RvDynamicBuffer> animationsBuffers;
+	//Vertex and index buffers shared by every mesh
+	RvGeometryPool* geometryPool = nullptr;
+	//Ranges of each mesh inside the geometry pool
+	vector<RvGeometryAllocation> geometryAllocations;
+	//Bounding box line lists drawn in place of meshes not yet uploaded
+	vector<RvGeometryAllocation> proxyAllocations;
+	//Meshlets buffer (storage)
+	vector<RvPersistentBuffer> meshletBuffers;
+
+	//Uniforms of every swap chain image (global, then material, model and bones of each mesh)
+	RvUniformRing* uniformRing = nullptr;
+	//Ring offsets of the frame being recorded (material, model and bones of each mesh)
+	uint32_t globalUniformOffset = 0;
+	vector<array<uint32_t, 3>> meshUniformOffsets;
 
 	//Texture related objects
 	uint32_t mipLevels;
-	RvTexture *textures;
+	RvTexture *textures = nullptr;
 #define RV_MAX_IMAGES_COUNT 32
-	uint32_t texturesSize;
+	uint32_t texturesSize = 0;
 	VkSampler textureSampler;
+	//Textures already uploaded, the missing texture is bound for the others
+	vector<uint8_t> texturesResident;
+	//Bumped when a texture becomes resident, per frame in flight sets are rewritten when behind
+	uint32_t texturesVersion = 0;
+	vector<uint32_t> descriptorTexturesVersions;
 
 #pragma endregion
 
@@ -186,33 +227,72 @@ private:
 	//Creating descriptors sets (uniforms bindings)
 	void createDescriptorSets();
 
-	//Load scene file and populates meshes vector
-	bool loadScene(const string& filePath);
+	//Load scene file and populates meshes vector, only what the import profile asks for is processed
+	bool loadScene(const string& filePath, const RvImportProfile& profile);
+
+	//Imports a scene through Assimp (anything but glTF) and converts it to the meshes vector
+	bool importScene(const string& filePath, const RvImportProfile& profile, RvImportTimer& timer);
+
+	//Starts loading a scene in background and returns right away, see streamScene
+	RvSceneHandle* loadSceneAsync(const string& filePath, RvImportProfileType profileType = RV_IMPORT_PROFILE_SKINNED_CHARACTER);
+
+	//Creates scene resources once imported, then uploads a few meshes and textures per frame
+	void streamScene();
+
+	//Uniforms, descriptors, placeholder texture and proxy geometry for the imported scene
+	void createSceneResources();
 	void loadBones(const aiMesh* pMesh, RvSkinnedMeshColored& meshData);
 	//TODO: Move to Blend-tree
 	void boneTransform(double timeInSeconds, vector<aiMatrix4x4>& transforms);
 	void readNodeHierarchy(double animationTime, double curDuration, double otherDuration, const aiNode* pNode, const aiMatrix4x4& parentTransform);
 
-	//Create vertex buffer
-	void createVertexBuffer();
+	//Create the geometry pool and upload the bounding box proxies of every mesh
+	void createGeometryPool();
+
+	//Queue the upload of a mesh vertices and indices into the geometry pool (releases its CPU copy)
+	void uploadMeshGeometry(uint32_t meshIndex);
 
-	//Create index buffer
-	void createIndexBuffer();
+	//Convert vertices to the uploaded vertex format
+	void packVertexData(const RvSkinnedVertexColored* vertices, uint32_t vertexCount, const RvSkinnedMeshColored& mesh, vector<char>& vertexData) const;
+
+	//Create meshlet buffers
+	void createMeshletBuffers();
 
 	//Create uniform buffers
 	void createUniformBuffers();
 
-	//Load image and upload into Vulkan Image Object
-	void loadTextureImages();
+	//Read and deduplicate texture files listed by the scene (loader thread)
+	void prepareTextures(vector<RvAssetFingerprint>& fingerprints, vector<RvFileView>& sources);
+
+	//Decode textures in parallel and queue them for upload (loader thread)
+	void decodeTextures(RvSceneHandle& handle, const vector<RvAssetFingerprint>& fingerprints, const vector<RvFileView>& sources);
+
+	//Allocate texture objects, only the missing texture is uploaded
+	void createTextureImages();
+
+	//Texture slot of a mesh (0 is the missing texture)
+	uint32_t meshTextureId(uint32_t meshId) const;
+
+	//View currently bound for a texture slot (missing texture while its own is streaming)
+	VkImageView textureView(uint32_t textureId) const;
+
+	//Rewrite image descriptors of a swap chain image sets
+	void updateTextureDescriptors(uint32_t frameSlot);
 
 	//Create texture sampler - interface for extracting colors from a texture
 	void createTextureSampler();
 
+	//Declares the frame passes and builds their render passes
+	void createRenderGraph();
+
 	//Creates command buffers array
 	void allocateCommandBuffers();
 
+	//Binds the material and model sets of a mesh with its uniform offsets
+	void bindMeshDescriptorSets(VkCommandBuffer commandBuffer, VkPipelineLayout layout, uint32_t frameSlot, size_t meshIndex);
+
 	//Records new draw commands
-	void recordCommandBuffers(uint32_t currentFrame);
+	void recordCommandBuffers(uint32_t frameSlot, uint32_t frameIndex);
 
 	//Main application loop
 	void mainLoop();
@@ -227,7 +307,13 @@ private:
 	void setupFpsCam();
 
 	//Updates uniform buffer for given image
-	void updateUniformBuffer(uint32_t currentFrame);
+	void updateUniformBuffer(uint32_t frameSlot);
+
+	//Transform applied to every mesh of the scene
+	glm::mat4 modelMatrix() const;
+
+	//Picks the coarsest detail level whose projected error stays under lodPixelError
+	uint32_t selectLod(const RvSkinnedMeshColored& mesh) const;
 
 	//Finalize
 	void cleanup();
@@ -1,17 +1,20 @@
 #include "RvAnimationTools.h"
 
+//STD Includes
+#include <cstring>
+
 
 namespace rvTools
 {
 	namespace animation
 	{
 		// Find animation for a given node
-		const aiNodeAnim* findNodeAnim(const aiAnimation* animation, const string& nodeName)
+		const aiNodeAnim* findNodeAnim(const aiAnimation* animation, const char* nodeName)
 		{
 			for (uint32_t i = 0; i < animation->mNumChannels; i++)
 			{
 				const aiNodeAnim* nodeAnim = animation->mChannels[i];
-				if (string(nodeAnim->mNodeName.data) == nodeName)
+				if (strcmp(nodeAnim->mNodeName.data, nodeName) == 0)
 				{
 					return nodeAnim;
 				}
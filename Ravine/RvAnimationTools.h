@@ -13,7 +13,7 @@ namespace rvTools
 {
 	namespace animation
 	{
-		const aiNodeAnim* findNodeAnim(const aiAnimation* animation, const string& nodeName);
+		const aiNodeAnim* findNodeAnim(const aiAnimation* animation, const char* nodeName);
 
 		aiMatrix4x4 interpolateTranslation(double interpol, double time, double otherTime, const aiNodeAnim* pNodeAnim, const aiNodeAnim* otherNodeAnim);
 		aiMatrix4x4 interpolateRotation(double interpol, double time, double otherTime, const aiNodeAnim* pNodeAnim, const aiNodeAnim* otherNodeAnim);
@@ -0,0 +1,256 @@
+#include "RvArchive.h"
+
+//EASTL Includes
+#include <eastl/algorithm.h>
+#include <eastl/sort.h>
+
+//STD Includes
+#include <atomic>
+#include <fstream>
+
+//FMT Includes
+#include <fmt/printf.h>
+
+//Ravine Includes
+#include "RvCompressionTools.h"
+
+bool RvArchive::open(const string& archivePath)
+{
+	view = RvFileSystem::map(archivePath);
+	header = nullptr;
+	entries = nullptr;
+	chunks = nullptr;
+	if (!view.isValid() || view.size() < sizeof(RvArchiveHeader))
+	{
+		return false;
+	}
+
+	const RvArchiveHeader* archiveHeader = reinterpret_cast<const RvArchiveHeader*>(view.data());
+	if (archiveHeader->magic != RV_ARCHIVE_MAGIC || archiveHeader->version != RV_ARCHIVE_VERSION || archiveHeader->chunkSize == 0
+		|| archiveHeader->tocOffset % RV_ARCHIVE_ALIGNMENT != 0 || archiveHeader->tocOffset > view.size())
+	{
+		return false;
+	}
+
+	const uint64_t tocSize = static_cast<uint64_t>(archiveHeader->entriesCount) * sizeof(RvArchiveEntry) + static_cast<uint64_t>(archiveHeader->chunksCount) * sizeof(RvArchiveChunk);
+	if (tocSize > view.size() - archiveHeader->tocOffset)
+	{
+		return false;
+	}
+
+	const RvArchiveEntry* archiveEntries = reinterpret_cast<const RvArchiveEntry*>(view.data() + archiveHeader->tocOffset);
+	const RvArchiveChunk* archiveChunks = reinterpret_cast<const RvArchiveChunk*>(archiveEntries + archiveHeader->entriesCount);
+
+	//Validate everything once, so reads don't need to
+	for (uint32_t c = 0; c < archiveHeader->chunksCount; c++)
+	{
+		const RvArchiveChunk& chunk = archiveChunks[c];
+		if (chunk.size > archiveHeader->chunkSize || chunk.compressedSize > archiveHeader->tocOffset || chunk.offset > archiveHeader->tocOffset - chunk.compressedSize)
+		{
+			return false;
+		}
+	}
+	for (uint32_t e = 0; e < archiveHeader->entriesCount; e++)
+	{
+		const RvArchiveEntry& entry = archiveEntries[e];
+		if (entry.firstChunk > archiveHeader->chunksCount || entry.chunksCount > archiveHeader->chunksCount - entry.firstChunk)
+		{
+			return false;
+		}
+
+		//Every chunk but the last one is full
+		uint64_t entrySize = 0;
+		for (uint32_t c = 0; c < entry.chunksCount; c++)
+		{
+			const RvArchiveChunk& chunk = archiveChunks[entry.firstChunk + c];
+			if (c + 1 < entry.chunksCount && chunk.size != archiveHeader->chunkSize)
+			{
+				return false;
+			}
+			entrySize += chunk.size;
+		}
+		if (entrySize != entry.size)
+		{
+			return false;
+		}
+	}
+
+	header = archiveHeader;
+	entries = archiveEntries;
+	chunks = archiveChunks;
+	return true;
+}
+
+bool RvArchive::isOpen() const
+{
+	return header != nullptr;
+}
+
+const RvArchiveEntry* RvArchive::find(const string& filePath) const
+{
+	if (!header)
+	{
+		return nullptr;
+	}
+
+	const uint64_t pathHash = hashPath(filePath);
+	const RvArchiveEntry* entriesEnd = entries + header->entriesCount;
+	const RvArchiveEntry* entry = eastl::lower_bound(entries, entriesEnd, pathHash,
+		[](const RvArchiveEntry& item, uint64_t hash) { return item.pathHash < hash; });
+	return entry != entriesEnd && entry->pathHash == pathHash ? entry : nullptr;
+}
+
+bool RvArchive::read(const RvArchiveEntry& entry, void* dst, RvThreadPool* threadPool) const
+{
+	std::atomic<bool> failed(false);
+	const auto readChunk = [&](uint32_t c)
+	{
+		const RvArchiveChunk& chunk = chunks[entry.firstChunk + c];
+		char* chunkDst = static_cast<char*>(dst) + static_cast<size_t>(c) * header->chunkSize;
+		const char* chunkSrc = view.data() + chunk.offset;
+		if (chunk.compressedSize == chunk.size)
+		{
+			memcpy(chunkDst, chunkSrc, chunk.size);
+		}
+		else if (!rvTools::compression::decompress(chunkSrc, chunk.compressedSize, chunkDst, chunk.size))
+		{
+			failed = true;
+		}
+	};
+
+	if (threadPool && entry.chunksCount > 1)
+	{
+		threadPool->parallelFor(entry.chunksCount, readChunk);
+	}
+	else
+	{
+		for (uint32_t c = 0; c < entry.chunksCount; c++)
+		{
+			readChunk(c);
+		}
+	}
+
+	return !failed;
+}
+
+uint32_t RvArchive::entriesCount() const
+{
+	return header ? header->entriesCount : 0;
+}
+
+uint64_t RvArchive::hashPath(const string& filePath)
+{
+	//64-bit FNV-1a
+	uint64_t hash = 14695981039346656037ull;
+	for (char c : filePath)
+	{
+		hash ^= static_cast<uint8_t>(c == '\\' ? '/' : c);
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+bool RvArchive::pack(const string& archivePath, const string& rootDirectory, const vector<string>& files, RvThreadPool& threadPool)
+{
+	std::ofstream file(archivePath.c_str(), std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+	{
+		fmt::print(stderr, "Failed to create archive {0}!\n", archivePath.c_str());
+		return false;
+	}
+
+	vector<RvArchiveEntry> packedEntries;
+	vector<RvArchiveChunk> packedChunks;
+	packedEntries.reserve(files.size());
+
+	//Header is written last, once the table of contents offset is known
+	RvArchiveHeader packedHeader = {};
+	file.write(reinterpret_cast<const char*>(&packedHeader), sizeof(RvArchiveHeader));
+	uint64_t offset = sizeof(RvArchiveHeader);
+
+	const char padding[RV_ARCHIVE_ALIGNMENT] = {};
+	const auto align = [&]()
+	{
+		const uint64_t paddingSize = (RV_ARCHIVE_ALIGNMENT - offset % RV_ARCHIVE_ALIGNMENT) % RV_ARCHIVE_ALIGNMENT;
+		file.write(padding, paddingSize);
+		offset += paddingSize;
+	};
+
+	const string root = rootDirectory.empty() || rootDirectory.back() == '/' || rootDirectory.back() == '\\' ? rootDirectory : rootDirectory + "/";
+	for (const string& filePath : files)
+	{
+		const RvFileView source = RvFileSystem::map(root + filePath);
+		if (!source.isValid())
+		{
+			fmt::print(stderr, "Failed to open file {0}!\n", filePath.c_str());
+			return false;
+		}
+
+		RvArchiveEntry entry;
+		entry.pathHash = hashPath(filePath);
+		entry.size = source.size();
+		entry.firstChunk = static_cast<uint32_t>(packedChunks.size());
+		entry.chunksCount = static_cast<uint32_t>((source.size() + RV_ARCHIVE_CHUNK_SIZE - 1) / RV_ARCHIVE_CHUNK_SIZE);
+
+		//Chunks that don't shrink are stored as they are
+		vector<vector<char>> compressedChunks(entry.chunksCount);
+		threadPool.parallelFor(entry.chunksCount, [&](uint32_t c)
+		{
+			const char* chunkSrc = source.data() + static_cast<size_t>(c) * RV_ARCHIVE_CHUNK_SIZE;
+			const size_t chunkSize = eastl::min<size_t>(RV_ARCHIVE_CHUNK_SIZE, source.size() - static_cast<size_t>(c) * RV_ARCHIVE_CHUNK_SIZE);
+			vector<char>& compressed = compressedChunks[c];
+			compressed.resize(rvTools::compression::compressBound(chunkSize));
+			const size_t compressedSize = rvTools::compression::compress(chunkSrc, chunkSize, compressed.data(), compressed.size());
+			if (compressedSize == 0 || compressedSize >= chunkSize)
+			{
+				compressed.assign(chunkSrc, chunkSrc + chunkSize);
+			}
+			else
+			{
+				compressed.resize(compressedSize);
+			}
+		});
+
+		for (uint32_t c = 0; c < entry.chunksCount; c++)
+		{
+			align();
+
+			RvArchiveChunk chunk;
+			chunk.offset = offset;
+			chunk.compressedSize = static_cast<uint32_t>(compressedChunks[c].size());
+			chunk.size = static_cast<uint32_t>(eastl::min<size_t>(RV_ARCHIVE_CHUNK_SIZE, source.size() - static_cast<size_t>(c) * RV_ARCHIVE_CHUNK_SIZE));
+			packedChunks.push_back(chunk);
+
+			file.write(compressedChunks[c].data(), compressedChunks[c].size());
+			offset += compressedChunks[c].size();
+		}
+		packedEntries.push_back(entry);
+	}
+
+	//Entries are sorted for binary search, two paths with the same hash can't be told apart
+	eastl::sort(packedEntries.begin(), packedEntries.end(),
+		[](const RvArchiveEntry& a, const RvArchiveEntry& b) { return a.pathHash < b.pathHash; });
+	for (size_t e = 1; e < packedEntries.size(); e++)
+	{
+		if (packedEntries[e].pathHash == packedEntries[e - 1].pathHash)
+		{
+			fmt::print(stderr, "Archive path hash collision, can't pack {0}!\n", archivePath.c_str());
+			return false;
+		}
+	}
+
+	align();
+	packedHeader.magic = RV_ARCHIVE_MAGIC;
+	packedHeader.version = RV_ARCHIVE_VERSION;
+	packedHeader.entriesCount = static_cast<uint32_t>(packedEntries.size());
+	packedHeader.chunksCount = static_cast<uint32_t>(packedChunks.size());
+	packedHeader.chunkSize = RV_ARCHIVE_CHUNK_SIZE;
+	packedHeader.alignment = RV_ARCHIVE_ALIGNMENT;
+	packedHeader.tocOffset = offset;
+	file.write(reinterpret_cast<const char*>(packedEntries.data()), packedEntries.size() * sizeof(RvArchiveEntry));
+	file.write(reinterpret_cast<const char*>(packedChunks.data()), packedChunks.size() * sizeof(RvArchiveChunk));
+
+	file.seekp(0);
+	file.write(reinterpret_cast<const char*>(&packedHeader), sizeof(RvArchiveHeader));
+	return file.good();
+}
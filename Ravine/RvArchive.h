@@ -0,0 +1,106 @@
+#ifndef RV_ARCHIVE_H
+#define RV_ARCHIVE_H
+
+//EASTL Includes
+#include <eastl/vector.h>
+#include <eastl/string.h>
+
+using eastl::vector;
+using eastl::string;
+
+//Ravine Includes
+#include "RvFileSystem.h"
+#include "RvThreadPool.h"
+
+//Archive identifiers
+#define RV_ARCHIVE_MAGIC 0x4B505652u	//"RVPK"
+#define RV_ARCHIVE_VERSION 1
+
+//Files are split in chunks that are compressed (and decompressed) independently
+#define RV_ARCHIVE_CHUNK_SIZE (256 * 1024)
+
+//Chunks and the table of contents start at page boundaries, so they can be read directly
+#define RV_ARCHIVE_ALIGNMENT 4096
+
+/**
+ * \brief .rvpak file header, the table of contents (entries followed by chunks) is stored at tocOffset.
+ */
+struct RvArchiveHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t entriesCount;
+	uint32_t chunksCount;
+	uint32_t chunkSize;
+	uint32_t alignment;
+	uint64_t tocOffset;
+};
+
+/**
+ * \brief Archived file, entries are sorted by path hash.
+ */
+struct RvArchiveEntry
+{
+	uint64_t pathHash;
+	uint64_t size;
+	uint32_t firstChunk;
+	uint32_t chunksCount;
+};
+
+/**
+ * \brief Piece of an archived file, stored uncompressed when compression doesn't pay off (compressedSize == size).
+ */
+struct RvArchiveChunk
+{
+	uint64_t offset;
+	uint32_t compressedSize;
+	uint32_t size;
+};
+
+/**
+ * \brief Read-only packed asset archive (.rvpak) with LZ4 compressed chunks.
+ */
+class RvArchive
+{
+public:
+
+	/**
+	 * \brief Maps an archive and validates its table of contents.
+	 */
+	bool open(const string& archivePath);
+
+	bool isOpen() const;
+
+	/**
+	 * \brief Looks up a file by its path relative to the archive root.
+	 * \return Null if the file isn't archived.
+	 */
+	const RvArchiveEntry* find(const string& filePath) const;
+
+	/**
+	 * \brief Decompresses a whole file into dst (e.g. mapped staging memory), which must hold entry.size bytes.
+	 * \param threadPool Workers used to decompress chunks in parallel (may be null).
+	 */
+	bool read(const RvArchiveEntry& entry, void* dst, RvThreadPool* threadPool = nullptr) const;
+
+	uint32_t entriesCount() const;
+
+	/**
+	 * \brief Hash used to identify archived paths (backslashes are treated as forward slashes).
+	 */
+	static uint64_t hashPath(const string& filePath);
+
+	/**
+	 * \brief Packs files into a new archive, compressing each file's chunks in parallel.
+	 * \param rootDirectory Directory the files are relative to (archived paths are the given ones).
+	 */
+	static bool pack(const string& archivePath, const string& rootDirectory, const vector<string>& files, RvThreadPool& threadPool);
+
+private:
+	RvFileView view;
+	const RvArchiveHeader* header = nullptr;
+	const RvArchiveEntry* entries = nullptr;
+	const RvArchiveChunk* chunks = nullptr;
+};
+
+#endif
@@ -0,0 +1,527 @@
+#include "RvAssetCache.h"
+
+//STD Includes
+#include <fstream>
+
+//Platform Includes
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+//FMT Includes
+#include <fmt/format.h>
+#include <fmt/printf.h>
+
+//Hash Includes
+#include "crc32.hpp"
+
+//Ravine Includes
+#include "RvFileSystem.h"
+
+//Cooked files identifiers
+#define RV_COOKED_SCENE_MAGIC 0x43535652u	//"RVSC"
+#define RV_COOKED_TEXTURE_MAGIC 0x58545652u	//"RVTX"
+
+string RvAssetCache::cacheDirectory = "../data/cache/";
+
+#pragma region Serialization Helpers
+
+namespace
+{
+	//Hashes 8 bytes at a time (multiply and rotate rounds, murmur finalizer), CRC32 collides too easily to key the cache
+	uint64_t contentHash64(const void* data, size_t size)
+	{
+		const uint64_t prime = 0x9E3779B97F4A7C15ull;
+		const char* bytes = static_cast<const char*>(data);
+		uint64_t hash = size * prime;
+
+		size_t offset = 0;
+		for (; offset + sizeof(uint64_t) <= size; offset += sizeof(uint64_t))
+		{
+			uint64_t word;
+			memcpy(&word, bytes + offset, sizeof(word));
+			word *= 0xC2B2AE3D27D4EB4Full;
+			word = (word << 31) | (word >> 33);
+			hash ^= word * prime;
+			hash = ((hash << 27) | (hash >> 37)) * prime + 0x85EBCA77C2B2AE63ull;
+		}
+
+		if (offset < size)
+		{
+			uint64_t tail = 0;
+			memcpy(&tail, bytes + offset, size - offset);
+			hash ^= tail * 0xC2B2AE3D27D4EB4Full;
+		}
+
+		hash ^= hash >> 33;
+		hash *= 0xFF51AFD7ED558CCDull;
+		hash ^= hash >> 33;
+		hash *= 0xC4CEB9FE1A85EC53ull;
+		hash ^= hash >> 33;
+		return hash;
+	}
+
+	//Appends plain data into a memory block that is written to disk at once
+	struct RvCacheWriter
+	{
+		vector<char> data;
+
+		void writeBytes(const void* src, size_t size)
+		{
+			const char* bytes = static_cast<const char*>(src);
+			data.insert(data.end(), bytes, bytes + size);
+		}
+
+		template<typename T>
+		void write(const T& value)
+		{
+			writeBytes(&value, sizeof(T));
+		}
+
+		void writeString(const string& str)
+		{
+			write(static_cast<uint32_t>(str.size()));
+			writeBytes(str.data(), str.size());
+		}
+	};
+
+	//Reads plain data back, failing (instead of overrunning) on truncated files
+	struct RvCacheReader
+	{
+		const RvFileView& data;
+		size_t position = 0;
+
+		explicit RvCacheReader(const RvFileView& data) : data(data) { }
+
+		bool readBytes(void* dst, size_t size)
+		{
+			if (size > data.size() - position) {
+				return false;
+			}
+			memcpy(dst, data.data() + position, size);
+			position += size;
+			return true;
+		}
+
+		template<typename T>
+		bool read(T& value)
+		{
+			return readBytes(&value, sizeof(T));
+		}
+
+		bool readString(string& str)
+		{
+			uint32_t size;
+			if (!read(size) || size > data.size() - position) {
+				return false;
+			}
+			str.assign(data.data() + position, data.data() + position + size);
+			position += size;
+			return true;
+		}
+	};
+
+	bool writeWholeFile(const string& filePath, const vector<char>& buffer)
+	{
+		//Make sure the cache directory exists (no-op when it already does)
+#ifdef _WIN32
+		_mkdir(RvAssetCache::cacheDirectory.c_str());
+#else
+		mkdir(RvAssetCache::cacheDirectory.c_str(), 0755);
+#endif
+
+		std::ofstream file(filePath.c_str(), std::ios::binary | std::ios::trunc);
+		if (!file.is_open()) {
+			return false;
+		}
+		file.write(buffer.data(), buffer.size());
+		return file.good();
+	}
+
+	bool readHeader(RvCacheReader& reader, uint32_t expectedMagic, const RvAssetFingerprint& expectedFingerprint)
+	{
+		uint32_t magic, version;
+		RvAssetFingerprint fingerprint;
+		if (!reader.read(magic) || !reader.read(version) || !reader.read(fingerprint.contentHash) ||
+			!reader.read(fingerprint.settingsHash) || !reader.read(fingerprint.contentSize)) {
+			return false;
+		}
+		return magic == expectedMagic && version == RV_ASSET_CACHE_VERSION && fingerprint == expectedFingerprint;
+	}
+
+	void writeHeader(RvCacheWriter& writer, uint32_t magic, const RvAssetFingerprint& fingerprint)
+	{
+		writer.write(magic);
+		writer.write(static_cast<uint32_t>(RV_ASSET_CACHE_VERSION));
+		writer.write(fingerprint.contentHash);
+		writer.write(fingerprint.settingsHash);
+		writer.write(fingerprint.contentSize);
+	}
+
+	void writeNode(RvCacheWriter& writer, const aiNode* node)
+	{
+		writer.writeString(node->mName.C_Str());
+		writer.write(node->mTransformation);
+		writer.write(node->mNumChildren);
+		for (uint32_t i = 0; i < node->mNumChildren; i++)
+		{
+			writeNode(writer, node->mChildren[i]);
+		}
+	}
+
+	aiNode* readNode(RvCacheReader& reader, aiNode* parent)
+	{
+		string name;
+		aiMatrix4x4 transformation;
+		uint32_t childrenCount;
+		if (!reader.readString(name) || !reader.read(transformation) || !reader.read(childrenCount)) {
+			return nullptr;
+		}
+
+		aiNode* node = new aiNode();
+		node->mName.Set(name.c_str());
+		node->mTransformation = transformation;
+		node->mParent = parent;
+		if (childrenCount > 0)
+		{
+			node->mChildren = new aiNode*[childrenCount]{};
+			for (uint32_t i = 0; i < childrenCount; i++)
+			{
+				node->mChildren[i] = readNode(reader, node);
+				if (!node->mChildren[i]) {
+					delete node;
+					return nullptr;
+				}
+				node->mNumChildren++;
+			}
+		}
+		return node;
+	}
+
+	template<typename KeyType>
+	void writeKeys(RvCacheWriter& writer, const KeyType* keys, uint32_t keysCount)
+	{
+		writer.write(keysCount);
+		writer.writeBytes(keys, sizeof(KeyType) * keysCount);
+	}
+
+	template<typename KeyType>
+	bool readKeys(RvCacheReader& reader, KeyType*& keys, uint32_t& keysCount)
+	{
+		if (!reader.read(keysCount) || keysCount > (reader.data.size() - reader.position) / sizeof(KeyType)) {
+			keysCount = 0;
+			return false;
+		}
+		keys = new KeyType[keysCount];
+		return reader.readBytes(keys, sizeof(KeyType) * keysCount);
+	}
+
+	void writeAnimation(RvCacheWriter& writer, const aiAnimation* animation)
+	{
+		writer.writeString(animation->mName.C_Str());
+		writer.write(animation->mDuration);
+		writer.write(animation->mTicksPerSecond);
+		writer.write(animation->mNumChannels);
+		for (uint32_t i = 0; i < animation->mNumChannels; i++)
+		{
+			const aiNodeAnim* channel = animation->mChannels[i];
+			writer.writeString(channel->mNodeName.C_Str());
+			writeKeys(writer, channel->mPositionKeys, channel->mNumPositionKeys);
+			writeKeys(writer, channel->mRotationKeys, channel->mNumRotationKeys);
+			writeKeys(writer, channel->mScalingKeys, channel->mNumScalingKeys);
+			writer.write(channel->mPreState);
+			writer.write(channel->mPostState);
+		}
+	}
+
+	aiAnimation* readAnimation(RvCacheReader& reader)
+	{
+		string name;
+		aiAnimation* animation = new aiAnimation();
+		uint32_t channelsCount;
+		if (!reader.readString(name) || !reader.read(animation->mDuration) ||
+			!reader.read(animation->mTicksPerSecond) || !reader.read(channelsCount) ||
+			channelsCount > reader.data.size() - reader.position) {
+			delete animation;
+			return nullptr;
+		}
+		animation->mName.Set(name.c_str());
+
+		animation->mChannels = new aiNodeAnim*[channelsCount]{};
+		for (uint32_t i = 0; i < channelsCount; i++)
+		{
+			aiNodeAnim* channel = new aiNodeAnim();
+			animation->mChannels[i] = channel;
+			animation->mNumChannels++;
+
+			string nodeName;
+			if (!reader.readString(nodeName) ||
+				!readKeys(reader, channel->mPositionKeys, channel->mNumPositionKeys) ||
+				!readKeys(reader, channel->mRotationKeys, channel->mNumRotationKeys) ||
+				!readKeys(reader, channel->mScalingKeys, channel->mNumScalingKeys) ||
+				!reader.read(channel->mPreState) || !reader.read(channel->mPostState)) {
+				delete animation;
+				return nullptr;
+			}
+			channel->mNodeName.Set(nodeName.c_str());
+		}
+		return animation;
+	}
+}
+
+#pragma endregion
+
+string RvAssetFingerprint::toString() const
+{
+	return string(fmt::format("{0:016x}{1:08x}{2:x}", contentHash, settingsHash, contentSize).c_str());
+}
+
+RvAssetFingerprint RvAssetCache::fingerprint(const void* data, size_t dataSize, const void* settings, size_t settingsSize)
+{
+	RvAssetFingerprint fingerprint;
+	fingerprint.contentHash = contentHash64(data, dataSize);
+	fingerprint.contentSize = dataSize;
+
+	//Settings are chained after the cache version, so format changes invalidate old entries as well
+	const uint32_t version = RV_ASSET_CACHE_VERSION;
+	fingerprint.settingsHash = crc(reinterpret_cast<char*>(const_cast<uint32_t*>(&version)), sizeof(version));
+	if (settings != nullptr && settingsSize > 0)
+	{
+		fingerprint.settingsHash = crc(static_cast<char*>(const_cast<void*>(settings)), settingsSize, fingerprint.settingsHash);
+	}
+
+	return fingerprint;
+}
+
+bool RvAssetCache::fingerprintFile(const string& filePath, const void* settings, size_t settingsSize, RvAssetFingerprint& fingerprint)
+{
+	const RvFileView source = RvFileSystem::map(filePath);
+	if (!source.isValid()) {
+		return false;
+	}
+
+	fingerprint = RvAssetCache::fingerprint(source.data(), source.size(), settings, settingsSize);
+	return true;
+}
+
+bool RvAssetCache::loadScene(const RvAssetFingerprint& fingerprint, RvSkinnedMeshColored*& meshes, uint32_t& meshesCount, vector<string>& texturePaths)
+{
+	const RvFileView buffer = RvFileSystem::map(cacheDirectory + fingerprint.toString() + ".rvscene");
+	if (!buffer.isValid()) {
+		return false;
+	}
+
+	RvCacheReader reader(buffer);
+	uint32_t vertexSize;
+	if (!readHeader(reader, RV_COOKED_SCENE_MAGIC, fingerprint) || !reader.read(vertexSize) || vertexSize != sizeof(RvSkinnedVertexColored)) {
+		return false;
+	}
+
+	//Textures registered for late-loading
+	uint32_t texturesCount;
+	if (!reader.read(texturesCount)) {
+		return false;
+	}
+	vector<string> paths(texturesCount);
+	for (string& path : paths)
+	{
+		if (!reader.readString(path)) {
+			return false;
+		}
+	}
+
+	//Meshes
+	uint32_t count;
+	if (!reader.read(count) || count == 0) {
+		return false;
+	}
+	RvSkinnedMeshColored* loaded = new RvSkinnedMeshColored[count]{};
+	bool valid = true;
+	for (uint32_t i = 0; i < count && valid; i++)
+	{
+		RvSkinnedMeshColored& mesh = loaded[i];
+		valid = reader.read(mesh.vertexCount) && mesh.vertexCount <= buffer.size() / sizeof(RvSkinnedVertexColored);
+		if (!valid) break;
+		mesh.vertices = new RvSkinnedVertexColored[mesh.vertexCount];
+		valid = reader.readBytes(mesh.vertices, sizeof(RvSkinnedVertexColored) * mesh.vertexCount) &&
+			reader.read(mesh.indexCount) && mesh.indexCount <= buffer.size() / sizeof(uint32_t);
+		if (!valid) break;
+		mesh.indices = new uint32_t[mesh.indexCount];
+		valid = reader.readBytes(mesh.indices, sizeof(uint32_t) * mesh.indexCount) &&
+			reader.read(mesh.texturesCount) && mesh.texturesCount <= texturesCount;
+		if (!valid) break;
+		mesh.textureIds = new uint32_t[mesh.texturesCount];
+		uint32_t meshletsCount = 0;
+		valid = reader.readBytes(mesh.textureIds, sizeof(uint32_t) * mesh.texturesCount) &&
+			reader.read(mesh.geometryId) && reader.read(meshletsCount) && meshletsCount <= buffer.size() / sizeof(RvMeshlet);
+		if (!valid) break;
+		mesh.meshlets.resize(meshletsCount);
+		uint32_t lodsCount = 0;
+		valid = reader.readBytes(mesh.meshlets.data(), sizeof(RvMeshlet) * meshletsCount) &&
+			reader.read(lodsCount) && lodsCount > 0 && lodsCount <= RV_MAX_LODS;
+		if (!valid) break;
+		mesh.lods.resize(lodsCount);
+		valid = reader.readBytes(mesh.lods.data(), sizeof(RvMeshLod) * lodsCount) && reader.read(mesh.animGlobalInverseTransform);
+
+		uint32_t mappingsCount = 0;
+		valid = valid && reader.read(mappingsCount);
+		for (uint32_t m = 0; m < mappingsCount && valid; m++)
+		{
+			string boneName;
+			uint16_t boneIndex;
+			valid = reader.readString(boneName) && reader.read(boneIndex);
+			mesh.boneMapping[boneName] = boneIndex;
+		}
+	}
+
+	//Scene-wide bones, hierarchy and animations are held by the first mesh
+	uint32_t boneInfoCount = 0;
+	uint8_t hasRootNode = 0;
+	valid = valid && reader.read(loaded[0].numBones) && reader.read(boneInfoCount) && boneInfoCount <= buffer.size() / sizeof(aiMatrix4x4);
+	if (valid)
+	{
+		loaded[0].boneInfo.resize(boneInfoCount);
+		for (RvBoneInfo& boneInfo : loaded[0].boneInfo)
+		{
+			valid = valid && reader.read(boneInfo.BoneOffset);
+		}
+	}
+	valid = valid && reader.read(hasRootNode);
+	if (valid && hasRootNode)
+	{
+		loaded[0].rootNode = readNode(reader, nullptr);
+		valid = loaded[0].rootNode != nullptr;
+	}
+	uint32_t animationsCount = 0;
+	valid = valid && reader.read(animationsCount);
+	for (uint32_t i = 0; i < animationsCount && valid; i++)
+	{
+		aiAnimation* animation = readAnimation(reader);
+		valid = animation != nullptr;
+		if (valid) {
+			loaded[0].animations.push_back(new RvAnimation({ animation }));
+		}
+	}
+
+	if (!valid)
+	{
+		fmt::print(stderr, "Discarding corrupted cooked scene {0}\n", fingerprint.toString().c_str());
+		for (RvAnimation* animation : loaded[0].animations)
+		{
+			delete animation->aiAnim;
+			delete animation;
+		}
+		delete loaded[0].rootNode;
+		for (uint32_t i = 0; i < count; i++)
+		{
+			delete[] loaded[i].vertices;
+			delete[] loaded[i].indices;
+			delete[] loaded[i].textureIds;
+		}
+		delete[] loaded;
+		return false;
+	}
+
+	meshes = loaded;
+	meshesCount = count;
+	texturePaths = paths;
+	return true;
+}
+
+bool RvAssetCache::storeScene(const RvAssetFingerprint& fingerprint, const RvSkinnedMeshColored* meshes, uint32_t meshesCount, const vector<string>& texturePaths)
+{
+	RvCacheWriter writer;
+	writeHeader(writer, RV_COOKED_SCENE_MAGIC, fingerprint);
+	writer.write(static_cast<uint32_t>(sizeof(RvSkinnedVertexColored)));
+
+	//Textures registered for late-loading
+	writer.write(static_cast<uint32_t>(texturePaths.size()));
+	for (const string& path : texturePaths)
+	{
+		writer.writeString(path);
+	}
+
+	//Meshes
+	writer.write(meshesCount);
+	for (uint32_t i = 0; i < meshesCount; i++)
+	{
+		const RvSkinnedMeshColored& mesh = meshes[i];
+		writer.write(mesh.vertexCount);
+		writer.writeBytes(mesh.vertices, sizeof(RvSkinnedVertexColored) * mesh.vertexCount);
+		writer.write(mesh.indexCount);
+		writer.writeBytes(mesh.indices, sizeof(uint32_t) * mesh.indexCount);
+		writer.write(mesh.texturesCount);
+		writer.writeBytes(mesh.textureIds, sizeof(uint32_t) * mesh.texturesCount);
+		writer.write(mesh.geometryId);
+		writer.write(static_cast<uint32_t>(mesh.meshlets.size()));
+		writer.writeBytes(mesh.meshlets.data(), sizeof(RvMeshlet) * mesh.meshlets.size());
+		writer.write(static_cast<uint32_t>(mesh.lods.size()));
+		writer.writeBytes(mesh.lods.data(), sizeof(RvMeshLod) * mesh.lods.size());
+		writer.write(mesh.animGlobalInverseTransform);
+		writer.write(static_cast<uint32_t>(mesh.boneMapping.size()));
+		for (const auto& mapping : mesh.boneMapping)
+		{
+			writer.writeString(mapping.first);
+			writer.write(mapping.second);
+		}
+	}
+
+	//Scene-wide bones, hierarchy and animations are held by the first mesh
+	writer.write(meshes[0].numBones);
+	writer.write(static_cast<uint32_t>(meshes[0].boneInfo.size()));
+	for (const RvBoneInfo& boneInfo : meshes[0].boneInfo)
+	{
+		writer.write(boneInfo.BoneOffset);
+	}
+	writer.write(static_cast<uint8_t>(meshes[0].rootNode != nullptr ? 1 : 0));
+	if (meshes[0].rootNode != nullptr)
+	{
+		writeNode(writer, meshes[0].rootNode);
+	}
+	writer.write(static_cast<uint32_t>(meshes[0].animations.size()));
+	for (const RvAnimation* animation : meshes[0].animations)
+	{
+		writeAnimation(writer, animation->aiAnim);
+	}
+
+	return writeWholeFile(cacheDirectory + fingerprint.toString() + ".rvscene", writer.data);
+}
+
+bool RvAssetCache::loadTexture(const RvAssetFingerprint& fingerprint, RvFileView& file, size_t& pixelsOffset, uint32_t& width, uint32_t& height)
+{
+	RvFileView buffer = RvFileSystem::map(cacheDirectory + fingerprint.toString() + ".rvtex");
+	if (!buffer.isValid()) {
+		return false;
+	}
+
+	RvCacheReader reader(buffer);
+	if (!readHeader(reader, RV_COOKED_TEXTURE_MAGIC, fingerprint) || !reader.read(width) || !reader.read(height)) {
+		return false;
+	}
+
+	//Pixels are always stored as RGBA8
+	const size_t dataSize = static_cast<size_t>(width) * height * 4;
+	if (dataSize != buffer.size() - reader.position) {
+		return false;
+	}
+	pixelsOffset = reader.position;
+	file = eastl::move(buffer);
+	return true;
+}
+
+bool RvAssetCache::storeTexture(const RvAssetFingerprint& fingerprint, const void* pixels, uint32_t width, uint32_t height)
+{
+	RvCacheWriter writer;
+	writeHeader(writer, RV_COOKED_TEXTURE_MAGIC, fingerprint);
+	writer.write(width);
+	writer.write(height);
+	writer.writeBytes(pixels, static_cast<size_t>(width) * height * 4);
+
+	return writeWholeFile(cacheDirectory + fingerprint.toString() + ".rvtex", writer.data);
+}
+
+RvAssetCache::RvAssetCache() = default;
+
+RvAssetCache::~RvAssetCache() = default;
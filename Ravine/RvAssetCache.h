@@ -0,0 +1,99 @@
+#ifndef RV_ASSET_CACHE_H
+#define RV_ASSET_CACHE_H
+
+//EASTL Includes
+#include <eastl/vector.h>
+#include <eastl/string.h>
+
+using eastl::vector;
+using eastl::string;
+
+//Ravine Includes
+#include "RvDataTypes.h"
+#include "RvFileSystem.h"
+
+//Bump whenever the layout of cooked files (or the data they are cooked from) changes
+#define RV_ASSET_CACHE_VERSION 5
+
+/**
+ * \brief Identifies a source asset by its content combined with the settings used to import it.
+ */
+struct RvAssetFingerprint
+{
+	//64 bits wide, cooked files are trusted on a fingerprint match alone
+	uint64_t contentHash = 0;
+	uint32_t settingsHash = 0;
+	uint64_t contentSize = 0;
+
+	/**
+	 * \brief Hexadecimal representation used to name cooked files.
+	 */
+	string toString() const;
+
+	bool operator==(const RvAssetFingerprint& other) const
+	{
+		return contentHash == other.contentHash && settingsHash == other.settingsHash && contentSize == other.contentSize;
+	}
+
+	bool operator!=(const RvAssetFingerprint& other) const
+	{
+		return !(*this == other);
+	}
+};
+
+/**
+ * \brief On-disk cache of imported (cooked) assets keyed by their fingerprints.
+ */
+class RvAssetCache
+{
+public:
+
+	/**
+	 * \brief Directory where cooked files are stored (created on demand).
+	 */
+	static string cacheDirectory;
+
+	/**
+	 * \brief Fingerprints an in-memory asset together with its import settings.
+	 * \param data Source asset bytes.
+	 * \param dataSize Amount of bytes in data.
+	 * \param settings Pointer to the import settings block (may be null).
+	 * \param settingsSize Size of the import settings block in bytes.
+	 */
+	static RvAssetFingerprint fingerprint(const void* data, size_t dataSize, const void* settings, size_t settingsSize);
+
+	/**
+	 * \brief Reads a file from disk and fingerprints it together with its import settings.
+	 * \return False if the file could not be read.
+	 */
+	static bool fingerprintFile(const string& filePath, const void* settings, size_t settingsSize, RvAssetFingerprint& fingerprint);
+
+	/**
+	 * \brief Loads a cooked scene, replacing what Assimp would have produced for the same source.
+	 * \return False when there is no valid cooked scene for the given fingerprint.
+	 */
+	static bool loadScene(const RvAssetFingerprint& fingerprint, RvSkinnedMeshColored*& meshes, uint32_t& meshesCount, vector<string>& texturePaths);
+
+	/**
+	 * \brief Writes a cooked scene (meshes, bones, node hierarchy and animations) for later runs.
+	 */
+	static bool storeScene(const RvAssetFingerprint& fingerprint, const RvSkinnedMeshColored* meshes, uint32_t meshesCount, const vector<string>& texturePaths);
+
+	/**
+	 * \brief Maps a cooked texture, its decoded RGBA8 pixels are left in place so they can be uploaded straight from the file.
+	 * \param pixelsOffset Receives where the pixels start in the file.
+	 * \return False when there is no valid cooked texture for the given fingerprint.
+	 */
+	static bool loadTexture(const RvAssetFingerprint& fingerprint, RvFileView& file, size_t& pixelsOffset, uint32_t& width, uint32_t& height);
+
+	/**
+	 * \brief Writes decoded RGBA8 pixels of a texture for later runs.
+	 */
+	static bool storeTexture(const RvAssetFingerprint& fingerprint, const void* pixels, uint32_t width, uint32_t height);
+
+private:
+	RvAssetCache();
+	~RvAssetCache();
+};
+
+#endif
@@ -0,0 +1,116 @@
+#include "RvAssimpIOSystem.h"
+
+//STD Includes
+#include <cstring>
+
+#pragma region RvAssimpIOStream
+
+RvAssimpIOStream::RvAssimpIOStream(RvFileView&& view) : view(eastl::move(view))
+{
+}
+
+RvAssimpIOStream::~RvAssimpIOStream()
+= default;
+
+size_t RvAssimpIOStream::Read(void* pvBuffer, size_t pSize, size_t pCount)
+{
+	if (pSize == 0 || pCount == 0)
+	{
+		return 0;
+	}
+
+	//Same semantics as fread: only whole elements are read
+	const size_t available = (view.size() - position) / pSize;
+	const size_t count = pCount < available ? pCount : available;
+	memcpy(pvBuffer, view.data() + position, count * pSize);
+	position += count * pSize;
+	return count;
+}
+
+size_t RvAssimpIOStream::Write(const void*, size_t, size_t)
+{
+	//Mapped files are read-only
+	return 0;
+}
+
+aiReturn RvAssimpIOStream::Seek(size_t pOffset, aiOrigin pOrigin)
+{
+	size_t target;
+	switch (pOrigin)
+	{
+	case aiOrigin_SET:
+		target = pOffset;
+		break;
+	case aiOrigin_CUR:
+		target = position + pOffset;
+		break;
+	case aiOrigin_END:
+		//Offset is negative for aiOrigin_END
+		target = view.size() - pOffset;
+		break;
+	default:
+		return aiReturn_FAILURE;
+	}
+
+	if (target > view.size())
+	{
+		return aiReturn_FAILURE;
+	}
+	position = target;
+	return aiReturn_SUCCESS;
+}
+
+size_t RvAssimpIOStream::Tell() const
+{
+	return position;
+}
+
+size_t RvAssimpIOStream::FileSize() const
+{
+	return view.size();
+}
+
+void RvAssimpIOStream::Flush()
+{
+}
+
+#pragma endregion
+
+#pragma region RvAssimpIOSystem
+
+bool RvAssimpIOSystem::Exists(const char* pFile) const
+{
+	return RvFileSystem::map(pFile).isValid();
+}
+
+char RvAssimpIOSystem::getOsSeparator() const
+{
+#ifdef _WIN32
+	return '\\';
+#else
+	return '/';
+#endif
+}
+
+Assimp::IOStream* RvAssimpIOSystem::Open(const char* pFile, const char* pMode)
+{
+	//Only reading is supported
+	if (strchr(pMode, 'w') || strchr(pMode, 'a'))
+	{
+		return nullptr;
+	}
+
+	RvFileView view = RvFileSystem::map(pFile);
+	if (!view.isValid())
+	{
+		return nullptr;
+	}
+	return new RvAssimpIOStream(eastl::move(view));
+}
+
+void RvAssimpIOSystem::Close(Assimp::IOStream* pFile)
+{
+	delete pFile;
+}
+
+#pragma endregion
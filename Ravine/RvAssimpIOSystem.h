@@ -0,0 +1,44 @@
+#ifndef RV_ASSIMP_IO_SYSTEM_H
+#define RV_ASSIMP_IO_SYSTEM_H
+
+//Assimp Includes
+#include <assimp/IOStream.hpp>
+#include <assimp/IOSystem.hpp>
+
+//Ravine Includes
+#include "RvFileSystem.h"
+
+/**
+ * \brief Read-only Assimp stream over a mapped file.
+ */
+class RvAssimpIOStream : public Assimp::IOStream
+{
+public:
+	explicit RvAssimpIOStream(RvFileView&& view);
+	~RvAssimpIOStream();
+
+	size_t Read(void* pvBuffer, size_t pSize, size_t pCount) override;
+	size_t Write(const void* pvBuffer, size_t pSize, size_t pCount) override;
+	aiReturn Seek(size_t pOffset, aiOrigin pOrigin) override;
+	size_t Tell() const override;
+	size_t FileSize() const override;
+	void Flush() override;
+
+private:
+	RvFileView view;
+	size_t position = 0;
+};
+
+/**
+ * \brief Routes Assimp file reads (including files referenced by the scene) through RvFileSystem.
+ */
+class RvAssimpIOSystem : public Assimp::IOSystem
+{
+public:
+	bool Exists(const char* pFile) const override;
+	char getOsSeparator() const override;
+	Assimp::IOStream* Open(const char* pFile, const char* pMode = "rb") override;
+	void Close(Assimp::IOStream* pFile) override;
+};
+
+#endif
@@ -0,0 +1,197 @@
+#include "RvCompressionTools.h"
+
+//STD Includes
+#include <cstring>
+
+//LZ4 block format limits
+#define RV_LZ4_MIN_MATCH 4
+#define RV_LZ4_LAST_LITERALS 5
+#define RV_LZ4_MATCH_FIND_LIMIT 12
+#define RV_LZ4_MAX_OFFSET 65535
+#define RV_LZ4_HASH_BITS 12
+
+namespace rvTools
+{
+	namespace compression
+	{
+		namespace
+		{
+			uint32_t read32(const uint8_t* src)
+			{
+				uint32_t value;
+				memcpy(&value, src, sizeof(uint32_t));
+				return value;
+			}
+
+			uint32_t hashSequence(uint32_t sequence)
+			{
+				return (sequence * 2654435761u) >> (32 - RV_LZ4_HASH_BITS);
+			}
+
+			//Lengths above the token nibble continue in 255-valued bytes
+			bool writeLength(uint8_t*& op, const uint8_t* opEnd, size_t length)
+			{
+				for (; length >= 255; length -= 255)
+				{
+					if (op >= opEnd) return false;
+					*op++ = 255;
+				}
+				if (op >= opEnd) return false;
+				*op++ = static_cast<uint8_t>(length);
+				return true;
+			}
+
+			bool readLength(const uint8_t*& ip, const uint8_t* ipEnd, size_t& length)
+			{
+				uint8_t byte;
+				do
+				{
+					if (ip >= ipEnd) return false;
+					byte = *ip++;
+					length += byte;
+				} while (byte == 255);
+				return true;
+			}
+
+			bool writeSequence(uint8_t*& op, const uint8_t* opEnd, const uint8_t* literals, size_t literalsCount, uint16_t offset, size_t matchLength)
+			{
+				if (op >= opEnd) return false;
+				uint8_t* token = op++;
+
+				const size_t literalsNibble = literalsCount < 15 ? literalsCount : 15;
+				*token = static_cast<uint8_t>(literalsNibble << 4);
+				if (literalsNibble == 15 && !writeLength(op, opEnd, literalsCount - 15)) return false;
+
+				if (literalsCount > static_cast<size_t>(opEnd - op)) return false;
+				memcpy(op, literals, literalsCount);
+				op += literalsCount;
+
+				//Last sequence only carries literals
+				if (matchLength == 0)
+				{
+					return true;
+				}
+
+				if (opEnd - op < 2) return false;
+				*op++ = static_cast<uint8_t>(offset);
+				*op++ = static_cast<uint8_t>(offset >> 8);
+
+				const size_t matchCode = matchLength - RV_LZ4_MIN_MATCH;
+				const size_t matchNibble = matchCode < 15 ? matchCode : 15;
+				*token |= static_cast<uint8_t>(matchNibble);
+				return matchNibble < 15 || writeLength(op, opEnd, matchCode - 15);
+			}
+		}
+
+		size_t compressBound(size_t srcSize)
+		{
+			return srcSize + srcSize / 255 + 16;
+		}
+
+		size_t compress(const char* src, size_t srcSize, char* dst, size_t dstCapacity)
+		{
+			const uint8_t* base = reinterpret_cast<const uint8_t*>(src);
+			const uint8_t* ip = base;
+			const uint8_t* anchor = base;
+			const uint8_t* ipEnd = base + srcSize;
+			uint8_t* op = reinterpret_cast<uint8_t*>(dst);
+			const uint8_t* opEnd = op + dstCapacity;
+
+			//Positions are stored plus one, zero marks an empty slot
+			uint32_t table[1 << RV_LZ4_HASH_BITS] = {};
+
+			if (srcSize > RV_LZ4_MATCH_FIND_LIMIT)
+			{
+				const uint8_t* matchLimit = ipEnd - RV_LZ4_MATCH_FIND_LIMIT;
+				const uint8_t* extendLimit = ipEnd - RV_LZ4_LAST_LITERALS;
+				while (ip < matchLimit)
+				{
+					const uint32_t sequence = read32(ip);
+					const uint32_t hash = hashSequence(sequence);
+					const uint32_t candidate = table[hash];
+					table[hash] = static_cast<uint32_t>(ip - base) + 1;
+
+					const uint8_t* ref = base + candidate - 1;
+					if (candidate == 0 || ip - ref > RV_LZ4_MAX_OFFSET || read32(ref) != sequence)
+					{
+						ip++;
+						continue;
+					}
+
+					size_t matchLength = RV_LZ4_MIN_MATCH;
+					while (ip + matchLength < extendLimit && ip[matchLength] == ref[matchLength])
+					{
+						matchLength++;
+					}
+
+					if (!writeSequence(op, opEnd, anchor, ip - anchor, static_cast<uint16_t>(ip - ref), matchLength))
+					{
+						return 0;
+					}
+					ip += matchLength;
+					anchor = ip;
+				}
+			}
+
+			if (!writeSequence(op, opEnd, anchor, ipEnd - anchor, 0, 0))
+			{
+				return 0;
+			}
+			return op - reinterpret_cast<uint8_t*>(dst);
+		}
+
+		bool decompress(const char* src, size_t srcSize, char* dst, size_t dstSize)
+		{
+			const uint8_t* ip = reinterpret_cast<const uint8_t*>(src);
+			const uint8_t* ipEnd = ip + srcSize;
+			uint8_t* base = reinterpret_cast<uint8_t*>(dst);
+			uint8_t* op = base;
+			const uint8_t* opEnd = base + dstSize;
+
+			while (ip < ipEnd)
+			{
+				const uint8_t token = *ip++;
+
+				size_t literalsCount = token >> 4;
+				if (literalsCount == 15 && !readLength(ip, ipEnd, literalsCount)) return false;
+				if (literalsCount > static_cast<size_t>(ipEnd - ip) || literalsCount > static_cast<size_t>(opEnd - op)) return false;
+				memcpy(op, ip, literalsCount);
+				ip += literalsCount;
+				op += literalsCount;
+
+				//The block ends right after the last literals
+				if (ip == ipEnd)
+				{
+					break;
+				}
+
+				if (ipEnd - ip < 2) return false;
+				const size_t offset = ip[0] | (ip[1] << 8);
+				ip += 2;
+				if (offset == 0 || offset > static_cast<size_t>(op - base)) return false;
+
+				size_t matchLength = token & 15;
+				if (matchLength == 15 && !readLength(ip, ipEnd, matchLength)) return false;
+				matchLength += RV_LZ4_MIN_MATCH;
+				if (matchLength > static_cast<size_t>(opEnd - op)) return false;
+
+				//Overlapping matches repeat the last bytes, so they must be copied forward one by one
+				const uint8_t* ref = op - offset;
+				if (offset >= matchLength)
+				{
+					memcpy(op, ref, matchLength);
+					op += matchLength;
+				}
+				else
+				{
+					for (size_t i = 0; i < matchLength; i++)
+					{
+						*op++ = *ref++;
+					}
+				}
+			}
+
+			return op == opEnd;
+		}
+	}
+}
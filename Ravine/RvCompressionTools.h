@@ -0,0 +1,23 @@
+#ifndef COMPRESSION_TOOLS_H
+#define COMPRESSION_TOOLS_H
+
+//STD Includes
+#include <cstdint>
+#include <cstddef>
+
+namespace rvTools
+{
+	namespace compression
+	{
+		//Worst case size of compressing srcSize bytes (incompressible data grows slightly)
+		size_t compressBound(size_t srcSize);
+
+		//Greedy LZ4 block compression, returns the compressed size or zero if it doesn't fit in dstCapacity
+		size_t compress(const char* src, size_t srcSize, char* dst, size_t dstCapacity);
+
+		//Decodes an LZ4 block, fails (instead of overrunning) on corrupt data or if it doesn't decode to exactly dstSize bytes
+		bool decompress(const char* src, size_t srcSize, char* dst, size_t dstSize);
+	}
+}
+
+#endif
@@ -0,0 +1,131 @@
+#include "RvConversionTools.h"
+
+//STD Includes
+#include <cassert>
+#include <cstring>
+#include <cstddef>
+
+//SIMD Includes
+#include <xmmintrin.h>
+
+namespace rvTools
+{
+	namespace conversion
+	{
+		namespace
+		{
+			//SIMD stores below write 16 bytes per 12 bytes field, each spill lands on the field written right after it
+			static_assert(offsetof(RvSkinnedVertexColored, pos) == 0, "Unexpected vertex layout");
+			static_assert(offsetof(RvSkinnedVertexColored, color) == 3 * sizeof(float), "Unexpected vertex layout");
+			static_assert(offsetof(RvSkinnedVertexColored, texCoord) == 6 * sizeof(float), "Unexpected vertex layout");
+			static_assert(offsetof(RvSkinnedVertexColored, normal) == 8 * sizeof(float), "Unexpected vertex layout");
+			static_assert(offsetof(RvSkinnedVertexColored, boneIDs) == 11 * sizeof(float), "Unexpected vertex layout");
+			static_assert(offsetof(RvSkinnedVertexColored, boneWeights) == 15 * sizeof(float), "Unexpected vertex layout");
+			static_assert(sizeof(RvSkinnedVertexColored) == 19 * sizeof(float), "Unexpected vertex layout");
+
+			void convertVertex(const aiMesh* mesh, uint32_t j, RvSkinnedVertexColored& vertex, bool hasColors, bool hasCoords, bool hasNormals)
+			{
+				const aiVector3D& position = mesh->mVertices[j];
+				vertex.pos = { position.x, position.y, position.z };
+
+				if (hasColors)
+				{
+					const aiColor4D& color = mesh->mColors[0][j];
+					vertex.color = { color.r, color.g, color.b };
+				}
+				else
+				{
+					vertex.color = { 1, 1, 1 };
+				}
+
+				if (hasCoords)
+				{
+					const aiVector3D& texCoord = mesh->mTextureCoords[0][j];
+					vertex.texCoord = { texCoord.x, texCoord.y };
+				}
+				else
+				{
+					vertex.texCoord = { 0, 0 };
+				}
+
+				if (hasNormals)
+				{
+					const aiVector3D& normal = mesh->mNormals[j];
+					vertex.normal = { normal.x, normal.y, normal.z };
+				}
+				else
+				{
+					vertex.normal = { 0, 0, 0 };
+				}
+
+				vertex.boneIDs = glm::uvec4(0);
+				vertex.boneWeights = glm::vec4(0.0f);
+			}
+
+			//Stream presence is resolved at compile time so the inner loop is branchless
+			template<bool hasColors, bool hasCoords, bool hasNormals>
+			void convertStreams(const aiMesh* mesh, RvSkinnedVertexColored* vertices)
+			{
+				const uint32_t vertexCount = mesh->mNumVertices;
+				if (vertexCount == 0)
+				{
+					return;
+				}
+
+				const aiVector3D* positions = mesh->mVertices;
+				const aiColor4D* colors = mesh->mColors[0];
+				const aiVector3D* coords = mesh->mTextureCoords[0];
+				const aiVector3D* normals = mesh->mNormals;
+				const __m128 zero = _mm_setzero_ps();
+				const __m128 white = _mm_set1_ps(1.0f);
+
+				//The last vertex is converted separately, since 16 bytes loads of 12 bytes elements read past the end of the streams
+				const uint32_t simdCount = vertexCount - 1;
+				for (uint32_t j = 0; j < simdCount; j++)
+				{
+					float* destination = reinterpret_cast<float*>(&vertices[j]);
+					_mm_storeu_ps(destination + 0, _mm_loadu_ps(&positions[j].x));
+					_mm_storeu_ps(destination + 3, hasColors ? _mm_loadu_ps(&colors[j].r) : white);
+					_mm_storel_pi(reinterpret_cast<__m64*>(destination + 6), hasCoords ? _mm_loadu_ps(&coords[j].x) : zero);
+					_mm_storeu_ps(destination + 8, hasNormals ? _mm_loadu_ps(&normals[j].x) : zero);
+
+					//Bone IDs and weights (zero bits for both), filled later from the bones
+					_mm_storeu_ps(destination + 11, zero);
+					_mm_storeu_ps(destination + 15, zero);
+				}
+
+				convertVertex(mesh, simdCount, vertices[simdCount], hasColors, hasCoords, hasNormals);
+			}
+		}
+
+		void convertVertices(const aiMesh* mesh, RvSkinnedVertexColored* vertices, uint32_t attributes)
+		{
+			const bool hasColors = mesh->HasVertexColors(0) && (attributes & RV_VERTEX_ATTRIBUTE_COLOR);
+			const bool hasCoords = mesh->HasTextureCoords(0) && (attributes & RV_VERTEX_ATTRIBUTE_UV);
+			const bool hasNormals = mesh->HasNormals() && (attributes & RV_VERTEX_ATTRIBUTE_NORMAL);
+			const uint32_t streams = (hasColors ? 4 : 0) | (hasCoords ? 2 : 0) | (hasNormals ? 1 : 0);
+			switch (streams)
+			{
+			case 0: convertStreams<false, false, false>(mesh, vertices); break;
+			case 1: convertStreams<false, false, true>(mesh, vertices); break;
+			case 2: convertStreams<false, true, false>(mesh, vertices); break;
+			case 3: convertStreams<false, true, true>(mesh, vertices); break;
+			case 4: convertStreams<true, false, false>(mesh, vertices); break;
+			case 5: convertStreams<true, false, true>(mesh, vertices); break;
+			case 6: convertStreams<true, true, false>(mesh, vertices); break;
+			default: convertStreams<true, true, true>(mesh, vertices); break;
+			}
+		}
+
+		void convertIndices(const aiMesh* mesh, uint32_t* indices)
+		{
+			const aiFace* faces = mesh->mFaces;
+			for (uint32_t j = 0; j < mesh->mNumFaces; j++)
+			{
+				//Make sure it's triangulated
+				assert(faces[j].mNumIndices == 3);
+				memcpy(indices + j * 3, faces[j].mIndices, sizeof(uint32_t) * 3);
+			}
+		}
+	}
+}
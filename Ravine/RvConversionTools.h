@@ -0,0 +1,23 @@
+#ifndef CONVERSION_TOOLS_H
+#define CONVERSION_TOOLS_H
+
+//Assimp Includes
+#include <assimp/mesh.h>
+
+//Ravine Includes
+#include "RvDataTypes.h"
+#include "RvImportProfile.h"
+
+namespace rvTools
+{
+	namespace conversion
+	{
+		//Streams positions, colors, UVs and normals into the interleaved layout (missing or unrequested streams get defaults), bone data is cleared
+		void convertVertices(const aiMesh* mesh, RvSkinnedVertexColored* vertices, uint32_t attributes = RV_VERTEX_ATTRIBUTE_ALL);
+
+		//Copies triangle indices (the mesh must be triangulated)
+		void convertIndices(const aiMesh* mesh, uint32_t* indices);
+	}
+}
+
+#endif
@@ -5,6 +5,7 @@
 #include <glm/mat4x4.hpp>
 #include <glm/vec3.hpp>
 using glm::vec3;
+#include <glm/vec4.hpp>
 #include <glm/gtc/quaternion.hpp>
 using glm::quat;
 
@@ -41,6 +42,49 @@ struct RvBoneInfo
 
 #pragma endregion
 
+#pragma region RvMeshlet
+
+//Meshlet limits (fit mesh shading hardware and 8-bit local indices)
+#define RV_MESHLET_MAX_VERTICES 64
+#define RV_MESHLET_MAX_TRIANGLES 124
+
+/**
+ * \brief Cluster of contiguous triangles in a mesh index buffer, laid out for std430 storage buffers.
+ */
+struct RvMeshlet
+{
+	//Center (xyz) and radius (w) in object space
+	glm::vec4 boundingSphere;
+	//Average normal (xyz) and cutoff (w), backfacing from the eye when dot(center - eye, axis) >= cutoff * length(center - eye) + radius
+	glm::vec4 normalCone;
+	//Range in the mesh index buffer
+	uint32_t firstIndex;
+	uint32_t indexCount;
+	//Unique vertices referenced
+	uint32_t vertexCount;
+	uint32_t padding;
+};
+
+#pragma endregion
+
+#pragma region RvMeshLod
+
+//Detail levels generated per mesh (including the original)
+#define RV_MAX_LODS 4
+
+/**
+ * \brief Detail level stored as a range of the mesh index buffer.
+ */
+struct RvMeshLod
+{
+	uint32_t firstIndex;
+	uint32_t indexCount;
+	//Object-space distance error against the original surface
+	float error;
+};
+
+#pragma endregion
+
 #pragma region RvBaseMesh
 
 template<typename RvVertexType>
@@ -55,6 +99,19 @@ struct RvBaseMesh
 	//TODO: Move to RvMaterialState
 	uint32_t*	textureIds;
 	uint32_t	texturesCount;
+
+	//Index of the first mesh with identical geometry (itself when unique)
+	uint32_t	geometryId;
+
+	//Object-space bounds (also used to dequantize positions)
+	glm::vec3	aabbMin;
+	glm::vec3	aabbMax;
+
+	//Detail levels, from the original (LOD 0) to the coarsest
+	vector<RvMeshLod> lods;
+
+	//Clusters for culling, covering LOD 0 in order
+	vector<RvMeshlet> meshlets;
 };
 
 #pragma endregion
@@ -339,4 +396,183 @@ struct RvSkinnedMeshColored : RvBaseMesh<RvSkinnedVertexColored>
 
 #pragma endregion
 
+#pragma region RvSkinnedMeshPacked
+
+/**
+ * \brief Vertex layouts a scene can be uploaded with.
+ */
+enum RvVertexFormat
+{
+	RV_VERTEX_FORMAT_FULL = 0,		//RvSkinnedVertexColored (76 bytes)
+	RV_VERTEX_FORMAT_PACKED = 1,	//RvSkinnedVertexPacked (32 bytes)
+	RV_VERTEX_FORMAT_QUANTIZED = 2	//RvSkinnedVertexQuantized (28 bytes)
+};
+
+/**
+ * \brief RvSkinnedVertexColored with compressed attributes, decoded by the *_packed shaders.
+ */
+struct RvSkinnedVertexPacked {
+	glm::vec3 pos;			//R32G32B32_SFLOAT
+	uint32_t normal;		//R16G16_SNORM (octahedron encoded)
+	uint32_t texCoord;		//R16G16_SFLOAT
+	uint32_t color;			//R8G8B8A8_UNORM
+	uint32_t boneIDs;		//R8G8B8A8_UINT
+	uint32_t boneWeights;	//R8G8B8A8_UNORM (sums up to 255)
+
+	static VkVertexInputBindingDescription getBindingDescription() {
+		VkVertexInputBindingDescription bindingDescription = {};
+		bindingDescription.binding = 0;
+		bindingDescription.stride = sizeof(RvSkinnedVertexPacked);
+		bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+		return bindingDescription;
+	}
+
+	static array<VkVertexInputAttributeDescription, 6> getAttributeDescriptions() {
+		array<VkVertexInputAttributeDescription, 6> attributeDescriptions = {};
+
+		//Position
+		attributeDescriptions[0].binding = 0;
+		attributeDescriptions[0].location = 0;
+		attributeDescriptions[0].format = VK_FORMAT_R32G32B32_SFLOAT;
+		attributeDescriptions[0].offset = offsetof(RvSkinnedVertexPacked, pos);
+
+		//Color
+		attributeDescriptions[1].binding = 0;
+		attributeDescriptions[1].location = 1;
+		attributeDescriptions[1].format = VK_FORMAT_R8G8B8A8_UNORM;
+		attributeDescriptions[1].offset = offsetof(RvSkinnedVertexPacked, color);
+
+		//Texture
+		attributeDescriptions[2].binding = 0;
+		attributeDescriptions[2].location = 2;
+		attributeDescriptions[2].format = VK_FORMAT_R16G16_SFLOAT;
+		attributeDescriptions[2].offset = offsetof(RvSkinnedVertexPacked, texCoord);
+
+		//Normal
+		attributeDescriptions[3].binding = 0;
+		attributeDescriptions[3].location = 3;
+		attributeDescriptions[3].format = VK_FORMAT_R16G16_SNORM;
+		attributeDescriptions[3].offset = offsetof(RvSkinnedVertexPacked, normal);
+
+		//BoneID
+		attributeDescriptions[4].binding = 0;
+		attributeDescriptions[4].location = 4;
+		attributeDescriptions[4].format = VK_FORMAT_R8G8B8A8_UINT;
+		attributeDescriptions[4].offset = offsetof(RvSkinnedVertexPacked, boneIDs);
+
+		//BoneWeight
+		attributeDescriptions[5].binding = 0;
+		attributeDescriptions[5].location = 5;
+		attributeDescriptions[5].format = VK_FORMAT_R8G8B8A8_UNORM;
+		attributeDescriptions[5].offset = offsetof(RvSkinnedVertexPacked, boneWeights);
+
+		return attributeDescriptions;
+	}
+};
+
+/**
+ * \brief RvSkinnedVertexPacked with positions quantized into the mesh bounds.
+ */
+struct RvSkinnedVertexQuantized {
+	uint16_t pos[4];		//R16G16B16A16_UNORM (dequantized with RvModelBufferObject scale/offset)
+	uint32_t normal;		//R16G16_SNORM (octahedron encoded)
+	uint32_t texCoord;		//R16G16_SFLOAT
+	uint32_t color;			//R8G8B8A8_UNORM
+	uint32_t boneIDs;		//R8G8B8A8_UINT
+	uint32_t boneWeights;	//R8G8B8A8_UNORM (sums up to 255)
+
+	static VkVertexInputBindingDescription getBindingDescription() {
+		VkVertexInputBindingDescription bindingDescription = {};
+		bindingDescription.binding = 0;
+		bindingDescription.stride = sizeof(RvSkinnedVertexQuantized);
+		bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+		return bindingDescription;
+	}
+
+	static array<VkVertexInputAttributeDescription, 6> getAttributeDescriptions() {
+		array<VkVertexInputAttributeDescription, 6> attributeDescriptions = {};
+
+		//Position
+		attributeDescriptions[0].binding = 0;
+		attributeDescriptions[0].location = 0;
+		attributeDescriptions[0].format = VK_FORMAT_R16G16B16A16_UNORM;
+		attributeDescriptions[0].offset = offsetof(RvSkinnedVertexQuantized, pos);
+
+		//Color
+		attributeDescriptions[1].binding = 0;
+		attributeDescriptions[1].location = 1;
+		attributeDescriptions[1].format = VK_FORMAT_R8G8B8A8_UNORM;
+		attributeDescriptions[1].offset = offsetof(RvSkinnedVertexQuantized, color);
+
+		//Texture
+		attributeDescriptions[2].binding = 0;
+		attributeDescriptions[2].location = 2;
+		attributeDescriptions[2].format = VK_FORMAT_R16G16_SFLOAT;
+		attributeDescriptions[2].offset = offsetof(RvSkinnedVertexQuantized, texCoord);
+
+		//Normal
+		attributeDescriptions[3].binding = 0;
+		attributeDescriptions[3].location = 3;
+		attributeDescriptions[3].format = VK_FORMAT_R16G16_SNORM;
+		attributeDescriptions[3].offset = offsetof(RvSkinnedVertexQuantized, normal);
+
+		//BoneID
+		attributeDescriptions[4].binding = 0;
+		attributeDescriptions[4].location = 4;
+		attributeDescriptions[4].format = VK_FORMAT_R8G8B8A8_UINT;
+		attributeDescriptions[4].offset = offsetof(RvSkinnedVertexQuantized, boneIDs);
+
+		//BoneWeight
+		attributeDescriptions[5].binding = 0;
+		attributeDescriptions[5].location = 5;
+		attributeDescriptions[5].format = VK_FORMAT_R8G8B8A8_UNORM;
+		attributeDescriptions[5].offset = offsetof(RvSkinnedVertexQuantized, boneWeights);
+
+		return attributeDescriptions;
+	}
+};
+
+static_assert(sizeof(RvSkinnedVertexPacked) == 32, "Packed skinned vertex must fit 32 bytes");
+static_assert(sizeof(RvSkinnedVertexQuantized) == 28, "Quantized skinned vertex must fit 28 bytes");
+
+#pragma endregion
+
+#pragma region RvVertexInputDescription
+
+/**
+ * \brief Vertex input state a pipeline is created with.
+ */
+struct RvVertexInputDescription
+{
+	VkVertexInputBindingDescription binding;
+	vector<VkVertexInputAttributeDescription> attributes;
+
+	template<typename RvVertexType>
+	static RvVertexInputDescription create()
+	{
+		RvVertexInputDescription description;
+		description.binding = RvVertexType::getBindingDescription();
+		auto attributeDescriptions = RvVertexType::getAttributeDescriptions();
+		description.attributes.assign(attributeDescriptions.begin(), attributeDescriptions.end());
+		return description;
+	}
+
+	static RvVertexInputDescription create(RvVertexFormat format)
+	{
+		switch (format)
+		{
+		case RV_VERTEX_FORMAT_PACKED:
+			return create<RvSkinnedVertexPacked>();
+		case RV_VERTEX_FORMAT_QUANTIZED:
+			return create<RvSkinnedVertexQuantized>();
+		default:
+			return create<RvSkinnedVertexColored>();
+		}
+	}
+};
+
+#pragma endregion
+
 #endif
@@ -0,0 +1,133 @@
+#include "RvDeletionQueue.h"
+
+//Ravine Includes
+#include "RvDevice.h"
+
+RvDeletionQueue::RvDeletionQueue(RvDevice& device) : device(&device), buckets(1)
+{
+}
+
+RvDeletionQueue::~RvDeletionQueue()
+= default;
+
+void RvDeletionQueue::destroyBuffer(VkBuffer buffer, const RvAllocation& allocation)
+{
+	RvDeletion deletion = {};
+	deletion.type = RV_DELETION_BUFFER;
+	deletion.buffer = buffer;
+	deletion.allocation = allocation;
+	push(deletion);
+}
+
+void RvDeletionQueue::destroyImage(VkImage image, const RvAllocation& allocation)
+{
+	RvDeletion deletion = {};
+	deletion.type = RV_DELETION_IMAGE;
+	deletion.image = image;
+	deletion.allocation = allocation;
+	push(deletion);
+}
+
+void RvDeletionQueue::destroyImageView(VkImageView imageView)
+{
+	RvDeletion deletion = {};
+	deletion.type = RV_DELETION_IMAGE_VIEW;
+	deletion.imageView = imageView;
+	push(deletion);
+}
+
+void RvDeletionQueue::destroyFramebuffer(VkFramebuffer framebuffer)
+{
+	RvDeletion deletion = {};
+	deletion.type = RV_DELETION_FRAMEBUFFER;
+	deletion.framebuffer = framebuffer;
+	push(deletion);
+}
+
+void RvDeletionQueue::freeAllocation(const RvAllocation& allocation)
+{
+	RvDeletion deletion = {};
+	deletion.type = RV_DELETION_ALLOCATION;
+	deletion.allocation = allocation;
+	push(deletion);
+}
+
+void RvDeletionQueue::push(std::function<void()> callback)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	buckets[currentSlot].callbacks.push_back(eastl::move(callback));
+}
+
+void RvDeletionQueue::push(const RvDeletion& deletion)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	buckets[currentSlot].deletions.push_back(deletion);
+}
+
+void RvDeletionQueue::beginFrame(uint32_t frameSlot)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	if (frameSlot >= buckets.size())
+	{
+		buckets.resize(frameSlot + 1);
+	}
+
+	destroy(buckets[frameSlot]);
+	currentSlot = frameSlot;
+}
+
+void RvDeletionQueue::flush()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	for (RvDeletionBucket& bucket : buckets)
+	{
+		destroy(bucket);
+	}
+}
+
+size_t RvDeletionQueue::pendingCount() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	size_t count = 0;
+	for (const RvDeletionBucket& bucket : buckets)
+	{
+		count += bucket.deletions.size() + bucket.callbacks.size();
+	}
+	return count;
+}
+
+void RvDeletionQueue::destroy(RvDeletionBucket& bucket)
+{
+	for (RvDeletion& deletion : bucket.deletions)
+	{
+		switch (deletion.type)
+		{
+		case RV_DELETION_BUFFER:
+			vkDestroyBuffer(device->handle, deletion.buffer, nullptr);
+			break;
+		case RV_DELETION_IMAGE:
+			vkDestroyImage(device->handle, deletion.image, nullptr);
+			break;
+		case RV_DELETION_IMAGE_VIEW:
+			vkDestroyImageView(device->handle, deletion.imageView, nullptr);
+			break;
+		case RV_DELETION_FRAMEBUFFER:
+			vkDestroyFramebuffer(device->handle, deletion.framebuffer, nullptr);
+			break;
+		case RV_DELETION_ALLOCATION:
+			break;
+		}
+
+		if (deletion.allocation.memory != VK_NULL_HANDLE)
+		{
+			device->allocator->free(deletion.allocation);
+		}
+	}
+	bucket.deletions.clear();
+
+	for (std::function<void()>& callback : bucket.callbacks)
+	{
+		callback();
+	}
+	bucket.callbacks.clear();
+}
@@ -0,0 +1,97 @@
+#ifndef RV_DELETION_QUEUE_H
+#define RV_DELETION_QUEUE_H
+
+//Vulkan Includes
+#include "volk.h"
+
+//EASTL Includes
+#include <eastl/vector.h>
+
+using eastl::vector;
+
+//STD Includes
+#include <functional>
+#include <mutex>
+
+//Ravine Includes
+#include "RvMemoryAllocator.h"
+
+class RvDevice;
+
+enum RvDeletionType : uint8_t
+{
+	RV_DELETION_BUFFER,
+	RV_DELETION_IMAGE,
+	RV_DELETION_IMAGE_VIEW,
+	RV_DELETION_FRAMEBUFFER,
+	//Memory only, e.g. aliased by several images
+	RV_DELETION_ALLOCATION
+};
+
+/**
+ * \brief Destroys resources once the GPU is done with them instead of waiting for the device to go idle.
+ * Whatever is released while a frame is recorded is destroyed when the fence of that frame slot is waited on again,
+ * by then every command submitted up to that frame completed.
+ */
+class RvDeletionQueue
+{
+public:
+	explicit RvDeletionQueue(RvDevice& device);
+	~RvDeletionQueue();
+
+	void destroyBuffer(VkBuffer buffer, const RvAllocation& allocation);
+	void destroyImage(VkImage image, const RvAllocation& allocation);
+	void destroyImageView(VkImageView imageView);
+	void destroyFramebuffer(VkFramebuffer framebuffer);
+	void freeAllocation(const RvAllocation& allocation);
+
+	/**
+	 * \brief Defers anything else, the callback must not release into this queue.
+	 */
+	void push(std::function<void()> callback);
+
+	/**
+	 * \brief Runs what was released the last time the frame slot was recorded, called right after waiting on its fence.
+	 * Releases go to this slot until the next call.
+	 */
+	void beginFrame(uint32_t frameSlot);
+
+	/**
+	 * \brief Destroys everything pending, the device must be idle.
+	 */
+	void flush();
+
+	size_t pendingCount() const;
+
+private:
+	struct RvDeletion
+	{
+		RvDeletionType type;
+		union
+		{
+			VkBuffer buffer;
+			VkImage image;
+			VkImageView imageView;
+			VkFramebuffer framebuffer;
+		};
+		RvAllocation allocation;
+	};
+
+	struct RvDeletionBucket
+	{
+		vector<RvDeletion> deletions;
+		vector<std::function<void()>> callbacks;
+	};
+
+	RvDevice* device;
+
+	//One bucket per frame slot, grown as slots show up
+	vector<RvDeletionBucket> buckets;
+	uint32_t currentSlot = 0;
+	mutable std::mutex mutex;
+
+	void push(const RvDeletion& deletion);
+	void destroy(RvDeletionBucket& bucket);
+};
+
+#endif
@@ -12,6 +12,37 @@ using eastl::set;
 //Ravine System Includes
 #include "RvTools.h"
 #include "RvConfig.h"
+#include "RvUploadContext.h"
+#include "RvDeletionQueue.h"
+
+namespace
+{
+	//Budget categories follow from what the resource is used for
+	RvAllocationCategory bufferCategory(VkBufferUsageFlags usage)
+	{
+		if (usage & VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT) {
+			return RV_ALLOCATION_UNIFORMS;
+		}
+		if (usage & (VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT)) {
+			return RV_ALLOCATION_GEOMETRY;
+		}
+		if (usage & VK_BUFFER_USAGE_TRANSFER_SRC_BIT) {
+			return RV_ALLOCATION_STAGING;
+		}
+		return RV_ALLOCATION_OTHER;
+	}
+
+	RvAllocationCategory imageCategory(VkImageUsageFlags usage)
+	{
+		if (usage & (VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT)) {
+			return RV_ALLOCATION_ATTACHMENTS;
+		}
+		if (usage & VK_IMAGE_USAGE_SAMPLED_BIT) {
+			return RV_ALLOCATION_TEXTURES;
+		}
+		return RV_ALLOCATION_OTHER;
+	}
+}
 
 RvDevice::RvDevice(VkPhysicalDevice physicalDevice, VkSurfaceKHR& surface) : surface(&surface), physicalDevice(physicalDevice)
 {
@@ -44,8 +75,32 @@ RvDevice::RvDevice(VkPhysicalDevice physicalDevice, VkSurfaceKHR& surface) : sur
 
 	createInfo.pEnabledFeatures = &deviceFeatures;
 
-	createInfo.enabledExtensionCount = static_cast<uint32_t>(rvCfg::DEVICE_EXTENSIONS.size());
-	createInfo.ppEnabledExtensionNames = rvCfg::DEVICE_EXTENSIONS.data();
+	//Host pointer import is optional, its VK_KHR_external_memory dependency is core since Vulkan 1.1
+	vector<const char*> deviceExtensions(rvCfg::DEVICE_EXTENSIONS.begin(), rvCfg::DEVICE_EXTENSIONS.end());
+	vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
+	if (deviceProperties.apiVersion >= VK_API_VERSION_1_1 && isExtensionSupported(VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME))
+	{
+		VkPhysicalDeviceExternalMemoryHostPropertiesEXT hostProperties = {};
+		hostProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTERNAL_MEMORY_HOST_PROPERTIES_EXT;
+		VkPhysicalDeviceProperties2 properties = {};
+		properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+		properties.pNext = &hostProperties;
+		vkGetPhysicalDeviceProperties2(physicalDevice, &properties);
+
+		deviceExtensions.push_back(VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME);
+		hostMemoryImportSupported = true;
+		hostPointerAlignment = hostProperties.minImportedHostPointerAlignment;
+	}
+
+	//Heap budgets are optional as well, the allocator estimates them from the heap sizes otherwise
+	if (deviceProperties.apiVersion >= VK_API_VERSION_1_1 && isExtensionSupported(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME))
+	{
+		deviceExtensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+		memoryBudgetSupported = true;
+	}
+
+	createInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
+	createInfo.ppEnabledExtensionNames = deviceExtensions.data();
 
 #ifdef VALIDATION_LAYERS_ENABLED
 		createInfo.enabledLayerCount = static_cast<uint32_t>(rvCfg::VALIDATION_LAYERS.size());
@@ -62,15 +117,23 @@ RvDevice::RvDevice(VkPhysicalDevice physicalDevice, VkSurfaceKHR& surface) : sur
 	vkGetDeviceQueue(handle, indices.presentFamily, 0, &presentQueue);
 
 	vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProperties);
-	vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
 	vkGetPhysicalDeviceFeatures(physicalDevice, &supportedFeatures);
 
 	//TODO: This should be dynamically chosen
 	sampleCount = getMaxUsableSampleCount();
 	fmt::print(stdout, "Chosen samples count: {0}\n", sampleCount);
+	fmt::print(stdout, "Host pointer import: {0}\n", hostMemoryImportSupported ? "enabled" : "not supported");
+	fmt::print(stdout, "Memory budget: {0}\n", memoryBudgetSupported ? "enabled" : "not supported");
+
+	//Device memory is sub-allocated from blocks per memory type
+	allocator = new RvMemoryAllocator(handle, physicalDevice, memoryBudgetSupported);
+	deletionQueue = new RvDeletionQueue(*this);
 
 	//Create command pool
 	createCommandPool();
+
+	//Staging memory reused by every upload
+	stagingRing = new RvStagingRing(*this, RV_STAGING_RING_SIZE);
 }
 
 
@@ -92,7 +155,7 @@ void RvDevice::createCommandPool()
 }
 
 void RvDevice::createBuffer(const VkDeviceSize size, const VkBufferUsageFlags usage, const VkMemoryPropertyFlags properties,
-                            VkBuffer& buffer, VkDeviceMemory& bufferMemory)
+                            VkBuffer& buffer, RvAllocation& bufferMemory, RvMemoryPool* pool)
 {
 	//Defining buffer creation info
 	VkBufferCreateInfo bufferCreateInfo = {};
@@ -110,21 +173,46 @@ void RvDevice::createBuffer(const VkDeviceSize size, const VkBufferUsageFlags us
 	VkMemoryRequirements memRequirements;
 	vkGetBufferMemoryRequirements(handle, buffer, &memRequirements);
 
-	VkMemoryAllocateInfo allocInfo = {};
-	allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-	allocInfo.allocationSize = memRequirements.size;
-	allocInfo.memoryTypeIndex = findMemoryType(memRequirements.memoryTypeBits, properties);
-
-	if (vkAllocateMemory(handle, &allocInfo, nullptr, &bufferMemory) != VK_SUCCESS) {
-		throw std::runtime_error("Failed to allocate buffer memory!");
+	//Pools hold a single memory type, the default ones are used when the buffer can't live in it
+	if (pool && !(memRequirements.memoryTypeBits & (1u << pool->memoryType))) {
+		pool = nullptr;
 	}
+	const uint32_t memoryType = pool ? pool->memoryType : findMemoryType(memRequirements.memoryTypeBits, properties);
+	bufferMemory = allocator->allocate(memRequirements, memoryType, RV_RESOURCE_LINEAR, bufferCategory(usage), pool);
 
 	//Binding buffer memory
-	vkBindBufferMemory(handle, buffer, bufferMemory, 0);
+	vkBindBufferMemory(handle, buffer, bufferMemory.memory, bufferMemory.offset);
+}
+
+bool RvDevice::isExtensionSupported(const char* extensionName) const
+{
+	uint32_t extensionCount;
+	vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, nullptr);
+	vector<VkExtensionProperties> availableExtensions(extensionCount);
+	vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, availableExtensions.data());
+
+	for (const VkExtensionProperties& extension : availableExtensions)
+	{
+		if (strcmp(extension.extensionName, extensionName) == 0) {
+			return true;
+		}
+	}
+	return false;
 }
 
 void RvDevice::clear()
 {
+	//The device is idle, nothing released is in flight anymore
+	deletionQueue->flush();
+	delete deletionQueue;
+
+	stagingRing->clear();
+	delete stagingRing;
+
+	//Every resource gave its memory back by now, this frees the blocks
+	allocator->clear();
+	delete allocator;
+
 	//Destroy command pool actually destroys all CMD Buffers
 	vkDestroyCommandPool(handle, commandPool, nullptr);
 
@@ -132,7 +220,7 @@ void RvDevice::clear()
 	vkDestroyDevice(handle, nullptr);
 }
 
-void RvDevice::createImage(VkExtent3D extent, uint32_t mipLevels, VkSampleCountFlagBits numSamples, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties, VkImageCreateFlagBits createFlagBits, VkImage & image, VkDeviceMemory & imageMemory) const
+void RvDevice::createImage(VkExtent3D extent, uint32_t mipLevels, VkSampleCountFlagBits numSamples, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties, VkImageCreateFlagBits createFlagBits, VkImage & image, RvAllocation & imageMemory) const
 {
 	//Defining image creation info
 	VkImageCreateInfo imageCreateInfo = {};
@@ -156,61 +244,166 @@ void RvDevice::createImage(VkExtent3D extent, uint32_t mipLevels, VkSampleCountF
 		throw std::runtime_error("Failed to create image!");
 	}
 
-	//Allocating image memory
-	VkMemoryRequirements memRequirements;
-	vkGetImageMemoryRequirements(handle, image, &memRequirements);
-
-	VkMemoryAllocateInfo allocInfo = {};
-	allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-	allocInfo.allocationSize = memRequirements.size;
-	allocInfo.memoryTypeIndex = findMemoryType(memRequirements.memoryTypeBits, properties);
-
-	if (vkAllocateMemory(handle, &allocInfo, nullptr, &imageMemory) != VK_SUCCESS) {
-		throw std::runtime_error("Failed to allocate image memory!");
+	//Allocating image memory, drivers may ask for render targets to get their own allocation
+	VkMemoryDedicatedRequirements dedicatedRequirements = {};
+	dedicatedRequirements.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS;
+	VkMemoryRequirements2 memRequirements2 = {};
+	memRequirements2.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2;
+	memRequirements2.pNext = &dedicatedRequirements;
+	VkImageMemoryRequirementsInfo2 requirementsInfo = {};
+	requirementsInfo.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_REQUIREMENTS_INFO_2;
+	requirementsInfo.image = image;
+	vkGetImageMemoryRequirements2(handle, &requirementsInfo, &memRequirements2);
+
+	const VkMemoryRequirements& memRequirements = memRequirements2.memoryRequirements;
+	const uint32_t memoryType = usage & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT ?
+		findTransientMemoryType(memRequirements.memoryTypeBits) : findMemoryType(memRequirements.memoryTypeBits, properties);
+
+	//Lazily allocated memory is backed on demand per memory object, a shared block would reserve it for images that never spill
+	if (dedicatedRequirements.prefersDedicatedAllocation || dedicatedRequirements.requiresDedicatedAllocation || isLazilyAllocated(memoryType)) {
+		imageMemory = allocator->allocateDedicated(memRequirements.size, memoryType, imageCategory(usage), image);
+	}
+	else {
+		imageMemory = allocator->allocate(memRequirements, memoryType, tiling == VK_IMAGE_TILING_OPTIMAL ? RV_RESOURCE_OPTIMAL : RV_RESOURCE_LINEAR,
+			imageCategory(usage));
 	}
 
 	//Binding image and memory
-	vkBindImageMemory(handle, image, imageMemory, 0);
+	vkBindImageMemory(handle, image, imageMemory.memory, imageMemory.offset);
 }
 
-RvDynamicBuffer RvDevice::createDynamicBuffer(VkDeviceSize bufferSize, VkBufferUsageFlagBits usageFlags, VkMemoryPropertyFlagBits memoryPropertyFlags)
+RvDynamicBuffer RvDevice::createDynamicBuffer(VkDeviceSize bufferSize, VkBufferUsageFlagBits usageFlags, VkMemoryPropertyFlagBits memoryPropertyFlags,
+	RvMemoryPool* pool)
 {
 	RvDynamicBuffer newBuffer(bufferSize);
-	createBuffer(bufferSize, usageFlags, memoryPropertyFlags, newBuffer.handle, newBuffer.memory);
+	createBuffer(bufferSize, usageFlags, memoryPropertyFlags, newBuffer.handle, newBuffer.allocation, pool);
 	return newBuffer;
 }
 
 RvPersistentBuffer RvDevice::createPersistentBuffer(void * data, VkDeviceSize bufferSize, size_t sizeOfDataType, VkBufferUsageFlagBits usageFlags, VkMemoryPropertyFlagBits memoryPropertyFlags)
 {
-	// Staging Buffer
-	RvDynamicBuffer stagingBuffer = createDynamicBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, 
-		static_cast<VkMemoryPropertyFlagBits>(VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT));
-
-	// Copying data
-	void* stagingData;
-	vkMapMemory(handle, stagingBuffer.memory, 0, bufferSize, 0, &stagingData);
-	memcpy(stagingData, static_cast<void*>(data), static_cast<size_t>(bufferSize));
-	vkUnmapMemory(handle, stagingBuffer.memory);
-
 	// Persistent buffer
-	RvPersistentBuffer newBuffer(bufferSize, sizeOfDataType);
-	createBuffer(bufferSize, usageFlags | VK_BUFFER_USAGE_TRANSFER_DST_BIT, memoryPropertyFlags, newBuffer.handle, newBuffer.memory);
+	RvPersistentBuffer newBuffer = createPersistentBuffer(bufferSize, sizeOfDataType, usageFlags, memoryPropertyFlags);
 
 	// Copying data to persistent buffer
-	rvTools::copyBuffer(*this, stagingBuffer.handle, newBuffer.handle, bufferSize);
+	uploadToBuffer(data, bufferSize, newBuffer.handle, 0);
 
-	//Clearing staging buffer
-	vkDestroyBuffer(handle, stagingBuffer.handle, nullptr);
-	vkFreeMemory(handle, stagingBuffer.memory, nullptr);
+	return newBuffer;
+}
 
+RvPersistentBuffer RvDevice::createPersistentBuffer(VkDeviceSize bufferSize, size_t sizeOfDataType, VkBufferUsageFlagBits usageFlags, VkMemoryPropertyFlagBits memoryPropertyFlags)
+{
+	RvPersistentBuffer newBuffer(bufferSize, sizeOfDataType);
+	createBuffer(bufferSize, usageFlags | VK_BUFFER_USAGE_TRANSFER_DST_BIT, memoryPropertyFlags, newBuffer.handle, newBuffer.allocation);
 	return newBuffer;
 }
 
-RvTexture RvDevice::createTexture(void* pixels, size_t width, size_t height, VkFormat format)
+void RvDevice::uploadToBuffer(const void* data, VkDeviceSize size, VkBuffer dstBuffer, VkDeviceSize dstOffset)
+{
+	RvUploadContext upload(*this);
+	upload.uploadBuffer(data, size, dstBuffer, dstOffset);
+	upload.wait();
+}
+
+bool RvDevice::importHostMemory(const RvFileView& file, size_t offset, VkDeviceSize size, RvDynamicBuffer& buffer, VkDeviceSize& bufferOffset)
+{
+	//Only file pages can be imported, archived files live in memory owned by the view
+	if (!hostMemoryImportSupported || !file.isMapped() || size == 0 || offset > file.size() || size > file.size() - offset) {
+		return false;
+	}
+
+	//Import whole alignment blocks around the range, they must not go past the mapped pages
+	const uintptr_t mappingBegin = reinterpret_cast<uintptr_t>(file.data());
+	const uintptr_t begin = mappingBegin + offset;
+	const uintptr_t alignedBegin = begin & ~static_cast<uintptr_t>(hostPointerAlignment - 1);
+	const uintptr_t alignedEnd = (begin + size + hostPointerAlignment - 1) & ~static_cast<uintptr_t>(hostPointerAlignment - 1);
+	if (alignedBegin < mappingBegin || alignedEnd > mappingBegin + file.mappedSize()) {
+		return false;
+	}
+	void* hostPointer = reinterpret_cast<void*>(alignedBegin);
+	const VkDeviceSize importSize = alignedEnd - alignedBegin;
+
+	VkMemoryHostPointerPropertiesEXT pointerProperties = {};
+	pointerProperties.sType = VK_STRUCTURE_TYPE_MEMORY_HOST_POINTER_PROPERTIES_EXT;
+	if (vkGetMemoryHostPointerPropertiesEXT(handle, VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT, hostPointer, &pointerProperties) != VK_SUCCESS) {
+		return false;
+	}
+
+	//Buffer aliasing the imported pages
+	VkExternalMemoryBufferCreateInfo externalCreateInfo = {};
+	externalCreateInfo.sType = VK_STRUCTURE_TYPE_EXTERNAL_MEMORY_BUFFER_CREATE_INFO;
+	externalCreateInfo.handleTypes = VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT;
+
+	VkBufferCreateInfo bufferCreateInfo = {};
+	bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	bufferCreateInfo.pNext = &externalCreateInfo;
+	bufferCreateInfo.size = importSize;
+	bufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+	bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+	VkBuffer importedBuffer;
+	if (vkCreateBuffer(handle, &bufferCreateInfo, nullptr, &importedBuffer) != VK_SUCCESS) {
+		return false;
+	}
+
+	VkMemoryRequirements memRequirements;
+	vkGetBufferMemoryRequirements(handle, importedBuffer, &memRequirements);
+	const uint32_t memoryTypeBits = memRequirements.memoryTypeBits & pointerProperties.memoryTypeBits;
+	if (memoryTypeBits == 0 || memRequirements.size > importSize) {
+		vkDestroyBuffer(handle, importedBuffer, nullptr);
+		return false;
+	}
+
+	VkImportMemoryHostPointerInfoEXT importInfo = {};
+	importInfo.sType = VK_STRUCTURE_TYPE_IMPORT_MEMORY_HOST_POINTER_INFO_EXT;
+	importInfo.handleType = VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT;
+	importInfo.pHostPointer = hostPointer;
+
+	VkMemoryAllocateInfo allocInfo = {};
+	allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+	allocInfo.pNext = &importInfo;
+	allocInfo.allocationSize = importSize;
+	allocInfo.memoryTypeIndex = findMemoryType(memoryTypeBits, 0);
+
+	//Some drivers refuse read-only file pages, which just means taking the staging path
+	VkDeviceMemory importedMemory;
+	if (vkAllocateMemory(handle, &allocInfo, nullptr, &importedMemory) != VK_SUCCESS) {
+		vkDestroyBuffer(handle, importedBuffer, nullptr);
+		return false;
+	}
+	vkBindBufferMemory(handle, importedBuffer, importedMemory, 0);
+
+	buffer = RvDynamicBuffer(importSize);
+	buffer.handle = importedBuffer;
+	buffer.allocation = allocator->adopt(importedMemory, importSize, allocInfo.memoryTypeIndex, RV_ALLOCATION_STAGING);
+	bufferOffset = begin - alignedBegin;
+	return true;
+}
+
+RvTexture RvDevice::createTexture(const void* pixels, size_t width, size_t height, VkFormat format)
 {
 	return rvTools::createTexture(this, pixels, width, height, format);
 }
 
+RvTexture RvDevice::createTexture(const RvFileView& file, size_t offset, size_t width, size_t height, VkFormat format)
+{
+	const VkDeviceSize dataSize = width * height * 4; //Size * 4 channels (RGBA)
+
+	//Buffer to image copies need texel aligned offsets
+	RvDynamicBuffer importedBuffer;
+	VkDeviceSize importedOffset;
+	if (offset % 4 == 0 && importHostMemory(file, offset, dataSize, importedBuffer, importedOffset))
+	{
+		RvUploadContext upload(*this);
+		upload.keepAlive(importedBuffer);
+		RvTexture texture = upload.createTexture(importedBuffer.handle, importedOffset, width, height, format);
+		upload.wait();
+		return texture;
+	}
+
+	return rvTools::createTexture(this, file.data() + offset, width, height, format);
+}
+
 uint32_t RvDevice::findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const
 {
 	for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
@@ -222,6 +415,24 @@ uint32_t RvDevice::findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags pro
 	throw std::runtime_error("Failed to find suitable memory type!");
 }
 
+uint32_t RvDevice::findTransientMemoryType(uint32_t typeFilter) const
+{
+	//On tile based and integrated GPUs transient attachments stay in tile memory, lazily allocated memory only gets backed if they spill
+	const VkMemoryPropertyFlags lazyProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+	for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
+		if ((typeFilter & (1 << i)) && (memProperties.memoryTypes[i].propertyFlags & lazyProperties) == lazyProperties) {
+			return i;
+		}
+	}
+
+	return findMemoryType(typeFilter, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+}
+
+bool RvDevice::isLazilyAllocated(uint32_t memoryType) const
+{
+	return (memProperties.memoryTypes[memoryType].propertyFlags & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT) != 0;
+}
+
 VkFormat RvDevice::findSupportedFormat(const vector<VkFormat>& candidates, VkImageTiling tiling, VkFormatFeatureFlags features)
 {
 	for (VkFormat format : candidates) {
@@ -292,12 +503,17 @@ void RvDevice::endSingleTimeCommands(VkCommandBuffer commandBuffer)
 	submitInfo.commandBufferCount = 1;
 	submitInfo.pCommandBuffers = &commandBuffer;
 
+	VkFenceCreateInfo fenceInfo = {};
+	fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+	VkFence fence;
+	vkCreateFence(handle, &fenceInfo, nullptr, &fence);
+
 	//The graphics queue implictly has a transfer queue
-	vkQueueSubmit(graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-	//TODO: Could use a fence instead of waiting for the queue.
-	//That would allow for scheduling multiple transfers simultaneously and waiting for all to complete.
-	vkQueueWaitIdle(graphicsQueue);
+	//Only this submission is waited on, batches of transfers should go through RvUploadContext
+	vkQueueSubmit(graphicsQueue, 1, &submitInfo, fence);
+	vkWaitForFences(handle, 1, &fence, VK_TRUE, UINT64_MAX);
 
+	vkDestroyFence(handle, fence, nullptr);
 	vkFreeCommandBuffers(handle, commandPool, 1, &commandBuffer);
 }
 
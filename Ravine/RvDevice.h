@@ -14,13 +14,23 @@ using eastl::string;
 #include "RvPersistentBuffer.h"
 #include "RvDynamicBuffer.h"
 #include "RvTexture.h"
+#include "RvFileSystem.h"
+#include "RvMemoryAllocator.h"
+
+class RvStagingRing;
+class RvDeletionQueue;
+
+//Staging memory shared by every upload context
+#define RV_STAGING_RING_SIZE (32 * 1024 * 1024)
 
 class RvDevice
 {
 private:
 	VkSurfaceKHR* surface;
 	void createCommandPool();
-	void createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer& buffer, VkDeviceMemory& bufferMemory);
+	void createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer& buffer, RvAllocation& bufferMemory,
+		RvMemoryPool* pool = nullptr);
+	bool isExtensionSupported(const char* extensionName) const;
 
 public:
 	RvDevice(VkPhysicalDevice physicalDevice, VkSurfaceKHR& surface);
@@ -38,6 +48,12 @@ public:
 	VkQueue presentQueue;
 	//Default command pool for the graphics queue
 	VkCommandPool commandPool = VK_NULL_HANDLE;
+	//Sub-allocates the memory of every buffer and image
+	RvMemoryAllocator* allocator = nullptr;
+	//Persistently mapped staging buffer used by upload contexts
+	RvStagingRing* stagingRing = nullptr;
+	//Resources released while they may still be in flight, destroyed once their frame completed
+	RvDeletionQueue* deletionQueue = nullptr;
 
 	//Physical Properties
 	VkPhysicalDeviceMemoryProperties memProperties;
@@ -47,20 +63,58 @@ public:
 	//Attributes
 	VkSampleCountFlagBits sampleCount;
 
+	//Host pointer import (VK_EXT_external_memory_host), pointers and sizes must be multiples of the alignment
+	bool hostMemoryImportSupported = false;
+	VkDeviceSize hostPointerAlignment = 0;
+
+	//Heap budget and usage queries (VK_EXT_memory_budget)
+	bool memoryBudgetSupported = false;
+
 	/**
 	 * \brief Should be used instead of destroying in destructor
 	 */
 	void clear();
 
-	RvTexture createTexture(void *pixels, size_t width, size_t height, VkFormat format = VK_FORMAT_R8G8B8A8_UNORM);
+	RvTexture createTexture(const void *pixels, size_t width, size_t height, VkFormat format = VK_FORMAT_R8G8B8A8_UNORM);
+
+	/**
+	 * \brief Creates a texture from RGBA8 pixels stored in a file, mapped pages are used as the transfer source when they can be imported.
+	 */
+	RvTexture createTexture(const RvFileView& file, size_t offset, size_t width, size_t height, VkFormat format = VK_FORMAT_R8G8B8A8_UNORM);
 	void createImage(VkExtent3D extent, uint32_t mipLevels, VkSampleCountFlagBits numSamples, VkFormat format, VkImageTiling tiling,
-		VkImageUsageFlags usage, VkMemoryPropertyFlags properties, VkImageCreateFlagBits createFlagBits, VkImage& image, VkDeviceMemory& imageMemory) const; 
+		VkImageUsageFlags usage, VkMemoryPropertyFlags properties, VkImageCreateFlagBits createFlagBits, VkImage& image, RvAllocation& imageMemory) const;
 	
-	RvDynamicBuffer createDynamicBuffer(VkDeviceSize bufferSize, VkBufferUsageFlagBits usageFlags, VkMemoryPropertyFlagBits memoryPropertyFlags);
+	/**
+	 * \brief Creates a buffer, host visible ones are persistently mapped (see allocation.mapped).
+	 * \param pool Custom pool of the allocator to place it in (default pools otherwise).
+	 */
+	RvDynamicBuffer createDynamicBuffer(VkDeviceSize bufferSize, VkBufferUsageFlagBits usageFlags, VkMemoryPropertyFlagBits memoryPropertyFlags,
+		RvMemoryPool* pool = nullptr);
 	RvPersistentBuffer createPersistentBuffer(void* data, VkDeviceSize bufferSize, size_t sizeOfDataType, VkBufferUsageFlagBits usageFlags, 
 		VkMemoryPropertyFlagBits memoryPropertyFlags);
+	RvPersistentBuffer createPersistentBuffer(VkDeviceSize bufferSize, size_t sizeOfDataType, VkBufferUsageFlagBits usageFlags,
+		VkMemoryPropertyFlagBits memoryPropertyFlags);
+
+	/**
+	 * \brief Copies data into a region of a device local buffer through the staging ring, waits for it to finish.
+	 * Several uploads should be recorded into one RvUploadContext instead.
+	 */
+	void uploadToBuffer(const void* data, VkDeviceSize size, VkBuffer dstBuffer, VkDeviceSize dstOffset);
+
+	/**
+	 * \brief Wraps a range of a mapped file in a transfer source buffer without copying it.
+	 * \param bufferOffset Receives where the range starts in the buffer (imports are rounded out to the pointer alignment).
+	 * \return False if the device can't import it, callers should copy through a staging buffer instead.
+	 */
+	bool importHostMemory(const RvFileView& file, size_t offset, VkDeviceSize size, RvDynamicBuffer& buffer, VkDeviceSize& bufferOffset);
 
 	uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const;
+
+	/**
+	 * \brief Memory type for images with VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT, lazily allocated when the device has it.
+	 */
+	uint32_t findTransientMemoryType(uint32_t typeFilter) const;
+	bool isLazilyAllocated(uint32_t memoryType) const;
 	VkFormat findSupportedFormat(const vector<VkFormat>& candidates, VkImageTiling tiling, VkFormatFeatureFlags features);
 	VkFormat findDepthFormat();
 	VkSampleCountFlagBits getMaxUsableSampleCount();
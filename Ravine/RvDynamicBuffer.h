@@ -4,6 +4,9 @@
 //Vulkan Include
 #include "volk.h"
 
+//Ravine Includes
+#include "RvMemoryAllocator.h"
+
 struct RvDynamicBuffer
 {
 	RvDynamicBuffer();
@@ -11,7 +14,7 @@ struct RvDynamicBuffer
 	~RvDynamicBuffer();
 
 	VkBuffer handle = VK_NULL_HANDLE;
-	VkDeviceMemory memory = VK_NULL_HANDLE;
+	RvAllocation allocation;
 	VkDeviceSize bufferSize = 0;
 };
 
@@ -0,0 +1,335 @@
+#include "RvFileSystem.h"
+
+//Ravine Includes
+#include "RvArchive.h"
+
+//Platform Includes
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//Granularity used to fault mapped pages in
+#define RV_FILE_PAGE_SIZE 4096
+
+#pragma region RvFileView
+
+RvFileView::~RvFileView()
+{
+	release();
+}
+
+RvFileView::RvFileView(RvFileView&& other) noexcept
+{
+	*this = eastl::move(other);
+}
+
+RvFileView& RvFileView::operator=(RvFileView&& other) noexcept
+{
+	if (this != &other)
+	{
+		release();
+		bytes = other.bytes;
+		length = other.length;
+		valid = other.valid;
+		storage = eastl::move(other.storage);
+#ifdef _WIN32
+		fileHandle = other.fileHandle;
+		mappingHandle = other.mappingHandle;
+		other.fileHandle = nullptr;
+		other.mappingHandle = nullptr;
+#endif
+		other.bytes = nullptr;
+		other.length = 0;
+		other.valid = false;
+	}
+	return *this;
+}
+
+size_t RvFileView::mappedSize() const
+{
+	return isMapped() ? (length + RV_FILE_PAGE_SIZE - 1) / RV_FILE_PAGE_SIZE * RV_FILE_PAGE_SIZE : 0;
+}
+
+void RvFileView::release()
+{
+#ifdef _WIN32
+	if (mappingHandle)
+	{
+		if (bytes)
+		{
+			UnmapViewOfFile(bytes);
+		}
+		CloseHandle(mappingHandle);
+	}
+	if (fileHandle)
+	{
+		CloseHandle(fileHandle);
+	}
+	fileHandle = nullptr;
+	mappingHandle = nullptr;
+#else
+	if (bytes && storage.empty())
+	{
+		munmap(const_cast<char*>(bytes), length);
+	}
+#endif
+	storage.clear();
+	bytes = nullptr;
+	length = 0;
+	valid = false;
+}
+
+#pragma endregion
+
+vector<RvFileSystem::RvMount> RvFileSystem::mounts;
+
+RvFileView RvFileSystem::map(const string& filePath)
+{
+	RvFileView view;
+
+	//Archived files shadow loose ones
+	if (!mounts.empty())
+	{
+		const string normalizedPath = normalizePath(filePath);
+		for (const RvMount& mount : mounts)
+		{
+			if (normalizedPath.compare(0, mount.mountPoint.size(), mount.mountPoint) != 0)
+			{
+				continue;
+			}
+
+			const RvArchiveEntry* entry = mount.archive->find(normalizedPath.substr(mount.mountPoint.size()));
+			if (!entry)
+			{
+				continue;
+			}
+
+			view.storage.resize(static_cast<size_t>(entry->size));
+			if (!mount.archive->read(*entry, view.storage.data(), mount.threadPool))
+			{
+				view.storage.clear();
+				return view;
+			}
+			view.bytes = view.storage.data();
+			view.length = view.storage.size();
+			view.valid = true;
+			return view;
+		}
+	}
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return view;
+	}
+	view.fileHandle = file;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize))
+	{
+		view.release();
+		return view;
+	}
+
+	//Empty files can't be mapped, but they are still valid
+	view.valid = true;
+	if (fileSize.QuadPart == 0)
+	{
+		return view;
+	}
+
+	view.mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!view.mappingHandle)
+	{
+		view.release();
+		return view;
+	}
+
+	view.bytes = static_cast<const char*>(MapViewOfFile(view.mappingHandle, FILE_MAP_READ, 0, 0, 0));
+	if (!view.bytes)
+	{
+		view.release();
+		return view;
+	}
+	view.length = static_cast<size_t>(fileSize.QuadPart);
+#else
+	const int file = open(filePath.c_str(), O_RDONLY);
+	if (file < 0)
+	{
+		return view;
+	}
+
+	struct stat fileStat;
+	if (fstat(file, &fileStat) != 0)
+	{
+		close(file);
+		return view;
+	}
+
+	//Empty files can't be mapped, but they are still valid
+	view.valid = true;
+	if (fileStat.st_size > 0)
+	{
+		void* mapped = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+		if (mapped == MAP_FAILED)
+		{
+			view.valid = false;
+		}
+		else
+		{
+			view.bytes = static_cast<const char*>(mapped);
+			view.length = static_cast<size_t>(fileStat.st_size);
+		}
+	}
+
+	//The mapping keeps its own reference to the file
+	close(file);
+#endif
+
+	return view;
+}
+
+RvFileRequest* RvFileSystem::readAsync(RvThreadPool& threadPool, const string& filePath)
+{
+	RvFileRequest* request = new RvFileRequest();
+	request->filePath = filePath;
+
+	threadPool.submit([request]()
+	{
+		request->view = map(request->filePath);
+
+		//Touch every page so the disk reads happen here instead of on the consumer
+		volatile char sink = 0;
+		for (size_t offset = 0; offset < request->view.size(); offset += RV_FILE_PAGE_SIZE)
+		{
+			sink += request->view.data()[offset];
+		}
+		(void)sink;
+
+		std::unique_lock<std::mutex> lock(request->mutex);
+		request->done = true;
+		request->finished.notify_all();
+	});
+
+	return request;
+}
+
+RvFileView& RvFileSystem::wait(RvFileRequest& request)
+{
+	std::unique_lock<std::mutex> lock(request.mutex);
+	request.finished.wait(lock, [&request]() { return request.done.load(); });
+	return request.view;
+}
+
+void RvFileSystem::mount(const RvArchive* archive, const string& mountPoint, RvThreadPool* threadPool)
+{
+	string normalizedMountPoint = normalizePath(mountPoint);
+	if (!normalizedMountPoint.empty() && normalizedMountPoint.back() != '/')
+	{
+		normalizedMountPoint.push_back('/');
+	}
+	mounts.push_back({ archive, normalizedMountPoint, threadPool });
+}
+
+void RvFileSystem::unmountAll()
+{
+	mounts.clear();
+}
+
+bool RvFileSystem::listFiles(const string& directory, vector<string>& files)
+{
+	//Directories still to be visited, relative to the root one
+	vector<string> pending;
+	pending.push_back("");
+
+	const string root = normalizePath(directory) + (directory.empty() || directory.back() == '/' || directory.back() == '\\' ? "" : "/");
+	while (!pending.empty())
+	{
+		const string relative = pending.back();
+		pending.pop_back();
+
+#ifdef _WIN32
+		WIN32_FIND_DATAA findData;
+		HANDLE find = FindFirstFileA((root + relative + "*").c_str(), &findData);
+		if (find == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+		do
+		{
+			const string name = findData.cFileName;
+			if (name == "." || name == "..")
+			{
+				continue;
+			}
+			if (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+			{
+				pending.push_back(relative + name + "/");
+			}
+			else
+			{
+				files.push_back(relative + name);
+			}
+		} while (FindNextFileA(find, &findData));
+		FindClose(find);
+#else
+		DIR* dir = opendir((root + relative).c_str());
+		if (!dir)
+		{
+			return false;
+		}
+		while (dirent* item = readdir(dir))
+		{
+			const string name = item->d_name;
+			if (name == "." || name == "..")
+			{
+				continue;
+			}
+
+			struct stat itemStat;
+			if (stat((root + relative + name).c_str(), &itemStat) != 0)
+			{
+				continue;
+			}
+			if (S_ISDIR(itemStat.st_mode))
+			{
+				pending.push_back(relative + name + "/");
+			}
+			else
+			{
+				files.push_back(relative + name);
+			}
+		}
+		closedir(dir);
+#endif
+	}
+
+	return true;
+}
+
+string RvFileSystem::normalizePath(const string& filePath)
+{
+	string normalized = filePath;
+	for (char& c : normalized)
+	{
+		if (c == '\\')
+		{
+			c = '/';
+		}
+	}
+	return normalized;
+}
@@ -0,0 +1,140 @@
+#ifndef RV_FILE_SYSTEM_H
+#define RV_FILE_SYSTEM_H
+
+//EASTL Includes
+#include <eastl/vector.h>
+#include <eastl/string.h>
+
+using eastl::vector;
+using eastl::string;
+
+//STD Includes
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
+//Ravine Includes
+#include "RvThreadPool.h"
+
+class RvArchive;
+
+/**
+ * \brief Read-only view of a whole file mapped in memory (zero-copy), unmapped when destroyed.
+ * Files served from a mounted archive are decompressed into memory owned by the view instead.
+ */
+class RvFileView
+{
+public:
+	RvFileView() = default;
+	~RvFileView();
+
+	RvFileView(RvFileView&& other) noexcept;
+	RvFileView& operator=(RvFileView&& other) noexcept;
+	RvFileView(const RvFileView&) = delete;
+	RvFileView& operator=(const RvFileView&) = delete;
+
+	const char* data() const { return bytes; }
+	size_t size() const { return length; }
+	bool empty() const { return length == 0; }
+
+	//False when the file could not be opened (empty files are valid)
+	bool isValid() const { return valid; }
+
+	//True when data points straight at the file pages (not at memory owned by the view)
+	bool isMapped() const { return bytes && storage.empty(); }
+
+	/**
+	 * \brief Size of the mapping rounded up to whole pages, every byte in it can be read.
+	 */
+	size_t mappedSize() const;
+
+private:
+	friend class RvFileSystem;
+	void release();
+
+	const char* bytes = nullptr;
+	size_t length = 0;
+	bool valid = false;
+	vector<char> storage;
+#ifdef _WIN32
+	void* fileHandle = nullptr;
+	void* mappingHandle = nullptr;
+#endif
+};
+
+/**
+ * \brief File read queued with RvFileSystem::readAsync.
+ */
+struct RvFileRequest
+{
+	string filePath;
+	RvFileView view;
+
+	bool isDone() const { return done; }
+
+private:
+	friend class RvFileSystem;
+	std::atomic<bool> done{ false };
+	std::mutex mutex;
+	std::condition_variable finished;
+};
+
+/**
+ * \brief File access layer, every loader goes through it instead of copying files into owned buffers.
+ */
+class RvFileSystem
+{
+public:
+
+	/**
+	 * \brief Maps a whole file for reading, mounted archives are looked up before loose files.
+	 * \return Invalid view if the file could not be opened.
+	 */
+	static RvFileView map(const string& filePath);
+
+	/**
+	 * \brief Serves files under mountPoint from an archive (it must outlive the mount), mount before any file is read.
+	 * \param threadPool Workers used to decompress chunks in parallel (may be null).
+	 */
+	static void mount(const RvArchive* archive, const string& mountPoint, RvThreadPool* threadPool = nullptr);
+
+	/**
+	 * \brief Removes every mounted archive.
+	 */
+	static void unmountAll();
+
+	/**
+	 * \brief Lists every file under a directory (recursively), paths are relative to it and use forward slashes.
+	 */
+	static bool listFiles(const string& directory, vector<string>& files);
+
+	/**
+	 * \brief Converts backslashes to forward slashes so the same file always gets the same path.
+	 */
+	static string normalizePath(const string& filePath);
+
+	/**
+	 * \brief Maps a file and faults its pages in on a worker thread, so consumers don't stall on disk reads.
+	 * Requests must be waited on before being deleted.
+	 */
+	static RvFileRequest* readAsync(RvThreadPool& threadPool, const string& filePath);
+
+	/**
+	 * \brief Blocks until the request is done and returns its view.
+	 */
+	static RvFileView& wait(RvFileRequest& request);
+
+private:
+	RvFileSystem();
+	~RvFileSystem();
+
+	struct RvMount
+	{
+		const RvArchive* archive;
+		string mountPoint;
+		RvThreadPool* threadPool;
+	};
+	static vector<RvMount> mounts;
+};
+
+#endif
@@ -0,0 +1,125 @@
+#include "RvFrameArena.h"
+
+//STD Includes
+#include <cstdint>
+#include <new>
+
+namespace
+{
+	//Rounds address up so that address + offset is a multiple of alignment (a power of two)
+	uintptr_t alignAddress(uintptr_t address, size_t alignment, size_t offset)
+	{
+		return ((address + offset + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1)) - offset;
+	}
+}
+
+RvFrameArena::RvFrameArena(size_t capacity) : size(capacity)
+{
+}
+
+RvFrameArena::~RvFrameArena()
+{
+	reset();
+	delete[] memory;
+}
+
+void* RvFrameArena::allocate(size_t size, size_t alignment, size_t alignmentOffset)
+{
+	//Threads that never allocate don't pay for their arena
+	if (memory == nullptr)
+	{
+		memory = new char[this->size];
+	}
+
+	const uintptr_t base = reinterpret_cast<uintptr_t>(memory);
+	const uintptr_t address = alignAddress(base + head, alignment, alignmentOffset);
+	if (address + size <= base + this->size)
+	{
+		head = address + size - base;
+		peakBytes = peakBytes > used() ? peakBytes : used();
+		return reinterpret_cast<void*>(address);
+	}
+
+	//Out of space, borrow from the heap until the arena is grown on reset
+	char* block = static_cast<char*>(::operator new(sizeof(RvOverflowBlock) + alignment + alignmentOffset + size));
+	RvOverflowBlock* header = reinterpret_cast<RvOverflowBlock*>(block);
+	header->next = overflow;
+	overflow = header;
+	overflowBytes += size;
+	peakBytes = peakBytes > used() ? peakBytes : used();
+	return reinterpret_cast<void*>(alignAddress(reinterpret_cast<uintptr_t>(block + sizeof(RvOverflowBlock)), alignment, alignmentOffset));
+}
+
+void RvFrameArena::reset()
+{
+	head = 0;
+	if (overflow == nullptr)
+	{
+		return;
+	}
+
+	while (overflow != nullptr)
+	{
+		RvOverflowBlock* next = overflow->next;
+		::operator delete(overflow);
+		overflow = next;
+	}
+	overflowBytes = 0;
+
+	//Grow past the peak (alignment padding included) so the same frame fits next time
+	while (size < peakBytes + peakBytes / 4)
+	{
+		size *= 2;
+	}
+	delete[] memory;
+	memory = nullptr;
+}
+
+RvFrameArena& RvFrameArena::local()
+{
+	thread_local RvFrameArena arena;
+	return arena;
+}
+
+RvFrameAllocator::RvFrameAllocator(const char* name) : arena(&RvFrameArena::local()), name(name)
+{
+}
+
+RvFrameAllocator::RvFrameAllocator(RvFrameArena& arena, const char* name) : arena(&arena), name(name)
+{
+}
+
+void* RvFrameAllocator::allocate(size_t n, int)
+{
+	return arena->allocate(n);
+}
+
+void* RvFrameAllocator::allocate(size_t n, size_t alignment, size_t offset, int)
+{
+	return arena->allocate(n, alignment, offset);
+}
+
+void RvFrameAllocator::deallocate(void*, size_t)
+{
+	//Released all together on reset
+}
+
+const char* RvFrameAllocator::get_name() const
+{
+	return name;
+}
+
+void RvFrameAllocator::set_name(const char* name)
+{
+	this->name = name;
+}
+
+bool operator==(const RvFrameAllocator& a, const RvFrameAllocator& b)
+{
+	return a.arena == b.arena;
+}
+
+bool operator!=(const RvFrameAllocator& a, const RvFrameAllocator& b)
+{
+	return a.arena != b.arena;
+}
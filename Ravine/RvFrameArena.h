@@ -0,0 +1,101 @@
+#ifndef RV_FRAME_ARENA_H
+#define RV_FRAME_ARENA_H
+
+//EASTL Includes
+#include <eastl/vector.h>
+
+using eastl::vector;
+
+//STD Includes
+#include <cstddef>
+
+//Starting size of an arena, it grows to the peak of a frame whenever a frame overflows it
+#define RV_FRAME_ARENA_SIZE (256 * 1024)
+#define RV_FRAME_ARENA_ALIGNMENT 16
+
+/**
+ * \brief Linear allocator for data that lives until the end of the frame (or job) that made it.
+ * Allocating bumps a pointer, freeing does nothing and reset() rewinds everything at once.
+ * Requests that don't fit are served from the heap until the next reset, which then grows the arena to the peak seen,
+ * so a steady frame ends up making no heap allocations at all.
+ */
+class RvFrameArena
+{
+public:
+	explicit RvFrameArena(size_t capacity = RV_FRAME_ARENA_SIZE);
+	~RvFrameArena();
+
+	RvFrameArena(const RvFrameArena&) = delete;
+	RvFrameArena& operator=(const RvFrameArena&) = delete;
+
+	void* allocate(size_t size, size_t alignment = RV_FRAME_ARENA_ALIGNMENT, size_t alignmentOffset = 0);
+
+	template<typename T>
+	T* allocateArray(size_t count)
+	{
+		return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+	}
+
+	/**
+	 * \brief Invalidates every allocation made since the last reset.
+	 */
+	void reset();
+
+	size_t capacity() const { return size; }
+	size_t used() const { return head + overflowBytes; }
+
+	//Largest amount used between two resets
+	size_t peak() const { return peakBytes; }
+
+	/**
+	 * \brief Arena of the calling thread, the main thread resets it at frame start and workers after every job.
+	 */
+	static RvFrameArena& local();
+
+private:
+	//Heap blocks serving what didn't fit, chained through their first bytes
+	struct RvOverflowBlock
+	{
+		RvOverflowBlock* next;
+	};
+
+	char* memory = nullptr;
+	size_t size;
+	size_t head = 0;
+
+	RvOverflowBlock* overflow = nullptr;
+	size_t overflowBytes = 0;
+	size_t peakBytes = 0;
+};
+
+/**
+ * \brief EASTL allocator over a frame arena (the one of the constructing thread by default), deallocate is a no-op.
+ * Containers using it must not outlive the reset of their arena.
+ */
+class RvFrameAllocator
+{
+public:
+	explicit RvFrameAllocator(const char* name = "RvFrameAllocator");
+	explicit RvFrameAllocator(RvFrameArena& arena, const char* name = "RvFrameAllocator");
+
+	void* allocate(size_t n, int flags = 0);
+	void* allocate(size_t n, size_t alignment, size_t offset, int flags = 0);
+	void deallocate(void* p, size_t n);
+
+	const char* get_name() const;
+	void set_name(const char* name);
+
+	RvFrameArena* arena;
+
+private:
+	const char* name;
+};
+
+bool operator==(const RvFrameAllocator& a, const RvFrameAllocator& b);
+bool operator!=(const RvFrameAllocator& a, const RvFrameAllocator& b);
+
+//Scratch vector released with the frame
+template<typename T>
+using RvFrameVector = vector<T, RvFrameAllocator>;
+
+#endif
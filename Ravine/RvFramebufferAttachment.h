@@ -4,9 +4,12 @@
 //Vulkan Include
 #include "volk.h"
 
+//Ravine Includes
+#include "RvMemoryAllocator.h"
+
 struct RvFramebufferAttachment {
 	VkImage image;
-	VkDeviceMemory memory;
+	RvAllocation allocation;
 	VkImageView imageView;
 };
 
@@ -33,7 +36,7 @@ const static RvFramebufferAttachmentCreateInfo rvDefaultDepthAttachment
 	1,
 	VK_FORMAT_MAX_ENUM, //Must be defined manually
 	VK_IMAGE_TILING_OPTIMAL,
-	VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+	VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
 	VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
 	VK_IMAGE_ASPECT_DEPTH_BIT,
 	static_cast<VkImageCreateFlagBits>(0), //No ImageCreateFlag bits defined
@@ -63,7 +66,7 @@ const static RvFramebufferAttachmentCreateInfo rvDefaultColorAttachment
 	1,
 	VK_FORMAT_MAX_ENUM, //Must be defined manually
 	VK_IMAGE_TILING_OPTIMAL,
-	VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+	VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, //Sampled images can't be transient
 	VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
 	VK_IMAGE_ASPECT_COLOR_BIT,
 	static_cast<VkImageCreateFlagBits>(0), //No ImageCreateFlag bits defined
@@ -72,4 +75,12 @@ const static RvFramebufferAttachmentCreateInfo rvDefaultColorAttachment
 	{0, 0, 1} //Must be defined manually
 };
 
+/**
+ * \brief Transient attachments live within their render pass, they are never stored so they can stay in lazily allocated memory.
+ */
+inline VkAttachmentStoreOp rvAttachmentStoreOp(const RvFramebufferAttachmentCreateInfo& createInfo)
+{
+	return createInfo.usage & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT ? VK_ATTACHMENT_STORE_OP_DONT_CARE : VK_ATTACHMENT_STORE_OP_STORE;
+}
+
 #endif
\ No newline at end of file
@@ -5,6 +5,7 @@
 
 //Ravine Include
 #include "RvTime.h"
+#include "RvDeletionQueue.h"
 
 //GLFW Includes
 #include <glfw/glfw3.h>
@@ -12,7 +13,7 @@
 #include "imgui_impl_glfw.h"
 
 RvGui::RvGui(RvDevice* device, RvSwapChain* swapChain, RvWindow* window, RvRenderPass* renderPass) : 
-	device(device), swapChain(swapChain), window(window), renderPass(renderPass), swapChainImagesCount(swapChain->images.size())
+	device(device), swapChain(swapChain), window(window), renderPass(renderPass), framesCount(RV_MAX_FRAMES_IN_FLIGHT)
 {
 	ImGui::CreateContext();
 	io = &ImGui::GetIO();
@@ -32,15 +33,15 @@ RvGui::~RvGui()
 	vkDestroyDescriptorSetLayout(device->handle, descriptorSetLayout, nullptr);
 
 	//Clear Buffers
-	for (size_t i = 0; i < swapChainImagesCount; i++)
+	for (size_t i = 0; i < framesCount; i++)
 	{
 		//Destroy Vertex Buffers
 		vkDestroyBuffer(device->handle, vertexBuffer[i].handle, nullptr);
-		vkFreeMemory(device->handle, vertexBuffer[i].memory, nullptr);
+		device->allocator->free(vertexBuffer[i].allocation);
 
 		//Destroy Index Buffers
 		vkDestroyBuffer(device->handle, indexBuffer[i].handle, nullptr);
-		vkFreeMemory(device->handle, indexBuffer[i].memory, nullptr);
+		device->allocator->free(indexBuffer[i].allocation);
 	}
 	vertexBuffer.clear();
 	indexBuffer.clear();
@@ -89,9 +90,8 @@ void RvGui::init(VkSampleCountFlagBits samplesCount)
 	createPushConstants(); //Create the structure that defines the push constant range
 
 	//Reset Buffers
-	swapChainImagesCount = swapChain->images.size();
-	vertexBuffer.resize(swapChainImagesCount);
-	indexBuffer.resize(swapChainImagesCount);
+	vertexBuffer.resize(framesCount);
+	indexBuffer.resize(framesCount);
 
 	//Create Cmd Buffers for drwaing
 	createCmdBuffers();
@@ -124,8 +124,8 @@ void RvGui::submitFrame()
 
 void RvGui::createCmdBuffers()
 {
-	//Resize according to swapChain size
-	cmdBuffers.resize(swapChainImagesCount);
+	//One per frame in flight
+	cmdBuffers.resize(framesCount);
 
 	//Allocate Command Buffers into Command Pool
 	VkCommandBufferAllocateInfo allocInfo = {};
@@ -269,7 +269,7 @@ void RvGui::createPushConstants()
 	pushConstantRange.offset = 0;
 }
 
-void RvGui::updateBuffers(uint32_t frameIndex)
+void RvGui::updateBuffers(uint32_t frameSlot)
 {
 	ImDrawData* imDrawData = ImGui::GetDrawData();
 
@@ -291,75 +291,61 @@ void RvGui::updateBuffers(uint32_t frameIndex)
 	}
 
 	//Compare CRC to detect changes and avoid useless updates
-	if (vtxCrc == lastVtxCrc[frameIndex])
+	if (vtxCrc == lastVtxCrc[frameSlot])
 	{
 		return;
 	}
 
-	lastVtxCrc[frameIndex] = vtxCrc;
+	lastVtxCrc[frameSlot] = vtxCrc;
 
 #pragma region Vertex Buffer
 
-	//Allocate new CPU Vertex Buffer
-	ImDrawVert* vtxRsc = new ImDrawVert[imDrawData->TotalVtxCount];
-	ImDrawVert* vtxItt = vtxRsc;
-	for (int n = 0; n < imDrawData->CmdListsCount; n++) {
-		const ImDrawList* cmd_list = imDrawData->CmdLists[n];
-		memcpy(vtxItt, cmd_list->VtxBuffer.Data, cmd_list->VtxBuffer.Size * sizeof(ImDrawVert));
-		vtxItt += cmd_list->VtxBuffer.Size;
-	}
-
 	//Recreate Buffers if allocated size is not enough
-	if(vertexBuffer[frameIndex].bufferSize < vertexBufferSize)
+	if(vertexBuffer[frameSlot].bufferSize < vertexBufferSize)
 	{
-		//Cleanup from old buffer
-		vkDestroyBuffer(device->handle, vertexBuffer[frameIndex].handle, nullptr);
-		vkFreeMemory(device->handle, vertexBuffer[frameIndex].memory, nullptr);
+		//Old buffer may still be read by a frame in flight
+		device->deletionQueue->destroyBuffer(vertexBuffer[frameSlot].handle, vertexBuffer[frameSlot].allocation);
 
 		//Create buffer on GPU
-		vertexBuffer[frameIndex] = device->createDynamicBuffer(vertexBufferSize,
+		vertexBuffer[frameSlot] = device->createDynamicBuffer(vertexBufferSize,
 			static_cast<VkBufferUsageFlagBits>(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT), VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
 	}
 
-	//Copy data to buffers
-	rvTools::copyToMemory(*device, reinterpret_cast<char*>(vtxRsc), vertexBuffer[frameIndex].memory, vertexBufferSize);
-
-	//Free-up memory
-	delete[] vtxRsc;
-#pragma endregion
-
-#pragma region Index Buffer
-	//Allocate new one
-	ImDrawIdx* idxRsc = new ImDrawIdx[imDrawData->TotalIdxCount];
-	ImDrawIdx* idxItt = idxRsc;
+	//Copy draw lists straight into the persistently mapped buffer, no CPU staging copy
+	char* vtxItt = vertexBuffer[frameSlot].allocation.mapped;
 	for (int n = 0; n < imDrawData->CmdListsCount; n++) {
 		const ImDrawList* cmd_list = imDrawData->CmdLists[n];
-		memcpy(idxItt, cmd_list->IdxBuffer.Data, cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx));
-		idxItt += cmd_list->IdxBuffer.Size;
+		memcpy(vtxItt, cmd_list->VtxBuffer.Data, cmd_list->VtxBuffer.Size * sizeof(ImDrawVert));
+		vtxItt += cmd_list->VtxBuffer.Size * sizeof(ImDrawVert);
 	}
+	device->allocator->flush(vertexBuffer[frameSlot].allocation);
+#pragma endregion
 
+#pragma region Index Buffer
 	//Recreate Buffers if allocated size is not enough
-	if(indexBuffer[frameIndex].bufferSize < indexBufferSize)
+	if(indexBuffer[frameSlot].bufferSize < indexBufferSize)
 	{
-		//Cleanup from old buffer
-		vkDestroyBuffer(device->handle, indexBuffer[frameIndex].handle, nullptr);
-		vkFreeMemory(device->handle, indexBuffer[frameIndex].memory, nullptr);
+		//Old buffer may still be read by a frame in flight
+		device->deletionQueue->destroyBuffer(indexBuffer[frameSlot].handle, indexBuffer[frameSlot].allocation);
 
 		//Create buffer on GPU
-		indexBuffer[frameIndex] = device->createDynamicBuffer(indexBufferSize,
+		indexBuffer[frameSlot] = device->createDynamicBuffer(indexBufferSize,
 			static_cast<VkBufferUsageFlagBits>(VK_BUFFER_USAGE_INDEX_BUFFER_BIT), VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
 	}
-	
-	//Copy data to buffers
-	rvTools::copyToMemory(*device, reinterpret_cast<char*>(idxRsc), indexBuffer[frameIndex].memory, indexBufferSize);
 
-	//Free-up memory
-	delete[] idxRsc;
+	//Same for indices
+	char* idxItt = indexBuffer[frameSlot].allocation.mapped;
+	for (int n = 0; n < imDrawData->CmdListsCount; n++) {
+		const ImDrawList* cmd_list = imDrawData->CmdLists[n];
+		memcpy(idxItt, cmd_list->IdxBuffer.Data, cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx));
+		idxItt += cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx);
+	}
+	device->allocator->flush(indexBuffer[frameSlot].allocation);
 #pragma endregion
 
 }
 
-void RvGui::recordCmdBuffers(uint32_t frameIndex)
+void RvGui::recordCmdBuffers(uint32_t frameSlot, uint32_t frameIndex)
 {
 	VkCommandBufferBeginInfo beginInfo = {};
 	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
@@ -376,24 +362,24 @@ void RvGui::recordCmdBuffers(uint32_t frameIndex)
 	beginInfo.pInheritanceInfo = &inheritanceInfo;
 
 	//Begin recording Command Buffer
-	if (vkBeginCommandBuffer(cmdBuffers[frameIndex], &beginInfo) != VK_SUCCESS) {
+	if (vkBeginCommandBuffer(cmdBuffers[frameSlot], &beginInfo) != VK_SUCCESS) {
 		throw std::runtime_error("Failed to begin recording command buffer!");
 	}
 
-	vkCmdBindDescriptorSets(cmdBuffers[frameIndex], VK_PIPELINE_BIND_POINT_GRAPHICS, guiPipeline->layout, 0, 1, &descriptorSet, 0, nullptr);
-	vkCmdBindPipeline(cmdBuffers[frameIndex], VK_PIPELINE_BIND_POINT_GRAPHICS, guiPipeline->handle);
+	vkCmdBindDescriptorSets(cmdBuffers[frameSlot], VK_PIPELINE_BIND_POINT_GRAPHICS, guiPipeline->layout, 0, 1, &descriptorSet, 0, nullptr);
+	vkCmdBindPipeline(cmdBuffers[frameSlot], VK_PIPELINE_BIND_POINT_GRAPHICS, guiPipeline->handle);
 
 	VkViewport viewport = {};
 	viewport.width = io->DisplaySize.x;
 	viewport.height = io->DisplaySize.y;
 	viewport.minDepth = 0.0f;
 	viewport.maxDepth = 1.0f;
-	vkCmdSetViewport(cmdBuffers[frameIndex], 0, 1, &viewport);
+	vkCmdSetViewport(cmdBuffers[frameSlot], 0, 1, &viewport);
 
 	//UI scale and translate via push constants
 	pushConstBlock.scale = glm::vec2(2.0f / io->DisplaySize.x, 2.0f / io->DisplaySize.y);
 	pushConstBlock.translate = glm::vec2(-1.0f);
-	vkCmdPushConstants(cmdBuffers[frameIndex], guiPipeline->layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(PushConstBlock), &pushConstBlock);
+	vkCmdPushConstants(cmdBuffers[frameSlot], guiPipeline->layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(PushConstBlock), &pushConstBlock);
 
 	//Render commands
 	ImDrawData* imDrawData = ImGui::GetDrawData();
@@ -403,8 +389,8 @@ void RvGui::recordCmdBuffers(uint32_t frameIndex)
 	if (imDrawData->CmdListsCount > 0) {
 
 		VkDeviceSize offsets[1] = { 0 };
-		vkCmdBindVertexBuffers(cmdBuffers[frameIndex], 0, 1, &vertexBuffer[frameIndex].handle, offsets);
-		vkCmdBindIndexBuffer(cmdBuffers[frameIndex], indexBuffer[frameIndex].handle, 0, VK_INDEX_TYPE_UINT16);
+		vkCmdBindVertexBuffers(cmdBuffers[frameSlot], 0, 1, &vertexBuffer[frameSlot].handle, offsets);
+		vkCmdBindIndexBuffer(cmdBuffers[frameSlot], indexBuffer[frameSlot].handle, 0, VK_INDEX_TYPE_UINT16);
 
 		for (int32_t i = 0; i < imDrawData->CmdListsCount; i++)
 		{
@@ -417,8 +403,8 @@ void RvGui::recordCmdBuffers(uint32_t frameIndex)
 				scissorRect.offset.y = eastl::max((int32_t)(pcmd->ClipRect.y), 0);
 				scissorRect.extent.width = (uint32_t)(pcmd->ClipRect.z - pcmd->ClipRect.x);
 				scissorRect.extent.height = (uint32_t)(pcmd->ClipRect.w - pcmd->ClipRect.y);
-				vkCmdSetScissor(cmdBuffers[frameIndex], 0, 1, &scissorRect);
-				vkCmdDrawIndexed(cmdBuffers[frameIndex], pcmd->ElemCount, 1, indexOffset, vertexOffset, 0);
+				vkCmdSetScissor(cmdBuffers[frameSlot], 0, 1, &scissorRect);
+				vkCmdDrawIndexed(cmdBuffers[frameSlot], pcmd->ElemCount, 1, indexOffset, vertexOffset, 0);
 				indexOffset += pcmd->ElemCount;
 			}
 			vertexOffset += cmd_list->VtxBuffer.Size;
@@ -426,7 +412,7 @@ void RvGui::recordCmdBuffers(uint32_t frameIndex)
 	}
 
 	//Stop recording Command Buffer
-	if (vkEndCommandBuffer(cmdBuffers[frameIndex]) != VK_SUCCESS) {
+	if (vkEndCommandBuffer(cmdBuffers[frameSlot]) != VK_SUCCESS) {
 		throw std::runtime_error("Failed to record command buffer!");
 	}
 }
@@ -30,8 +30,8 @@ struct RvGui
 	RvRenderPass* renderPass;
 	RvWindow* window;
 
-	//External parameters state
-	uint32_t swapChainImagesCount = 0;
+	//Buffers and command buffers exist per frame in flight, independently of the swapchain image count
+	uint32_t framesCount = 0;
 
 	//Font Attributes
 	RvTexture fontTexture;
@@ -65,8 +65,8 @@ struct RvGui
 	void init(VkSampleCountFlagBits samplesCount);
 	void acquireFrame();
 	void submitFrame();
-	void updateBuffers(uint32_t frameIndex);
-	void recordCmdBuffers(uint32_t frameIndex);
+	void updateBuffers(uint32_t frameSlot);
+	void recordCmdBuffers(uint32_t frameSlot, uint32_t frameIndex);
 
 private:
 	void createCmdBuffers();
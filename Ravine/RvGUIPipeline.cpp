@@ -20,8 +20,8 @@ RvGuiPipeline::RvGuiPipeline(RvDevice& device, VkExtent2D extent, VkSampleCountF
 	}
 
 	//Load Shaders
-	vector<char> vertShaderCode = rvTools::readFile("../data/shaders/gui.vert");
-	vector<char> fragShaderCode = rvTools::readFile("../data/shaders/gui.frag");
+	RvFileView vertShaderCode = rvTools::readFile("../data/shaders/gui.vert");
+	RvFileView fragShaderCode = rvTools::readFile("../data/shaders/gui.frag");
 	vector<char> vertexShader = rvTools::compileShaderText("Polygon Vertex Shader", vertShaderCode,
 		shaderc_vertex_shader, "main");
 	vertModule = rvTools::createShaderModule(device.handle, vertexShader);
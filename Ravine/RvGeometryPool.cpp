@@ -0,0 +1,173 @@
+#include "RvGeometryPool.h"
+
+RvGeometryPool::RvGeometryPool(RvDevice& device, size_t vertexStride, uint32_t vertexCapacity, uint32_t indexCapacity) :
+	device(&device), vertexStride(vertexStride)
+{
+	//Vulkan doesn't allow zero sized buffers
+	vertexCapacity = vertexCapacity > 0 ? vertexCapacity : 1;
+	indexCapacity = indexCapacity > 0 ? indexCapacity : 1;
+
+	vertexBuffer = device.createPersistentBuffer(vertexStride * vertexCapacity, vertexStride,
+		(VkBufferUsageFlagBits)(VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT), VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+	indexBuffer = device.createPersistentBuffer(sizeof(uint32_t) * indexCapacity, sizeof(uint32_t),
+		(VkBufferUsageFlagBits)(VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT), VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+	//Everything starts free
+	freeVertices.push_back({ 0, vertexCapacity });
+	freeIndices.push_back({ 0, indexCapacity });
+}
+
+RvGeometryPool::~RvGeometryPool()
+= default;
+
+bool RvGeometryPool::allocate(const void* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount, RvGeometryAllocation& allocation)
+{
+	RvUploadContext upload(*device);
+	const bool allocated = allocate(upload, vertices, vertexCount, indices, indexCount, allocation);
+	upload.wait();
+	return allocated;
+}
+
+bool RvGeometryPool::allocate(RvUploadContext& upload, const void* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount,
+	RvGeometryAllocation& allocation)
+{
+	if (!reserve(vertexCount, indexCount, allocation))
+	{
+		return false;
+	}
+
+	upload.uploadBuffer(vertices, vertexStride * vertexCount, vertexBuffer.handle, vertexStride * allocation.vertexOffset);
+	upload.uploadBuffer(indices, sizeof(uint32_t) * indexCount, indexBuffer.handle, sizeof(uint32_t) * allocation.firstIndex);
+	return true;
+}
+
+bool RvGeometryPool::reserve(uint32_t vertexCount, uint32_t indexCount, RvGeometryAllocation& allocation)
+{
+	uint32_t vertexOffset = 0;
+	if (!allocateRange(freeVertices, vertexCount, vertexOffset))
+	{
+		return false;
+	}
+
+	uint32_t firstIndex = 0;
+	if (!allocateRange(freeIndices, indexCount, firstIndex))
+	{
+		freeRange(freeVertices, vertexOffset, vertexCount);
+		return false;
+	}
+
+	allocation.vertexOffset = static_cast<int32_t>(vertexOffset);
+	allocation.vertexCount = vertexCount;
+	allocation.firstIndex = firstIndex;
+	allocation.indexCount = indexCount;
+	return true;
+}
+
+void RvGeometryPool::release(const RvGeometryAllocation& allocation)
+{
+	freeRange(freeVertices, static_cast<uint32_t>(allocation.vertexOffset), allocation.vertexCount);
+	freeRange(freeIndices, allocation.firstIndex, allocation.indexCount);
+}
+
+void RvGeometryPool::bind(VkCommandBuffer commandBuffer) const
+{
+	const VkDeviceSize offsets[] = { 0 };
+	vkCmdBindVertexBuffers(commandBuffer, 0, 1, &vertexBuffer.handle, offsets);
+	vkCmdBindIndexBuffer(commandBuffer, indexBuffer.handle, 0, VK_INDEX_TYPE_UINT32);
+}
+
+uint32_t RvGeometryPool::freeVertexCount() const
+{
+	uint32_t count = 0;
+	for (const RvGeometryRange& range : freeVertices)
+	{
+		count += range.count;
+	}
+	return count;
+}
+
+uint32_t RvGeometryPool::freeIndexCount() const
+{
+	uint32_t count = 0;
+	for (const RvGeometryRange& range : freeIndices)
+	{
+		count += range.count;
+	}
+	return count;
+}
+
+void RvGeometryPool::clear()
+{
+	vkDestroyBuffer(device->handle, vertexBuffer.handle, nullptr);
+	vkDestroyBuffer(device->handle, indexBuffer.handle, nullptr);
+	device->allocator->free(vertexBuffer.allocation);
+	device->allocator->free(indexBuffer.allocation);
+	freeVertices.clear();
+	freeIndices.clear();
+}
+
+bool RvGeometryPool::allocateRange(vector<RvGeometryRange>& freeRanges, uint32_t count, uint32_t& offset)
+{
+	if (count == 0)
+	{
+		offset = 0;
+		return true;
+	}
+
+	//First fit: take the front of the lowest range that is large enough
+	for (size_t i = 0; i < freeRanges.size(); i++)
+	{
+		RvGeometryRange& range = freeRanges[i];
+		if (range.count < count)
+		{
+			continue;
+		}
+
+		offset = range.offset;
+		range.offset += count;
+		range.count -= count;
+		if (range.count == 0)
+		{
+			freeRanges.erase(freeRanges.begin() + i);
+		}
+		return true;
+	}
+	return false;
+}
+
+void RvGeometryPool::freeRange(vector<RvGeometryRange>& freeRanges, uint32_t offset, uint32_t count)
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	//Find the first free range after the released one
+	size_t next = 0;
+	while (next < freeRanges.size() && freeRanges[next].offset < offset)
+	{
+		next++;
+	}
+
+	//Coalesce with the previous and/or next ranges when they touch
+	const bool mergePrevious = next > 0 && freeRanges[next - 1].offset + freeRanges[next - 1].count == offset;
+	const bool mergeNext = next < freeRanges.size() && offset + count == freeRanges[next].offset;
+	if (mergePrevious && mergeNext)
+	{
+		freeRanges[next - 1].count += count + freeRanges[next].count;
+		freeRanges.erase(freeRanges.begin() + next);
+	}
+	else if (mergePrevious)
+	{
+		freeRanges[next - 1].count += count;
+	}
+	else if (mergeNext)
+	{
+		freeRanges[next].offset = offset;
+		freeRanges[next].count += count;
+	}
+	else
+	{
+		freeRanges.insert(freeRanges.begin() + next, { offset, count });
+	}
+}
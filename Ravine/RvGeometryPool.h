@@ -0,0 +1,99 @@
+#ifndef RV_GEOMETRY_POOL_H
+#define RV_GEOMETRY_POOL_H
+
+//EASTL Includes
+#include <eastl/vector.h>
+
+using eastl::vector;
+
+//Ravine Includes
+#include "RvDevice.h"
+#include "RvPersistentBuffer.h"
+#include "RvUploadContext.h"
+
+/**
+ * \brief Contiguous run of elements (vertices or indices) inside a pool buffer.
+ */
+struct RvGeometryRange
+{
+	uint32_t offset;
+	uint32_t count;
+};
+
+/**
+ * \brief Handle to a mesh living inside a geometry pool, with the offsets to use on indexed draws.
+ */
+struct RvGeometryAllocation
+{
+	int32_t vertexOffset = 0;
+	uint32_t vertexCount = 0;
+	uint32_t firstIndex = 0;
+	uint32_t indexCount = 0;
+};
+
+/**
+ * \brief Large device local vertex and index buffers shared by every mesh of a vertex format.
+ * Meshes are sub-allocated with a first-fit free-list, so all of them draw from a single binding.
+ * Reference: https://developer.nvidia.com/vulkan-memory-management
+ */
+class RvGeometryPool
+{
+public:
+	RvGeometryPool(RvDevice& device, size_t vertexStride, uint32_t vertexCapacity, uint32_t indexCapacity);
+	~RvGeometryPool();
+
+	//Pool buffers
+	RvPersistentBuffer vertexBuffer;
+	RvPersistentBuffer indexBuffer;
+
+	/**
+	 * \brief Reserves room for a mesh and uploads its vertices (vertexStride bytes each) and indices.
+	 * \return False if there is no free range large enough for either of them.
+	 */
+	bool allocate(const void* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount, RvGeometryAllocation& allocation);
+
+	/**
+	 * \brief Same as above with the copies recorded into an upload context, so many meshes are uploaded by one submission.
+	 */
+	bool allocate(RvUploadContext& upload, const void* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount,
+		RvGeometryAllocation& allocation);
+
+	/**
+	 * \brief Reserves room for a mesh without uploading anything, the caller fills the ranges (e.g. through an upload scheduler).
+	 * \return False if there is no free range large enough for either of them.
+	 */
+	bool reserve(uint32_t vertexCount, uint32_t indexCount, RvGeometryAllocation& allocation);
+
+	/**
+	 * \brief Returns the ranges of an allocation to the pool, merging them with adjacent free ranges.
+	 * The caller must make sure no command buffer still references the mesh.
+	 */
+	void release(const RvGeometryAllocation& allocation);
+
+	/**
+	 * \brief Binds the pool vertex and index buffers, once for every mesh drawn from it.
+	 */
+	void bind(VkCommandBuffer commandBuffer) const;
+
+	//Amount of unused elements
+	uint32_t freeVertexCount() const;
+	uint32_t freeIndexCount() const;
+
+	/**
+	 * \brief Should be used instead of destroying in destructor
+	 */
+	void clear();
+
+	//Free-list helpers (ranges are kept sorted by offset)
+	static bool allocateRange(vector<RvGeometryRange>& freeRanges, uint32_t count, uint32_t& offset);
+	static void freeRange(vector<RvGeometryRange>& freeRanges, uint32_t offset, uint32_t count);
+
+private:
+	RvDevice* device;
+	size_t vertexStride;
+
+	vector<RvGeometryRange> freeVertices;
+	vector<RvGeometryRange> freeIndices;
+};
+
+#endif
@@ -0,0 +1,1055 @@
+#include "RvGltfLoader.h"
+
+//EASTL Includes
+#include <eastl/map.h>
+#include <eastl/algorithm.h>
+
+using eastl::map;
+
+//STD Includes
+#include <cctype>
+#include <cstring>
+#include <cstddef>
+
+//GLM Includes
+#include <glm/geometric.hpp>
+
+//FMT Includes
+#include <fmt/format.h>
+#include <fmt/printf.h>
+
+//Ravine Includes
+#include "RvJson.h"
+#include "RvFileSystem.h"
+
+//GLB container identifiers
+#define RV_GLB_MAGIC 0x46546C67u		//"glTF"
+#define RV_GLB_CHUNK_JSON 0x4E4F534Au	//"JSON"
+#define RV_GLB_CHUNK_BIN 0x004E4942u	//"BIN"
+
+//Accessor component types
+#define RV_GLTF_BYTE 5120
+#define RV_GLTF_UNSIGNED_BYTE 5121
+#define RV_GLTF_SHORT 5122
+#define RV_GLTF_UNSIGNED_SHORT 5123
+#define RV_GLTF_UNSIGNED_INT 5125
+#define RV_GLTF_FLOAT 5126
+
+//Primitive topologies that can be converted to triangle lists
+#define RV_GLTF_TRIANGLES 4
+#define RV_GLTF_TRIANGLE_STRIP 5
+#define RV_GLTF_TRIANGLE_FAN 6
+
+//Animation keys are stored in milliseconds, as the Assimp glTF importer does
+#define RV_GLTF_TICKS_PER_SECOND 1000.0
+
+#pragma region Import Helpers
+
+namespace
+{
+	//Strided view of an accessor inside a buffer
+	struct RvGltfAccessor
+	{
+		const char* data = nullptr;
+		uint32_t count = 0;
+		uint32_t stride = 0;
+		uint32_t componentType = 0;
+		uint32_t componentsCount = 0;
+		bool normalized = false;
+	};
+
+	struct RvGltfBuffer
+	{
+		const char* data = nullptr;
+		size_t size = 0;
+	};
+
+	uint32_t componentSize(uint32_t componentType)
+	{
+		switch (componentType)
+		{
+		case RV_GLTF_BYTE:
+		case RV_GLTF_UNSIGNED_BYTE:
+			return 1;
+		case RV_GLTF_SHORT:
+		case RV_GLTF_UNSIGNED_SHORT:
+			return 2;
+		case RV_GLTF_UNSIGNED_INT:
+		case RV_GLTF_FLOAT:
+			return 4;
+		default:
+			return 0;
+		}
+	}
+
+	uint32_t componentsCount(const char* type)
+	{
+		if (strcmp(type, "SCALAR") == 0) return 1;
+		if (strcmp(type, "VEC2") == 0) return 2;
+		if (strcmp(type, "VEC3") == 0) return 3;
+		if (strcmp(type, "VEC4") == 0) return 4;
+		if (strcmp(type, "MAT4") == 0) return 16;
+		return 0;
+	}
+
+	//Reads one component as float, normalized integers are mapped to [0, 1] or [-1, 1]
+	float readFloat(const RvGltfAccessor& accessor, uint32_t element, uint32_t component)
+	{
+		const char* src = accessor.data + static_cast<size_t>(element) * accessor.stride + component * componentSize(accessor.componentType);
+		switch (accessor.componentType)
+		{
+		case RV_GLTF_FLOAT:
+		{
+			float value;
+			memcpy(&value, src, sizeof(float));
+			return value;
+		}
+		case RV_GLTF_UNSIGNED_BYTE:
+		{
+			const uint8_t value = *reinterpret_cast<const uint8_t*>(src);
+			return accessor.normalized ? value / 255.0f : value;
+		}
+		case RV_GLTF_BYTE:
+		{
+			const int8_t value = *reinterpret_cast<const int8_t*>(src);
+			return accessor.normalized ? eastl::max(value / 127.0f, -1.0f) : value;
+		}
+		case RV_GLTF_UNSIGNED_SHORT:
+		{
+			uint16_t value;
+			memcpy(&value, src, sizeof(uint16_t));
+			return accessor.normalized ? value / 65535.0f : value;
+		}
+		case RV_GLTF_SHORT:
+		{
+			int16_t value;
+			memcpy(&value, src, sizeof(int16_t));
+			return accessor.normalized ? eastl::max(value / 32767.0f, -1.0f) : value;
+		}
+		case RV_GLTF_UNSIGNED_INT:
+		{
+			uint32_t value;
+			memcpy(&value, src, sizeof(uint32_t));
+			return static_cast<float>(value);
+		}
+		default:
+			return 0.0f;
+		}
+	}
+
+	uint32_t readUint(const RvGltfAccessor& accessor, uint32_t element, uint32_t component)
+	{
+		const char* src = accessor.data + static_cast<size_t>(element) * accessor.stride + component * componentSize(accessor.componentType);
+		switch (accessor.componentType)
+		{
+		case RV_GLTF_UNSIGNED_BYTE:
+			return *reinterpret_cast<const uint8_t*>(src);
+		case RV_GLTF_UNSIGNED_SHORT:
+		{
+			uint16_t value;
+			memcpy(&value, src, sizeof(uint16_t));
+			return value;
+		}
+		case RV_GLTF_UNSIGNED_INT:
+		{
+			uint32_t value;
+			memcpy(&value, src, sizeof(uint32_t));
+			return value;
+		}
+		default:
+			return 0;
+		}
+	}
+
+	//Copies float vectors into an interleaved layout, falling back to per-component conversion for other types
+	void copyVectors(const RvGltfAccessor& accessor, uint32_t components, char* dst, size_t dstStride)
+	{
+		if (accessor.componentType == RV_GLTF_FLOAT && accessor.componentsCount >= components)
+		{
+			const char* src = accessor.data;
+			const size_t size = components * sizeof(float);
+			for (uint32_t i = 0; i < accessor.count; i++, src += accessor.stride, dst += dstStride)
+			{
+				memcpy(dst, src, size);
+			}
+			return;
+		}
+
+		for (uint32_t i = 0; i < accessor.count; i++, dst += dstStride)
+		{
+			float* values = reinterpret_cast<float*>(dst);
+			for (uint32_t c = 0; c < components; c++)
+			{
+				values[c] = c < accessor.componentsCount ? readFloat(accessor, i, c) : 0.0f;
+			}
+		}
+	}
+
+	bool decodeBase64(const char* text, vector<char>& bytes)
+	{
+		const auto decode = [](char c) -> int
+		{
+			if (c >= 'A' && c <= 'Z') return c - 'A';
+			if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+			if (c >= '0' && c <= '9') return c - '0' + 52;
+			if (c == '+') return 62;
+			if (c == '/') return 63;
+			return -1;
+		};
+
+		uint32_t accumulator = 0;
+		uint32_t bits = 0;
+		for (; *text && *text != '='; text++)
+		{
+			const int value = decode(*text);
+			if (value < 0)
+			{
+				return false;
+			}
+			accumulator = (accumulator << 6) | value;
+			bits += 6;
+			if (bits >= 8)
+			{
+				bits -= 8;
+				bytes.push_back(static_cast<char>((accumulator >> bits) & 0xFF));
+			}
+		}
+		return true;
+	}
+
+	//glTF matrices are column-major, Assimp ones row-major
+	aiMatrix4x4 toMatrix(const float* columnMajor)
+	{
+		aiMatrix4x4 matrix;
+		for (uint32_t row = 0; row < 4; row++)
+		{
+			for (uint32_t column = 0; column < 4; column++)
+			{
+				matrix[row][column] = columnMajor[column * 4 + row];
+			}
+		}
+		return matrix;
+	}
+
+	/**
+	 * \brief State of a single glTF import: the parsed document and every buffer it references.
+	 */
+	class RvGltfImport
+	{
+	public:
+		RvJsonDocument document;
+		string directory;
+
+		RvFileView file;
+		RvGltfBuffer binaryChunk;
+		vector<RvFileView> externalBuffers;
+		vector<vector<char>> embeddedBuffers;
+		vector<RvGltfBuffer> buffers;
+
+		//Unique node names, used to bind bones and animation channels
+		vector<string> nodeNames;
+
+		bool open(const string& filePath);
+		bool loadBuffers();
+		bool resolveAccessor(uint32_t index, RvGltfAccessor& accessor) const;
+		bool resolveAccessor(const RvJsonValue& object, const char* key, RvGltfAccessor& accessor) const;
+		void nodeTransform(const RvJsonValue& node, aiVector3D& translation, aiQuaternion& rotation, aiVector3D& scale) const;
+		//Nodes must form a strict tree, visitedNodes (one flag per node) rejects any node reached twice
+		aiNode* buildNode(uint32_t index, aiNode* parent, uint32_t depth, vector<bool>& visitedNodes) const;
+
+		const RvJsonValue* array(const char* key) const
+		{
+			return document.getArray(document.root(), key);
+		}
+
+		const RvJsonValue* element(const char* key, uint32_t index) const
+		{
+			const RvJsonValue* items = array(key);
+			return items && index < items->size ? &document.at(*items, index) : nullptr;
+		}
+	};
+
+	bool RvGltfImport::open(const string& filePath)
+	{
+		file = RvFileSystem::map(filePath);
+		if (!file.isValid())
+		{
+			return false;
+		}
+
+		const size_t separator = RvFileSystem::normalizePath(filePath).find_last_of('/');
+		directory = separator == string::npos ? string() : filePath.substr(0, separator + 1);
+
+		//Binary container: header followed by a JSON chunk and an optional BIN chunk
+		const char* json = file.data();
+		size_t jsonSize = file.size();
+		uint32_t header[3];
+		if (file.size() >= sizeof(header) && memcmp(file.data(), "glTF", 4) == 0)
+		{
+			memcpy(header, file.data(), sizeof(header));
+			//The total length covers the header itself, chunks are walked within it
+			if (header[0] != RV_GLB_MAGIC || header[1] != 2 || header[2] < sizeof(header) || header[2] > file.size())
+			{
+				return false;
+			}
+
+			jsonSize = 0;
+			size_t offset = sizeof(header);
+			while (header[2] - offset >= 8)
+			{
+				uint32_t chunk[2];
+				memcpy(chunk, file.data() + offset, sizeof(chunk));
+				offset += sizeof(chunk);
+				if (chunk[0] > header[2] - offset)
+				{
+					return false;
+				}
+
+				if (chunk[1] == RV_GLB_CHUNK_JSON && jsonSize == 0)
+				{
+					json = file.data() + offset;
+					jsonSize = chunk[0];
+				}
+				else if (chunk[1] == RV_GLB_CHUNK_BIN && !binaryChunk.data)
+				{
+					binaryChunk.data = file.data() + offset;
+					binaryChunk.size = chunk[0];
+				}
+				offset += chunk[0];
+			}
+		}
+
+		return jsonSize > 0 && document.parse(json, jsonSize) && document.root().type == RV_JSON_OBJECT;
+	}
+
+	bool RvGltfImport::loadBuffers()
+	{
+		const RvJsonValue* items = array("buffers");
+		const uint32_t buffersCount = items ? items->size : 0;
+		buffers.resize(buffersCount);
+		for (uint32_t i = 0; i < buffersCount; i++)
+		{
+			const RvJsonValue& item = document.at(*items, i);
+			const size_t byteLength = static_cast<size_t>(document.getNumber(item, "byteLength", 0.0));
+			const char* uri = document.getText(item, "uri", nullptr);
+
+			RvGltfBuffer& buffer = buffers[i];
+			if (!uri)
+			{
+				//Only the first buffer of a GLB may refer to the BIN chunk
+				buffer = i == 0 ? binaryChunk : RvGltfBuffer();
+			}
+			else if (strncmp(uri, "data:", 5) == 0)
+			{
+				const char* payload = strstr(uri, ";base64,");
+				embeddedBuffers.push_back(vector<char>());
+				if (!payload || !decodeBase64(payload + 8, embeddedBuffers.back()))
+				{
+					return false;
+				}
+				buffer.data = embeddedBuffers.back().data();
+				buffer.size = embeddedBuffers.back().size();
+			}
+			else
+			{
+				//External buffers are mapped, never copied
+				externalBuffers.push_back(RvFileSystem::map(directory + uri));
+				buffer.data = externalBuffers.back().data();
+				buffer.size = externalBuffers.back().size();
+			}
+
+			if (!buffer.data || buffer.size < byteLength)
+			{
+				return false;
+			}
+		}
+
+		//Pointers into embedded buffers are only stable once every buffer was added
+		uint32_t embedded = 0;
+		for (uint32_t i = 0; i < buffersCount; i++)
+		{
+			const char* uri = document.getText(document.at(*items, i), "uri", nullptr);
+			if (uri && strncmp(uri, "data:", 5) == 0)
+			{
+				buffers[i].data = embeddedBuffers[embedded++].data();
+			}
+		}
+		return true;
+	}
+
+	bool RvGltfImport::resolveAccessor(uint32_t index, RvGltfAccessor& accessor) const
+	{
+		const RvJsonValue* item = element("accessors", index);
+		if (!item || document.find(*item, "sparse"))
+		{
+			return false;
+		}
+
+		accessor.count = static_cast<uint32_t>(document.getNumber(*item, "count", 0.0));
+		accessor.componentType = static_cast<uint32_t>(document.getNumber(*item, "componentType", 0.0));
+		accessor.componentsCount = componentsCount(document.getText(*item, "type", ""));
+		accessor.normalized = document.getBool(*item, "normalized", false);
+		const uint32_t elementSize = componentSize(accessor.componentType) * accessor.componentsCount;
+		if (elementSize == 0)
+		{
+			return false;
+		}
+
+		//Accessors without a buffer view are all zeros, which nothing here can use
+		const RvJsonValue* view = element("bufferViews", static_cast<uint32_t>(document.getNumber(*item, "bufferView", -1.0)));
+		if (!view)
+		{
+			return false;
+		}
+		const uint32_t bufferIndex = static_cast<uint32_t>(document.getNumber(*view, "buffer", -1.0));
+		if (bufferIndex >= buffers.size())
+		{
+			return false;
+		}
+
+		const size_t viewOffset = static_cast<size_t>(document.getNumber(*view, "byteOffset", 0.0));
+		const size_t viewLength = static_cast<size_t>(document.getNumber(*view, "byteLength", 0.0));
+		const size_t accessorOffset = static_cast<size_t>(document.getNumber(*item, "byteOffset", 0.0));
+		accessor.stride = static_cast<uint32_t>(document.getNumber(*view, "byteStride", elementSize));
+
+		//Whole accessor must lie inside its view, and the view inside its buffer
+		const RvGltfBuffer& buffer = buffers[bufferIndex];
+		if (viewOffset > buffer.size || viewLength > buffer.size - viewOffset || accessor.stride < elementSize ||
+			(accessor.count > 0 && accessorOffset + static_cast<size_t>(accessor.count - 1) * accessor.stride + elementSize > viewLength))
+		{
+			return false;
+		}
+
+		accessor.data = buffer.data + viewOffset + accessorOffset;
+		return true;
+	}
+
+	bool RvGltfImport::resolveAccessor(const RvJsonValue& object, const char* key, RvGltfAccessor& accessor) const
+	{
+		const RvJsonValue* index = document.find(object, key);
+		return index && index->type == RV_JSON_NUMBER && resolveAccessor(static_cast<uint32_t>(index->number), accessor);
+	}
+
+	void RvGltfImport::nodeTransform(const RvJsonValue& node, aiVector3D& translation, aiQuaternion& rotation, aiVector3D& scale) const
+	{
+		translation = aiVector3D(0.0f);
+		rotation = aiQuaternion();
+		scale = aiVector3D(1.0f);
+
+		const RvJsonValue* matrix = document.getArray(node, "matrix");
+		if (matrix && matrix->size == 16)
+		{
+			float values[16];
+			for (uint32_t i = 0; i < 16; i++)
+			{
+				values[i] = static_cast<float>(document.at(*matrix, i).number);
+			}
+			toMatrix(values).Decompose(scale, rotation, translation);
+			return;
+		}
+
+		const RvJsonValue* t = document.getArray(node, "translation");
+		if (t && t->size == 3)
+		{
+			translation = aiVector3D(float(document.at(*t, 0).number), float(document.at(*t, 1).number), float(document.at(*t, 2).number));
+		}
+		//Stored as xyzw, Assimp quaternions are constructed as wxyz
+		const RvJsonValue* r = document.getArray(node, "rotation");
+		if (r && r->size == 4)
+		{
+			rotation = aiQuaternion(float(document.at(*r, 3).number), float(document.at(*r, 0).number), float(document.at(*r, 1).number), float(document.at(*r, 2).number));
+		}
+		const RvJsonValue* s = document.getArray(node, "scale");
+		if (s && s->size == 3)
+		{
+			scale = aiVector3D(float(document.at(*s, 0).number), float(document.at(*s, 1).number), float(document.at(*s, 2).number));
+		}
+	}
+
+	aiNode* RvGltfImport::buildNode(uint32_t index, aiNode* parent, uint32_t depth, vector<bool>& visitedNodes) const
+	{
+		//Shared children would be expanded once per path (and duplicate the names bones bind to), cycles never end
+		const RvJsonValue* item = element("nodes", index);
+		if (!item || depth > 256 || visitedNodes[index])
+		{
+			return nullptr;
+		}
+		visitedNodes[index] = true;
+
+		aiNode* node = new aiNode();
+		node->mName.Set(nodeNames[index].c_str());
+		node->mParent = parent;
+
+		aiVector3D translation, scale;
+		aiQuaternion rotation;
+		nodeTransform(*item, translation, rotation, scale);
+		node->mTransformation = aiMatrix4x4(scale, rotation, translation);
+
+		const RvJsonValue* childrenIndices = document.getArray(*item, "children");
+		if (childrenIndices && childrenIndices->size > 0)
+		{
+			node->mChildren = new aiNode*[childrenIndices->size]{};
+			for (uint32_t i = 0; i < childrenIndices->size; i++)
+			{
+				aiNode* child = buildNode(static_cast<uint32_t>(document.at(*childrenIndices, i).number), node, depth + 1, visitedNodes);
+				if (!child)
+				{
+					delete node;
+					return nullptr;
+				}
+				node->mChildren[node->mNumChildren++] = child;
+			}
+		}
+		return node;
+	}
+
+	//Converts one triangle primitive into the engine vertex layout, only requested streams (RvVertexAttributeBits) are read
+	bool convertPrimitive(const RvGltfImport& gltf, const RvJsonValue& primitive, uint32_t vertexAttributes, RvSkinnedMeshColored& mesh)
+	{
+		const RvJsonDocument& document = gltf.document;
+		const RvJsonValue* attributes = document.getObject(primitive, "attributes");
+		RvGltfAccessor positions;
+		if (!attributes || !gltf.resolveAccessor(*attributes, "POSITION", positions) || positions.componentsCount != 3)
+		{
+			return false;
+		}
+
+		//Defaults match the Assimp conversion (white, no UVs, bone data cleared)
+		const uint32_t vertexCount = positions.count;
+		mesh.vertexCount = vertexCount;
+		mesh.vertices = new RvSkinnedVertexColored[vertexCount];
+		for (uint32_t v = 0; v < vertexCount; v++)
+		{
+			RvSkinnedVertexColored& vertex = mesh.vertices[v];
+			vertex.color = { 1, 1, 1 };
+			vertex.texCoord = { 0, 0 };
+			vertex.normal = { 0, 0, 0 };
+			vertex.boneIDs = glm::uvec4(0);
+			vertex.boneWeights = glm::vec4(0.0f);
+		}
+
+		char* base = reinterpret_cast<char*>(mesh.vertices);
+		const size_t stride = sizeof(RvSkinnedVertexColored);
+		copyVectors(positions, 3, base + offsetof(RvSkinnedVertexColored, pos), stride);
+
+		RvGltfAccessor stream;
+		const bool wantsNormals = (vertexAttributes & RV_VERTEX_ATTRIBUTE_NORMAL) != 0;
+		const bool hasNormals = wantsNormals && gltf.resolveAccessor(*attributes, "NORMAL", stream) && stream.count == vertexCount;
+		if (hasNormals)
+		{
+			copyVectors(stream, 3, base + offsetof(RvSkinnedVertexColored, normal), stride);
+		}
+		if ((vertexAttributes & RV_VERTEX_ATTRIBUTE_COLOR) && gltf.resolveAccessor(*attributes, "COLOR_0", stream) && stream.count == vertexCount)
+		{
+			copyVectors(stream, 3, base + offsetof(RvSkinnedVertexColored, color), stride);
+		}
+		if ((vertexAttributes & RV_VERTEX_ATTRIBUTE_UV) && gltf.resolveAccessor(*attributes, "TEXCOORD_0", stream) && stream.count == vertexCount)
+		{
+			copyVectors(stream, 2, base + offsetof(RvSkinnedVertexColored, texCoord), stride);
+
+			//glTF UVs start at the top-left corner, images are flipped on load like the Assimp route expects
+			for (uint32_t v = 0; v < vertexCount; v++)
+			{
+				mesh.vertices[v].texCoord.y = 1.0f - mesh.vertices[v].texCoord.y;
+			}
+		}
+
+		//Topology is converted to a triangle list
+		const uint32_t mode = static_cast<uint32_t>(document.getNumber(primitive, "mode", RV_GLTF_TRIANGLES));
+		RvGltfAccessor indicesAccessor;
+		const bool indexed = document.find(primitive, "indices") != nullptr;
+		if (indexed && (!gltf.resolveAccessor(primitive, "indices", indicesAccessor) || indicesAccessor.componentsCount != 1))
+		{
+			return false;
+		}
+		const uint32_t sourceCount = indexed ? indicesAccessor.count : vertexCount;
+		vector<uint32_t> source(sourceCount);
+		if (!indexed)
+		{
+			for (uint32_t i = 0; i < sourceCount; i++)
+			{
+				source[i] = i;
+			}
+		}
+		else if (indicesAccessor.componentType == RV_GLTF_UNSIGNED_INT && indicesAccessor.stride == sizeof(uint32_t))
+		{
+			memcpy(source.data(), indicesAccessor.data, sizeof(uint32_t) * sourceCount);
+		}
+		else
+		{
+			for (uint32_t i = 0; i < sourceCount; i++)
+			{
+				source[i] = readUint(indicesAccessor, i, 0);
+			}
+		}
+
+		vector<uint32_t> triangles;
+		if (mode == RV_GLTF_TRIANGLES)
+		{
+			triangles.assign(source.begin(), source.begin() + sourceCount / 3 * 3);
+		}
+		else if (mode == RV_GLTF_TRIANGLE_STRIP)
+		{
+			//Every other triangle is flipped to keep the winding
+			for (uint32_t i = 2; i < sourceCount; i++)
+			{
+				const bool odd = (i & 1) != 0;
+				triangles.push_back(source[i - 2]);
+				triangles.push_back(odd ? source[i] : source[i - 1]);
+				triangles.push_back(odd ? source[i - 1] : source[i]);
+			}
+		}
+		else if (mode == RV_GLTF_TRIANGLE_FAN)
+		{
+			for (uint32_t i = 2; i < sourceCount; i++)
+			{
+				triangles.push_back(source[i - 1]);
+				triangles.push_back(source[i]);
+				triangles.push_back(source[0]);
+			}
+		}
+
+		for (uint32_t index : triangles)
+		{
+			if (index >= vertexCount)
+			{
+				return false;
+			}
+		}
+		mesh.indexCount = static_cast<uint32_t>(triangles.size());
+		mesh.indices = new uint32_t[mesh.indexCount];
+		memcpy(mesh.indices, triangles.data(), sizeof(uint32_t) * mesh.indexCount);
+
+		//Area weighted smooth normals, as Assimp's GenNormals step would do
+		if (wantsNormals && !hasNormals)
+		{
+			for (uint32_t t = 0; t + 2 < mesh.indexCount; t += 3)
+			{
+				RvSkinnedVertexColored& a = mesh.vertices[mesh.indices[t + 0]];
+				RvSkinnedVertexColored& b = mesh.vertices[mesh.indices[t + 1]];
+				RvSkinnedVertexColored& c = mesh.vertices[mesh.indices[t + 2]];
+				const glm::vec3 faceNormal = glm::cross(b.pos - a.pos, c.pos - a.pos);
+				a.normal += faceNormal;
+				b.normal += faceNormal;
+				c.normal += faceNormal;
+			}
+			for (uint32_t v = 0; v < vertexCount; v++)
+			{
+				const float length = glm::length(mesh.vertices[v].normal);
+				mesh.vertices[v].normal = length > 0.0f ? mesh.vertices[v].normal / length : glm::vec3(0.0f);
+			}
+		}
+
+		return true;
+	}
+
+	//Writes influences of a skinned primitive, joints are remapped to scene-wide bone ids
+	bool convertSkinning(const RvGltfImport& gltf, const RvJsonValue& primitive, const vector<uint16_t>& jointBones, RvSkinnedMeshColored& mesh)
+	{
+		const RvJsonValue* attributes = gltf.document.getObject(primitive, "attributes");
+		RvGltfAccessor joints, weights;
+		if (!gltf.resolveAccessor(*attributes, "JOINTS_0", joints) || !gltf.resolveAccessor(*attributes, "WEIGHTS_0", weights))
+		{
+			//Not skinned
+			return true;
+		}
+		if (joints.count != mesh.vertexCount || weights.count != mesh.vertexCount || joints.componentsCount != 4 || weights.componentsCount != 4)
+		{
+			return false;
+		}
+
+		for (uint32_t v = 0; v < mesh.vertexCount; v++)
+		{
+			for (uint32_t c = 0; c < 4; c++)
+			{
+				const float weight = readFloat(weights, v, c);
+				const uint32_t joint = readUint(joints, v, c);
+				if (weight <= 0.0f)
+				{
+					continue;
+				}
+				if (joint >= jointBones.size())
+				{
+					return false;
+				}
+				mesh.vertices[v].AddBoneData(jointBones[joint], weight);
+			}
+		}
+		return true;
+	}
+
+	template<typename KeyType>
+	KeyType* restKey(const typename KeyType::elem_type& value)
+	{
+		KeyType* key = new KeyType[1];
+		key[0].mTime = 0.0;
+		key[0].mValue = value;
+		return key;
+	}
+
+	aiAnimation* convertAnimation(const RvGltfImport& gltf, const RvJsonValue& item, uint32_t animationIndex)
+	{
+		const RvJsonDocument& document = gltf.document;
+		const RvJsonValue* channels = document.getArray(item, "channels");
+		const RvJsonValue* samplers = document.getArray(item, "samplers");
+		if (!channels || !samplers)
+		{
+			return nullptr;
+		}
+
+		aiAnimation* animation = new aiAnimation();
+		const char* name = document.getText(item, "name", "");
+		animation->mName.Set(*name ? string(name).c_str() : fmt::format("animation_{0}", animationIndex).c_str());
+		animation->mTicksPerSecond = RV_GLTF_TICKS_PER_SECOND;
+
+		//Channels targeting the same node are merged into one aiNodeAnim
+		map<uint32_t, aiNodeAnim*> nodeChannels;
+		for (uint32_t c = 0; c < channels->size; c++)
+		{
+			const RvJsonValue& channel = document.at(*channels, c);
+			const RvJsonValue* target = document.getObject(channel, "target");
+			const uint32_t samplerIndex = static_cast<uint32_t>(document.getNumber(channel, "sampler", -1.0));
+			if (!target || samplerIndex >= samplers->size)
+			{
+				continue;
+			}
+
+			const uint32_t nodeIndex = static_cast<uint32_t>(document.getNumber(*target, "node", -1.0));
+			const char* path = document.getText(*target, "path", "");
+			const bool isTranslation = strcmp(path, "translation") == 0;
+			const bool isRotation = strcmp(path, "rotation") == 0;
+			const bool isScale = strcmp(path, "scale") == 0;
+
+			//Morph target weights have no runtime counterpart
+			if (nodeIndex >= gltf.nodeNames.size() || !(isTranslation || isRotation || isScale))
+			{
+				continue;
+			}
+
+			const RvJsonValue& sampler = document.at(*samplers, samplerIndex);
+			RvGltfAccessor input, output;
+			if (!gltf.resolveAccessor(sampler, "input", input) || !gltf.resolveAccessor(sampler, "output", output) || input.count == 0)
+			{
+				continue;
+			}
+
+			//Cubic splines store in-tangent, value and out-tangent per key, only values are kept (STEP is sampled linearly)
+			const bool cubic = strcmp(document.getText(sampler, "interpolation", "LINEAR"), "CUBICSPLINE") == 0;
+			const uint32_t valuesPerKey = cubic ? 3 : 1;
+			const uint32_t valueOffset = cubic ? 1 : 0;
+			if (output.count < input.count * valuesPerKey || output.componentsCount != (isRotation ? 4u : 3u))
+			{
+				continue;
+			}
+
+			aiNodeAnim*& nodeAnim = nodeChannels[nodeIndex];
+			if (!nodeAnim)
+			{
+				nodeAnim = new aiNodeAnim();
+				nodeAnim->mNodeName.Set(gltf.nodeNames[nodeIndex].c_str());
+			}
+
+			const uint32_t keysCount = input.count;
+			for (uint32_t k = 0; k < keysCount; k++)
+			{
+				animation->mDuration = eastl::max(animation->mDuration, readFloat(input, k, 0) * RV_GLTF_TICKS_PER_SECOND);
+			}
+
+			if (isRotation && !nodeAnim->mRotationKeys)
+			{
+				nodeAnim->mNumRotationKeys = keysCount;
+				nodeAnim->mRotationKeys = new aiQuatKey[keysCount];
+				for (uint32_t k = 0; k < keysCount; k++)
+				{
+					const uint32_t v = k * valuesPerKey + valueOffset;
+					nodeAnim->mRotationKeys[k].mTime = readFloat(input, k, 0) * RV_GLTF_TICKS_PER_SECOND;
+					nodeAnim->mRotationKeys[k].mValue = aiQuaternion(readFloat(output, v, 3), readFloat(output, v, 0), readFloat(output, v, 1), readFloat(output, v, 2));
+				}
+			}
+			else if ((isTranslation && !nodeAnim->mPositionKeys) || (isScale && !nodeAnim->mScalingKeys))
+			{
+				aiVectorKey* keys = new aiVectorKey[keysCount];
+				for (uint32_t k = 0; k < keysCount; k++)
+				{
+					const uint32_t v = k * valuesPerKey + valueOffset;
+					keys[k].mTime = readFloat(input, k, 0) * RV_GLTF_TICKS_PER_SECOND;
+					keys[k].mValue = aiVector3D(readFloat(output, v, 0), readFloat(output, v, 1), readFloat(output, v, 2));
+				}
+				(isTranslation ? nodeAnim->mPositionKeys : nodeAnim->mScalingKeys) = keys;
+				(isTranslation ? nodeAnim->mNumPositionKeys : nodeAnim->mNumScalingKeys) = keysCount;
+			}
+		}
+
+		animation->mNumChannels = static_cast<uint32_t>(nodeChannels.size());
+		animation->mChannels = new aiNodeAnim*[animation->mNumChannels];
+		uint32_t channelIndex = 0;
+		for (auto& nodeChannel : nodeChannels)
+		{
+			//Interpolation expects every track to have keys, missing ones hold the node rest pose
+			aiNodeAnim* nodeAnim = nodeChannel.second;
+			aiVector3D translation, scale;
+			aiQuaternion rotation;
+			gltf.nodeTransform(document.at(*gltf.array("nodes"), nodeChannel.first), translation, rotation, scale);
+			if (!nodeAnim->mPositionKeys)
+			{
+				nodeAnim->mNumPositionKeys = 1;
+				nodeAnim->mPositionKeys = restKey<aiVectorKey>(translation);
+			}
+			if (!nodeAnim->mRotationKeys)
+			{
+				nodeAnim->mNumRotationKeys = 1;
+				nodeAnim->mRotationKeys = restKey<aiQuatKey>(rotation);
+			}
+			if (!nodeAnim->mScalingKeys)
+			{
+				nodeAnim->mNumScalingKeys = 1;
+				nodeAnim->mScalingKeys = restKey<aiVectorKey>(scale);
+			}
+			animation->mChannels[channelIndex++] = nodeAnim;
+		}
+
+		return animation;
+	}
+
+	//Frees meshes of a failed load, before the hierarchy and animations are attached
+	bool discardMeshes(RvSkinnedMeshColored*& meshes, uint32_t& meshesCount)
+	{
+		for (uint32_t i = 0; i < meshesCount; i++)
+		{
+			delete[] meshes[i].vertices;
+			delete[] meshes[i].indices;
+			delete[] meshes[i].textureIds;
+		}
+		delete[] meshes;
+		meshes = nullptr;
+		meshesCount = 0;
+		return false;
+	}
+}
+
+#pragma endregion
+
+bool RvGltfLoader::isGltf(const string& filePath)
+{
+	const size_t extension = filePath.find_last_of('.');
+	if (extension == string::npos)
+	{
+		return false;
+	}
+
+	string suffix = filePath.substr(extension + 1);
+	for (char& c : suffix)
+	{
+		c = static_cast<char>(tolower(c));
+	}
+	return suffix == "gltf" || suffix == "glb";
+}
+
+bool RvGltfLoader::load(const string& filePath, const RvImportProfile& profile, RvSkinnedMeshColored*& meshes, uint32_t& meshesCount,
+	vector<string>& texturePaths, RvImportTimer& timer)
+{
+	RvGltfImport gltf;
+	if (!gltf.open(filePath) || !gltf.loadBuffers())
+	{
+		fmt::print(stderr, "Failed to read glTF file {0}!\n", filePath.c_str());
+		return false;
+	}
+	const RvJsonDocument& document = gltf.document;
+	timer.lap("Read and parse");
+
+	//Unnamed or repeated node names are made unique, bones and channels are bound by name
+	const RvJsonValue* nodes = gltf.array("nodes");
+	const uint32_t nodesCount = nodes ? nodes->size : 0;
+	gltf.nodeNames.resize(nodesCount);
+	map<string, uint32_t> usedNames;
+	for (uint32_t n = 0; n < nodesCount; n++)
+	{
+		string name = document.getText(document.at(*nodes, n), "name", "");
+		if (name.empty())
+		{
+			name = fmt::format("node_{0}", n).c_str();
+		}
+		else if (usedNames.find(name) != usedNames.end())
+		{
+			name += fmt::format("_{0}", n).c_str();
+		}
+		usedNames[name] = n;
+		gltf.nodeNames[n] = name;
+	}
+
+	//Skins are bound to meshes through the nodes that instance them
+	const RvJsonValue* meshItems = gltf.array("meshes");
+	const uint32_t meshItemsCount = meshItems ? meshItems->size : 0;
+	vector<int32_t> meshSkins(meshItemsCount, -1);
+	for (uint32_t n = 0; n < nodesCount; n++)
+	{
+		const RvJsonValue& node = document.at(*nodes, n);
+		const uint32_t meshIndex = static_cast<uint32_t>(document.getNumber(node, "mesh", -1.0));
+		const int32_t skinIndex = static_cast<int32_t>(document.getNumber(node, "skin", -1.0));
+		if (meshIndex < meshItemsCount && meshSkins[meshIndex] < 0)
+		{
+			meshSkins[meshIndex] = skinIndex;
+		}
+	}
+
+	//One engine mesh per primitive, as Assimp splits them
+	meshesCount = 0;
+	for (uint32_t m = 0; m < meshItemsCount; m++)
+	{
+		const RvJsonValue* primitives = document.getArray(document.at(*meshItems, m), "primitives");
+		meshesCount += primitives ? primitives->size : 0;
+	}
+	if (meshesCount == 0)
+	{
+		fmt::print(stderr, "glTF file {0} has no meshes!\n", filePath.c_str());
+		return false;
+	}
+	meshes = new RvSkinnedMeshColored[meshesCount]{};
+
+	//Bones are registered scene-wide on the first mesh, as the animation runtime reads them from there
+	const RvJsonValue* skins = (profile.vertexAttributes & RV_VERTEX_ATTRIBUTE_BONES) ? gltf.array("skins") : nullptr;
+	const uint32_t skinsCount = skins ? skins->size : 0;
+	vector<vector<uint16_t>> skinBones(skinsCount);
+	for (uint32_t s = 0; s < skinsCount; s++)
+	{
+		const RvJsonValue& skin = document.at(*skins, s);
+		const RvJsonValue* joints = document.getArray(skin, "joints");
+		RvGltfAccessor inverseBindMatrices;
+		const bool hasInverseBinds = gltf.resolveAccessor(skin, "inverseBindMatrices", inverseBindMatrices) &&
+			inverseBindMatrices.componentsCount == 16 && inverseBindMatrices.componentType == RV_GLTF_FLOAT;
+		for (uint32_t j = 0; joints && j < joints->size; j++)
+		{
+			const uint32_t nodeIndex = static_cast<uint32_t>(document.at(*joints, j).number);
+			if (nodeIndex >= nodesCount)
+			{
+				fmt::print(stderr, "Invalid joint in glTF file {0}!\n", filePath.c_str());
+				return discardMeshes(meshes, meshesCount);
+			}
+
+			const string& boneName = gltf.nodeNames[nodeIndex];
+			uint16_t boneIndex;
+			auto mapped = meshes[0].boneMapping.find(boneName);
+			if (mapped == meshes[0].boneMapping.end())
+			{
+				boneIndex = meshes[0].numBones++;
+				meshes[0].boneMapping[boneName] = boneIndex;
+				meshes[0].boneInfo.push_back(RvBoneInfo());
+			}
+			else
+			{
+				boneIndex = mapped->second;
+			}
+
+			if (hasInverseBinds && j < inverseBindMatrices.count)
+			{
+				float values[16];
+				memcpy(values, inverseBindMatrices.data + static_cast<size_t>(j) * inverseBindMatrices.stride, sizeof(values));
+				meshes[0].boneInfo[boneIndex].BoneOffset = toMatrix(values);
+			}
+			skinBones[s].push_back(boneIndex);
+		}
+	}
+
+	timer.lap("Skins");
+
+	//Geometry and base color textures
+	const RvJsonValue* materials = profile.loadMaterials ? gltf.array("materials") : nullptr;
+	uint32_t meshIndex = 0;
+	for (uint32_t m = 0; m < meshItemsCount; m++)
+	{
+		const RvJsonValue* primitives = document.getArray(document.at(*meshItems, m), "primitives");
+		for (uint32_t p = 0; primitives && p < primitives->size; p++, meshIndex++)
+		{
+			const RvJsonValue& primitive = document.at(*primitives, p);
+			RvSkinnedMeshColored& mesh = meshes[meshIndex];
+			mesh.animGlobalInverseTransform = aiMatrix4x4();
+			if (!convertPrimitive(gltf, primitive, profile.vertexAttributes, mesh))
+			{
+				fmt::print(stderr, "Unsupported primitive {0} of mesh {1} in glTF file {2}!\n", p, m, filePath.c_str());
+				return discardMeshes(meshes, meshesCount);
+			}
+
+			const int32_t skinIndex = meshSkins[m];
+			if (skinIndex >= 0 && static_cast<uint32_t>(skinIndex) < skinsCount)
+			{
+				if (!convertSkinning(gltf, primitive, skinBones[skinIndex], mesh))
+				{
+					fmt::print(stderr, "Invalid skinning data in glTF file {0}!\n", filePath.c_str());
+					return discardMeshes(meshes, meshesCount);
+				}
+				for (uint16_t boneIndex : skinBones[skinIndex])
+				{
+					for (auto& bone : meshes[0].boneMapping)
+					{
+						if (bone.second == boneIndex)
+						{
+							mesh.boneMapping[bone.first] = boneIndex;
+						}
+					}
+				}
+			}
+
+			//Embedded images (no uri) are left to the missing texture
+			mesh.texturesCount = 0;
+			mesh.textureIds = new uint32_t[1];
+			const uint32_t materialIndex = static_cast<uint32_t>(document.getNumber(primitive, "material", -1.0));
+			const RvJsonValue* material = materials && materialIndex < materials->size ? &document.at(*materials, materialIndex) : nullptr;
+			const RvJsonValue* pbr = material ? document.getObject(*material, "pbrMetallicRoughness") : nullptr;
+			const RvJsonValue* baseColor = pbr ? document.getObject(*pbr, "baseColorTexture") : nullptr;
+			const RvJsonValue* texture = baseColor ? gltf.element("textures", static_cast<uint32_t>(document.getNumber(*baseColor, "index", -1.0))) : nullptr;
+			const RvJsonValue* image = texture ? gltf.element("images", static_cast<uint32_t>(document.getNumber(*texture, "source", -1.0))) : nullptr;
+			const char* uri = image ? document.getText(*image, "uri", nullptr) : nullptr;
+			if (uri && strncmp(uri, "data:", 5) != 0)
+			{
+				const string texPath = uri;
+				auto listed = eastl::find(texturePaths.begin(), texturePaths.end(), texPath);
+				mesh.textureIds[0] = static_cast<uint32_t>(listed - texturePaths.begin());
+				mesh.texturesCount = 1;
+				if (listed == texturePaths.end())
+				{
+					texturePaths.push_back(texPath);
+				}
+			}
+		}
+	}
+
+	timer.lap("Primitives");
+
+	//Scene roots are parented to an identity root, like Assimp does
+	aiNode* rootNode = new aiNode();
+	rootNode->mName.Set("RootNode");
+	const RvJsonValue* scene = gltf.element("scenes", static_cast<uint32_t>(document.getNumber(document.root(), "scene", 0.0)));
+	const RvJsonValue* roots = scene ? document.getArray(*scene, "nodes") : nullptr;
+	if (roots && roots->size > 0)
+	{
+		rootNode->mChildren = new aiNode*[roots->size]{};
+		vector<bool> visitedNodes(nodesCount, false);
+		for (uint32_t r = 0; r < roots->size; r++)
+		{
+			aiNode* child = gltf.buildNode(static_cast<uint32_t>(document.at(*roots, r).number), rootNode, 0, visitedNodes);
+			if (!child)
+			{
+				fmt::print(stderr, "Invalid node hierarchy in glTF file {0}!\n", filePath.c_str());
+				delete rootNode;
+				return discardMeshes(meshes, meshesCount);
+			}
+			rootNode->mChildren[rootNode->mNumChildren++] = child;
+		}
+	}
+	meshes[0].rootNode = rootNode;
+	timer.lap("Nodes");
+
+	const RvJsonValue* animations = profile.loadAnimations ? gltf.array("animations") : nullptr;
+	for (uint32_t a = 0; animations && a < animations->size; a++)
+	{
+		aiAnimation* animation = convertAnimation(gltf, document.at(*animations, a), a);
+		if (animation)
+		{
+			meshes[0].animations.push_back(new RvAnimation({ animation }));
+		}
+	}
+	meshes[0].curAnimId = 0;
+	timer.lap("Animations");
+
+	return true;
+}
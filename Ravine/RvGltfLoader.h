@@ -0,0 +1,42 @@
+#ifndef RV_GLTF_LOADER_H
+#define RV_GLTF_LOADER_H
+
+//EASTL Includes
+#include <eastl/vector.h>
+#include <eastl/string.h>
+
+using eastl::vector;
+using eastl::string;
+
+//Ravine Includes
+#include "RvDataTypes.h"
+#include "RvImportProfile.h"
+
+/**
+ * \brief Native glTF 2.0 (.gltf and .glb) loader, reads accessors straight from mapped buffers without going through Assimp.
+ * Produces the same runtime data as the Assimp import: one mesh per primitive, aiNode hierarchy, bone offsets and aiAnimation keys.
+ */
+class RvGltfLoader
+{
+public:
+
+	/**
+	 * \brief Whether the file should take the glTF path (by extension).
+	 */
+	static bool isGltf(const string& filePath);
+
+	/**
+	 * \brief Loads every mesh primitive with the streams, base color texture, skins and animations the profile asks for.
+	 * \param texturePaths Receives base color image paths relative to the file, meshes hold ids into it.
+	 * \param timer Receives the time taken by each loading step.
+	 * \return False if the file is malformed or uses unsupported features (sparse accessors, embedded images are skipped).
+	 */
+	static bool load(const string& filePath, const RvImportProfile& profile, RvSkinnedMeshColored*& meshes, uint32_t& meshesCount,
+		vector<string>& texturePaths, RvImportTimer& timer);
+
+private:
+	RvGltfLoader();
+	~RvGltfLoader();
+};
+
+#endif
@@ -144,12 +144,12 @@ RvGraphicsPipeline* RvGraphicsPipeline::defaultGraphicsPipeline(RvDevice& device
 		defaultPipeline->renderPass = renderPass;
 		
 		//ShaderModules
-		vector<char> vertexCode = rvTools::readFile("../data/shaders/skinned_tex_color.vert");
+		RvFileView vertexCode = rvTools::readFile("../data/shaders/skinned_tex_color.vert");
 		vector<char> vertexShader = rvTools::compileShaderText("Polygon Vertex Shader", vertexCode,
 			shaderc_shader_kind::shaderc_vertex_shader, "main");
 		VkShaderModule vertexModule = rvTools::createShaderModule(device.handle, vertexShader);
 		defaultPipeline->attachShader(VK_SHADER_STAGE_VERTEX_BIT, &vertexModule, "main");
-		vector<char> fragmentCode = rvTools::readFile("../data/shaders/phong_tex_color.frag");
+		RvFileView fragmentCode = rvTools::readFile("../data/shaders/phong_tex_color.frag");
 		vector<char> fragmentShader = rvTools::compileShaderText("Polygon Fragment Shader", fragmentCode,
 			shaderc_shader_kind::shaderc_fragment_shader, "main");
 		VkShaderModule fragModule = rvTools::createShaderModule(device.handle, fragmentShader);
@@ -166,14 +166,14 @@ VkPipelineCache RvGraphicsPipeline::defaultPipelineCache(RvDevice& device)
 		VkPipelineCacheCreateInfo cacheCreateInfo = {};
 		cacheCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
 
-		//Try loading cache from disk
-		try
+		//Try loading cache from disk (the mapping must outlive the cache creation)
+		const RvFileView data = RvFileSystem::map("../data/cache/default.pipeline");
+		if (data.isValid())
 		{
-			vector<char> data = rvTools::readFile("..\data\cache\default.pipeline");
 			cacheCreateInfo.initialDataSize = data.size();
 			cacheCreateInfo.pInitialData = data.data();
 		}
-		catch (std::exception exc)
+		else
 		{
 			fmt::print(stdout, "No default PipelineCache file found, creating new one...");
 		}
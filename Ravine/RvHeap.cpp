@@ -0,0 +1,320 @@
+#include "RvHeap.h"
+
+//STD Includes
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+
+//FMT Includes
+#include <fmt/printf.h>
+
+namespace
+{
+	//Block sizes, header included (multiples of the header size so every block stays aligned)
+	const size_t sizeClasses[] = { 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024 };
+	const uint32_t sizeClassCount = sizeof(sizeClasses) / sizeof(sizeClasses[0]);
+	const uint8_t largeBlock = UINT8_MAX;
+
+	const char* categoryNames[RV_HEAP_CATEGORY_COUNT] = { "General", "Animation", "Assets", "GUI", "Renderer" };
+
+	//Stored right before every block handed out, copied with memcpy since offset alignments may leave it unaligned
+	struct RvHeapHeader
+	{
+		uint64_t size;
+		//Distance from the malloc'd address (large blocks only)
+		uint32_t offset;
+		uint8_t sizeClass;
+		uint8_t category;
+		uint16_t padding;
+	};
+	static_assert(sizeof(RvHeapHeader) == RV_HEAP_HEADER_SIZE, "Heap header must fill the reserved bytes");
+
+	struct RvFreeBlock
+	{
+		RvFreeBlock* next;
+	};
+
+	//Shared pools, leaked on purpose so blocks can still be freed during static destruction
+	struct RvHeapPools
+	{
+		std::mutex mutex;
+		RvFreeBlock* freeLists[sizeClassCount] = {};
+	};
+
+	RvHeapPools& pools()
+	{
+		static RvHeapPools* instance = new RvHeapPools();
+		return *instance;
+	}
+
+	//Trivial so it stays usable while the thread is being torn down
+	struct RvHeapCache
+	{
+		RvFreeBlock* freeLists[sizeClassCount];
+		uint32_t counts[sizeClassCount];
+		bool bypass;
+	};
+	thread_local RvHeapCache cache;
+	thread_local RvHeapCategory threadCategory = RV_HEAP_GENERAL;
+
+	//Gives the cached blocks back when the thread exits, later frees go straight to the shared pools
+	struct RvHeapCacheOwner
+	{
+		void acquire() {}
+
+		~RvHeapCacheOwner()
+		{
+			std::lock_guard<std::mutex> lock(pools().mutex);
+			for (uint32_t sizeClass = 0; sizeClass < sizeClassCount; sizeClass++)
+			{
+				while (cache.freeLists[sizeClass] != nullptr)
+				{
+					RvFreeBlock* block = cache.freeLists[sizeClass];
+					cache.freeLists[sizeClass] = block->next;
+					block->next = pools().freeLists[sizeClass];
+					pools().freeLists[sizeClass] = block;
+				}
+				cache.counts[sizeClass] = 0;
+			}
+			cache.bypass = true;
+		}
+	};
+	thread_local RvHeapCacheOwner cacheOwner;
+
+	std::atomic<int64_t> liveBytes[RV_HEAP_CATEGORY_COUNT];
+	std::atomic<int64_t> peakBytes[RV_HEAP_CATEGORY_COUNT];
+	std::atomic<uint64_t> allocationCounts[RV_HEAP_CATEGORY_COUNT];
+	std::atomic<uint64_t> freeCounts[RV_HEAP_CATEGORY_COUNT];
+
+	//Written by the thread calling update
+	double allocationRates[RV_HEAP_CATEGORY_COUNT];
+	uint64_t sampledCounts[RV_HEAP_CATEGORY_COUNT];
+	double sampleTime = 0.0;
+
+	uintptr_t alignUp(uintptr_t value, size_t alignment)
+	{
+		return (value + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+	}
+
+	uint8_t sizeClassOf(size_t blockSize)
+	{
+		uint8_t sizeClass = 0;
+		while (sizeClasses[sizeClass] < blockSize)
+		{
+			sizeClass++;
+		}
+		return sizeClass;
+	}
+
+	//Splits a new page in blocks of the class, the caller holds the pools mutex
+	void growPool(uint8_t sizeClass)
+	{
+		char* page = static_cast<char*>(malloc(RV_HEAP_PAGE_SIZE + RV_HEAP_HEADER_SIZE));
+		if (page == nullptr)
+		{
+			throw std::bad_alloc();
+		}
+
+		const size_t blockSize = sizeClasses[sizeClass];
+		char* block = reinterpret_cast<char*>(alignUp(reinterpret_cast<uintptr_t>(page), RV_HEAP_HEADER_SIZE));
+		for (char* end = block + RV_HEAP_PAGE_SIZE - blockSize; block <= end; block += blockSize)
+		{
+			RvFreeBlock* freeBlock = reinterpret_cast<RvFreeBlock*>(block);
+			freeBlock->next = pools().freeLists[sizeClass];
+			pools().freeLists[sizeClass] = freeBlock;
+		}
+	}
+
+	char* allocatePooled(uint8_t sizeClass)
+	{
+		if (cache.bypass)
+		{
+			std::lock_guard<std::mutex> lock(pools().mutex);
+			if (pools().freeLists[sizeClass] == nullptr)
+			{
+				growPool(sizeClass);
+			}
+			RvFreeBlock* block = pools().freeLists[sizeClass];
+			pools().freeLists[sizeClass] = block->next;
+			return reinterpret_cast<char*>(block);
+		}
+
+		//Refill half of the cache at once so the lock is taken once per batch
+		if (cache.freeLists[sizeClass] == nullptr)
+		{
+			cacheOwner.acquire();
+			std::lock_guard<std::mutex> lock(pools().mutex);
+			for (uint32_t i = 0; i < RV_HEAP_CACHE_LIMIT / 2; i++)
+			{
+				if (pools().freeLists[sizeClass] == nullptr)
+				{
+					growPool(sizeClass);
+				}
+				RvFreeBlock* block = pools().freeLists[sizeClass];
+				pools().freeLists[sizeClass] = block->next;
+				block->next = cache.freeLists[sizeClass];
+				cache.freeLists[sizeClass] = block;
+			}
+			cache.counts[sizeClass] = RV_HEAP_CACHE_LIMIT / 2;
+		}
+
+		RvFreeBlock* block = cache.freeLists[sizeClass];
+		cache.freeLists[sizeClass] = block->next;
+		cache.counts[sizeClass]--;
+		return reinterpret_cast<char*>(block);
+	}
+
+	void freePooled(char* pointer, uint8_t sizeClass)
+	{
+		RvFreeBlock* block = reinterpret_cast<RvFreeBlock*>(pointer);
+		if (cache.bypass)
+		{
+			std::lock_guard<std::mutex> lock(pools().mutex);
+			block->next = pools().freeLists[sizeClass];
+			pools().freeLists[sizeClass] = block;
+			return;
+		}
+
+		block->next = cache.freeLists[sizeClass];
+		cache.freeLists[sizeClass] = block;
+		if (++cache.counts[sizeClass] <= RV_HEAP_CACHE_LIMIT)
+		{
+			return;
+		}
+
+		//Blocks freed by a thread other than their allocator's would otherwise pile up in its cache
+		std::lock_guard<std::mutex> lock(pools().mutex);
+		for (uint32_t i = 0; i < RV_HEAP_CACHE_LIMIT / 2; i++)
+		{
+			block = cache.freeLists[sizeClass];
+			cache.freeLists[sizeClass] = block->next;
+			block->next = pools().freeLists[sizeClass];
+			pools().freeLists[sizeClass] = block;
+		}
+		cache.counts[sizeClass] -= RV_HEAP_CACHE_LIMIT / 2;
+	}
+}
+
+void* RvHeap::allocate(size_t size, size_t alignment, size_t alignmentOffset)
+{
+	alignment = alignment > RV_HEAP_HEADER_SIZE ? alignment : RV_HEAP_HEADER_SIZE;
+
+	RvHeapHeader header = {};
+	header.size = size;
+	header.category = threadCategory;
+
+	//Pooled blocks are header aligned, which covers smaller alignments at offsets that are multiples of it
+	char* pointer;
+	if (alignment == RV_HEAP_HEADER_SIZE && alignmentOffset % RV_HEAP_HEADER_SIZE == 0 &&
+		size <= RV_HEAP_MAX_POOLED_SIZE - RV_HEAP_HEADER_SIZE)
+	{
+		header.sizeClass = sizeClassOf(size + RV_HEAP_HEADER_SIZE);
+		pointer = allocatePooled(header.sizeClass) + RV_HEAP_HEADER_SIZE;
+	}
+	else
+	{
+		//Room for the header, the offset and the worst case padding
+		char* block = static_cast<char*>(malloc(RV_HEAP_HEADER_SIZE + alignmentOffset + alignment + size));
+		if (block == nullptr)
+		{
+			throw std::bad_alloc();
+		}
+
+		const uintptr_t address = reinterpret_cast<uintptr_t>(block) + RV_HEAP_HEADER_SIZE + alignmentOffset;
+		pointer = reinterpret_cast<char*>(alignUp(address, alignment) - alignmentOffset);
+		header.sizeClass = largeBlock;
+		header.offset = static_cast<uint32_t>(pointer - block);
+	}
+	memcpy(pointer - RV_HEAP_HEADER_SIZE, &header, sizeof(RvHeapHeader));
+
+	const int64_t live = liveBytes[header.category] += static_cast<int64_t>(size);
+	int64_t peak = peakBytes[header.category].load(std::memory_order_relaxed);
+	while (live > peak && !peakBytes[header.category].compare_exchange_weak(peak, live, std::memory_order_relaxed))
+	{
+	}
+	allocationCounts[header.category].fetch_add(1, std::memory_order_relaxed);
+
+	return pointer;
+}
+
+void RvHeap::free(void* pointer)
+{
+	if (pointer == nullptr)
+	{
+		return;
+	}
+
+	char* bytes = static_cast<char*>(pointer);
+	RvHeapHeader header;
+	memcpy(&header, bytes - RV_HEAP_HEADER_SIZE, sizeof(RvHeapHeader));
+
+	liveBytes[header.category] -= static_cast<int64_t>(header.size);
+	freeCounts[header.category].fetch_add(1, std::memory_order_relaxed);
+
+	if (header.sizeClass == largeBlock)
+	{
+		::free(bytes - header.offset);
+	}
+	else
+	{
+		freePooled(bytes - RV_HEAP_HEADER_SIZE, header.sizeClass);
+	}
+}
+
+RvHeapStats RvHeap::getStats(RvHeapCategory category)
+{
+	RvHeapStats stats;
+	stats.liveBytes = liveBytes[category].load(std::memory_order_relaxed);
+	stats.peakBytes = peakBytes[category].load(std::memory_order_relaxed);
+	stats.allocationCount = allocationCounts[category].load(std::memory_order_relaxed);
+	stats.freeCount = freeCounts[category].load(std::memory_order_relaxed);
+	stats.allocationRate = allocationRates[category];
+	return stats;
+}
+
+const char* RvHeap::categoryName(RvHeapCategory category)
+{
+	return categoryNames[category];
+}
+
+void RvHeap::update(double deltaTime)
+{
+	//Rates are averaged over about a second, single frames are too noisy
+	sampleTime += deltaTime;
+	if (sampleTime < 1.0)
+	{
+		return;
+	}
+
+	for (uint32_t category = 0; category < RV_HEAP_CATEGORY_COUNT; category++)
+	{
+		const uint64_t count = allocationCounts[category].load(std::memory_order_relaxed);
+		allocationRates[category] = (count - sampledCounts[category]) / sampleTime;
+		sampledCounts[category] = count;
+	}
+	sampleTime = 0.0;
+}
+
+void RvHeap::printStats()
+{
+	fmt::print(stdout, "CPU heap:\n");
+	for (uint32_t category = 0; category < RV_HEAP_CATEGORY_COUNT; category++)
+	{
+		const RvHeapStats stats = getStats(static_cast<RvHeapCategory>(category));
+		fmt::print(stdout, "\t{0}: {1:.1f}KB live (peak {2:.1f}KB), {3} allocations, {4} frees, {5:.0f} allocations/s\n",
+			categoryNames[category], stats.liveBytes / 1024.0, stats.peakBytes / 1024.0,
+			stats.allocationCount, stats.freeCount, stats.allocationRate);
+	}
+}
+
+RvHeapCategory RvHeap::currentCategory()
+{
+	return threadCategory;
+}
+
+void RvHeap::setCurrentCategory(RvHeapCategory category)
+{
+	threadCategory = category;
+}
@@ -0,0 +1,94 @@
+#ifndef RV_HEAP_H
+#define RV_HEAP_H
+
+//STD Includes
+#include <cstddef>
+#include <cstdint>
+
+//Small blocks (header included) come from size class pools, anything larger or over-aligned from malloc
+#define RV_HEAP_MAX_POOLED_SIZE 1024
+#define RV_HEAP_PAGE_SIZE (64 * 1024)
+
+//Blocks a thread keeps per size class before giving half of them back to the shared pool
+#define RV_HEAP_CACHE_LIMIT 64
+
+//Every block starts with a header, which also gives the default alignment
+#define RV_HEAP_HEADER_SIZE 16
+
+/**
+ * \brief Subsystem an allocation is accounted to.
+ */
+enum RvHeapCategory : uint8_t
+{
+	RV_HEAP_GENERAL,
+	RV_HEAP_ANIMATION,
+	RV_HEAP_ASSETS,
+	RV_HEAP_GUI,
+	RV_HEAP_RENDERER,
+	RV_HEAP_CATEGORY_COUNT
+};
+
+struct RvHeapStats
+{
+	int64_t liveBytes = 0;
+	int64_t peakBytes = 0;
+	uint64_t allocationCount = 0;
+	uint64_t freeCount = 0;
+
+	//Allocations per second over the last sampling period (see RvHeap::update)
+	double allocationRate = 0.0;
+};
+
+/**
+ * \brief Backend of the EASTL allocator and of array new/delete.
+ * Small blocks come from size class pools behind per-thread caches, so most allocations neither lock nor reach malloc.
+ * Alignment requests are honored, and every block is accounted to the category of the RvHeapScope active on its thread.
+ * Pool pages are never given back to the system, freed blocks are only reused.
+ */
+class RvHeap
+{
+public:
+	static void* allocate(size_t size, size_t alignment = RV_HEAP_HEADER_SIZE, size_t alignmentOffset = 0);
+	static void free(void* pointer);
+
+	static RvHeapStats getStats(RvHeapCategory category);
+	static const char* categoryName(RvHeapCategory category);
+
+	/**
+	 * \brief Samples allocation rates, meant to be called once per frame.
+	 */
+	static void update(double deltaTime);
+	static void printStats();
+
+	static RvHeapCategory currentCategory();
+	static void setCurrentCategory(RvHeapCategory category);
+
+private:
+	RvHeap();
+	~RvHeap();
+};
+
+/**
+ * \brief Accounts allocations made by this thread to a category until the scope ends.
+ */
+class RvHeapScope
+{
+public:
+	explicit RvHeapScope(RvHeapCategory category) : previous(RvHeap::currentCategory())
+	{
+		RvHeap::setCurrentCategory(category);
+	}
+
+	~RvHeapScope()
+	{
+		RvHeap::setCurrentCategory(previous);
+	}
+
+	RvHeapScope(const RvHeapScope&) = delete;
+	RvHeapScope& operator=(const RvHeapScope&) = delete;
+
+private:
+	RvHeapCategory previous;
+};
+
+#endif
@@ -0,0 +1,139 @@
+#include "RvImportProfile.h"
+
+//FMT Includes
+#include <fmt/printf.h>
+
+//Assimp Includes
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+#include <assimp/config.h>
+
+//Validation, triangle lists and cleanup needed by every profile (cache locality is left to the mesh optimizer, which redoes it)
+#define RV_IMPORT_BASE_STEPS aiProcess_JoinIdenticalVertices | aiProcess_Triangulate | aiProcess_SortByPType | \
+	aiProcess_FindDegenerates | aiProcess_FindInvalidData | aiProcess_ValidateDataStructure | aiProcess_OptimizeMeshes
+
+//Nothing reads tangents, cameras or lights
+#define RV_IMPORT_UNUSED_COMPONENTS aiComponent_TANGENTS_AND_BITANGENTS | aiComponent_CAMERAS | aiComponent_LIGHTS
+
+namespace
+{
+	const RvImportProfile profiles[RV_IMPORT_PROFILE_COUNT] = {
+		{
+			RV_IMPORT_PROFILE_STATIC_PROP, "Static prop",
+			RV_IMPORT_BASE_STEPS | aiProcess_RemoveComponent | aiProcess_GenNormals | aiProcess_RemoveRedundantMaterials,
+			RV_IMPORT_UNUSED_COMPONENTS | aiComponent_BONEWEIGHTS | aiComponent_ANIMATIONS,
+			RV_VERTEX_ATTRIBUTE_COLOR | RV_VERTEX_ATTRIBUTE_UV | RV_VERTEX_ATTRIBUTE_NORMAL,
+			true, false
+		},
+		{
+			RV_IMPORT_PROFILE_SKINNED_CHARACTER, "Skinned character",
+			RV_IMPORT_BASE_STEPS | aiProcess_RemoveComponent | aiProcess_GenNormals | aiProcess_RemoveRedundantMaterials | aiProcess_LimitBoneWeights,
+			RV_IMPORT_UNUSED_COMPONENTS,
+			RV_VERTEX_ATTRIBUTE_ALL,
+			true, true
+		},
+		{
+			RV_IMPORT_PROFILE_COLLISION, "Collision",
+			RV_IMPORT_BASE_STEPS | aiProcess_RemoveComponent,
+			RV_IMPORT_UNUSED_COMPONENTS | aiComponent_NORMALS | aiComponent_COLORS | aiComponent_TEXCOORDS | aiComponent_BONEWEIGHTS |
+			aiComponent_ANIMATIONS | aiComponent_TEXTURES | aiComponent_MATERIALS,
+			0,
+			false, false
+		}
+	};
+}
+
+const RvImportProfile& RvImportProfile::get(RvImportProfileType type)
+{
+	return profiles[type];
+}
+
+const aiScene* RvImportProfile::readScene(Assimp::Importer& importer, const string& filePath, RvImportTimer& timer) const
+{
+	importer.SetPropertyInteger(AI_CONFIG_PP_RVC_FLAGS, static_cast<int>(removedComponents));
+
+	//Validation is part of reading, every other step runs on its own
+	if (!importer.ReadFile(filePath.c_str(), postProcessSteps & aiProcess_ValidateDataStructure))
+	{
+		return nullptr;
+	}
+	timer.lap("ReadFile");
+
+	for (const RvPostProcessStep& step : postProcessStepsOrder())
+	{
+		if (!(postProcessSteps & step.flag))
+		{
+			continue;
+		}
+		if (!importer.ApplyPostProcessing(step.flag))
+		{
+			return nullptr;
+		}
+		timer.lap(step.name);
+	}
+	return importer.GetScene();
+}
+
+const vector<RvPostProcessStep>& postProcessStepsOrder()
+{
+	//Mirrors Assimp's post-process registry, every flag runs each step registered for it
+	static const vector<RvPostProcessStep> steps = {
+		{ aiProcess_MakeLeftHanded, "MakeLeftHanded" },
+		{ aiProcess_FlipUVs, "FlipUVs" },
+		{ aiProcess_FlipWindingOrder, "FlipWindingOrder" },
+		{ aiProcess_RemoveComponent, "RemoveComponent" },
+		{ aiProcess_RemoveRedundantMaterials, "RemoveRedundantMaterials" },
+		{ aiProcess_FindInstances, "FindInstances" },
+		{ aiProcess_OptimizeGraph, "OptimizeGraph" },
+		{ aiProcess_OptimizeMeshes, "OptimizeMeshes" },
+		{ aiProcess_FindDegenerates, "FindDegenerates" },
+		{ aiProcess_GenUVCoords, "GenUVCoords" },
+		{ aiProcess_TransformUVCoords, "TransformUVCoords" },
+		{ aiProcess_GlobalScale, "GlobalScale" },
+		{ aiProcess_PreTransformVertices, "PreTransformVertices" },
+		{ aiProcess_Triangulate, "Triangulate" },
+		{ aiProcess_SortByPType, "SortByPType" },
+		{ aiProcess_FindInvalidData, "FindInvalidData" },
+		{ aiProcess_FixInfacingNormals, "FixInfacingNormals" },
+		{ aiProcess_SplitByBoneCount, "SplitByBoneCount" },
+		{ aiProcess_SplitLargeMeshes, "SplitLargeMeshes" },
+		{ aiProcess_GenNormals, "GenNormals" },
+		{ aiProcess_GenSmoothNormals, "GenSmoothNormals" },
+		{ aiProcess_CalcTangentSpace, "CalcTangentSpace" },
+		{ aiProcess_JoinIdenticalVertices, "JoinIdenticalVertices" },
+		{ aiProcess_Debone, "Debone" },
+		{ aiProcess_LimitBoneWeights, "LimitBoneWeights" },
+		{ aiProcess_ImproveCacheLocality, "ImproveCacheLocality" }
+	};
+	return steps;
+}
+
+#pragma region RvImportTimer
+
+RvImportTimer::RvImportTimer() : last(std::chrono::high_resolution_clock::now())
+{
+}
+
+void RvImportTimer::lap(const char* step)
+{
+	const std::chrono::high_resolution_clock::time_point now = std::chrono::high_resolution_clock::now();
+	steps.push_back({ step, std::chrono::duration<double, std::milli>(now - last).count() });
+	last = now;
+}
+
+void RvImportTimer::print(const string& filePath) const
+{
+	double total = 0.0;
+	for (const RvImportStepTime& step : steps)
+	{
+		total += step.milliseconds;
+	}
+
+	fmt::print(stdout, "Imported {0} in {1:.2f}ms:\n", filePath.c_str(), total);
+	for (const RvImportStepTime& step : steps)
+	{
+		fmt::print(stdout, "\t{0:<28} {1:>9.2f}ms {2:>5.1f}%\n", step.name, step.milliseconds, total > 0.0 ? step.milliseconds * 100.0 / total : 0.0);
+	}
+}
+
+#pragma endregion
@@ -0,0 +1,115 @@
+#ifndef RV_IMPORT_PROFILE_H
+#define RV_IMPORT_PROFILE_H
+
+//EASTL Includes
+#include <eastl/vector.h>
+#include <eastl/string.h>
+
+using eastl::vector;
+using eastl::string;
+
+//STD Includes
+#include <chrono>
+
+struct aiScene;
+namespace Assimp
+{
+	class Importer;
+}
+
+class RvImportTimer;
+
+enum RvImportProfileType
+{
+	//Rigid meshes drawn with materials, bones and animations are dropped
+	RV_IMPORT_PROFILE_STATIC_PROP,
+	//Everything the skinned pipeline reads, bones and animations included
+	RV_IMPORT_PROFILE_SKINNED_CHARACTER,
+	//Positions and triangles only
+	RV_IMPORT_PROFILE_COLLISION,
+	RV_IMPORT_PROFILE_COUNT
+};
+
+//Vertex streams filled by the loaders (positions always are), missing ones keep the conversion defaults
+enum RvVertexAttributeBits
+{
+	RV_VERTEX_ATTRIBUTE_COLOR = 1 << 0,
+	RV_VERTEX_ATTRIBUTE_UV = 1 << 1,
+	RV_VERTEX_ATTRIBUTE_NORMAL = 1 << 2,
+	RV_VERTEX_ATTRIBUTE_BONES = 1 << 3,
+	RV_VERTEX_ATTRIBUTE_ALL = RV_VERTEX_ATTRIBUTE_COLOR | RV_VERTEX_ATTRIBUTE_UV | RV_VERTEX_ATTRIBUTE_NORMAL | RV_VERTEX_ATTRIBUTE_BONES
+};
+
+/**
+ * \brief Selects which import work is done for an asset, so nothing is computed only to be thrown away.
+ */
+struct RvImportProfile
+{
+	RvImportProfileType type;
+	const char* name;
+
+	//Assimp post-process steps (aiProcess flags)
+	uint32_t postProcessSteps;
+
+	//Components stripped before the other steps run (aiComponent flags for aiProcess_RemoveComponent)
+	uint32_t removedComponents;
+
+	//Vertex streams converted (RvVertexAttributeBits)
+	uint32_t vertexAttributes;
+
+	bool loadMaterials;
+	bool loadAnimations;
+
+	static const RvImportProfile& get(RvImportProfileType type);
+
+	/**
+	 * \brief Reads a scene with Assimp, then applies the profile post-process steps one by one so each of them is timed.
+	 * \return The scene (owned by the importer) or null if the import failed.
+	 */
+	const aiScene* readScene(Assimp::Importer& importer, const string& filePath, RvImportTimer& timer) const;
+};
+
+/**
+ * \brief Assimp post-process step with a printable name.
+ */
+struct RvPostProcessStep
+{
+	uint32_t flag;
+	const char* name;
+};
+
+/**
+ * \brief Post-process steps in the order Assimp runs them, so applying them one by one gives the same scene.
+ */
+const vector<RvPostProcessStep>& postProcessStepsOrder();
+
+/**
+ * \brief Records how long each step of an import took.
+ */
+class RvImportTimer
+{
+public:
+	RvImportTimer();
+
+	/**
+	 * \brief Records the time since the previous lap (or construction) under the given step name.
+	 */
+	void lap(const char* step);
+
+	/**
+	 * \brief Prints every step with its share of the total.
+	 */
+	void print(const string& filePath) const;
+
+	struct RvImportStepTime
+	{
+		const char* name;
+		double milliseconds;
+	};
+	vector<RvImportStepTime> steps;
+
+private:
+	std::chrono::high_resolution_clock::time_point last;
+};
+
+#endif
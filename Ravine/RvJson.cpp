@@ -0,0 +1,389 @@
+#include "RvJson.h"
+
+//STD Includes
+#include <cstdlib>
+#include <cstring>
+
+//Deeper documents are rejected instead of overflowing the stack
+#define RV_JSON_MAX_DEPTH 256
+
+bool RvJsonDocument::parse(const char* text, size_t textSize)
+{
+	cursor = text;
+	end = text + textSize;
+	values.clear();
+	children.clear();
+	strings.clear();
+	pending.clear();
+
+	//Offset zero is the empty string, used as key of values that aren't members
+	strings.push_back('\0');
+
+	uint32_t rootIndex;
+	if (!parseValue(0, rootIndex))
+	{
+		values.clear();
+		return false;
+	}
+
+	//Nothing but whitespace may follow the root value
+	skipWhitespace();
+	if (cursor != end)
+	{
+		values.clear();
+		return false;
+	}
+	return true;
+}
+
+const RvJsonValue& RvJsonDocument::root() const
+{
+	static const RvJsonValue nullValue;
+	return values.empty() ? nullValue : values[0];
+}
+
+const RvJsonValue* RvJsonDocument::find(const RvJsonValue& object, const char* key) const
+{
+	if (object.type != RV_JSON_OBJECT)
+	{
+		return nullptr;
+	}
+
+	for (uint32_t i = 0; i < object.size; i++)
+	{
+		const RvJsonValue& member = values[children[object.offset + i]];
+		if (strcmp(strings.data() + member.key, key) == 0)
+		{
+			return &member;
+		}
+	}
+	return nullptr;
+}
+
+const RvJsonValue& RvJsonDocument::at(const RvJsonValue& container, uint32_t index) const
+{
+	return values[children[container.offset + index]];
+}
+
+const char* RvJsonDocument::text(const RvJsonValue& value) const
+{
+	return value.type == RV_JSON_STRING ? strings.data() + value.offset : "";
+}
+
+double RvJsonDocument::getNumber(const RvJsonValue& object, const char* key, double fallback) const
+{
+	const RvJsonValue* member = find(object, key);
+	return member && member->type == RV_JSON_NUMBER ? member->number : fallback;
+}
+
+bool RvJsonDocument::getBool(const RvJsonValue& object, const char* key, bool fallback) const
+{
+	const RvJsonValue* member = find(object, key);
+	return member && member->type == RV_JSON_BOOL ? member->number != 0.0 : fallback;
+}
+
+const char* RvJsonDocument::getText(const RvJsonValue& object, const char* key, const char* fallback) const
+{
+	const RvJsonValue* member = find(object, key);
+	return member && member->type == RV_JSON_STRING ? text(*member) : fallback;
+}
+
+const RvJsonValue* RvJsonDocument::getArray(const RvJsonValue& object, const char* key) const
+{
+	const RvJsonValue* member = find(object, key);
+	return member && member->type == RV_JSON_ARRAY ? member : nullptr;
+}
+
+const RvJsonValue* RvJsonDocument::getObject(const RvJsonValue& object, const char* key) const
+{
+	const RvJsonValue* member = find(object, key);
+	return member && member->type == RV_JSON_OBJECT ? member : nullptr;
+}
+
+bool RvJsonDocument::parseValue(uint32_t depth, uint32_t& index)
+{
+	skipWhitespace();
+	if (cursor == end || depth > RV_JSON_MAX_DEPTH)
+	{
+		return false;
+	}
+
+	//Children are appended to values while parsing, so this value is only accessed by index
+	index = static_cast<uint32_t>(values.size());
+	values.push_back(RvJsonValue());
+
+	switch (*cursor)
+	{
+	case '{':
+	case '[':
+	{
+		const bool isObject = *cursor == '{';
+		const char closing = isObject ? '}' : ']';
+		values[index].type = isObject ? RV_JSON_OBJECT : RV_JSON_ARRAY;
+		cursor++;
+
+		const size_t mark = pending.size();
+		skipWhitespace();
+		if (cursor != end && *cursor == closing)
+		{
+			cursor++;
+		}
+		else
+		{
+			for (;;)
+			{
+				uint32_t key = 0;
+				if (isObject)
+				{
+					uint32_t keySize;
+					skipWhitespace();
+					if (!parseString(key, keySize))
+					{
+						return false;
+					}
+					skipWhitespace();
+					if (cursor == end || *cursor != ':')
+					{
+						return false;
+					}
+					cursor++;
+				}
+
+				uint32_t child;
+				if (!parseValue(depth + 1, child))
+				{
+					return false;
+				}
+				values[child].key = key;
+				pending.push_back(child);
+
+				skipWhitespace();
+				if (cursor == end)
+				{
+					return false;
+				}
+				if (*cursor == ',')
+				{
+					cursor++;
+					continue;
+				}
+				if (*cursor != closing)
+				{
+					return false;
+				}
+				cursor++;
+				break;
+			}
+		}
+
+		//Children of a container are stored contiguously once it closes
+		values[index].offset = static_cast<uint32_t>(children.size());
+		values[index].size = static_cast<uint32_t>(pending.size() - mark);
+		children.insert(children.end(), pending.begin() + mark, pending.end());
+		pending.resize(mark);
+		return true;
+	}
+	case '"':
+	{
+		uint32_t offset, size;
+		if (!parseString(offset, size))
+		{
+			return false;
+		}
+		values[index].type = RV_JSON_STRING;
+		values[index].offset = offset;
+		values[index].size = size;
+		return true;
+	}
+	case 't':
+	case 'f':
+	case 'n':
+	{
+		const char* literals[] = { "true", "false", "null" };
+		for (uint32_t l = 0; l < 3; l++)
+		{
+			const size_t length = strlen(literals[l]);
+			if (static_cast<size_t>(end - cursor) >= length && memcmp(cursor, literals[l], length) == 0)
+			{
+				cursor += length;
+				values[index].type = l < 2 ? RV_JSON_BOOL : RV_JSON_NULL;
+				values[index].number = l == 0 ? 1.0 : 0.0;
+				return true;
+			}
+		}
+		return false;
+	}
+	default:
+		values[index].type = RV_JSON_NUMBER;
+		return parseNumber(values[index].number);
+	}
+}
+
+bool RvJsonDocument::parseString(uint32_t& offset, uint32_t& size)
+{
+	if (cursor == end || *cursor != '"')
+	{
+		return false;
+	}
+	cursor++;
+
+	offset = static_cast<uint32_t>(strings.size());
+	for (;;)
+	{
+		//Copy runs of plain characters at once
+		const char* run = cursor;
+		while (cursor != end && *cursor != '"' && *cursor != '\\' && static_cast<unsigned char>(*cursor) >= 0x20)
+		{
+			cursor++;
+		}
+		strings.insert(strings.end(), run, cursor);
+
+		if (cursor == end || static_cast<unsigned char>(*cursor) < 0x20)
+		{
+			return false;
+		}
+		if (*cursor == '"')
+		{
+			cursor++;
+			break;
+		}
+
+		//Escape sequence
+		cursor++;
+		if (cursor == end)
+		{
+			return false;
+		}
+		const char escaped = *cursor++;
+		switch (escaped)
+		{
+		case '"': strings.push_back('"'); break;
+		case '\\': strings.push_back('\\'); break;
+		case '/': strings.push_back('/'); break;
+		case 'b': strings.push_back('\b'); break;
+		case 'f': strings.push_back('\f'); break;
+		case 'n': strings.push_back('\n'); break;
+		case 'r': strings.push_back('\r'); break;
+		case 't': strings.push_back('\t'); break;
+		case 'u':
+		{
+			const auto readHex = [this](uint32_t& codeUnit)
+			{
+				if (end - cursor < 4)
+				{
+					return false;
+				}
+				codeUnit = 0;
+				for (uint32_t i = 0; i < 4; i++)
+				{
+					const char c = *cursor++;
+					codeUnit <<= 4;
+					if (c >= '0' && c <= '9') codeUnit |= c - '0';
+					else if (c >= 'a' && c <= 'f') codeUnit |= c - 'a' + 10;
+					else if (c >= 'A' && c <= 'F') codeUnit |= c - 'A' + 10;
+					else return false;
+				}
+				return true;
+			};
+
+			uint32_t codePoint;
+			if (!readHex(codePoint))
+			{
+				return false;
+			}
+
+			//Characters outside the BMP come as surrogate pairs
+			if (codePoint >= 0xD800 && codePoint < 0xDC00)
+			{
+				uint32_t low;
+				if (end - cursor < 2 || cursor[0] != '\\' || cursor[1] != 'u')
+				{
+					return false;
+				}
+				cursor += 2;
+				if (!readHex(low) || low < 0xDC00 || low >= 0xE000)
+				{
+					return false;
+				}
+				codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+			}
+
+			//Encode as UTF-8
+			if (codePoint < 0x80)
+			{
+				strings.push_back(static_cast<char>(codePoint));
+			}
+			else if (codePoint < 0x800)
+			{
+				strings.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+				strings.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+			}
+			else if (codePoint < 0x10000)
+			{
+				strings.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+				strings.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+				strings.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+			}
+			else
+			{
+				strings.push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+				strings.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+				strings.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+				strings.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+			}
+			break;
+		}
+		default:
+			return false;
+		}
+	}
+
+	size = static_cast<uint32_t>(strings.size() - offset);
+	strings.push_back('\0');
+	return true;
+}
+
+bool RvJsonDocument::parseNumber(double& number)
+{
+	//Validate the JSON number grammar, then let strtod convert it
+	const char* start = cursor;
+	if (cursor != end && *cursor == '-') cursor++;
+	const char* digits = cursor;
+	while (cursor != end && *cursor >= '0' && *cursor <= '9') cursor++;
+	if (cursor == digits) return false;
+	if (cursor != end && *cursor == '.')
+	{
+		cursor++;
+		digits = cursor;
+		while (cursor != end && *cursor >= '0' && *cursor <= '9') cursor++;
+		if (cursor == digits) return false;
+	}
+	if (cursor != end && (*cursor == 'e' || *cursor == 'E'))
+	{
+		cursor++;
+		if (cursor != end && (*cursor == '+' || *cursor == '-')) cursor++;
+		digits = cursor;
+		while (cursor != end && *cursor >= '0' && *cursor <= '9') cursor++;
+		if (cursor == digits) return false;
+	}
+
+	//Text isn't null-terminated, so the number is copied out first
+	char buffer[64];
+	const size_t length = cursor - start;
+	if (length >= sizeof(buffer))
+	{
+		return false;
+	}
+	memcpy(buffer, start, length);
+	buffer[length] = '\0';
+	number = strtod(buffer, nullptr);
+	return true;
+}
+
+void RvJsonDocument::skipWhitespace()
+{
+	while (cursor != end && (*cursor == ' ' || *cursor == '\t' || *cursor == '\n' || *cursor == '\r'))
+	{
+		cursor++;
+	}
+}
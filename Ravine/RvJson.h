@@ -0,0 +1,94 @@
+#ifndef RV_JSON_H
+#define RV_JSON_H
+
+//EASTL Includes
+#include <eastl/vector.h>
+
+using eastl::vector;
+
+//STD Includes
+#include <cstdint>
+#include <cstddef>
+
+enum RvJsonType
+{
+	RV_JSON_NULL,
+	RV_JSON_BOOL,
+	RV_JSON_NUMBER,
+	RV_JSON_STRING,
+	RV_JSON_ARRAY,
+	RV_JSON_OBJECT
+};
+
+/**
+ * \brief Parsed JSON value, containers reference their children through the document.
+ */
+struct RvJsonValue
+{
+	RvJsonType type = RV_JSON_NULL;
+	//Number (booleans are 0 or 1)
+	double number = 0.0;
+	//Offset in the strings pool (strings) or in the children table (arrays and objects)
+	uint32_t offset = 0;
+	//String length or children count
+	uint32_t size = 0;
+	//Offset in the strings pool of the member key (objects only)
+	uint32_t key = 0;
+};
+
+/**
+ * \brief Minimal read-only JSON DOM, values are stored flat and children of a container contiguously (O(1) indexing).
+ */
+class RvJsonDocument
+{
+public:
+
+	/**
+	 * \brief Parses UTF-8 text (not required to be null-terminated).
+	 * \return False on malformed input.
+	 */
+	bool parse(const char* text, size_t textSize);
+
+	const RvJsonValue& root() const;
+
+	/**
+	 * \brief Member of an object by key.
+	 * \return Null if value isn't an object or has no such member.
+	 */
+	const RvJsonValue* find(const RvJsonValue& object, const char* key) const;
+
+	/**
+	 * \brief Child of an array (or object) by index, index must be lower than size.
+	 */
+	const RvJsonValue& at(const RvJsonValue& container, uint32_t index) const;
+
+	/**
+	 * \brief Null-terminated (unescaped) contents of a string value.
+	 */
+	const char* text(const RvJsonValue& value) const;
+
+	//Typed member lookups, fallback is returned when the member is missing or has another type
+	double getNumber(const RvJsonValue& object, const char* key, double fallback) const;
+	bool getBool(const RvJsonValue& object, const char* key, bool fallback) const;
+	const char* getText(const RvJsonValue& object, const char* key, const char* fallback) const;
+	const RvJsonValue* getArray(const RvJsonValue& object, const char* key) const;
+	const RvJsonValue* getObject(const RvJsonValue& object, const char* key) const;
+
+private:
+	bool parseValue(uint32_t depth, uint32_t& index);
+	bool parseString(uint32_t& offset, uint32_t& size);
+	bool parseNumber(double& number);
+	void skipWhitespace();
+
+	const char* cursor = nullptr;
+	const char* end = nullptr;
+
+	vector<RvJsonValue> values;
+	vector<uint32_t> children;
+	vector<char> strings;
+
+	//Children of the containers being parsed, moved to the children table once a container closes
+	vector<uint32_t> pending;
+};
+
+#endif
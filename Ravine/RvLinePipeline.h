@@ -6,10 +6,12 @@
 
 //Ravine Systems
 #include "RvDevice.h"
+#include "RvDataTypes.h"
+#include "RvFileSystem.h"
 
 struct RvLinePipeline
 {
-	RvLinePipeline(RvDevice& device, VkExtent2D extent, VkSampleCountFlagBits sampleCount, VkDescriptorSetLayout* descriptorSetLayout, size_t descriptorSetLayoutCount, VkRenderPass renderPass, const vector<char>& vertShaderCode, const vector<char>& fragShaderCode);
+	RvLinePipeline(RvDevice& device, VkExtent2D extent, VkSampleCountFlagBits sampleCount, VkDescriptorSetLayout* descriptorSetLayout, size_t descriptorSetLayoutCount, VkRenderPass renderPass, const RvVertexInputDescription& vertexInput, const RvFileView& vertShaderCode, const RvFileView& fragShaderCode);
 	~RvLinePipeline();
 
 	RvDevice* device;
@@ -0,0 +1,814 @@
+#include "RvMemoryAllocator.h"
+
+//EASTL Includes
+#include <eastl/algorithm.h>
+
+//STD Includes
+#include <stdexcept>
+
+//FMT Includes
+#include <fmt/printf.h>
+
+//Platform Includes
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace
+{
+	VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment)
+	{
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+	uint32_t highestBit(VkDeviceSize value)
+	{
+#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanReverse64(&index, value);
+		return index;
+#else
+		return 63 - __builtin_clzll(value);
+#endif
+	}
+
+	uint32_t lowestBit(uint32_t value)
+	{
+#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanForward(&index, value);
+		return index;
+#else
+		return __builtin_ctz(value);
+#endif
+	}
+
+	//Size class of a chunk: first level is the power of two, second level a linear subdivision of it
+	void mapping(VkDeviceSize size, uint32_t& firstLevel, uint32_t& secondLevel)
+	{
+		if (size < RV_TLSF_SL_COUNT)
+		{
+			firstLevel = 0;
+			secondLevel = static_cast<uint32_t>(size);
+			return;
+		}
+
+		const uint32_t msb = highestBit(size);
+		firstLevel = msb - RV_TLSF_SL_LOG2 + 1;
+		secondLevel = static_cast<uint32_t>(size >> (msb - RV_TLSF_SL_LOG2)) - RV_TLSF_SL_COUNT;
+	}
+
+	float toMegabytes(VkDeviceSize bytes)
+	{
+		return bytes / (1024.0f * 1024.0f);
+	}
+
+	const char* categoryNames[RV_ALLOCATION_CATEGORY_COUNT] = { "Geometry", "Textures", "Attachments", "Uniforms", "Staging", "Other" };
+}
+
+#pragma region RvMemoryStats
+
+float RvMemoryStats::fragmentation() const
+{
+	return freeBytes == 0 ? 0.0f : 1.0f - static_cast<float>(contiguousFreeBytes) / freeBytes;
+}
+
+void RvMemoryStats::add(const RvMemoryStats& other)
+{
+	blockCount += other.blockCount;
+	blockBytes += other.blockBytes;
+	allocationCount += other.allocationCount;
+	usedBytes += other.usedBytes;
+	freeRangeCount += other.freeRangeCount;
+	freeBytes += other.freeBytes;
+	largestFreeRange = eastl::max(largestFreeRange, other.largestFreeRange);
+	contiguousFreeBytes += other.contiguousFreeBytes;
+	dedicatedCount += other.dedicatedCount;
+	dedicatedBytes += other.dedicatedBytes;
+}
+
+#pragma endregion
+
+#pragma region RvMemoryBlock
+
+RvMemoryBlock::RvMemoryBlock(RvMemoryPool* pool, VkDeviceMemory memory, VkDeviceSize size, char* mapped) :
+	pool(pool), memory(memory), size(size), mapped(mapped)
+{
+	for (uint32_t fl = 0; fl < RV_TLSF_FL_COUNT; fl++)
+	{
+		for (uint32_t sl = 0; sl < RV_TLSF_SL_COUNT; sl++)
+		{
+			freeLists[fl][sl] = RV_TLSF_NONE;
+		}
+	}
+
+	//The whole block starts as a single free chunk
+	if (pool->algorithm == RV_MEMORY_ALGORITHM_TLSF)
+	{
+		chunks.push_back({ 0, size, RV_TLSF_NONE, RV_TLSF_NONE, RV_TLSF_NONE, RV_TLSF_NONE, true });
+		insertFree(0);
+	}
+}
+
+bool RvMemoryBlock::allocate(VkDeviceSize allocationSize, VkDeviceSize alignment, VkDeviceSize& offset, uint32_t& chunk)
+{
+	if (pool->algorithm == RV_MEMORY_ALGORITHM_LINEAR)
+	{
+		const VkDeviceSize begin = alignUp(head, alignment);
+		if (begin + allocationSize > size)
+		{
+			return false;
+		}
+
+		head = begin + allocationSize;
+		allocationCount++;
+		usedBytes += allocationSize;
+		offset = begin;
+		chunk = RV_TLSF_NONE;
+		return true;
+	}
+
+	//Any chunk this large can hold the allocation wherever the aligned offset falls
+	const uint32_t index = findFree(allocationSize + alignment - 1);
+	if (index == RV_TLSF_NONE)
+	{
+		return false;
+	}
+	removeFree(index);
+
+	//Alignment padding goes back to the free lists (chunks may be reallocated by newChunk, so they're accessed by index)
+	const VkDeviceSize alignedOffset = alignUp(chunks[index].offset, alignment);
+	const VkDeviceSize padding = alignedOffset - chunks[index].offset;
+	if (padding > 0)
+	{
+		const uint32_t front = newChunk();
+		chunks[front] = { chunks[index].offset, padding, chunks[index].prevPhysical, index, RV_TLSF_NONE, RV_TLSF_NONE, true };
+		if (chunks[front].prevPhysical != RV_TLSF_NONE)
+		{
+			chunks[chunks[front].prevPhysical].nextPhysical = front;
+		}
+		chunks[index].prevPhysical = front;
+		chunks[index].offset = alignedOffset;
+		chunks[index].size -= padding;
+		insertFree(front);
+	}
+
+	//So does whatever remains after the allocation
+	if (chunks[index].size > allocationSize)
+	{
+		const uint32_t back = newChunk();
+		chunks[back] = { alignedOffset + allocationSize, chunks[index].size - allocationSize, index, chunks[index].nextPhysical, RV_TLSF_NONE, RV_TLSF_NONE, true };
+		if (chunks[back].nextPhysical != RV_TLSF_NONE)
+		{
+			chunks[chunks[back].nextPhysical].prevPhysical = back;
+		}
+		chunks[index].nextPhysical = back;
+		chunks[index].size = allocationSize;
+		insertFree(back);
+	}
+
+	chunks[index].free = false;
+	allocationCount++;
+	usedBytes += allocationSize;
+	offset = alignedOffset;
+	chunk = index;
+	return true;
+}
+
+void RvMemoryBlock::free(uint32_t chunk, VkDeviceSize allocationSize)
+{
+	allocationCount--;
+	usedBytes -= allocationSize;
+
+	if (pool->algorithm == RV_MEMORY_ALGORITHM_LINEAR)
+	{
+		//Space is only reclaimed once the whole block is unused
+		if (allocationCount == 0)
+		{
+			head = 0;
+		}
+		return;
+	}
+
+	//Merge with free physical neighbours, so free chunks are never adjacent
+	uint32_t index = chunk;
+	chunks[index].free = true;
+
+	const uint32_t prev = chunks[index].prevPhysical;
+	if (prev != RV_TLSF_NONE && chunks[prev].free)
+	{
+		removeFree(prev);
+		chunks[prev].size += chunks[index].size;
+		chunks[prev].nextPhysical = chunks[index].nextPhysical;
+		if (chunks[prev].nextPhysical != RV_TLSF_NONE)
+		{
+			chunks[chunks[prev].nextPhysical].prevPhysical = prev;
+		}
+		releaseChunk(index);
+		index = prev;
+	}
+
+	const uint32_t next = chunks[index].nextPhysical;
+	if (next != RV_TLSF_NONE && chunks[next].free)
+	{
+		removeFree(next);
+		chunks[index].size += chunks[next].size;
+		chunks[index].nextPhysical = chunks[next].nextPhysical;
+		if (chunks[index].nextPhysical != RV_TLSF_NONE)
+		{
+			chunks[chunks[index].nextPhysical].prevPhysical = index;
+		}
+		releaseChunk(next);
+	}
+
+	insertFree(index);
+}
+
+void RvMemoryBlock::addStats(RvMemoryStats& stats) const
+{
+	stats.blockCount++;
+	stats.blockBytes += size;
+	stats.allocationCount += allocationCount;
+	stats.usedBytes += usedBytes;
+
+	if (pool->algorithm == RV_MEMORY_ALGORITHM_LINEAR)
+	{
+		//Freed allocations below the head are not reusable until the block empties
+		if (head < size)
+		{
+			stats.freeRangeCount++;
+			stats.freeBytes += size - head;
+			stats.largestFreeRange = eastl::max(stats.largestFreeRange, size - head);
+			stats.contiguousFreeBytes += size - head;
+		}
+		return;
+	}
+
+	VkDeviceSize largestFreeRange = 0;
+	for (const RvMemoryChunk& chunk : chunks)
+	{
+		if (chunk.free && chunk.size > 0)
+		{
+			stats.freeRangeCount++;
+			stats.freeBytes += chunk.size;
+			largestFreeRange = eastl::max(largestFreeRange, chunk.size);
+		}
+	}
+	stats.largestFreeRange = eastl::max(stats.largestFreeRange, largestFreeRange);
+	stats.contiguousFreeBytes += largestFreeRange;
+}
+
+uint32_t RvMemoryBlock::newChunk()
+{
+	if (!unusedChunks.empty())
+	{
+		const uint32_t index = unusedChunks.back();
+		unusedChunks.pop_back();
+		return index;
+	}
+
+	chunks.push_back();
+	return static_cast<uint32_t>(chunks.size() - 1);
+}
+
+void RvMemoryBlock::releaseChunk(uint32_t chunk)
+{
+	chunks[chunk].size = 0;
+	chunks[chunk].free = false;
+	unusedChunks.push_back(chunk);
+}
+
+void RvMemoryBlock::insertFree(uint32_t chunk)
+{
+	uint32_t fl, sl;
+	mapping(chunks[chunk].size, fl, sl);
+
+	const uint32_t head = freeLists[fl][sl];
+	chunks[chunk].prevFree = RV_TLSF_NONE;
+	chunks[chunk].nextFree = head;
+	if (head != RV_TLSF_NONE)
+	{
+		chunks[head].prevFree = chunk;
+	}
+	freeLists[fl][sl] = chunk;
+
+	firstLevelBitmap |= 1u << fl;
+	secondLevelBitmaps[fl] |= 1u << sl;
+}
+
+void RvMemoryBlock::removeFree(uint32_t chunk)
+{
+	uint32_t fl, sl;
+	mapping(chunks[chunk].size, fl, sl);
+
+	const uint32_t prev = chunks[chunk].prevFree;
+	const uint32_t next = chunks[chunk].nextFree;
+	if (prev != RV_TLSF_NONE)
+	{
+		chunks[prev].nextFree = next;
+	}
+	else
+	{
+		freeLists[fl][sl] = next;
+	}
+	if (next != RV_TLSF_NONE)
+	{
+		chunks[next].prevFree = prev;
+	}
+
+	if (freeLists[fl][sl] == RV_TLSF_NONE)
+	{
+		secondLevelBitmaps[fl] &= ~(1u << sl);
+		if (secondLevelBitmaps[fl] == 0)
+		{
+			firstLevelBitmap &= ~(1u << fl);
+		}
+	}
+}
+
+uint32_t RvMemoryBlock::findFree(VkDeviceSize minimumSize) const
+{
+	//Rounding up to the next size class makes any chunk of the class found large enough (good fit instead of a list walk)
+	VkDeviceSize searchSize = minimumSize;
+	if (searchSize >= RV_TLSF_SL_COUNT)
+	{
+		searchSize += (static_cast<VkDeviceSize>(1) << (highestBit(searchSize) - RV_TLSF_SL_LOG2)) - 1;
+	}
+
+	uint32_t fl, sl;
+	mapping(searchSize, fl, sl);
+	if (fl >= RV_TLSF_FL_COUNT)
+	{
+		return RV_TLSF_NONE;
+	}
+
+	//Smallest non-empty class of this first level, otherwise of the next non-empty first level
+	uint32_t secondLevelMap = secondLevelBitmaps[fl] & (~0u << sl);
+	if (secondLevelMap == 0)
+	{
+		const uint32_t firstLevelMap = fl + 1 < RV_TLSF_FL_COUNT ? firstLevelBitmap & (~0u << (fl + 1)) : 0;
+		if (firstLevelMap == 0)
+		{
+			return RV_TLSF_NONE;
+		}
+		fl = lowestBit(firstLevelMap);
+		secondLevelMap = secondLevelBitmaps[fl];
+	}
+
+	return freeLists[fl][lowestBit(secondLevelMap)];
+}
+
+#pragma endregion
+
+#pragma region RvMemoryPool
+
+RvMemoryPool::RvMemoryPool(uint32_t memoryType, VkDeviceSize blockSize, RvMemoryAlgorithm algorithm, bool isDefault) :
+	memoryType(memoryType), blockSize(blockSize), algorithm(algorithm), isDefault(isDefault)
+{
+}
+
+#pragma endregion
+
+#pragma region RvMemoryAllocator
+
+RvMemoryAllocator::RvMemoryAllocator(VkDevice device, VkPhysicalDevice physicalDevice, bool memoryBudgetSupported) :
+	device(device), physicalDevice(physicalDevice), memoryBudgetSupported(memoryBudgetSupported)
+{
+	vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+
+	VkPhysicalDeviceProperties properties;
+	vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+	bufferImageGranularity = properties.limits.bufferImageGranularity;
+	nonCoherentAtomSize = properties.limits.nonCoherentAtomSize;
+	maxAllocationCount = properties.limits.maxMemoryAllocationCount;
+
+	defaultPools.resize(memoryProperties.memoryTypeCount * RV_RESOURCE_KIND_COUNT, nullptr);
+	dedicatedCounts.resize(memoryProperties.memoryTypeCount, 0);
+	dedicatedBytes.resize(memoryProperties.memoryTypeCount, 0);
+
+	updateBudget();
+}
+
+RvMemoryAllocator::~RvMemoryAllocator()
+= default;
+
+RvAllocation RvMemoryAllocator::allocate(const VkMemoryRequirements& requirements, uint32_t memoryType, RvResourceKind kind, RvAllocationCategory category,
+	RvMemoryPool* pool)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	VkDeviceSize size = requirements.size;
+	VkDeviceSize alignment = requirements.alignment;
+
+	//Non coherent ranges are flushed by whole atoms, so allocations mustn't share one
+	if (isMappable(memoryType) && !isCoherent(memoryType))
+	{
+		alignment = eastl::max(alignment, nonCoherentAtomSize);
+		size = alignUp(size, nonCoherentAtomSize);
+	}
+
+	if (!pool)
+	{
+		//Resources larger than half a block would waste most of it
+		if (size > preferredBlockSize(memoryType) / 2)
+		{
+			return allocateDedicatedLocked(size, memoryType, category, VK_NULL_HANDLE, VK_NULL_HANDLE);
+		}
+
+		//Without a granularity any resource can be a neighbour of any other, one pool serves both kinds
+		if (bufferImageGranularity <= 1)
+		{
+			kind = RV_RESOURCE_LINEAR;
+		}
+
+		RvMemoryPool*& defaultPool = defaultPools[memoryType * RV_RESOURCE_KIND_COUNT + kind];
+		if (!defaultPool)
+		{
+			defaultPool = new RvMemoryPool(memoryType, preferredBlockSize(memoryType), RV_MEMORY_ALGORITHM_TLSF, true);
+		}
+		pool = defaultPool;
+	}
+
+	RvAllocation allocation;
+	allocation.size = size;
+	allocation.memoryType = memoryType;
+	allocation.category = category;
+
+	RvMemoryBlock* target = nullptr;
+	for (RvMemoryBlock* block : pool->blocks)
+	{
+		if (block->allocate(size, alignment, allocation.offset, allocation.chunk))
+		{
+			target = block;
+			break;
+		}
+	}
+
+	if (!target)
+	{
+		//Blocks of custom pools grow to fit allocations larger than their block size
+		const VkDeviceSize blockSize = eastl::max(pool->blockSize, size);
+		char* mapped;
+		const VkDeviceMemory memory = allocateMemory(blockSize, memoryType, nullptr, mapped);
+		target = new RvMemoryBlock(pool, memory, blockSize, mapped);
+		pool->blocks.push_back(target);
+
+		if (!target->allocate(size, alignment, allocation.offset, allocation.chunk)) {
+			throw std::runtime_error("Failed to sub-allocate device memory!");
+		}
+	}
+
+	allocation.memory = target->memory;
+	allocation.mapped = target->mapped ? target->mapped + allocation.offset : nullptr;
+	allocation.block = target;
+	addToCategory(allocation);
+	return allocation;
+}
+
+RvAllocation RvMemoryAllocator::allocateDedicated(VkDeviceSize size, uint32_t memoryType, RvAllocationCategory category, VkImage image, VkBuffer buffer)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return allocateDedicatedLocked(size, memoryType, category, image, buffer);
+}
+
+RvAllocation RvMemoryAllocator::allocateDedicatedLocked(VkDeviceSize size, uint32_t memoryType, RvAllocationCategory category, VkImage image, VkBuffer buffer)
+{
+	//Lets the driver place the resource as it would for its own allocations (e.g. framebuffer compression)
+	VkMemoryDedicatedAllocateInfo dedicatedInfo = {};
+	dedicatedInfo.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO;
+	dedicatedInfo.image = image;
+	dedicatedInfo.buffer = buffer;
+	const bool hasOwner = image != VK_NULL_HANDLE || buffer != VK_NULL_HANDLE;
+
+	RvAllocation allocation;
+	allocation.memory = allocateMemory(size, memoryType, hasOwner ? &dedicatedInfo : nullptr, allocation.mapped);
+	allocation.size = size;
+	allocation.memoryType = memoryType;
+	allocation.category = category;
+
+	dedicatedCounts[memoryType]++;
+	dedicatedBytes[memoryType] += size;
+	addToCategory(allocation);
+	return allocation;
+}
+
+RvAllocation RvMemoryAllocator::adopt(VkDeviceMemory memory, VkDeviceSize size, uint32_t memoryType, RvAllocationCategory category)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	RvAllocation allocation;
+	allocation.memory = memory;
+	allocation.size = size;
+	allocation.memoryType = memoryType;
+	allocation.category = category;
+
+	dedicatedCounts[memoryType]++;
+	dedicatedBytes[memoryType] += size;
+	allocationsCount++;
+	heapAllocatedBytes[memoryProperties.memoryTypes[memoryType].heapIndex] += size;
+	addToCategory(allocation);
+	return allocation;
+}
+
+void RvMemoryAllocator::free(RvAllocation& allocation)
+{
+	if (allocation.memory == VK_NULL_HANDLE)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	categoryStats[allocation.category].allocationCount--;
+	categoryStats[allocation.category].bytes -= allocation.size;
+
+	if (!allocation.block)
+	{
+		dedicatedCounts[allocation.memoryType]--;
+		dedicatedBytes[allocation.memoryType] -= allocation.size;
+		freeMemory(allocation.memory, allocation.size, allocation.memoryType);
+	}
+	else
+	{
+		RvMemoryBlock* block = allocation.block;
+		block->free(allocation.chunk, allocation.size);
+
+		//Empty blocks of default pools are given back, one is kept so alternating allocations don't churn vkAllocateMemory
+		RvMemoryPool* pool = block->pool;
+		if (block->isEmpty() && pool->isDefault && pool->blocks.size() > 1)
+		{
+			pool->blocks.erase(eastl::find(pool->blocks.begin(), pool->blocks.end(), block));
+			destroyBlock(block);
+		}
+	}
+
+	allocation = RvAllocation();
+}
+
+RvMemoryPool* RvMemoryAllocator::createPool(uint32_t memoryType, VkDeviceSize blockSize, RvMemoryAlgorithm algorithm)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	RvMemoryPool* pool = new RvMemoryPool(memoryType, blockSize, algorithm, false);
+	customPools.push_back(pool);
+	return pool;
+}
+
+void RvMemoryAllocator::destroyPool(RvMemoryPool* pool)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	for (RvMemoryBlock* block : pool->blocks)
+	{
+		destroyBlock(block);
+	}
+	customPools.erase(eastl::find(customPools.begin(), customPools.end(), pool));
+	delete pool;
+}
+
+void RvMemoryAllocator::flush(const RvAllocation& allocation) const
+{
+	if (isCoherent(allocation.memoryType))
+	{
+		return;
+	}
+
+	VkMappedMemoryRange range = {};
+	range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+	range.memory = allocation.memory;
+	range.offset = allocation.offset;
+	range.size = allocation.block ? allocation.size : VK_WHOLE_SIZE;
+	vkFlushMappedMemoryRanges(device, 1, &range);
+}
+
+RvMemoryStats RvMemoryAllocator::getStats(uint32_t memoryType) const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	RvMemoryStats stats;
+	for (uint32_t kind = 0; kind < RV_RESOURCE_KIND_COUNT; kind++)
+	{
+		if (const RvMemoryPool* pool = defaultPools[memoryType * RV_RESOURCE_KIND_COUNT + kind])
+		{
+			for (const RvMemoryBlock* block : pool->blocks)
+			{
+				block->addStats(stats);
+			}
+		}
+	}
+	for (const RvMemoryPool* pool : customPools)
+	{
+		if (pool->memoryType == memoryType)
+		{
+			for (const RvMemoryBlock* block : pool->blocks)
+			{
+				block->addStats(stats);
+			}
+		}
+	}
+
+	stats.dedicatedCount = dedicatedCounts[memoryType];
+	stats.dedicatedBytes = dedicatedBytes[memoryType];
+	return stats;
+}
+
+RvCategoryStats RvMemoryAllocator::getCategoryStats(RvAllocationCategory category) const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return categoryStats[category];
+}
+
+const char* RvMemoryAllocator::categoryName(RvAllocationCategory category)
+{
+	return categoryNames[category];
+}
+
+void RvMemoryAllocator::updateBudget()
+{
+	VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProperties = {};
+	budgetProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+	VkPhysicalDeviceMemoryProperties2 properties = {};
+	properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+	properties.pNext = &budgetProperties;
+	if (memoryBudgetSupported)
+	{
+		vkGetPhysicalDeviceMemoryProperties2(physicalDevice, &properties);
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+	for (uint32_t heapIndex = 0; heapIndex < memoryProperties.memoryHeapCount; heapIndex++)
+	{
+		heapAllocatedAtUpdate[heapIndex] = heapAllocatedBytes[heapIndex];
+		heapUsage[heapIndex] = budgetProperties.heapUsage[heapIndex];
+		heapBudget[heapIndex] = budgetProperties.heapBudget[heapIndex];
+	}
+}
+
+RvMemoryBudget RvMemoryAllocator::getBudget(uint32_t heapIndex) const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	RvMemoryBudget budget;
+	budget.heapSize = memoryProperties.memoryHeaps[heapIndex].size;
+	budget.deviceLocal = (memoryProperties.memoryHeaps[heapIndex].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+	budget.allocatedBytes = heapAllocatedBytes[heapIndex];
+
+	if (memoryBudgetSupported)
+	{
+		//Other processes and the driver are only seen at update time, what this allocator did since is accounted right away
+		const VkDeviceSize usage = heapUsage[heapIndex] + heapAllocatedBytes[heapIndex];
+		budget.usage = usage > heapAllocatedAtUpdate[heapIndex] ? usage - heapAllocatedAtUpdate[heapIndex] : 0;
+		budget.budget = heapBudget[heapIndex];
+	}
+	else
+	{
+		budget.usage = heapAllocatedBytes[heapIndex];
+		budget.budget = static_cast<VkDeviceSize>(budget.heapSize * RV_DEFAULT_BUDGET_RATIO);
+	}
+	return budget;
+}
+
+float RvMemoryAllocator::deviceLocalPressure() const
+{
+	float pressure = 0.0f;
+	for (uint32_t heapIndex = 0; heapIndex < memoryProperties.memoryHeapCount; heapIndex++)
+	{
+		const RvMemoryBudget budget = getBudget(heapIndex);
+		if (budget.deviceLocal)
+		{
+			pressure = eastl::max(pressure, budget.pressure());
+		}
+	}
+	return pressure;
+}
+
+RvMemoryStats RvMemoryAllocator::getTotalStats() const
+{
+	RvMemoryStats stats;
+	for (uint32_t memoryType = 0; memoryType < memoryProperties.memoryTypeCount; memoryType++)
+	{
+		stats.add(getStats(memoryType));
+	}
+	return stats;
+}
+
+void RvMemoryAllocator::printStats() const
+{
+	fmt::print(stdout, "Device memory: {0} of {1} allocations\n", allocationsCount, maxAllocationCount);
+	for (uint32_t memoryType = 0; memoryType < memoryProperties.memoryTypeCount; memoryType++)
+	{
+		const RvMemoryStats stats = getStats(memoryType);
+		if (stats.blockCount == 0 && stats.dedicatedCount == 0)
+		{
+			continue;
+		}
+
+		fmt::print(stdout, "\tType {0} (heap {1}): {2} blocks ({3:.1f}MB) holding {4} allocations ({5:.1f}MB), {6} free ranges (largest {7:.1f}MB, {8:.0f}% fragmented), {9} dedicated ({10:.1f}MB)\n",
+			memoryType, memoryProperties.memoryTypes[memoryType].heapIndex,
+			stats.blockCount, toMegabytes(stats.blockBytes), stats.allocationCount, toMegabytes(stats.usedBytes),
+			stats.freeRangeCount, toMegabytes(stats.largestFreeRange), stats.fragmentation() * 100.0f,
+			stats.dedicatedCount, toMegabytes(stats.dedicatedBytes));
+	}
+	for (uint32_t category = 0; category < RV_ALLOCATION_CATEGORY_COUNT; category++)
+	{
+		const RvCategoryStats stats = getCategoryStats(static_cast<RvAllocationCategory>(category));
+		fmt::print(stdout, "\t{0}: {1} allocations ({2:.1f}MB)\n", categoryNames[category], stats.allocationCount, toMegabytes(stats.bytes));
+	}
+	for (uint32_t heapIndex = 0; heapIndex < memoryProperties.memoryHeapCount; heapIndex++)
+	{
+		const RvMemoryBudget budget = getBudget(heapIndex);
+		fmt::print(stdout, "\tHeap {0}{1}: {2:.1f}MB used of a {3:.1f}MB budget ({4:.1f}MB allocated here){5}\n",
+			heapIndex, budget.deviceLocal ? " (device local)" : "", toMegabytes(budget.usage), toMegabytes(budget.budget),
+			toMegabytes(budget.allocatedBytes), memoryBudgetSupported ? "" : ", estimated");
+	}
+}
+
+void RvMemoryAllocator::clear()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	for (RvMemoryPool* pool : defaultPools)
+	{
+		if (pool)
+		{
+			for (RvMemoryBlock* block : pool->blocks)
+			{
+				destroyBlock(block);
+			}
+			delete pool;
+		}
+	}
+	for (RvMemoryPool* pool : customPools)
+	{
+		for (RvMemoryBlock* block : pool->blocks)
+		{
+			destroyBlock(block);
+		}
+		delete pool;
+	}
+	defaultPools.clear();
+	customPools.clear();
+}
+
+VkDeviceSize RvMemoryAllocator::preferredBlockSize(uint32_t memoryType) const
+{
+	//Small heaps (e.g. the host visible window of device local memory) would be exhausted by a few large blocks
+	const VkDeviceSize heapSize = memoryProperties.memoryHeaps[memoryProperties.memoryTypes[memoryType].heapIndex].size;
+	return heapSize <= RV_SMALL_HEAP_SIZE ? alignUp(heapSize / 8, 32) : RV_MEMORY_BLOCK_SIZE;
+}
+
+bool RvMemoryAllocator::isMappable(uint32_t memoryType) const
+{
+	return (memoryProperties.memoryTypes[memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0;
+}
+
+bool RvMemoryAllocator::isCoherent(uint32_t memoryType) const
+{
+	return (memoryProperties.memoryTypes[memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
+}
+
+VkDeviceMemory RvMemoryAllocator::allocateMemory(VkDeviceSize size, uint32_t memoryType, const void* next, char*& mapped)
+{
+	VkMemoryAllocateInfo allocInfo = {};
+	allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+	allocInfo.pNext = next;
+	allocInfo.allocationSize = size;
+	allocInfo.memoryTypeIndex = memoryType;
+
+	VkDeviceMemory memory;
+	if (vkAllocateMemory(device, &allocInfo, nullptr, &memory) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to allocate device memory!");
+	}
+	allocationsCount++;
+	heapAllocatedBytes[memoryProperties.memoryTypes[memoryType].heapIndex] += size;
+
+	//Host visible memory stays mapped for its whole lifetime
+	mapped = nullptr;
+	if (isMappable(memoryType))
+	{
+		vkMapMemory(device, memory, 0, VK_WHOLE_SIZE, 0, reinterpret_cast<void**>(&mapped));
+	}
+	return memory;
+}
+
+void RvMemoryAllocator::freeMemory(VkDeviceMemory memory, VkDeviceSize size, uint32_t memoryType)
+{
+	//Freeing implicitly unmaps
+	vkFreeMemory(device, memory, nullptr);
+	allocationsCount--;
+	heapAllocatedBytes[memoryProperties.memoryTypes[memoryType].heapIndex] -= size;
+}
+
+void RvMemoryAllocator::destroyBlock(RvMemoryBlock* block)
+{
+	freeMemory(block->memory, block->size, block->pool->memoryType);
+	delete block;
+}
+
+void RvMemoryAllocator::addToCategory(const RvAllocation& allocation)
+{
+	categoryStats[allocation.category].allocationCount++;
+	categoryStats[allocation.category].bytes += allocation.size;
+}
+
+#pragma endregion
@@ -0,0 +1,317 @@
+#ifndef RV_MEMORY_ALLOCATOR_H
+#define RV_MEMORY_ALLOCATOR_H
+
+//EASTL Includes
+#include <eastl/vector.h>
+
+using eastl::vector;
+
+//STD Includes
+#include <mutex>
+
+//Vulkan Includes
+#include "volk.h"
+
+//Size of the blocks sub-allocated by default pools (heaps up to RV_SMALL_HEAP_SIZE use an eighth of the heap instead)
+#define RV_MEMORY_BLOCK_SIZE (64ull * 1024 * 1024)
+#define RV_SMALL_HEAP_SIZE (1024ull * 1024 * 1024)
+
+//Two-level segregated fit: power of two first level, split in RV_TLSF_SL_COUNT linear second level classes
+#define RV_TLSF_SL_LOG2 4
+#define RV_TLSF_SL_COUNT (1 << RV_TLSF_SL_LOG2)
+#define RV_TLSF_FL_COUNT 32
+#define RV_TLSF_NONE UINT32_MAX
+
+//Share of a heap assumed available when the driver can't report a budget
+#define RV_DEFAULT_BUDGET_RATIO 0.8
+
+//VK_EXT_memory_budget is newer than the bundled Vulkan headers
+#ifndef VK_EXT_memory_budget
+#define VK_EXT_memory_budget 1
+#define VK_EXT_MEMORY_BUDGET_EXTENSION_NAME "VK_EXT_memory_budget"
+#define VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT static_cast<VkStructureType>(1000237000)
+typedef struct VkPhysicalDeviceMemoryBudgetPropertiesEXT {
+	VkStructureType sType;
+	void* pNext;
+	VkDeviceSize heapBudget[VK_MAX_MEMORY_HEAPS];
+	VkDeviceSize heapUsage[VK_MAX_MEMORY_HEAPS];
+} VkPhysicalDeviceMemoryBudgetPropertiesEXT;
+#endif
+
+class RvMemoryBlock;
+class RvMemoryPool;
+
+//What an allocation holds, for budget reports
+enum RvAllocationCategory
+{
+	RV_ALLOCATION_GEOMETRY,
+	RV_ALLOCATION_TEXTURES,
+	RV_ALLOCATION_ATTACHMENTS,
+	RV_ALLOCATION_UNIFORMS,
+	RV_ALLOCATION_STAGING,
+	RV_ALLOCATION_OTHER,
+	RV_ALLOCATION_CATEGORY_COUNT
+};
+
+/**
+ * \brief Range of device memory bound to a resource, either sub-allocated from a block or dedicated.
+ */
+struct RvAllocation
+{
+	VkDeviceMemory memory = VK_NULL_HANDLE;
+	VkDeviceSize offset = 0;
+	VkDeviceSize size = 0;
+
+	//Host visible memory is persistently mapped, points at offset (null otherwise)
+	char* mapped = nullptr;
+
+	//Null for dedicated allocations
+	RvMemoryBlock* block = nullptr;
+	uint32_t chunk = RV_TLSF_NONE;
+	uint32_t memoryType = 0;
+	RvAllocationCategory category = RV_ALLOCATION_OTHER;
+};
+
+enum RvMemoryAlgorithm
+{
+	//Allocations can be freed in any order, free neighbours are merged
+	RV_MEMORY_ALGORITHM_TLSF,
+	//Bump allocation, a block is reused once every allocation made from it was freed
+	RV_MEMORY_ALGORITHM_LINEAR
+};
+
+//Buffers and optimal tiling images are kept in separate blocks when the device has a buffer-image granularity
+enum RvResourceKind
+{
+	RV_RESOURCE_LINEAR,
+	RV_RESOURCE_OPTIMAL,
+	RV_RESOURCE_KIND_COUNT
+};
+
+/**
+ * \brief Usage of a memory type (or of every type).
+ */
+struct RvMemoryStats
+{
+	uint32_t blockCount = 0;
+	VkDeviceSize blockBytes = 0;
+	uint32_t allocationCount = 0;
+	VkDeviceSize usedBytes = 0;
+	uint32_t freeRangeCount = 0;
+	VkDeviceSize freeBytes = 0;
+	VkDeviceSize largestFreeRange = 0;
+	//Sum of the largest free range of each block
+	VkDeviceSize contiguousFreeBytes = 0;
+	uint32_t dedicatedCount = 0;
+	VkDeviceSize dedicatedBytes = 0;
+
+	//0 when the free space of each block is contiguous, towards 1 as it gets split in small ranges
+	float fragmentation() const;
+
+	void add(const RvMemoryStats& other);
+};
+
+struct RvCategoryStats
+{
+	uint32_t allocationCount = 0;
+	VkDeviceSize bytes = 0;
+};
+
+/**
+ * \brief Usage of a memory heap against what the system lets the process use.
+ */
+struct RvMemoryBudget
+{
+	VkDeviceSize heapSize = 0;
+	bool deviceLocal = false;
+
+	//Device memory this allocator holds in the heap (blocks and dedicated allocations)
+	VkDeviceSize allocatedBytes = 0;
+
+	//Usage of the whole process and its budget, estimated from the allocated bytes and the heap size without VK_EXT_memory_budget
+	VkDeviceSize usage = 0;
+	VkDeviceSize budget = 0;
+
+	//Over 1 once the budget is exceeded, the system may start paging memory out
+	float pressure() const { return budget > 0 ? static_cast<float>(usage) / budget : 0.0f; }
+};
+
+/**
+ * \brief One vkAllocateMemory, resources are placed in it by a TLSF or a linear allocator.
+ */
+class RvMemoryBlock
+{
+public:
+	RvMemoryBlock(RvMemoryPool* pool, VkDeviceMemory memory, VkDeviceSize size, char* mapped);
+
+	RvMemoryPool* pool;
+	VkDeviceMemory memory;
+	VkDeviceSize size;
+	char* mapped;
+
+	/**
+	 * \return False if there is no free range large enough (once aligned).
+	 */
+	bool allocate(VkDeviceSize allocationSize, VkDeviceSize alignment, VkDeviceSize& offset, uint32_t& chunk);
+	void free(uint32_t chunk, VkDeviceSize allocationSize);
+
+	bool isEmpty() const { return allocationCount == 0; }
+	void addStats(RvMemoryStats& stats) const;
+
+private:
+	struct RvMemoryChunk
+	{
+		VkDeviceSize offset;
+		VkDeviceSize size;
+		//Neighbours by offset and inside the free list of the chunk size class
+		uint32_t prevPhysical;
+		uint32_t nextPhysical;
+		uint32_t prevFree;
+		uint32_t nextFree;
+		bool free;
+	};
+
+	uint32_t allocationCount = 0;
+	VkDeviceSize usedBytes = 0;
+
+	//Linear algorithm
+	VkDeviceSize head = 0;
+
+	//TLSF algorithm (unused chunks have a zero size)
+	vector<RvMemoryChunk> chunks;
+	vector<uint32_t> unusedChunks;
+	uint32_t firstLevelBitmap = 0;
+	uint32_t secondLevelBitmaps[RV_TLSF_FL_COUNT] = {};
+	uint32_t freeLists[RV_TLSF_FL_COUNT][RV_TLSF_SL_COUNT];
+
+	uint32_t newChunk();
+	void releaseChunk(uint32_t chunk);
+	void insertFree(uint32_t chunk);
+	void removeFree(uint32_t chunk);
+	uint32_t findFree(VkDeviceSize minimumSize) const;
+};
+
+/**
+ * \brief Blocks of one memory type sharing an algorithm.
+ */
+class RvMemoryPool
+{
+public:
+	RvMemoryPool(uint32_t memoryType, VkDeviceSize blockSize, RvMemoryAlgorithm algorithm, bool isDefault);
+
+	uint32_t memoryType;
+	VkDeviceSize blockSize;
+	RvMemoryAlgorithm algorithm;
+
+	//Default pools give empty blocks back (but one), custom pools keep them until destroyed
+	bool isDefault;
+
+	vector<RvMemoryBlock*> blocks;
+};
+
+/**
+ * \brief Sub-allocates device memory from large blocks per memory type instead of calling vkAllocateMemory per resource.
+ * Large resources (more than half a block, or the ones the driver asks for) get dedicated allocations.
+ * Reference: https://developer.nvidia.com/vulkan-memory-management
+ */
+class RvMemoryAllocator
+{
+public:
+	RvMemoryAllocator(VkDevice device, VkPhysicalDevice physicalDevice, bool memoryBudgetSupported);
+	~RvMemoryAllocator();
+
+	/**
+	 * \brief Places a resource in a block of the memory type (or of the pool, which must hold buffers only).
+	 */
+	RvAllocation allocate(const VkMemoryRequirements& requirements, uint32_t memoryType, RvResourceKind kind, RvAllocationCategory category,
+		RvMemoryPool* pool = nullptr);
+
+	/**
+	 * \brief Allocates memory for a single resource, the image or buffer (if any) is passed on to the driver as its dedicated owner.
+	 */
+	RvAllocation allocateDedicated(VkDeviceSize size, uint32_t memoryType, RvAllocationCategory category,
+		VkImage image = VK_NULL_HANDLE, VkBuffer buffer = VK_NULL_HANDLE);
+
+	/**
+	 * \brief Takes ownership of memory allocated elsewhere (e.g. imported), it is freed as a dedicated allocation.
+	 */
+	RvAllocation adopt(VkDeviceMemory memory, VkDeviceSize size, uint32_t memoryType, RvAllocationCategory category);
+
+	void free(RvAllocation& allocation);
+
+	/**
+	 * \brief Creates a pool of buffers with its own blocks, e.g. a linear pool for resources released all together.
+	 */
+	RvMemoryPool* createPool(uint32_t memoryType, VkDeviceSize blockSize, RvMemoryAlgorithm algorithm);
+	void destroyPool(RvMemoryPool* pool);
+
+	/**
+	 * \brief Flushes host writes to an allocation of a non coherent memory type.
+	 */
+	void flush(const RvAllocation& allocation) const;
+
+	RvMemoryStats getStats(uint32_t memoryType) const;
+	RvMemoryStats getTotalStats() const;
+	RvCategoryStats getCategoryStats(RvAllocationCategory category) const;
+	static const char* categoryName(RvAllocationCategory category);
+	void printStats() const;
+
+	/**
+	 * \brief Queries the heap budgets (with VK_EXT_memory_budget), meant to be called once per frame.
+	 */
+	void updateBudget();
+
+	uint32_t heapCount() const { return memoryProperties.memoryHeapCount; }
+	RvMemoryBudget getBudget(uint32_t heapIndex) const;
+
+	/**
+	 * \brief Highest pressure of the device local heaps, streaming and detail levels should back off as it nears 1.
+	 */
+	float deviceLocalPressure() const;
+	bool isBudgetSupported() const { return memoryBudgetSupported; }
+
+	//Live vkAllocateMemory calls, must stay below the device maxMemoryAllocationCount
+	uint32_t deviceAllocationCount() const { return allocationsCount; }
+
+	/**
+	 * \brief Should be used instead of destroying in destructor
+	 */
+	void clear();
+
+private:
+	VkDevice device;
+	VkPhysicalDevice physicalDevice;
+	VkPhysicalDeviceMemoryProperties memoryProperties;
+	VkDeviceSize bufferImageGranularity;
+	VkDeviceSize nonCoherentAtomSize;
+	uint32_t maxAllocationCount;
+
+	mutable std::mutex mutex;
+
+	//Indexed by memory type * RV_RESOURCE_KIND_COUNT + kind, created when first used
+	vector<RvMemoryPool*> defaultPools;
+	vector<RvMemoryPool*> customPools;
+
+	vector<uint32_t> dedicatedCounts;
+	vector<VkDeviceSize> dedicatedBytes;
+	uint32_t allocationsCount = 0;
+	RvCategoryStats categoryStats[RV_ALLOCATION_CATEGORY_COUNT];
+
+	//Budget of each heap as last queried, allocations made since are added to the reported usage
+	bool memoryBudgetSupported;
+	VkDeviceSize heapAllocatedBytes[VK_MAX_MEMORY_HEAPS] = {};
+	VkDeviceSize heapAllocatedAtUpdate[VK_MAX_MEMORY_HEAPS] = {};
+	VkDeviceSize heapUsage[VK_MAX_MEMORY_HEAPS] = {};
+	VkDeviceSize heapBudget[VK_MAX_MEMORY_HEAPS] = {};
+
+	VkDeviceSize preferredBlockSize(uint32_t memoryType) const;
+	bool isMappable(uint32_t memoryType) const;
+	bool isCoherent(uint32_t memoryType) const;
+	VkDeviceMemory allocateMemory(VkDeviceSize size, uint32_t memoryType, const void* next, char*& mapped);
+	void freeMemory(VkDeviceMemory memory, VkDeviceSize size, uint32_t memoryType);
+	RvAllocation allocateDedicatedLocked(VkDeviceSize size, uint32_t memoryType, RvAllocationCategory category, VkImage image, VkBuffer buffer);
+	void addToCategory(const RvAllocation& allocation);
+	void destroyBlock(RvMemoryBlock* block);
+};
+
+#endif
@@ -0,0 +1,751 @@
+#include "RvMeshOptimizer.h"
+
+//STD Includes
+#include <cmath>
+
+//EASTL Includes
+#include <eastl/sort.h>
+
+//GLM Includes
+#include <glm/glm.hpp>
+
+namespace
+{
+	const uint32_t INVALID_INDEX = ~0u;
+
+	//Forsyth's scoring parameters (https://tomforsyth1000.github.io/papers/fast_vert_cache_opt.html)
+	const uint32_t FORSYTH_CACHE_SIZE = 32;
+	const float FORSYTH_CACHE_DECAY_POWER = 1.5f;
+	const float FORSYTH_LAST_TRI_SCORE = 0.75f;
+	const float FORSYTH_VALENCE_BOOST_SCALE = 2.0f;
+	const float FORSYTH_VALENCE_BOOST_POWER = 0.5f;
+
+	//Smallest cluster (in triangles) the overdraw optimizer splits into
+	const uint32_t OVERDRAW_MIN_CLUSTER_SIZE = 32;
+
+	//Symmetric 4x4 matrix accumulating (area weighted) squared distances to planes
+	struct RvQuadric
+	{
+		double a00 = 0, a01 = 0, a02 = 0, a03 = 0;
+		double a11 = 0, a12 = 0, a13 = 0;
+		double a22 = 0, a23 = 0;
+		double a33 = 0;
+		double weight = 0;
+
+		void addPlane(double a, double b, double c, double d, double planeWeight)
+		{
+			a00 += planeWeight * a * a; a01 += planeWeight * a * b; a02 += planeWeight * a * c; a03 += planeWeight * a * d;
+			a11 += planeWeight * b * b; a12 += planeWeight * b * c; a13 += planeWeight * b * d;
+			a22 += planeWeight * c * c; a23 += planeWeight * c * d;
+			a33 += planeWeight * d * d;
+			weight += planeWeight;
+		}
+
+		void add(const RvQuadric& other)
+		{
+			a00 += other.a00; a01 += other.a01; a02 += other.a02; a03 += other.a03;
+			a11 += other.a11; a12 += other.a12; a13 += other.a13;
+			a22 += other.a22; a23 += other.a23;
+			a33 += other.a33;
+			weight += other.weight;
+		}
+
+		//Mean squared distance from p to the accumulated planes
+		double evaluate(const glm::vec3& p) const
+		{
+			if (weight <= 0.0)
+			{
+				return 0.0;
+			}
+			const double x = p.x, y = p.y, z = p.z;
+			const double error = a00 * x * x + 2 * a01 * x * y + 2 * a02 * x * z + 2 * a03 * x +
+				a11 * y * y + 2 * a12 * y * z + 2 * a13 * y +
+				a22 * z * z + 2 * a23 * z +
+				a33;
+			return error > 0.0 ? error / weight : 0.0;
+		}
+	};
+
+	struct RvCollapse
+	{
+		uint32_t from;
+		uint32_t to;
+		double error;
+	};
+
+	uint32_t dominantBone(const RvSkinnedVertexColored& vertex)
+	{
+		uint32_t dominant = 0;
+		for (uint32_t i = 1; i < 4; i++)
+		{
+			if (vertex.boneWeights[i] > vertex.boneWeights[dominant])
+			{
+				dominant = i;
+			}
+		}
+		return vertex.boneWeights[dominant] > 0.0f ? vertex.boneIDs[dominant] : INVALID_INDEX;
+	}
+
+	void computeMeshletBounds(RvMeshlet& meshlet, const uint32_t* indices, const RvSkinnedVertexColored* vertices,
+		const uint32_t* meshletVertices)
+	{
+		//Sphere centered at the vertices average
+		glm::vec3 center = glm::vec3(0.0f);
+		for (uint32_t v = 0; v < meshlet.vertexCount; v++)
+		{
+			center += vertices[meshletVertices[v]].pos;
+		}
+		center /= static_cast<float>(meshlet.vertexCount);
+		float radius = 0.0f;
+		for (uint32_t v = 0; v < meshlet.vertexCount; v++)
+		{
+			radius = glm::max(radius, glm::length(vertices[meshletVertices[v]].pos - center));
+		}
+		meshlet.boundingSphere = glm::vec4(center, radius);
+
+		//Cone axis is the area weighted average of the triangle normals
+		const uint32_t triangleCount = meshlet.indexCount / 3;
+		vector<glm::vec3> normals(triangleCount);
+		glm::vec3 axis = glm::vec3(0.0f);
+		for (uint32_t t = 0; t < triangleCount; t++)
+		{
+			const uint32_t* triangle = &indices[meshlet.firstIndex + t * 3];
+			const glm::vec3& p0 = vertices[triangle[0]].pos;
+			const glm::vec3 normal = glm::cross(vertices[triangle[1]].pos - p0, vertices[triangle[2]].pos - p0);
+			axis += normal;
+			const float area = glm::length(normal);
+			normals[t] = area > 0.0f ? normal / area : glm::vec3(0.0f);
+		}
+		const float axisLength = glm::length(axis);
+		if (axisLength <= 0.0f)
+		{
+			//Cutoff above 1 never passes the culling test
+			meshlet.normalCone = glm::vec4(0.0f, 0.0f, 0.0f, 2.0f);
+			return;
+		}
+		axis /= axisLength;
+
+		//Cone aperture covers the normal deviating the most from the axis
+		float minDot = 1.0f;
+		for (uint32_t t = 0; t < triangleCount; t++)
+		{
+			if (normals[t] != glm::vec3(0.0f))
+			{
+				minDot = glm::min(minDot, glm::dot(normals[t], axis));
+			}
+		}
+		const float cutoff = minDot <= 0.0f ? 2.0f : glm::sqrt(1.0f - minDot * minDot);
+		meshlet.normalCone = glm::vec4(axis, cutoff);
+	}
+
+	float forsythVertexScore(int32_t cachePosition, uint32_t remainingValence)
+	{
+		//Vertex isn't used by any remaining triangle
+		if (remainingValence == 0)
+		{
+			return -1.0f;
+		}
+
+		float score = 0.0f;
+		if (cachePosition >= 0)
+		{
+			//Vertices of the last triangle are scored equally, so the strip direction doesn't matter
+			if (cachePosition < 3)
+			{
+				score = FORSYTH_LAST_TRI_SCORE;
+			}
+			else
+			{
+				const float scaler = 1.0f / (FORSYTH_CACHE_SIZE - 3);
+				score = std::pow(1.0f - (cachePosition - 3) * scaler, FORSYTH_CACHE_DECAY_POWER);
+			}
+		}
+
+		//Boost vertices with few triangles left, so they don't become lonely
+		score += FORSYTH_VALENCE_BOOST_SCALE * std::pow(static_cast<float>(remainingValence), -FORSYTH_VALENCE_BOOST_POWER);
+		return score;
+	}
+}
+
+namespace rvTools
+{
+	namespace optimizer
+	{
+		RvVertexCacheStats analyzeVertexCache(const uint32_t* indices, uint32_t indexCount, uint32_t vertexCount, uint32_t cacheSize)
+		{
+			RvVertexCacheStats stats;
+			if (indexCount < 3 || vertexCount == 0)
+			{
+				return stats;
+			}
+
+			//FIFO cache: a vertex is cached while fewer than cacheSize misses happened since it was transformed
+			vector<uint32_t> timestamps(vertexCount, 0);
+			uint32_t time = cacheSize + 1;
+			uint32_t misses = 0;
+			for (uint32_t i = 0; i < indexCount; i++)
+			{
+				const uint32_t index = indices[i];
+				if (time - timestamps[index] > cacheSize)
+				{
+					timestamps[index] = time++;
+					misses++;
+				}
+			}
+
+			stats.acmr = static_cast<float>(misses) / (indexCount / 3);
+			stats.atvr = static_cast<float>(misses) / vertexCount;
+			return stats;
+		}
+
+		void optimizeVertexCache(uint32_t* indices, uint32_t indexCount, uint32_t vertexCount)
+		{
+			const uint32_t triangleCount = indexCount / 3;
+			if (triangleCount == 0)
+			{
+				return;
+			}
+
+			//Build vertex to triangle adjacency
+			vector<uint32_t> valence(vertexCount, 0);
+			for (uint32_t i = 0; i < indexCount; i++)
+			{
+				valence[indices[i]]++;
+			}
+			vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+			for (uint32_t v = 0; v < vertexCount; v++)
+			{
+				adjacencyOffsets[v + 1] = adjacencyOffsets[v] + valence[v];
+			}
+			vector<uint32_t> adjacency(indexCount);
+			vector<uint32_t> remainingValence(vertexCount, 0);
+			for (uint32_t t = 0; t < triangleCount; t++)
+			{
+				for (uint32_t k = 0; k < 3; k++)
+				{
+					const uint32_t v = indices[t * 3 + k];
+					adjacency[adjacencyOffsets[v] + remainingValence[v]++] = t;
+				}
+			}
+
+			//Initial scores
+			vector<int32_t> cachePosition(vertexCount, -1);
+			vector<float> vertexScore(vertexCount);
+			for (uint32_t v = 0; v < vertexCount; v++)
+			{
+				vertexScore[v] = forsythVertexScore(-1, remainingValence[v]);
+			}
+			vector<float> triangleScore(triangleCount);
+			vector<uint8_t> emitted(triangleCount, 0);
+			uint32_t bestTriangle = 0;
+			for (uint32_t t = 0; t < triangleCount; t++)
+			{
+				triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+				if (triangleScore[t] > triangleScore[bestTriangle])
+				{
+					bestTriangle = t;
+				}
+			}
+
+			uint32_t cache[FORSYTH_CACHE_SIZE + 3];
+			uint32_t cacheCount = 0;
+			uint32_t scanCursor = 0;
+			vector<uint32_t> output(indexCount);
+			for (uint32_t emittedCount = 0; emittedCount < triangleCount; emittedCount++)
+			{
+				//Nothing adjacent to the cache remains, resume from the next unemitted triangle
+				if (bestTriangle == INVALID_INDEX)
+				{
+					while (emitted[scanCursor])
+					{
+						scanCursor++;
+					}
+					bestTriangle = scanCursor;
+				}
+
+				const uint32_t* triangle = &indices[bestTriangle * 3];
+				output[emittedCount * 3 + 0] = triangle[0];
+				output[emittedCount * 3 + 1] = triangle[1];
+				output[emittedCount * 3 + 2] = triangle[2];
+				emitted[bestTriangle] = 1;
+
+				//Detach emitted triangle from its vertices
+				for (uint32_t k = 0; k < 3; k++)
+				{
+					const uint32_t v = triangle[k];
+					uint32_t* vertexTriangles = &adjacency[adjacencyOffsets[v]];
+					for (uint32_t a = 0; a < remainingValence[v]; a++)
+					{
+						if (vertexTriangles[a] == bestTriangle)
+						{
+							vertexTriangles[a] = vertexTriangles[remainingValence[v] - 1];
+							break;
+						}
+					}
+					remainingValence[v]--;
+				}
+
+				//Move the triangle vertices to the front of the LRU cache
+				uint32_t newCache[FORSYTH_CACHE_SIZE + 3];
+				uint32_t newCacheCount = 0;
+				newCache[newCacheCount++] = triangle[0];
+				newCache[newCacheCount++] = triangle[1];
+				newCache[newCacheCount++] = triangle[2];
+				for (uint32_t c = 0; c < cacheCount; c++)
+				{
+					const uint32_t v = cache[c];
+					if (v != triangle[0] && v != triangle[1] && v != triangle[2])
+					{
+						newCache[newCacheCount++] = v;
+					}
+				}
+
+				//Update vertex scores (entries past the cache size were just evicted)
+				for (uint32_t c = 0; c < newCacheCount; c++)
+				{
+					const uint32_t v = newCache[c];
+					cachePosition[v] = c < FORSYTH_CACHE_SIZE ? static_cast<int32_t>(c) : -1;
+					vertexScore[v] = forsythVertexScore(cachePosition[v], remainingValence[v]);
+				}
+
+				//Rescore triangles touching the cache and pick the best one
+				bestTriangle = INVALID_INDEX;
+				float bestScore = -1.0f;
+				for (uint32_t c = 0; c < newCacheCount; c++)
+				{
+					const uint32_t v = newCache[c];
+					const uint32_t* vertexTriangles = &adjacency[adjacencyOffsets[v]];
+					for (uint32_t a = 0; a < remainingValence[v]; a++)
+					{
+						const uint32_t t = vertexTriangles[a];
+						triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+						if (triangleScore[t] > bestScore)
+						{
+							bestScore = triangleScore[t];
+							bestTriangle = t;
+						}
+					}
+				}
+
+				cacheCount = newCacheCount < FORSYTH_CACHE_SIZE ? newCacheCount : FORSYTH_CACHE_SIZE;
+				memcpy(cache, newCache, sizeof(uint32_t) * cacheCount);
+			}
+
+			memcpy(indices, output.data(), sizeof(uint32_t) * indexCount);
+		}
+
+		void optimizeOverdraw(uint32_t* indices, uint32_t indexCount, const RvSkinnedVertexColored* vertices, uint32_t vertexCount, float threshold)
+		{
+			const uint32_t triangleCount = indexCount / 3;
+			if (triangleCount <= OVERDRAW_MIN_CLUSTER_SIZE)
+			{
+				return;
+			}
+
+			//Split into clusters whose cache efficiency stays close to the whole mesh (Sander et al. 2007)
+			const uint32_t cacheSize = 16;
+			const float targetAcmr = analyzeVertexCache(indices, indexCount, vertexCount, cacheSize).acmr * threshold;
+			vector<uint32_t> clusterStarts;
+			clusterStarts.push_back(0);
+			vector<uint32_t> timestamps(vertexCount, 0);
+			uint32_t time = cacheSize + 1;
+			uint32_t clusterMisses = 0;
+			for (uint32_t t = 0; t < triangleCount; t++)
+			{
+				for (uint32_t k = 0; k < 3; k++)
+				{
+					const uint32_t index = indices[t * 3 + k];
+					if (time - timestamps[index] > cacheSize)
+					{
+						timestamps[index] = time++;
+						clusterMisses++;
+					}
+				}
+
+				const uint32_t clusterSize = t + 1 - clusterStarts.back();
+				if (clusterSize >= OVERDRAW_MIN_CLUSTER_SIZE && t + 1 < triangleCount &&
+					static_cast<float>(clusterMisses) / clusterSize <= targetAcmr)
+				{
+					//Next cluster starts with a cold cache, as it may be drawn after any other
+					clusterStarts.push_back(t + 1);
+					clusterMisses = 0;
+					time += cacheSize + 1;
+				}
+			}
+			clusterStarts.push_back(triangleCount);
+			const uint32_t clusterCount = static_cast<uint32_t>(clusterStarts.size()) - 1;
+			if (clusterCount < 2)
+			{
+				return;
+			}
+
+			//Area weighted centroid and normal of each cluster
+			vector<glm::vec3> clusterCentroids(clusterCount, glm::vec3(0.0f));
+			vector<glm::vec3> clusterNormals(clusterCount, glm::vec3(0.0f));
+			glm::vec3 meshCentroid = glm::vec3(0.0f);
+			float meshArea = 0.0f;
+			for (uint32_t c = 0; c < clusterCount; c++)
+			{
+				float clusterArea = 0.0f;
+				for (uint32_t t = clusterStarts[c]; t < clusterStarts[c + 1]; t++)
+				{
+					const glm::vec3& p0 = vertices[indices[t * 3 + 0]].pos;
+					const glm::vec3& p1 = vertices[indices[t * 3 + 1]].pos;
+					const glm::vec3& p2 = vertices[indices[t * 3 + 2]].pos;
+					const glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+					const float area = glm::length(normal);
+					clusterCentroids[c] += (p0 + p1 + p2) * (area / 3.0f);
+					clusterNormals[c] += normal;
+					clusterArea += area;
+				}
+				meshCentroid += clusterCentroids[c];
+				meshArea += clusterArea;
+				clusterCentroids[c] = clusterArea > 0.0f ? clusterCentroids[c] / clusterArea : vertices[indices[clusterStarts[c] * 3]].pos;
+			}
+			meshCentroid = meshArea > 0.0f ? meshCentroid / meshArea : glm::vec3(0.0f);
+
+			//Clusters facing away from the center occlude the others, so they are drawn first
+			vector<float> sortKeys(clusterCount);
+			vector<uint32_t> clusterOrder(clusterCount);
+			for (uint32_t c = 0; c < clusterCount; c++)
+			{
+				const float normalLength = glm::length(clusterNormals[c]);
+				const glm::vec3 normal = normalLength > 0.0f ? clusterNormals[c] / normalLength : glm::vec3(0.0f);
+				sortKeys[c] = glm::dot(clusterCentroids[c] - meshCentroid, normal);
+				clusterOrder[c] = c;
+			}
+			eastl::stable_sort(clusterOrder.begin(), clusterOrder.end(), [&sortKeys](uint32_t a, uint32_t b) {
+				return sortKeys[a] > sortKeys[b];
+			});
+
+			vector<uint32_t> output;
+			output.reserve(indexCount);
+			for (uint32_t c : clusterOrder)
+			{
+				output.insert(output.end(), indices + clusterStarts[c] * 3, indices + clusterStarts[c + 1] * 3);
+			}
+			memcpy(indices, output.data(), sizeof(uint32_t) * triangleCount * 3);
+		}
+
+		uint32_t optimizeVertexFetch(RvSkinnedVertexColored* vertices, uint32_t vertexCount, uint32_t* indices, uint32_t indexCount)
+		{
+			//Assign new vertex ids in order of first use
+			vector<uint32_t> remap(vertexCount, INVALID_INDEX);
+			uint32_t usedCount = 0;
+			for (uint32_t i = 0; i < indexCount; i++)
+			{
+				uint32_t& newIndex = remap[indices[i]];
+				if (newIndex == INVALID_INDEX)
+				{
+					newIndex = usedCount++;
+				}
+				indices[i] = newIndex;
+			}
+
+			//Move attributes along (unused vertices are dropped)
+			vector<RvSkinnedVertexColored> original(vertices, vertices + vertexCount);
+			for (uint32_t v = 0; v < vertexCount; v++)
+			{
+				if (remap[v] != INVALID_INDEX)
+				{
+					vertices[remap[v]] = original[v];
+				}
+			}
+
+			return usedCount;
+		}
+
+		uint32_t simplify(uint32_t* destination, const uint32_t* indices, uint32_t indexCount, const RvSkinnedVertexColored* vertices, uint32_t vertexCount,
+			uint32_t targetIndexCount, float& resultError)
+		{
+			vector<uint32_t> result(indices, indices + indexCount);
+			double maxError = 0.0;
+
+			//Vertices sharing a position are seams (split UVs or normals), moving them would tear the surface
+			vector<uint8_t> locked(vertexCount, 0);
+			vector<uint32_t> sortedVertices(vertexCount);
+			for (uint32_t v = 0; v < vertexCount; v++)
+			{
+				sortedVertices[v] = v;
+			}
+			eastl::sort(sortedVertices.begin(), sortedVertices.end(), [vertices](uint32_t a, uint32_t b) {
+				const glm::vec3& pa = vertices[a].pos;
+				const glm::vec3& pb = vertices[b].pos;
+				return pa.x != pb.x ? pa.x < pb.x : (pa.y != pb.y ? pa.y < pb.y : pa.z < pb.z);
+			});
+			for (uint32_t i = 1; i < vertexCount; i++)
+			{
+				if (vertices[sortedVertices[i]].pos == vertices[sortedVertices[i - 1]].pos)
+				{
+					locked[sortedVertices[i]] = 1;
+					locked[sortedVertices[i - 1]] = 1;
+				}
+			}
+
+			//Border edges (used by a single triangle) lock their vertices
+			vector<uint64_t> edges;
+			edges.reserve(indexCount);
+			for (uint32_t i = 0; i + 2 < indexCount; i += 3)
+			{
+				for (uint32_t k = 0; k < 3; k++)
+				{
+					const uint64_t a = indices[i + k], b = indices[i + (k + 1) % 3];
+					edges.push_back(a < b ? (a << 32) | b : (b << 32) | a);
+				}
+			}
+			eastl::sort(edges.begin(), edges.end());
+			for (uint32_t i = 0; i < edges.size();)
+			{
+				uint32_t run = 1;
+				while (i + run < edges.size() && edges[i + run] == edges[i])
+				{
+					run++;
+				}
+				if (run == 1)
+				{
+					locked[static_cast<uint32_t>(edges[i] >> 32)] = 1;
+					locked[static_cast<uint32_t>(edges[i] & 0xFFFFFFFF)] = 1;
+				}
+				i += run;
+			}
+
+			//Plane quadrics of every triangle accumulated on its vertices
+			vector<RvQuadric> quadrics(vertexCount);
+			for (uint32_t i = 0; i + 2 < indexCount; i += 3)
+			{
+				const glm::vec3& p0 = vertices[indices[i]].pos;
+				const glm::vec3 normal = glm::cross(vertices[indices[i + 1]].pos - p0, vertices[indices[i + 2]].pos - p0);
+				const float length = glm::length(normal);
+				if (length <= 0.0f)
+				{
+					continue;
+				}
+				const glm::vec3 n = normal / length;
+				for (uint32_t k = 0; k < 3; k++)
+				{
+					quadrics[indices[i + k]].addPlane(n.x, n.y, n.z, -glm::dot(n, p0), length * 0.5);
+				}
+			}
+
+			vector<uint32_t> bones(vertexCount);
+			for (uint32_t v = 0; v < vertexCount; v++)
+			{
+				bones[v] = dominantBone(vertices[v]);
+			}
+
+			//Collapse the cheapest independent edges in passes, until the target is reached
+			vector<RvCollapse> collapses;
+			vector<uint32_t> remap(vertexCount);
+			vector<uint8_t> touched(vertexCount);
+			vector<uint32_t> adjacencyOffsets(vertexCount + 1);
+			vector<uint32_t> adjacency;
+			while (result.size() > targetIndexCount)
+			{
+				const uint32_t triangleCount = static_cast<uint32_t>(result.size()) / 3;
+
+				collapses.clear();
+				for (uint32_t i = 0; i < result.size(); i += 3)
+				{
+					for (uint32_t k = 0; k < 3; k++)
+					{
+						const uint32_t from = result[i + k];
+						const uint32_t to = result[i + (k + 1) % 3];
+						if (!locked[from] && bones[from] == bones[to])
+						{
+							RvQuadric quadric = quadrics[from];
+							quadric.add(quadrics[to]);
+							collapses.push_back({ from, to, quadric.evaluate(vertices[to].pos) });
+						}
+					}
+				}
+				if (collapses.empty())
+				{
+					break;
+				}
+				eastl::sort(collapses.begin(), collapses.end(), [](const RvCollapse& a, const RvCollapse& b) {
+					return a.error < b.error;
+				});
+
+				//Vertex to triangle adjacency of the current result, for flip checks
+				eastl::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+				for (uint32_t index : result)
+				{
+					adjacencyOffsets[index + 1]++;
+				}
+				for (uint32_t v = 0; v < vertexCount; v++)
+				{
+					adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+				}
+				adjacency.resize(result.size());
+				vector<uint32_t> cursor(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+				for (uint32_t i = 0; i < result.size(); i++)
+				{
+					adjacency[cursor[result[i]]++] = i / 3;
+				}
+
+				for (uint32_t v = 0; v < vertexCount; v++)
+				{
+					remap[v] = v;
+				}
+				eastl::fill(touched.begin(), touched.end(), 0);
+
+				//Each collapse removes two triangles on manifold meshes
+				const uint32_t targetTriangles = targetIndexCount / 3;
+				uint32_t collapsed = 0;
+				for (const RvCollapse& collapse : collapses)
+				{
+					if (targetTriangles + collapsed * 2 >= triangleCount)
+					{
+						break;
+					}
+					if (touched[collapse.from] || touched[collapse.to])
+					{
+						continue;
+					}
+
+					//Reject collapses flipping any remaining triangle around the moved vertex
+					bool flips = false;
+					for (uint32_t a = adjacencyOffsets[collapse.from]; a < adjacencyOffsets[collapse.from + 1] && !flips; a++)
+					{
+						const uint32_t* triangle = &result[adjacency[a] * 3];
+						if (triangle[0] == collapse.to || triangle[1] == collapse.to || triangle[2] == collapse.to)
+						{
+							continue;
+						}
+						glm::vec3 before[3], after[3];
+						for (uint32_t k = 0; k < 3; k++)
+						{
+							before[k] = vertices[triangle[k]].pos;
+							after[k] = triangle[k] == collapse.from ? vertices[collapse.to].pos : before[k];
+						}
+						const glm::vec3 normalBefore = glm::cross(before[1] - before[0], before[2] - before[0]);
+						const glm::vec3 normalAfter = glm::cross(after[1] - after[0], after[2] - after[0]);
+						flips = glm::dot(normalBefore, normalAfter) <= 0.0f;
+					}
+					if (flips)
+					{
+						continue;
+					}
+
+					//Neighbors are frozen for this pass so flip checks stay valid
+					for (uint32_t a = adjacencyOffsets[collapse.from]; a < adjacencyOffsets[collapse.from + 1]; a++)
+					{
+						const uint32_t* triangle = &result[adjacency[a] * 3];
+						touched[triangle[0]] = touched[triangle[1]] = touched[triangle[2]] = 1;
+					}
+					touched[collapse.to] = 1;
+
+					remap[collapse.from] = collapse.to;
+					quadrics[collapse.to].add(quadrics[collapse.from]);
+					maxError = collapse.error > maxError ? collapse.error : maxError;
+					collapsed++;
+				}
+				if (collapsed == 0)
+				{
+					break;
+				}
+
+				//Apply collapses and drop degenerated triangles
+				uint32_t writeIndex = 0;
+				for (uint32_t i = 0; i < result.size(); i += 3)
+				{
+					const uint32_t a = remap[result[i]], b = remap[result[i + 1]], c = remap[result[i + 2]];
+					if (a != b && b != c && a != c)
+					{
+						result[writeIndex++] = a;
+						result[writeIndex++] = b;
+						result[writeIndex++] = c;
+					}
+				}
+				result.resize(writeIndex);
+			}
+
+			resultError = static_cast<float>(std::sqrt(maxError));
+			memcpy(destination, result.data(), sizeof(uint32_t) * result.size());
+			return static_cast<uint32_t>(result.size());
+		}
+
+		void buildLodChain(RvSkinnedMeshColored& mesh, uint32_t maxLods)
+		{
+			mesh.lods.clear();
+			mesh.lods.push_back({ 0, mesh.indexCount, 0.0f });
+
+			vector<uint32_t> chain(mesh.indices, mesh.indices + mesh.indexCount);
+			vector<uint32_t> simplified(mesh.indexCount);
+			for (uint32_t lod = 1; lod < maxLods; lod++)
+			{
+				//Each level halves the previous one, simplified from the original to avoid accumulating error
+				const RvMeshLod& previous = mesh.lods.back();
+				const uint32_t targetIndexCount = (previous.indexCount / 6) * 3;
+				float error = 0.0f;
+				const uint32_t simplifiedCount = simplify(simplified.data(), mesh.indices, mesh.indexCount, mesh.vertices, mesh.vertexCount,
+					targetIndexCount, error);
+
+				//Not worth a level if it didn't get meaningfully smaller
+				if (simplifiedCount == 0 || simplifiedCount > previous.indexCount * 9 / 10)
+				{
+					break;
+				}
+
+				optimizeVertexCache(simplified.data(), simplifiedCount, mesh.vertexCount);
+				mesh.lods.push_back({ static_cast<uint32_t>(chain.size()), simplifiedCount, glm::max(error, previous.error) });
+				chain.insert(chain.end(), simplified.begin(), simplified.begin() + simplifiedCount);
+			}
+
+			delete[] mesh.indices;
+			mesh.indexCount = static_cast<uint32_t>(chain.size());
+			mesh.indices = new uint32_t[mesh.indexCount];
+			memcpy(mesh.indices, chain.data(), sizeof(uint32_t) * mesh.indexCount);
+		}
+
+		void buildMeshlets(const uint32_t* indices, uint32_t indexCount, const RvSkinnedVertexColored* vertices, uint32_t vertexCount,
+			vector<RvMeshlet>& meshlets, uint32_t maxVertices, uint32_t maxTriangles)
+		{
+			meshlets.clear();
+			const uint32_t triangleCount = indexCount / 3;
+			if (triangleCount == 0)
+			{
+				return;
+			}
+
+			//Triangles are taken in order, which keeps the cache and overdraw optimized sequence intact
+			vector<uint32_t> vertexMeshlet(vertexCount, INVALID_INDEX);
+			uint32_t meshletVertices[RV_MESHLET_MAX_VERTICES];
+			RvMeshlet meshlet = {};
+			for (uint32_t t = 0; t < triangleCount; t++)
+			{
+				const uint32_t* triangle = &indices[t * 3];
+				const uint32_t meshletId = static_cast<uint32_t>(meshlets.size());
+				uint32_t newVertices = 0;
+				for (uint32_t k = 0; k < 3; k++)
+				{
+					//Repeated vertices (degenerate triangles) are only counted once
+					const bool repeated = (k > 0 && triangle[k] == triangle[0]) || (k > 1 && triangle[k] == triangle[1]);
+					newVertices += vertexMeshlet[triangle[k]] != meshletId && !repeated ? 1 : 0;
+				}
+
+				//Flush when the triangle doesn't fit
+				if (meshlet.vertexCount + newVertices > maxVertices || meshlet.indexCount / 3 + 1 > maxTriangles)
+				{
+					computeMeshletBounds(meshlet, indices, vertices, meshletVertices);
+					meshlets.push_back(meshlet);
+					meshlet = {};
+					meshlet.firstIndex = t * 3;
+				}
+
+				const uint32_t currentId = static_cast<uint32_t>(meshlets.size());
+				for (uint32_t k = 0; k < 3; k++)
+				{
+					if (vertexMeshlet[triangle[k]] != currentId)
+					{
+						vertexMeshlet[triangle[k]] = currentId;
+						meshletVertices[meshlet.vertexCount++] = triangle[k];
+					}
+				}
+				meshlet.indexCount += 3;
+			}
+			computeMeshletBounds(meshlet, indices, vertices, meshletVertices);
+			meshlets.push_back(meshlet);
+		}
+	}
+}
@@ -0,0 +1,73 @@
+#ifndef MESH_OPTIMIZER_H
+#define MESH_OPTIMIZER_H
+
+//Ravine Includes
+#include "RvDataTypes.h"
+
+namespace rvTools
+{
+	namespace optimizer
+	{
+		/**
+		 * \brief Post-transform cache efficiency of an index buffer.
+		 */
+		struct RvVertexCacheStats
+		{
+			//Average Cache Miss Ratio (transformed vertices per triangle, 0.5 is ideal, 3.0 worst)
+			float acmr = 0.0f;
+			//Average Transform to Vertex Ratio (transformed vertices per vertex, 1.0 is ideal)
+			float atvr = 0.0f;
+		};
+
+		/**
+		 * \brief Simulates a FIFO post-transform cache over a triangle list.
+		 * \param cacheSize Simulated cache entries (16 is a conservative estimate for current hardware).
+		 */
+		RvVertexCacheStats analyzeVertexCache(const uint32_t* indices, uint32_t indexCount, uint32_t vertexCount, uint32_t cacheSize = 16);
+
+		/**
+		 * \brief Reorders triangles for post-transform cache locality (Forsyth's linear-speed algorithm).
+		 */
+		void optimizeVertexCache(uint32_t* indices, uint32_t indexCount, uint32_t vertexCount);
+
+		/**
+		 * \brief Reorders clusters of a cache optimized index buffer to reduce overdraw from any view direction.
+		 * \param threshold How much worse than the original ACMR clusters may get (smaller clusters sort better).
+		 */
+		void optimizeOverdraw(uint32_t* indices, uint32_t indexCount, const RvSkinnedVertexColored* vertices, uint32_t vertexCount, float threshold = 1.05f);
+
+		/**
+		 * \brief Reorders vertices by first use in the index buffer (remapping indices) and drops unused ones.
+		 * \return Vertex count after unused vertices are removed.
+		 */
+		uint32_t optimizeVertexFetch(RvSkinnedVertexColored* vertices, uint32_t vertexCount, uint32_t* indices, uint32_t indexCount);
+
+		/**
+		 * \brief Simplifies a triangle list with quadric error metrics, collapsing edges onto existing vertices.
+		 * Vertices on borders, UV/normal seams (shared positions) and collapses between different dominant bones are kept,
+		 * so the simplified indices remain valid for the original vertex buffer.
+		 * \param destination Receives the simplified indices (must hold indexCount entries).
+		 * \param targetIndexCount Index count the simplification stops at (if reachable).
+		 * \param resultError Object-space distance error of the result.
+		 * \return Index count of the simplified triangle list.
+		 */
+		uint32_t simplify(uint32_t* destination, const uint32_t* indices, uint32_t indexCount, const RvSkinnedVertexColored* vertices, uint32_t vertexCount,
+			uint32_t targetIndexCount, float& resultError);
+
+		/**
+		 * \brief Appends simplified detail levels (1/2, 1/4, 1/8 of the triangles...) to the mesh index buffer and fills mesh.lods.
+		 * Stops early when a level can't be reduced further.
+		 */
+		void buildLodChain(RvSkinnedMeshColored& mesh, uint32_t maxLods = RV_MAX_LODS);
+
+		/**
+		 * \brief Splits an index buffer into meshlets of contiguous triangles, computing their bounding spheres and normal cones.
+		 * \param maxVertices Unique vertices per meshlet (at most RV_MESHLET_MAX_VERTICES).
+		 * \param maxTriangles Triangles per meshlet (at most RV_MESHLET_MAX_TRIANGLES).
+		 */
+		void buildMeshlets(const uint32_t* indices, uint32_t indexCount, const RvSkinnedVertexColored* vertices, uint32_t vertexCount,
+			vector<RvMeshlet>& meshlets, uint32_t maxVertices = RV_MESHLET_MAX_VERTICES, uint32_t maxTriangles = RV_MESHLET_MAX_TRIANGLES);
+	}
+}
+
+#endif
@@ -0,0 +1,112 @@
+#include "RvPackingTools.h"
+
+//GLM Includes
+#include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+
+namespace rvTools
+{
+	namespace packing
+	{
+		uint32_t packNormal(const glm::vec3& normal)
+		{
+			//Degenerated normals (meshes without normals) are kept as zero
+			float length = glm::abs(normal.x) + glm::abs(normal.y) + glm::abs(normal.z);
+			if (length == 0.0f)
+			{
+				return 0;
+			}
+
+			//Project onto octahedron, then fold lower hemisphere over the upper one
+			glm::vec2 oct = glm::vec2(normal.x, normal.y) / length;
+			if (normal.z < 0.0f)
+			{
+				oct = (1.0f - glm::abs(glm::vec2(oct.y, oct.x))) *
+					glm::vec2(oct.x >= 0.0f ? 1.0f : -1.0f, oct.y >= 0.0f ? 1.0f : -1.0f);
+			}
+			return glm::packSnorm2x16(oct);
+		}
+
+		uint32_t packBoneIDs(const glm::uvec4& boneIDs)
+		{
+			return (boneIDs.x & 0xFF) | ((boneIDs.y & 0xFF) << 8) | ((boneIDs.z & 0xFF) << 16) | ((boneIDs.w & 0xFF) << 24);
+		}
+
+		uint32_t packBoneWeights(const glm::vec4& boneWeights)
+		{
+			float sum = boneWeights.x + boneWeights.y + boneWeights.z + boneWeights.w;
+			if (sum <= 0.0f)
+			{
+				return 0;
+			}
+
+			//Quantize normalized weights and hand the rounding error to the heaviest one
+			uint32_t quantized[4];
+			uint32_t total = 0;
+			uint32_t heaviest = 0;
+			for (uint32_t i = 0; i < 4; i++)
+			{
+				quantized[i] = static_cast<uint32_t>(boneWeights[i] / sum * 255.0f + 0.5f);
+				total += quantized[i];
+				if (boneWeights[i] > boneWeights[heaviest])
+				{
+					heaviest = i;
+				}
+			}
+			quantized[heaviest] = static_cast<uint32_t>(static_cast<int32_t>(quantized[heaviest]) + 255 - static_cast<int32_t>(total));
+
+			return quantized[0] | (quantized[1] << 8) | (quantized[2] << 16) | (quantized[3] << 24);
+		}
+
+		void computeBounds(const RvSkinnedVertexColored* vertices, uint32_t vertexCount, glm::vec3& aabbMin, glm::vec3& aabbMax)
+		{
+			if (vertexCount == 0)
+			{
+				aabbMin = aabbMax = glm::vec3(0.0f);
+				return;
+			}
+
+			aabbMin = aabbMax = vertices[0].pos;
+			for (uint32_t i = 1; i < vertexCount; i++)
+			{
+				aabbMin = glm::min(aabbMin, vertices[i].pos);
+				aabbMax = glm::max(aabbMax, vertices[i].pos);
+			}
+		}
+
+		void packVertices(const RvSkinnedVertexColored* vertices, uint32_t vertexCount, RvSkinnedVertexPacked* packed)
+		{
+			for (uint32_t i = 0; i < vertexCount; i++)
+			{
+				const RvSkinnedVertexColored& vertex = vertices[i];
+				packed[i].pos = vertex.pos;
+				packed[i].normal = packNormal(vertex.normal);
+				packed[i].texCoord = glm::packHalf2x16(vertex.texCoord);
+				packed[i].color = glm::packUnorm4x8(glm::vec4(vertex.color, 1.0f));
+				packed[i].boneIDs = packBoneIDs(vertex.boneIDs);
+				packed[i].boneWeights = packBoneWeights(vertex.boneWeights);
+			}
+		}
+
+		void packVertices(const RvSkinnedVertexColored* vertices, uint32_t vertexCount, const glm::vec3& aabbMin, const glm::vec3& aabbMax,
+			RvSkinnedVertexQuantized* quantized)
+		{
+			//Flat axes would divide by zero
+			glm::vec3 extent = glm::max(aabbMax - aabbMin, glm::vec3(1e-6f));
+			for (uint32_t i = 0; i < vertexCount; i++)
+			{
+				const RvSkinnedVertexColored& vertex = vertices[i];
+				glm::vec3 unitPos = glm::clamp((vertex.pos - aabbMin) / extent, 0.0f, 1.0f);
+				quantized[i].pos[0] = glm::packUnorm1x16(unitPos.x);
+				quantized[i].pos[1] = glm::packUnorm1x16(unitPos.y);
+				quantized[i].pos[2] = glm::packUnorm1x16(unitPos.z);
+				quantized[i].pos[3] = 0xFFFF;
+				quantized[i].normal = packNormal(vertex.normal);
+				quantized[i].texCoord = glm::packHalf2x16(vertex.texCoord);
+				quantized[i].color = glm::packUnorm4x8(glm::vec4(vertex.color, 1.0f));
+				quantized[i].boneIDs = packBoneIDs(vertex.boneIDs);
+				quantized[i].boneWeights = packBoneWeights(vertex.boneWeights);
+			}
+		}
+	}
+}
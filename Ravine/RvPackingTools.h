@@ -0,0 +1,33 @@
+#ifndef PACKING_TOOLS_H
+#define PACKING_TOOLS_H
+
+//GLM Includes
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+//Ravine Includes
+#include "RvDataTypes.h"
+
+namespace rvTools
+{
+	namespace packing
+	{
+		//Octahedron encoded unit vector into two SNORM16 (R16G16_SNORM)
+		uint32_t packNormal(const glm::vec3& normal);
+
+		//Four UINT8 bone indices (R8G8B8A8_UINT), bone count must be under 256
+		uint32_t packBoneIDs(const glm::uvec4& boneIDs);
+
+		//Four UNORM8 weights renormalized to sum exactly 255 (R8G8B8A8_UNORM)
+		uint32_t packBoneWeights(const glm::vec4& boneWeights);
+
+		void computeBounds(const RvSkinnedVertexColored* vertices, uint32_t vertexCount, glm::vec3& aabbMin, glm::vec3& aabbMax);
+
+		void packVertices(const RvSkinnedVertexColored* vertices, uint32_t vertexCount, RvSkinnedVertexPacked* packed);
+		void packVertices(const RvSkinnedVertexColored* vertices, uint32_t vertexCount, const glm::vec3& aabbMin, const glm::vec3& aabbMax,
+			RvSkinnedVertexQuantized* quantized);
+	}
+}
+
+#endif
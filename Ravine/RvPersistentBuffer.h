@@ -4,6 +4,9 @@
 //Vulkan Include
 #include "volk.h"
 
+//Ravine Includes
+#include "RvMemoryAllocator.h"
+
 struct RvPersistentBuffer
 {
 	//Buffer size in bytes (so it's the whole buffer)
@@ -12,7 +15,7 @@ struct RvPersistentBuffer
 	~RvPersistentBuffer();
 
 	VkBuffer handle = VK_NULL_HANDLE;
-	VkDeviceMemory memory = VK_NULL_HANDLE;
+	RvAllocation allocation;
 	VkDeviceSize bufferSize = 0;
 	size_t sizeOfDataType = 0;
 	size_t instancesCount = 0;
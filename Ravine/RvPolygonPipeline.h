@@ -5,10 +5,12 @@
 #include "volk.h"
 //Ravine Systems
 #include "RvDevice.h"
+#include "RvDataTypes.h"
+#include "RvFileSystem.h"
 
 struct RvPolygonPipeline
 {
-	RvPolygonPipeline(RvDevice& device, VkExtent2D extent, VkSampleCountFlagBits sampleCount, VkDescriptorSetLayout* descriptorSetLayout, size_t descriptorSetLayoutCount, VkRenderPass renderPass, const vector<char>& vertShaderCode, const vector<char>& fragShaderCode);
+	RvPolygonPipeline(RvDevice& device, VkExtent2D extent, VkSampleCountFlagBits sampleCount, VkDescriptorSetLayout* descriptorSetLayout, size_t descriptorSetLayoutCount, VkRenderPass renderPass, const RvVertexInputDescription& vertexInput, const RvFileView& vertShaderCode, const RvFileView& fragShaderCode);
 	~RvPolygonPipeline();
 
 	RvDevice* device;
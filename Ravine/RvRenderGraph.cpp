@@ -0,0 +1,878 @@
+#include "RvRenderGraph.h"
+
+//EASTL Includes
+#include <eastl/algorithm.h>
+#include <eastl/sort.h>
+
+//STD Includes
+#include <stdexcept>
+
+//FMT Includes
+#include <fmt/printf.h>
+
+//Ravine Includes
+#include "RvDeletionQueue.h"
+#include "RvFrameArena.h"
+#include "RvTools.h"
+
+namespace
+{
+	//Everything an attachment write may still be doing when the next user starts
+	const VkPipelineStageFlags attachmentStages = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+		VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+	const VkAccessFlags attachmentWrites = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+	const VkAccessFlags attachmentAccesses = attachmentWrites | VK_ACCESS_COLOR_ATTACHMENT_READ_BIT |
+		VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_INPUT_ATTACHMENT_READ_BIT;
+
+	bool isDepthFormat(VkFormat format)
+	{
+		return format == VK_FORMAT_D16_UNORM || format == VK_FORMAT_X8_D24_UNORM_PACK32 || format == VK_FORMAT_D32_SFLOAT ||
+			format == VK_FORMAT_D16_UNORM_S8_UINT || rvTools::hasStencilComponent(format);
+	}
+
+	bool writes(const RvGraphPass& pass, uint32_t resource)
+	{
+		for (const RvGraphColorOutput& output : pass.colorOutputs)
+		{
+			if (output.resource == resource || output.resolve == resource)
+			{
+				return true;
+			}
+		}
+		return pass.depthOutput == resource;
+	}
+
+	bool sameExtent(VkExtent2D a, VkExtent2D b)
+	{
+		return a.width == b.width && a.height == b.height;
+	}
+
+	//How an attachment is used within one render pass
+	struct RvAttachmentUse
+	{
+		uint32_t firstSubpass;
+		uint32_t lastSubpass;
+		VkAttachmentLoadOp loadOp;
+		VkImageLayout lastLayout;
+		VkClearValue clearValue;
+	};
+
+	struct RvSubpassReferences
+	{
+		vector<VkAttachmentReference> inputs;
+		vector<VkAttachmentReference> colors;
+		vector<VkAttachmentReference> resolves;
+		VkAttachmentReference depth = { VK_ATTACHMENT_UNUSED, VK_IMAGE_LAYOUT_UNDEFINED };
+		vector<uint32_t> preserves;
+
+		bool references(uint32_t attachment) const
+		{
+			if (depth.attachment == attachment)
+			{
+				return true;
+			}
+			for (const vector<VkAttachmentReference>* refs : { &inputs, &colors, &resolves })
+			{
+				for (const VkAttachmentReference& ref : *refs)
+				{
+					if (ref.attachment == attachment)
+					{
+						return true;
+					}
+				}
+			}
+			return false;
+		}
+	};
+}
+
+#pragma region Pass Declaration
+
+void RvGraphPass::addColorOutput(uint32_t resource, const VkClearColorValue* clearColor, uint32_t resolve)
+{
+	RvGraphColorOutput output = {};
+	output.resource = resource;
+	output.resolve = resolve;
+	output.clear = clearColor != nullptr;
+	if (clearColor != nullptr)
+	{
+		output.clearValue.color = *clearColor;
+	}
+	colorOutputs.push_back(output);
+}
+
+void RvGraphPass::setDepthOutput(uint32_t resource, const VkClearDepthStencilValue* clearDepthStencil)
+{
+	depthOutput = resource;
+	clearDepth = clearDepthStencil != nullptr;
+	if (clearDepthStencil != nullptr)
+	{
+		depthClearValue.depthStencil = *clearDepthStencil;
+	}
+}
+
+void RvGraphPass::addInputAttachment(uint32_t resource)
+{
+	inputAttachments.push_back(resource);
+}
+
+void RvGraphPass::addTextureInput(uint32_t resource)
+{
+	textureInputs.push_back(resource);
+}
+
+#pragma endregion
+
+RvRenderGraph::RvRenderGraph(RvDevice& device) : device(&device)
+{
+}
+
+RvRenderGraph::~RvRenderGraph()
+= default;
+
+uint32_t RvRenderGraph::createImage(const char* name, const RvGraphImageInfo& info)
+{
+	if (compiled) {
+		throw std::runtime_error("Render graph images must be created before compiling it!");
+	}
+
+	RvGraphResource resource;
+	resource.name = name;
+	resource.info = info;
+	resource.aspect = VK_IMAGE_ASPECT_COLOR_BIT;
+	if (isDepthFormat(info.format))
+	{
+		resource.aspect = VK_IMAGE_ASPECT_DEPTH_BIT;
+		if (rvTools::hasStencilComponent(info.format) || info.format == VK_FORMAT_D16_UNORM_S8_UINT)
+		{
+			resource.aspect |= VK_IMAGE_ASPECT_STENCIL_BIT;
+		}
+	}
+	resources.push_back(resource);
+	return static_cast<uint32_t>(resources.size() - 1);
+}
+
+uint32_t RvRenderGraph::importImage(const char* name, VkFormat format, const vector<VkImage>& frameImages,
+	const vector<VkImageView>& frameViews, VkImageLayout finalLayout)
+{
+	RvGraphImageInfo info;
+	info.format = format;
+	const uint32_t index = createImage(name, info);
+
+	RvGraphResource& resource = resources[index];
+	resource.imported = true;
+	resource.importedFinalLayout = finalLayout;
+	resource.frameImages = frameImages;
+	resource.frameViews = frameViews;
+	return index;
+}
+
+void RvRenderGraph::setOutput(uint32_t resource)
+{
+	resources[resource].output = true;
+}
+
+RvGraphPass& RvRenderGraph::addPass(const char* name)
+{
+	if (compiled) {
+		throw std::runtime_error("Render graph passes must be added before compiling it!");
+	}
+
+	passes.push_back(RvGraphPass());
+	passes.back().name = name;
+	return passes.back();
+}
+
+const RvGraphPass& RvRenderGraph::getPass(const char* name) const
+{
+	for (const RvGraphPass& pass : passes)
+	{
+		if (pass.name == name)
+		{
+			return pass;
+		}
+	}
+	throw std::runtime_error("Render graph pass not found!");
+}
+
+void RvRenderGraph::compile(VkExtent2D extent, uint32_t framesCount)
+{
+	if (compiled) {
+		throw std::runtime_error("Render graph is already compiled!");
+	}
+	this->extent = extent;
+	this->framesCount = framesCount;
+
+	vector<bool> livePasses;
+	cullPasses(livePasses);
+
+	//Passes run in declaration order, consecutive ones share a render pass while they can
+	for (uint32_t passIt = 0; passIt < passes.size(); passIt++)
+	{
+		if (!livePasses[passIt])
+		{
+			continue;
+		}
+
+		if (renderPasses.empty() || !canMerge(renderPasses.back(), passes[passIt]))
+		{
+			RvGraphRenderPass renderPass = {};
+			renderPass.extent = passExtent(passes[passIt]);
+			renderPasses.push_back(renderPass);
+		}
+		renderPasses.back().passes.push_back(passIt);
+	}
+
+	//Lifetimes decide store operations and which images may share memory
+	for (uint32_t renderPassIt = 0; renderPassIt < renderPasses.size(); renderPassIt++)
+	{
+		for (uint32_t passIt : renderPasses[renderPassIt].passes)
+		{
+			const RvGraphPass& pass = passes[passIt];
+			auto markUse = [&](uint32_t resource)
+			{
+				if (resource == RV_GRAPH_NONE)
+				{
+					return;
+				}
+				RvGraphResource& used = resources[resource];
+				used.firstUse = eastl::min(used.firstUse, renderPassIt);
+				used.lastUse = eastl::max(used.lastUse, renderPassIt);
+			};
+
+			for (const RvGraphColorOutput& output : pass.colorOutputs)
+			{
+				markUse(output.resource);
+				markUse(output.resolve);
+			}
+			markUse(pass.depthOutput);
+			for (uint32_t resource : pass.inputAttachments)
+			{
+				markUse(resource);
+			}
+			for (uint32_t resource : pass.textureInputs)
+			{
+				markUse(resource);
+			}
+		}
+	}
+
+	//Every image starts the frame with undefined contents
+	vector<VkImageLayout> layouts(resources.size(), VK_IMAGE_LAYOUT_UNDEFINED);
+	for (uint32_t renderPassIt = 0; renderPassIt < renderPasses.size(); renderPassIt++)
+	{
+		buildRenderPass(renderPassIt, layouts);
+	}
+
+	createResources();
+	compiled = true;
+}
+
+void RvRenderGraph::resize(VkExtent2D extent, uint32_t framesCount)
+{
+	if (!compiled) {
+		throw std::runtime_error("Trying to resize a not yet compiled render graph!");
+	}
+
+	destroyResources(true);
+	this->extent = extent;
+	this->framesCount = framesCount;
+	createResources();
+}
+
+void RvRenderGraph::setImportedImages(uint32_t resource, const vector<VkImage>& frameImages, const vector<VkImageView>& frameViews)
+{
+	resources[resource].frameImages = frameImages;
+	resources[resource].frameViews = frameViews;
+}
+
+void RvRenderGraph::execute(VkCommandBuffer commandBuffer, uint32_t frameIndex)
+{
+	for (const RvGraphRenderPass& graphPass : renderPasses)
+	{
+		//Transitions of this render pass go in a single barrier
+		if (!graphPass.barriers.empty())
+		{
+			RvFrameVector<VkImageMemoryBarrier> barriers;
+			barriers.reserve(graphPass.barriers.size());
+			for (const RvGraphBarrier& graphBarrier : graphPass.barriers)
+			{
+				const RvGraphResource& resource = resources[graphBarrier.resource];
+				VkImageMemoryBarrier barrier = {};
+				barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+				barrier.oldLayout = graphBarrier.oldLayout;
+				barrier.newLayout = graphBarrier.newLayout;
+				barrier.srcAccessMask = graphBarrier.srcAccess;
+				barrier.dstAccessMask = graphBarrier.dstAccess;
+				barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+				barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+				barrier.image = resource.frameImage(frameIndex);
+				barrier.subresourceRange.aspectMask = resource.aspect;
+				barrier.subresourceRange.baseMipLevel = 0;
+				barrier.subresourceRange.levelCount = 1;
+				barrier.subresourceRange.baseArrayLayer = 0;
+				barrier.subresourceRange.layerCount = 1;
+				barriers.push_back(barrier);
+			}
+			vkCmdPipelineBarrier(commandBuffer, graphPass.srcStages, graphPass.dstStages, 0, 0, nullptr, 0, nullptr,
+				static_cast<uint32_t>(barriers.size()), barriers.data());
+		}
+
+		VkRenderPassBeginInfo renderPassInfo = {};
+		renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+		renderPassInfo.renderPass = graphPass.renderPass->handle;
+		renderPassInfo.framebuffer = graphPass.renderPass->framebuffers[frameIndex];
+		renderPassInfo.renderArea.offset = { 0, 0 };
+		renderPassInfo.renderArea.extent = actualExtent(graphPass.extent);
+		renderPassInfo.clearValueCount = static_cast<uint32_t>(graphPass.clearValues.size());
+		renderPassInfo.pClearValues = graphPass.clearValues.data();
+
+		for (uint32_t subpass = 0; subpass < graphPass.passes.size(); subpass++)
+		{
+			const RvGraphPass& pass = passes[graphPass.passes[subpass]];
+			if (subpass == 0)
+			{
+				vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, pass.contents);
+			}
+			else
+			{
+				vkCmdNextSubpass(commandBuffer, pass.contents);
+			}
+
+			if (pass.record)
+			{
+				pass.record(commandBuffer, frameIndex);
+			}
+		}
+
+		vkCmdEndRenderPass(commandBuffer);
+	}
+}
+
+RvRenderPass* RvRenderGraph::getRenderPass(const RvGraphPass& pass) const
+{
+	if (pass.renderPass == RV_GRAPH_NONE) {
+		throw std::runtime_error("Render graph pass was culled or the graph is not compiled!");
+	}
+	return renderPasses[pass.renderPass].renderPass;
+}
+
+VkDeviceSize RvRenderGraph::transientBytes() const
+{
+	VkDeviceSize bytes = 0;
+	for (const RvGraphMemorySlot& slot : memorySlots)
+	{
+		if (slot.lazilyAllocated)
+		{
+			VkDeviceSize committed = 0;
+			vkGetDeviceMemoryCommitment(device->handle, slot.allocation.memory, &committed);
+			bytes += committed;
+		}
+		else
+		{
+			bytes += slot.size;
+		}
+	}
+	return bytes;
+}
+
+void RvRenderGraph::printStats() const
+{
+	fmt::print(stdout, "Render graph: {0} passes in {1} render passes, {2:.1f}MB of transient images ({3:.1f}MB without aliasing)\n",
+		passes.size(), renderPasses.size(), transientBytes() / (1024.0 * 1024.0), unaliasedBytes / (1024.0 * 1024.0));
+	for (const RvGraphMemorySlot& slot : memorySlots)
+	{
+		fmt::print(stdout, "\t{0:.1f}MB{1} shared by", slot.size / (1024.0 * 1024.0), slot.lazilyAllocated ? " (lazily allocated)" : "");
+		for (uint32_t resource : slot.resources)
+		{
+			fmt::print(stdout, " {0}", resources[resource].name.c_str());
+		}
+		fmt::print(stdout, "\n");
+	}
+}
+
+void RvRenderGraph::clear()
+{
+	destroyResources(false);
+	for (RvGraphRenderPass& graphPass : renderPasses)
+	{
+		graphPass.renderPass->clear();
+		delete graphPass.renderPass;
+	}
+	renderPasses.clear();
+	passes.clear();
+	resources.clear();
+	compiled = false;
+}
+
+void RvRenderGraph::cullPasses(vector<bool>& livePasses) const
+{
+	//Without declared outputs every pass is kept
+	vector<bool> needed(resources.size(), false);
+	bool anyOutput = false;
+	for (uint32_t resource = 0; resource < resources.size(); resource++)
+	{
+		needed[resource] = resources[resource].output;
+		anyOutput |= resources[resource].output;
+	}
+	livePasses.assign(passes.size(), !anyOutput);
+	if (!anyOutput)
+	{
+		return;
+	}
+
+	//Walking backwards, a pass lives if it writes something a live pass (or the frame result) needs
+	for (uint32_t passIt = static_cast<uint32_t>(passes.size()); passIt-- > 0;)
+	{
+		const RvGraphPass& pass = passes[passIt];
+		bool live = false;
+		for (const RvGraphColorOutput& output : pass.colorOutputs)
+		{
+			live |= needed[output.resource] || (output.resolve != RV_GRAPH_NONE && needed[output.resolve]);
+		}
+		live |= pass.depthOutput != RV_GRAPH_NONE && needed[pass.depthOutput];
+		if (!live)
+		{
+			continue;
+		}
+		livePasses[passIt] = true;
+
+		//Outputs that aren't cleared keep what earlier passes wrote
+		for (const RvGraphColorOutput& output : pass.colorOutputs)
+		{
+			needed[output.resource] = needed[output.resource] || !output.clear;
+		}
+		if (pass.depthOutput != RV_GRAPH_NONE)
+		{
+			needed[pass.depthOutput] = needed[pass.depthOutput] || !pass.clearDepth;
+		}
+		for (uint32_t resource : pass.inputAttachments)
+		{
+			needed[resource] = true;
+		}
+		for (uint32_t resource : pass.textureInputs)
+		{
+			needed[resource] = true;
+		}
+	}
+}
+
+VkExtent2D RvRenderGraph::passExtent(const RvGraphPass& pass) const
+{
+	if (!pass.colorOutputs.empty())
+	{
+		return resources[pass.colorOutputs[0].resource].info.extent;
+	}
+	if (pass.depthOutput != RV_GRAPH_NONE)
+	{
+		return resources[pass.depthOutput].info.extent;
+	}
+	throw std::runtime_error("Render graph passes must write at least one attachment!");
+}
+
+VkExtent2D RvRenderGraph::actualExtent(VkExtent2D extent) const
+{
+	return extent.width == 0 || extent.height == 0 ? this->extent : extent;
+}
+
+bool RvRenderGraph::canMerge(const RvGraphRenderPass& renderPass, const RvGraphPass& pass) const
+{
+	//Subpasses share the framebuffer
+	if (!sameExtent(renderPass.extent, passExtent(pass)))
+	{
+		return false;
+	}
+
+	for (uint32_t passIt : renderPass.passes)
+	{
+		const RvGraphPass& previous = passes[passIt];
+
+		//Sampling reads the whole image, which is only complete once its render pass ended
+		for (uint32_t resource : pass.textureInputs)
+		{
+			if (writes(previous, resource))
+			{
+				return false;
+			}
+		}
+
+		//Overwriting what an earlier subpass samples would need a barrier inside the render pass
+		for (uint32_t resource : previous.textureInputs)
+		{
+			if (writes(pass, resource))
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+void RvRenderGraph::buildRenderPass(uint32_t index, vector<VkImageLayout>& layouts)
+{
+	RvGraphRenderPass& graphPass = renderPasses[index];
+	graphPass.srcStages = 0;
+	graphPass.dstStages = 0;
+
+	//Sampled images were last written as attachments of an earlier render pass
+	for (uint32_t passIt : graphPass.passes)
+	{
+		for (uint32_t resource : passes[passIt].textureInputs)
+		{
+			resources[resource].usage |= VK_IMAGE_USAGE_SAMPLED_BIT;
+			resources[resource].transientAttachment = false;
+			if (layouts[resource] == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
+			{
+				continue;
+			}
+			if (layouts[resource] == VK_IMAGE_LAYOUT_UNDEFINED) {
+				throw std::runtime_error(("Render graph image " + resources[resource].name + " is sampled before being written!").c_str());
+			}
+
+			RvGraphBarrier barrier;
+			barrier.resource = resource;
+			barrier.oldLayout = layouts[resource];
+			barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+			barrier.srcAccess = attachmentWrites;
+			barrier.dstAccess = VK_ACCESS_SHADER_READ_BIT;
+			graphPass.barriers.push_back(barrier);
+			graphPass.srcStages |= attachmentStages;
+			graphPass.dstStages |= VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+			layouts[resource] = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		}
+	}
+
+	//Gather attachment references, attachments are numbered in order of first use
+	vector<RvAttachmentUse> uses;
+	vector<RvSubpassReferences> subpassReferences(graphPass.passes.size());
+	for (uint32_t subpass = 0; subpass < graphPass.passes.size(); subpass++)
+	{
+		RvGraphPass& pass = passes[graphPass.passes[subpass]];
+		pass.renderPass = index;
+		pass.subpass = subpass;
+		RvSubpassReferences& references = subpassReferences[subpass];
+
+		auto reference = [&](uint32_t resource, VkImageLayout layout, bool read, const VkClearValue* clearValue) -> VkAttachmentReference
+		{
+			RvGraphResource& used = resources[resource];
+			uint32_t attachment = static_cast<uint32_t>(eastl::find(graphPass.attachments.begin(), graphPass.attachments.end(), resource) -
+				graphPass.attachments.begin());
+			if (attachment == graphPass.attachments.size())
+			{
+				if (read && layouts[resource] == VK_IMAGE_LAYOUT_UNDEFINED) {
+					throw std::runtime_error(("Render graph image " + used.name + " is read before being written!").c_str());
+				}
+
+				//Contents are only loaded when something earlier in the frame wrote them
+				RvAttachmentUse use = {};
+				use.firstSubpass = subpass;
+				use.loadOp = clearValue != nullptr ? VK_ATTACHMENT_LOAD_OP_CLEAR :
+					layouts[resource] != VK_IMAGE_LAYOUT_UNDEFINED ? VK_ATTACHMENT_LOAD_OP_LOAD : VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+				if (clearValue != nullptr)
+				{
+					use.clearValue = *clearValue;
+				}
+				graphPass.attachments.push_back(resource);
+				uses.push_back(use);
+			}
+			uses[attachment].lastSubpass = subpass;
+			uses[attachment].lastLayout = layout;
+			return { attachment, layout };
+		};
+
+		for (uint32_t resource : pass.inputAttachments)
+		{
+			if (writes(pass, resource)) {
+				throw std::runtime_error(("Render graph pass " + pass.name + " reads and writes the same attachment!").c_str());
+			}
+			RvGraphResource& input = resources[resource];
+			input.usage |= VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
+			const VkImageLayout layout = input.aspect & VK_IMAGE_ASPECT_DEPTH_BIT ?
+				VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+			references.inputs.push_back(reference(resource, layout, true, nullptr));
+		}
+
+		bool resolved = false;
+		for (const RvGraphColorOutput& output : pass.colorOutputs)
+		{
+			resources[output.resource].usage |= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+			references.colors.push_back(reference(output.resource, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, false,
+				output.clear ? &output.clearValue : nullptr));
+			resolved |= output.resolve != RV_GRAPH_NONE;
+		}
+
+		//Resolves overwrite the whole image, they never load it
+		if (resolved)
+		{
+			for (const RvGraphColorOutput& output : pass.colorOutputs)
+			{
+				VkAttachmentReference resolve = { VK_ATTACHMENT_UNUSED, VK_IMAGE_LAYOUT_UNDEFINED };
+				if (output.resolve != RV_GRAPH_NONE)
+				{
+					resources[output.resolve].usage |= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+					resolve = reference(output.resolve, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, false, nullptr);
+					if (uses[resolve.attachment].firstSubpass == subpass)
+					{
+						uses[resolve.attachment].loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+					}
+				}
+				references.resolves.push_back(resolve);
+			}
+		}
+
+		if (pass.depthOutput != RV_GRAPH_NONE)
+		{
+			resources[pass.depthOutput].usage |= VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+			references.depth = reference(pass.depthOutput, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, false,
+				pass.clearDepth ? &pass.depthClearValue : nullptr);
+		}
+	}
+
+	RvRenderPass* renderPass = new RvRenderPass();
+	graphPass.renderPass = renderPass;
+
+	//Attachment descriptions, stored only when a later render pass or the frame result needs the contents
+	graphPass.clearValues.resize(graphPass.attachments.size());
+	for (uint32_t attachment = 0; attachment < graphPass.attachments.size(); attachment++)
+	{
+		const uint32_t resource = graphPass.attachments[attachment];
+		const RvGraphResource& used = resources[resource];
+		const RvAttachmentUse& use = uses[attachment];
+		const bool stored = used.imported || used.output || used.lastUse > index;
+		const bool hasStencil = (used.aspect & VK_IMAGE_ASPECT_STENCIL_BIT) != 0;
+
+		RvAttachmentDescription description = {};
+		description.format = used.info.format;
+		description.samples = used.info.samples;
+		description.loadOp = use.loadOp;
+		description.storeOp = stored ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+		description.stencilLoadOp = hasStencil ? description.loadOp : VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+		description.stencilStoreOp = hasStencil ? description.storeOp : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+		description.initialLayout = layouts[resource];
+		description.finalLayout = used.imported && used.lastUse == index ? used.importedFinalLayout : use.lastLayout;
+		renderPass->addAttachmentDescriptor(description);
+
+		graphPass.clearValues[attachment] = use.clearValue;
+		layouts[resource] = description.finalLayout;
+		if (description.loadOp == VK_ATTACHMENT_LOAD_OP_LOAD || stored)
+		{
+			resources[resource].transientAttachment = false;
+		}
+	}
+
+	for (uint32_t subpass = 0; subpass < graphPass.passes.size(); subpass++)
+	{
+		RvSubpassReferences& references = subpassReferences[subpass];
+
+		//Attachments used before and after a subpass that doesn't touch them must survive it
+		for (uint32_t attachment = 0; attachment < uses.size(); attachment++)
+		{
+			if (uses[attachment].firstSubpass < subpass && uses[attachment].lastSubpass > subpass && !references.references(attachment))
+			{
+				references.preserves.push_back(attachment);
+			}
+		}
+
+		VkSubpassDescription description = {};
+		description.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+		description.inputAttachmentCount = static_cast<uint32_t>(references.inputs.size());
+		description.pInputAttachments = references.inputs.data();
+		description.colorAttachmentCount = static_cast<uint32_t>(references.colors.size());
+		description.pColorAttachments = references.colors.data();
+		description.pResolveAttachments = references.resolves.empty() ? nullptr : references.resolves.data();
+		description.pDepthStencilAttachment = references.depth.attachment != VK_ATTACHMENT_UNUSED ? &references.depth : nullptr;
+		description.preserveAttachmentCount = static_cast<uint32_t>(references.preserves.size());
+		description.pPreserveAttachments = references.preserves.data();
+
+		//The first subpass waits on earlier render passes (of this frame or the last one), which may have used these images
+		//or others aliasing their memory, the following ones on the subpass before them
+		VkSubpassDependency dependency = {};
+		dependency.srcSubpass = subpass == 0 ? VK_SUBPASS_EXTERNAL : subpass - 1;
+		dependency.dstSubpass = subpass;
+		dependency.srcStageMask = attachmentStages | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+		dependency.srcAccessMask = attachmentWrites;
+		dependency.dstStageMask = attachmentStages | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+		dependency.dstAccessMask = attachmentAccesses;
+		dependency.dependencyFlags = subpass == 0 ? 0 : VK_DEPENDENCY_BY_REGION_BIT;
+
+		renderPass->addSubpass(RvSubpass(description, dependency));
+	}
+
+	renderPass->createHandle(*device);
+}
+
+void RvRenderGraph::createResources()
+{
+	//Images are created first, their requirements decide which ones share memory
+	vector<VkMemoryRequirements> requirements(resources.size());
+	vector<uint32_t> transients;
+	unaliasedBytes = 0;
+	for (uint32_t resourceIt = 0; resourceIt < resources.size(); resourceIt++)
+	{
+		RvGraphResource& resource = resources[resourceIt];
+		if (resource.imported || resource.firstUse == RV_GRAPH_NONE)
+		{
+			continue;
+		}
+
+		const VkExtent2D size = actualExtent(resource.info.extent);
+		VkImageCreateInfo imageCreateInfo = {};
+		imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+		imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
+		imageCreateInfo.extent = { size.width, size.height, 1 };
+		imageCreateInfo.mipLevels = 1;
+		imageCreateInfo.arrayLayers = 1;
+		imageCreateInfo.format = resource.info.format;
+		imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+		imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		imageCreateInfo.usage = resource.usage | (resource.transientAttachment ? VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT : 0);
+		imageCreateInfo.samples = resource.info.samples;
+		imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+		if (vkCreateImage(device->handle, &imageCreateInfo, nullptr, &resource.image) != VK_SUCCESS) {
+			throw std::runtime_error("Failed to create render graph image!");
+		}
+
+		vkGetImageMemoryRequirements(device->handle, resource.image, &requirements[resourceIt]);
+		unaliasedBytes += requirements[resourceIt].size;
+		transients.push_back(resourceIt);
+	}
+
+	//Largest first, each image joins the first slot of its memory type whose images are used in other render passes only
+	eastl::sort(transients.begin(), transients.end(), [&](uint32_t a, uint32_t b)
+	{
+		return requirements[a].size > requirements[b].size;
+	});
+	for (uint32_t resourceIt : transients)
+	{
+		RvGraphResource& resource = resources[resourceIt];
+		const VkMemoryRequirements& imageRequirements = requirements[resourceIt];
+		const uint32_t memoryType = resource.transientAttachment ? device->findTransientMemoryType(imageRequirements.memoryTypeBits) :
+			device->findMemoryType(imageRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+		uint32_t slotIt = 0;
+		for (; slotIt < memorySlots.size(); slotIt++)
+		{
+			const RvGraphMemorySlot& slot = memorySlots[slotIt];
+			bool disjoint = slot.memoryType == memoryType;
+			for (uint32_t other : slot.resources)
+			{
+				disjoint &= resource.firstUse > resources[other].lastUse || resource.lastUse < resources[other].firstUse;
+			}
+			if (disjoint)
+			{
+				break;
+			}
+		}
+		if (slotIt == memorySlots.size())
+		{
+			RvGraphMemorySlot slot = {};
+			slot.alignment = 1;
+			slot.memoryType = memoryType;
+			slot.lazilyAllocated = device->isLazilyAllocated(memoryType);
+			memorySlots.push_back(slot);
+		}
+
+		RvGraphMemorySlot& slot = memorySlots[slotIt];
+		slot.size = eastl::max(slot.size, imageRequirements.size);
+		slot.alignment = eastl::max(slot.alignment, imageRequirements.alignment);
+		slot.resources.push_back(resourceIt);
+		resource.memorySlot = slotIt;
+	}
+
+	//Bind every image of a slot at the start of its memory
+	for (RvGraphMemorySlot& slot : memorySlots)
+	{
+		VkMemoryRequirements slotRequirements = {};
+		slotRequirements.size = slot.size;
+		slotRequirements.alignment = slot.alignment;
+		slotRequirements.memoryTypeBits = 1u << slot.memoryType;
+		//Lazily allocated memory is backed per memory object, so those slots don't go in shared blocks
+		if (slot.lazilyAllocated)
+		{
+			slot.allocation = device->allocator->allocateDedicated(slot.size, slot.memoryType, RV_ALLOCATION_ATTACHMENTS);
+		}
+		else
+		{
+			slot.allocation = device->allocator->allocate(slotRequirements, slot.memoryType, RV_RESOURCE_OPTIMAL, RV_ALLOCATION_ATTACHMENTS);
+		}
+
+		for (uint32_t resourceIt : slot.resources)
+		{
+			RvGraphResource& resource = resources[resourceIt];
+			vkBindImageMemory(device->handle, resource.image, slot.allocation.memory, slot.allocation.offset);
+			resource.view = rvTools::createImageView(device->handle, resource.image, resource.info.format,
+				resource.aspect & (VK_IMAGE_ASPECT_COLOR_BIT | VK_IMAGE_ASPECT_DEPTH_BIT), 1);
+		}
+	}
+
+	//Framebuffers, imported images change per frame
+	for (RvGraphRenderPass& graphPass : renderPasses)
+	{
+		vector<vector<VkImageView>> frameAttachments(framesCount);
+		for (uint32_t frameIt = 0; frameIt < framesCount; frameIt++)
+		{
+			for (uint32_t resource : graphPass.attachments)
+			{
+				frameAttachments[frameIt].push_back(resources[resource].frameView(frameIt));
+			}
+		}
+
+		const VkExtent2D size = actualExtent(graphPass.extent);
+		graphPass.renderPass->createFramebuffers({ size.width, size.height, 1 }, frameAttachments);
+	}
+}
+
+void RvRenderGraph::destroyResources(bool deferred)
+{
+	RvDeletionQueue* deletionQueue = device->deletionQueue;
+	for (RvGraphRenderPass& graphPass : renderPasses)
+	{
+		for (VkFramebuffer framebuffer : graphPass.renderPass->framebuffers)
+		{
+			if (deferred)
+			{
+				deletionQueue->destroyFramebuffer(framebuffer);
+			}
+			else
+			{
+				vkDestroyFramebuffer(device->handle, framebuffer, nullptr);
+			}
+		}
+		graphPass.renderPass->framebuffers.clear();
+	}
+
+	//Memory is shared, so images are destroyed on their own and slots free it
+	for (RvGraphResource& resource : resources)
+	{
+		if (resource.image == VK_NULL_HANDLE)
+		{
+			continue;
+		}
+		if (deferred)
+		{
+			deletionQueue->destroyImageView(resource.view);
+			deletionQueue->destroyImage(resource.image, RvAllocation());
+		}
+		else
+		{
+			vkDestroyImageView(device->handle, resource.view, nullptr);
+			vkDestroyImage(device->handle, resource.image, nullptr);
+		}
+		resource.view = VK_NULL_HANDLE;
+		resource.image = VK_NULL_HANDLE;
+		resource.memorySlot = RV_GRAPH_NONE;
+	}
+
+	for (RvGraphMemorySlot& slot : memorySlots)
+	{
+		if (deferred)
+		{
+			deletionQueue->freeAllocation(slot.allocation);
+		}
+		else
+		{
+			device->allocator->free(slot.allocation);
+		}
+	}
+	memorySlots.clear();
+}
@@ -0,0 +1,225 @@
+#ifndef RV_RENDER_GRAPH_H
+#define RV_RENDER_GRAPH_H
+
+//Vulkan Includes
+#include "volk.h"
+
+//EASTL Includes
+#include <eastl/string.h>
+#include <eastl/vector.h>
+
+using eastl::string;
+using eastl::vector;
+
+//STD Includes
+#include <functional>
+
+//Ravine Includes
+#include "RvDevice.h"
+#include "RvRenderPass.h"
+
+//Index of a missing resource (e.g. a color output without resolve)
+#define RV_GRAPH_NONE UINT32_MAX
+
+/**
+ * \brief Description of an image owned by the graph.
+ */
+struct RvGraphImageInfo
+{
+	VkFormat format = VK_FORMAT_UNDEFINED;
+
+	//Zero follows the graph extent (the swapchain one), anything else is fixed
+	VkExtent2D extent = { 0, 0 };
+	VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT;
+};
+
+struct RvGraphColorOutput
+{
+	uint32_t resource;
+	uint32_t resolve;
+	bool clear;
+	VkClearValue clearValue;
+};
+
+/**
+ * \brief A pass declares what it reads and writes, the graph derives render passes, layouts and barriers from it.
+ */
+struct RvGraphPass
+{
+	string name;
+
+	vector<RvGraphColorOutput> colorOutputs;
+	uint32_t depthOutput = RV_GRAPH_NONE;
+	bool clearDepth = false;
+	VkClearValue depthClearValue = {};
+
+	//Read in the fragment shader of the same render pass (subpassLoad)
+	vector<uint32_t> inputAttachments;
+
+	//Sampled after the render pass that wrote them
+	vector<uint32_t> textureInputs;
+
+	//Records the pass inside its subpass, secondary command buffers are only allowed with matching contents
+	std::function<void(VkCommandBuffer commandBuffer, uint32_t frameIndex)> record;
+	VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE;
+
+	//Filled by compile, culled passes keep RV_GRAPH_NONE
+	uint32_t renderPass = RV_GRAPH_NONE;
+	uint32_t subpass = 0;
+
+	void addColorOutput(uint32_t resource, const VkClearColorValue* clearColor = nullptr, uint32_t resolve = RV_GRAPH_NONE);
+	void setDepthOutput(uint32_t resource, const VkClearDepthStencilValue* clearDepthStencil = nullptr);
+	void addInputAttachment(uint32_t resource);
+	void addTextureInput(uint32_t resource);
+};
+
+/**
+ * \brief Builds the frame out of passes declaring their reads and writes.
+ * Consecutive passes of the same size are merged as subpasses of one render pass unless one samples what another wrote,
+ * load/store operations and layouts come from where each image is used next, and the transitions needed before a render pass
+ * are issued in a single barrier. Images owned by the graph are transient, their contents live within a frame only, so
+ * images whose lifetimes don't overlap share memory. Images that never leave their render pass are created as transient attachments
+ * in lazily allocated memory when the device has it, which tile based GPUs never back.
+ */
+class RvRenderGraph
+{
+public:
+	explicit RvRenderGraph(RvDevice& device);
+	~RvRenderGraph();
+
+	uint32_t createImage(const char* name, const RvGraphImageInfo& info);
+
+	/**
+	 * \brief Registers an image owned elsewhere with one view per frame (e.g. the swapchain images).
+	 */
+	uint32_t importImage(const char* name, VkFormat format, const vector<VkImage>& frameImages, const vector<VkImageView>& frameViews,
+		VkImageLayout finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+
+	/**
+	 * \brief Marks an image as a result of the frame, passes that don't contribute to any result are culled.
+	 */
+	void setOutput(uint32_t resource);
+
+	/**
+	 * \brief Adds a pass after the previous ones, the reference is valid until the next pass is added.
+	 */
+	RvGraphPass& addPass(const char* name);
+	const RvGraphPass& getPass(const char* name) const;
+
+	/**
+	 * \brief Builds render passes and creates images and framebuffers, passes can't be added afterwards.
+	 */
+	void compile(VkExtent2D extent, uint32_t framesCount);
+
+	/**
+	 * \brief Recreates images and framebuffers, render pass handles (and pipelines built on them) stay valid.
+	 * The old ones go through the device deletion queue, frames in flight may keep using them.
+	 */
+	void resize(VkExtent2D extent, uint32_t framesCount);
+	void setImportedImages(uint32_t resource, const vector<VkImage>& frameImages, const vector<VkImageView>& frameViews);
+
+	/**
+	 * \brief Records every pass of the frame into a primary command buffer.
+	 */
+	void execute(VkCommandBuffer commandBuffer, uint32_t frameIndex);
+
+	RvRenderPass* getRenderPass(const RvGraphPass& pass) const;
+	//Memory of the transient images (lazily allocated memory counts what is committed), and what it would be if none of them shared memory
+	VkDeviceSize transientBytes() const;
+	VkDeviceSize unaliasedTransientBytes() const { return unaliasedBytes; }
+	void printStats() const;
+
+	/**
+	 * \brief Should be used instead of destroying in destructor.
+	 */
+	void clear();
+
+private:
+	struct RvGraphResource
+	{
+		string name;
+		RvGraphImageInfo info;
+		VkImageUsageFlags usage = 0;
+		VkImageAspectFlags aspect = 0;
+
+		bool imported = false;
+		bool output = false;
+		VkImageLayout importedFinalLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		vector<VkImage> frameImages;
+		vector<VkImageView> frameViews;
+
+		//Transient images
+		VkImage image = VK_NULL_HANDLE;
+		VkImageView view = VK_NULL_HANDLE;
+		uint32_t memorySlot = RV_GRAPH_NONE;
+
+		//Never loaded, stored nor sampled, so it can stay in tile memory (VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT)
+		bool transientAttachment = true;
+
+		//Render passes using it, within a frame
+		uint32_t firstUse = RV_GRAPH_NONE;
+		uint32_t lastUse = 0;
+
+		VkImage frameImage(uint32_t frameIndex) const { return imported ? frameImages[frameIndex] : image; }
+		VkImageView frameView(uint32_t frameIndex) const { return imported ? frameViews[frameIndex] : view; }
+	};
+
+	//Transition done before a render pass starts
+	struct RvGraphBarrier
+	{
+		uint32_t resource;
+		VkImageLayout oldLayout;
+		VkImageLayout newLayout;
+		VkAccessFlags srcAccess;
+		VkAccessFlags dstAccess;
+	};
+
+	struct RvGraphRenderPass
+	{
+		RvRenderPass* renderPass;
+		vector<uint32_t> passes;
+		vector<uint32_t> attachments;
+		vector<VkClearValue> clearValues;
+		//As declared, zero follows the graph extent
+		VkExtent2D extent;
+
+		vector<RvGraphBarrier> barriers;
+		VkPipelineStageFlags srcStages;
+		VkPipelineStageFlags dstStages;
+	};
+
+	//Memory shared by transient images used in disjoint render pass ranges
+	struct RvGraphMemorySlot
+	{
+		RvAllocation allocation;
+		VkDeviceSize size;
+		VkDeviceSize alignment;
+		uint32_t memoryType;
+		bool lazilyAllocated;
+		vector<uint32_t> resources;
+	};
+
+	RvDevice* device;
+	VkExtent2D extent = { 0, 0 };
+	uint32_t framesCount = 0;
+	bool compiled = false;
+
+	vector<RvGraphResource> resources;
+	vector<RvGraphPass> passes;
+	vector<RvGraphRenderPass> renderPasses;
+	vector<RvGraphMemorySlot> memorySlots;
+
+	//Sum of the transient image sizes, what they would take without aliasing
+	VkDeviceSize unaliasedBytes = 0;
+
+	void cullPasses(vector<bool>& livePasses) const;
+	VkExtent2D passExtent(const RvGraphPass& pass) const;
+	VkExtent2D actualExtent(VkExtent2D extent) const;
+	bool canMerge(const RvGraphRenderPass& renderPass, const RvGraphPass& pass) const;
+	void buildRenderPass(uint32_t index, vector<VkImageLayout>& layouts);
+
+	void createResources();
+	void destroyResources(bool deferred);
+};
+
+#endif
@@ -1,34 +1,14 @@
 #include "RvRenderPass.h"
 #include "RvTools.h"
+#include "RvFrameArena.h"
 #include <stdexcept>
 #include <eastl/array.h>
 
 void RvRenderPass::construct(const RvDevice& device, const uint32_t framesCount, const VkExtent3D& sizeAndLayers,
     const VkImageView* swapchainImages)
 {
-	this->device = &device;
-
-	//Create RenderPass
-	VkRenderPassCreateInfo createInfo = {};
-	createInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-	createInfo.attachmentCount = static_cast<uint32_t>(attachmentDescriptions.size());
-	createInfo.pAttachments = attachmentDescriptions.data();
-	const uint32_t subpassSize = static_cast<uint32_t>(subpasses.size());
-	VkSubpassDescription* subpassDescriptions = new VkSubpassDescription[subpassSize];
-	VkSubpassDependency* subpassDependencies = new VkSubpassDependency[subpassSize];
-	for (uint32_t i = 0; i < subpassSize; i++)
-	{
-		subpassDescriptions[i] = subpasses[i].description;
-		subpassDependencies[i] = subpasses[i].dependency;
-	}
-	createInfo.subpassCount = subpassSize;
-	createInfo.pSubpasses = subpassDescriptions;
-	createInfo.dependencyCount = subpassSize;
-	createInfo.pDependencies = subpassDependencies;
-
-	if (vkCreateRenderPass(device.handle, &createInfo, nullptr, &handle) != VK_SUCCESS) {
-		throw std::runtime_error("Failed to create render pass!");
-	}
+	createHandle(device);
+	RvFrameArena& scratch = RvFrameArena::local();
 
 	//Resize array to allocate required VkFramebuffer objects
 	framebuffers.resize(framesCount);
@@ -48,7 +28,7 @@ void RvRenderPass::construct(const RvDevice& device, const uint32_t framesCount,
 			framebufferAttachmentsCreateInfos.size() +
 			(swapchainImages != VK_NULL_HANDLE ? 1 : 0);
 
-		VkImageView* attachments = new VkImageView[attachmentCount];
+		VkImageView* attachments = scratch.allocateArray<VkImageView>(attachmentCount);
 		uint32_t it = 0;
 
 		//Link all shared attachments
@@ -90,6 +70,60 @@ void RvRenderPass::construct(const RvDevice& device, const uint32_t framesCount,
 	}
 }
 
+void RvRenderPass::createHandle(const RvDevice& device)
+{
+	this->device = &device;
+
+	//Create RenderPass
+	VkRenderPassCreateInfo createInfo = {};
+	createInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+	createInfo.attachmentCount = static_cast<uint32_t>(attachmentDescriptions.size());
+	createInfo.pAttachments = attachmentDescriptions.data();
+	const uint32_t subpassSize = static_cast<uint32_t>(subpasses.size());
+	//Create info scratch arrays are only read by the create calls
+	RvFrameArena& scratch = RvFrameArena::local();
+	VkSubpassDescription* subpassDescriptions = scratch.allocateArray<VkSubpassDescription>(subpassSize);
+	VkSubpassDependency* subpassDependencies = scratch.allocateArray<VkSubpassDependency>(subpassSize);
+	for (uint32_t i = 0; i < subpassSize; i++)
+	{
+		subpassDescriptions[i] = subpasses[i].description;
+		subpassDependencies[i] = subpasses[i].dependency;
+	}
+	createInfo.subpassCount = subpassSize;
+	createInfo.pSubpasses = subpassDescriptions;
+	createInfo.dependencyCount = subpassSize;
+	createInfo.pDependencies = subpassDependencies;
+
+	if (vkCreateRenderPass(device.handle, &createInfo, nullptr, &handle) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create render pass!");
+	}
+}
+
+void RvRenderPass::createFramebuffers(const VkExtent3D& sizeAndLayers, const vector<vector<VkImageView>>& frameAttachments)
+{
+	for (VkFramebuffer framebuffer : framebuffers)
+	{
+		vkDestroyFramebuffer(device->handle, framebuffer, nullptr);
+	}
+	framebuffers.resize(frameAttachments.size());
+
+	for (uint32_t frameIt = 0; frameIt < frameAttachments.size(); frameIt++)
+	{
+		VkFramebufferCreateInfo framebufferCreateInfo = {};
+		framebufferCreateInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+		framebufferCreateInfo.renderPass = handle;
+		framebufferCreateInfo.attachmentCount = static_cast<uint32_t>(frameAttachments[frameIt].size());
+		framebufferCreateInfo.pAttachments = frameAttachments[frameIt].data();
+		framebufferCreateInfo.width = sizeAndLayers.width;
+		framebufferCreateInfo.height = sizeAndLayers.height;
+		framebufferCreateInfo.layers = sizeAndLayers.depth;
+
+		if (vkCreateFramebuffer(device->handle, &framebufferCreateInfo, nullptr, &framebuffers[frameIt]) != VK_SUCCESS) {
+			throw std::runtime_error("Failed to create framebuffer!");
+		}
+	}
+}
+
 void RvRenderPass::resizeAttachments(const uint32_t framesCount, const VkExtent3D& sizeAndLayers,
 	const VkImageView* swapchainImages)
 {
@@ -100,6 +134,8 @@ void RvRenderPass::resizeAttachments(const uint32_t framesCount, const VkExtent3
 
 	//TODO: Study a way to resize attachments without using single-time commands (such as vkFlushMappedMemoryRanges)
 
+	RvFrameArena& scratch = RvFrameArena::local();
+
 	//Clear FrameBuffers
 	for (VkFramebuffer framebuffer : framebuffers)
 	{
@@ -111,14 +147,14 @@ void RvRenderPass::resizeAttachments(const uint32_t framesCount, const VkExtent3
 	{
 		vkDestroyImageView(device->handle, sharedFramebufferAttachment.imageView, nullptr);
 		vkDestroyImage(device->handle, sharedFramebufferAttachment.image, nullptr);
-		vkFreeMemory(device->handle, sharedFramebufferAttachment.memory, nullptr);
+		device->allocator->free(sharedFramebufferAttachment.allocation);
 	}
 	sharedFramebufferAttachments.clear();
 	for (auto& framebufferAttachment : framebufferAttachments)
 	{
 		vkDestroyImageView(device->handle, framebufferAttachment.imageView, nullptr);
 		vkDestroyImage(device->handle, framebufferAttachment.image, nullptr);
-		vkFreeMemory(device->handle, framebufferAttachment.memory, nullptr);
+		device->allocator->free(framebufferAttachment.allocation);
 	}
 	framebufferAttachments.clear();
 
@@ -149,7 +185,7 @@ void RvRenderPass::resizeAttachments(const uint32_t framesCount, const VkExtent3
 			sharedFramebufferAttachments.size() +
 			framebufferAttachmentsCreateInfos.size() +
 			(swapchainImages != VK_NULL_HANDLE ? 1 : 0);
-		VkImageView* attachments = new VkImageView[attachmentCount];
+		VkImageView* attachments = scratch.allocateArray<VkImageView>(attachmentCount);
 		uint32_t it = 0;
 
 		//Link all shared attachments
@@ -199,7 +235,7 @@ void RvRenderPass::clear()
 	{
 		vkDestroyImageView(device->handle, sharedFramebufferAttachment.imageView, nullptr);
 		vkDestroyImage(device->handle, sharedFramebufferAttachment.image, nullptr);
-		vkFreeMemory(device->handle, sharedFramebufferAttachment.memory, nullptr);
+		device->allocator->free(sharedFramebufferAttachment.allocation);
 	}
 	sharedFramebufferAttachments.clear();
 
@@ -209,7 +245,7 @@ void RvRenderPass::clear()
 	{
 		vkDestroyImageView(device->handle, framebufferAttachment.imageView, nullptr);
 		vkDestroyImage(device->handle, framebufferAttachment.image, nullptr);
-		vkFreeMemory(device->handle, framebufferAttachment.memory, nullptr);
+		device->allocator->free(framebufferAttachment.allocation);
 	}
 	framebufferAttachments.clear();
 
@@ -273,7 +309,7 @@ RvRenderPass* RvRenderPass::defaultRenderPass(RvDevice& device, const RvSwapChai
 	colorAttachment.format = swapChain.imageFormat;	//Formats should match
 	colorAttachment.samples = device.sampleCount;
 	colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-	colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+	colorAttachment.storeOp = rvAttachmentStoreOp(msaaCreateInfo);	//Only the resolve is kept
 	colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
 	colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
 	colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
@@ -286,7 +322,7 @@ RvRenderPass* RvRenderPass::defaultRenderPass(RvDevice& device, const RvSwapChai
 	depthAttachment.format = device.findDepthFormat();
 	depthAttachment.samples = device.sampleCount;
 	depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-	depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+	depthAttachment.storeOp = rvAttachmentStoreOp(depthCreateInfo);
 	depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
 	depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
 	depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
@@ -321,9 +357,11 @@ RvSubpass::RvSubpass(const RvSubpass& subpass) : RvSubpass(subpass.description,
 
 RvSubpass::RvSubpass(VkSubpassDescription descriptr, VkSubpassDependency dependency) : description(descriptr), dependency(dependency)
 {
-	//Copy attachment references and rewire pointers
+	//Copy attachment references and rewire pointers (resolve and depth-stencil are optional)
+	const uint32_t resolveCount = description.pResolveAttachments != nullptr ? description.colorAttachmentCount : 0;
+	const uint32_t depthCount = description.pDepthStencilAttachment != nullptr ? 1 : 0;
 	attachmentReferences = new VkAttachmentReference[description.inputAttachmentCount +
-		description.colorAttachmentCount * 3];
+		description.colorAttachmentCount + resolveCount + depthCount];
 
 	//Use another pointer to iterate over memory blocks
 	VkAttachmentReference* refPtr = attachmentReferences;
@@ -337,18 +375,27 @@ RvSubpass::RvSubpass(VkSubpassDescription descriptr, VkSubpassDependency depende
 	}
 
 	//Color attachments
-	memcpy(refPtr, description.pColorAttachments, description.colorAttachmentCount * sizeof(VkAttachmentReference));
-	description.pColorAttachments = refPtr;
-	refPtr += description.colorAttachmentCount;
+	if (description.colorAttachmentCount > 0)
+	{
+		memcpy(refPtr, description.pColorAttachments, description.colorAttachmentCount * sizeof(VkAttachmentReference));
+		description.pColorAttachments = refPtr;
+		refPtr += description.colorAttachmentCount;
+	}
 
-	//Depth attachments
-	memcpy(refPtr, description.pDepthStencilAttachment, description.colorAttachmentCount * sizeof(VkAttachmentReference));
-	description.pDepthStencilAttachment = refPtr;
-	refPtr += description.colorAttachmentCount;
+	//Depth attachment
+	if (depthCount > 0)
+	{
+		memcpy(refPtr, description.pDepthStencilAttachment, sizeof(VkAttachmentReference));
+		description.pDepthStencilAttachment = refPtr;
+		refPtr += depthCount;
+	}
 
 	//Resolve attachments
-	memcpy(refPtr, description.pResolveAttachments, description.colorAttachmentCount * sizeof(VkAttachmentReference));
-	description.pResolveAttachments = refPtr;
+	if (resolveCount > 0)
+	{
+		memcpy(refPtr, description.pResolveAttachments, resolveCount * sizeof(VkAttachmentReference));
+		description.pResolveAttachments = refPtr;
+	}
 
 	//Preserve attachments
 	if (description.preserveAttachmentCount > 0)
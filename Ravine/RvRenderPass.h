@@ -53,6 +53,19 @@ struct RvRenderPass
 
 	void resizeAttachments(const uint32_t framesCount, const VkExtent3D& sizeAndLayers, const VkImageView* swapchainImages = VK_NULL_HANDLE);
 
+	/**
+	 * \brief Creates the VkRenderPass out of the attachment descriptions and subpasses, without any attachment.
+	 * \param device The device to create the VkRenderPass instance.
+	 */
+	void createHandle(const RvDevice& device);
+
+	/**
+	 * \brief (Re)creates one framebuffer per frame over attachments owned elsewhere (e.g. by RvRenderGraph).
+	 * \param sizeAndLayers Size of the framebuffer (width and height) and amount of layers (depth).
+	 * \param frameAttachments Image views of every attachment for each frame, in attachment description order.
+	 */
+	void createFramebuffers(const VkExtent3D& sizeAndLayers, const vector<vector<VkImageView>>& frameAttachments);
+
 	/**
 	 * \brief 
 	 */
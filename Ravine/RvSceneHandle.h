@@ -0,0 +1,74 @@
+#ifndef RV_SCENE_HANDLE_H
+#define RV_SCENE_HANDLE_H
+
+//EASTL Includes
+#include <eastl/vector.h>
+#include <eastl/deque.h>
+#include <eastl/string.h>
+
+using eastl::vector;
+using eastl::deque;
+using eastl::string;
+
+//STD Includes
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+//Ravine Includes
+#include "RvFileSystem.h"
+#include "RvImportProfile.h"
+
+enum RvSceneLoadState
+{
+	//Loader thread is importing the file, there is nothing to draw yet
+	RV_SCENE_LOAD_IMPORTING,
+	//Mesh data is available, GPU resources are yet to be created
+	RV_SCENE_LOAD_IMPORTED,
+	//Resources are being uploaded, missing ones are drawn with placeholders
+	RV_SCENE_LOAD_STREAMING,
+	//Every mesh and texture is resident
+	RV_SCENE_LOAD_READY,
+	RV_SCENE_LOAD_FAILED
+};
+
+/**
+ * \brief Decoded RGBA8 pixels waiting to be uploaded.
+ */
+struct RvDecodedTexture
+{
+	uint32_t textureId;
+	vector<char> pixels;
+	uint32_t width;
+	uint32_t height;
+
+	//Cooked textures keep their file mapped instead of filling pixels, so the upload can read it in place
+	RvFileView cooked;
+	size_t cookedOffset = 0;
+};
+
+/**
+ * \brief Tracks a scene being loaded in background, returned before any of its data is available.
+ */
+struct RvSceneHandle
+{
+	string filePath;
+	RvImportProfileType profileType = RV_IMPORT_PROFILE_SKINNED_CHARACTER;
+	std::atomic<RvSceneLoadState> state{ RV_SCENE_LOAD_IMPORTING };
+
+	//Set by the loader thread once every texture was decoded (or failed to)
+	std::atomic<bool> texturesDecoded{ false };
+
+	//Produced by the loader thread, consumed by the render thread
+	std::mutex decodedMutex;
+	deque<RvDecodedTexture> decodedTextures;
+
+	std::thread loader;
+
+	bool isResident() const
+	{
+		return state == RV_SCENE_LOAD_READY;
+	}
+};
+
+#endif
@@ -6,6 +6,9 @@
 //STD Includes
 #include <stdexcept>
 
+//Ravine Includes
+#include "RvDeletionQueue.h"
+
 RvSwapChain::RvSwapChain(RvDevice& device, VkSurfaceKHR surface, uint32_t width, uint32_t height, VkSwapchainKHR oldSwapChain)
 {
 	this->device = &device;
@@ -148,6 +151,31 @@ void RvSwapChain::clear()
 	destroySyncObjects();
 }
 
+void RvSwapChain::retire(RvSwapChain& replacement)
+{
+	replacement.inFlightFences = eastl::move(inFlightFences);
+	replacement.imageAvailableSemaphores = eastl::move(imageAvailableSemaphores);
+	replacement.renderFinishedSemaphores = eastl::move(renderFinishedSemaphores);
+	replacement.currentFrame = currentFrame;
+
+	RvDeletionQueue* deletionQueue = device->deletionQueue;
+	for (VkImageView imageView : imageViews)
+	{
+		deletionQueue->destroyImageView(imageView);
+	}
+	imageViews.clear();
+	images.clear();
+
+	//Callbacks run after the handles of their bucket, so the views are gone before the swapchain
+	const VkDevice deviceHandle = device->handle;
+	const VkSwapchainKHR swapchainHandle = handle;
+	deletionQueue->push([deviceHandle, swapchainHandle]()
+	{
+		vkDestroySwapchainKHR(deviceHandle, swapchainHandle, nullptr);
+	});
+	handle = VK_NULL_HANDLE;
+}
+
 void RvSwapChain::createImageViews()
 {
 	//Match the size
@@ -195,23 +223,29 @@ bool RvSwapChain::acquireNextFrame(uint32_t& frameIndex)
 {
 	//Wait for in-flight fences
 	vkWaitForFences(device->handle, 1, &inFlightFences[currentFrame], VK_TRUE, eastl::numeric_limits<uint64_t>::max());
-	vkResetFences(device->handle, 1, &inFlightFences[currentFrame]);
+
+	//Resources released the last time this slot was recorded are no longer in use
+	device->deletionQueue->beginFrame(static_cast<uint32_t>(currentFrame));
 
 	//Acquiring an image from the swap chain
 	//Reference: https://vulkan-tutorial.com/Drawing_a_triangle/Drawing/Rendering_and_presentation#page_Acquiring_an_image_from_the_swap_chain
 	const VkResult result = vkAcquireNextImageKHR(device->handle, handle, eastl::numeric_limits<uint64_t>::max(),
 	                                        imageAvailableSemaphores[currentFrame], VK_NULL_HANDLE, &frameIndex);
 	if (result == VK_ERROR_OUT_OF_DATE_KHR) {
+		//Nothing is submitted in this slot, its fence stays signaled and the next frame moves on to the following one
+		currentFrame = (currentFrame + 1) % RV_MAX_FRAMES_IN_FLIGHT;
 		return false;
 	}
 	if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
 		throw std::runtime_error("Failed to acquire swap chain image!");
 	}
 
+	//Only reset once the frame is certain to be submitted, an unsignaled fence would never be waited out
+	vkResetFences(device->handle, 1, &inFlightFences[currentFrame]);
 	return true;
 }
 
-bool RvSwapChain::submitNextFrame(VkCommandBuffer* commandBuffers, uint32_t frameIndex)
+bool RvSwapChain::submitNextFrame(VkCommandBuffer commandBuffer, uint32_t frameIndex)
 {
 	//Submitting the command queue
 	//Reference: https://vulkan-tutorial.com/Drawing_a_triangle/Drawing/Rendering_and_presentation#page_Submitting_the_command_buffer
@@ -226,7 +260,7 @@ bool RvSwapChain::submitNextFrame(VkCommandBuffer* commandBuffers, uint32_t fram
 
 	//TODO: Research on multiple command buffers for same frame
 	submitInfo.commandBufferCount = 1;
-	submitInfo.pCommandBuffers = &commandBuffers[frameIndex];
+	submitInfo.pCommandBuffers = &commandBuffer;
 
 	VkSemaphore signalSemaphores[] = { renderFinishedSemaphores[currentFrame] };
 	submitInfo.signalSemaphoreCount = 1;
@@ -250,16 +284,17 @@ bool RvSwapChain::submitNextFrame(VkCommandBuffer* commandBuffers, uint32_t fram
 
 	presentInfo.pResults = nullptr; // Optional
 
+	//The frame was submitted either way, the next one uses the following slot
+	currentFrame = (currentFrame + 1) % RV_MAX_FRAMES_IN_FLIGHT;
+
 	result = vkQueuePresentKHR(device->presentQueue, &presentInfo);
-	if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || framebufferResized) {
-		framebufferResized = false;
+	if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR) {
 		return false;
 	}
 	if (result != VK_SUCCESS) {
 		throw std::runtime_error("Failed to present swap chain image!");
 	}
 
-	currentFrame = (currentFrame + 1) % RV_MAX_FRAMES_IN_FLIGHT;
 	return true;
 }
 
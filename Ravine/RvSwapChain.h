@@ -28,7 +28,6 @@ public:
 	//Extent values
 	uint32_t width;
 	uint32_t height;
-	bool framebufferResized = false;
 
 	//Number of maximum simultaneous frames
 	#define RV_MAX_FRAMES_IN_FLIGHT 3
@@ -59,8 +58,17 @@ public:
 	void createSyncObjects();
 	void destroySyncObjects();
 
+	/**
+	 * \brief Hands the fences and semaphores of the frames in flight over to the swapchain replacing this one,
+	 * the handle and image views go through the deletion queue. This object is left empty and can be deleted.
+	 */
+	void retire(RvSwapChain& replacement);
+
+	//Frame in flight being recorded, whose fence was waited on by acquireNextFrame (not the image index)
+	uint32_t frameSlot() const { return static_cast<uint32_t>(currentFrame); }
+
 	bool acquireNextFrame(uint32_t& frameIndex);
-	bool submitNextFrame(VkCommandBuffer* commandBuffers, uint32_t frameIndex);
+	bool submitNextFrame(VkCommandBuffer commandBuffer, uint32_t frameIndex);
 
 	VkSurfaceFormatKHR chooseSurfaceFormat(const vector<VkSurfaceFormatKHR>& availableFormats);
 	VkPresentModeKHR choosePresentMode(const vector<VkPresentModeKHR>& availablePresentModes);
@@ -4,6 +4,9 @@
 //Vulkan Includes
 #include "volk.h"
 
+//Ravine Includes
+#include "RvMemoryAllocator.h"
+
 struct RvTexture
 {
 	RvTexture() = default;
@@ -27,8 +30,9 @@ struct RvTexture
 	//The VkImageView handle
 	VkImageView view;
 
-	//The memory handle on a GPU device
-	VkDeviceMemory memory;
+	//The memory range on a GPU device and the allocator it came from
+	RvAllocation allocation;
+	RvMemoryAllocator* allocator;
 
 	void free();
 
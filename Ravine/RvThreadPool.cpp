@@ -0,0 +1,138 @@
+#include "RvThreadPool.h"
+
+//Ravine Includes
+#include "RvFrameArena.h"
+
+//STD Includes
+#include <atomic>
+#include <memory>
+
+RvThreadPool::RvThreadPool(uint32_t threadsCount)
+{
+	if (threadsCount == 0)
+	{
+		const uint32_t hardwareThreads = std::thread::hardware_concurrency();
+		threadsCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+	}
+
+	workers.reserve(threadsCount);
+	for (uint32_t i = 0; i < threadsCount; i++)
+	{
+		workers.push_back(std::thread(&RvThreadPool::workerLoop, this));
+	}
+}
+
+RvThreadPool::~RvThreadPool()
+{
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	jobAvailable.notify_all();
+
+	for (std::thread& worker : workers)
+	{
+		worker.join();
+	}
+}
+
+void RvThreadPool::submit(std::function<void()> job)
+{
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		jobs.push_back({ std::move(job), RvHeap::currentCategory() });
+	}
+	jobAvailable.notify_one();
+}
+
+void RvThreadPool::parallelFor(uint32_t count, const std::function<void(uint32_t)>& job)
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	//Workers and caller pull indices from a shared counter, which balances uneven items (e.g. meshes of different sizes)
+	struct ParallelState
+	{
+		std::atomic<uint32_t> nextIndex{ 0 };
+		std::atomic<uint32_t> completed{ 0 };
+		std::mutex doneMutex;
+		std::condition_variable itemsDone;
+	};
+	std::shared_ptr<ParallelState> state = std::make_shared<ParallelState>();
+	const std::function<void(uint32_t)>* jobPtr = &job;
+
+	//Job is only touched while some index is unfinished, so helpers that start late never read the caller's frame
+	const auto drain = [state, count, jobPtr]()
+	{
+		for (uint32_t i = state->nextIndex++; i < count; i = state->nextIndex++)
+		{
+			(*jobPtr)(i);
+			if (++state->completed == count)
+			{
+				std::unique_lock<std::mutex> lock(state->doneMutex);
+				state->itemsDone.notify_one();
+			}
+		}
+	};
+
+	const uint32_t helpersCount = count - 1 < size() ? count - 1 : size();
+	for (uint32_t i = 0; i < helpersCount; i++)
+	{
+		submit(drain);
+	}
+
+	drain();
+
+	//Wait for items instead of helpers, this keeps nested calls (from jobs running on workers) from dead-locking
+	std::unique_lock<std::mutex> lock(state->doneMutex);
+	state->itemsDone.wait(lock, [&state, count]() { return state->completed == count; });
+}
+
+void RvThreadPool::wait()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	jobsDone.wait(lock, [this]() { return jobs.empty() && activeJobs == 0; });
+}
+
+uint32_t RvThreadPool::size() const
+{
+	return static_cast<uint32_t>(workers.size());
+}
+
+void RvThreadPool::workerLoop()
+{
+	for (;;)
+	{
+		RvJob job;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			jobAvailable.wait(lock, [this]() { return stopping || !jobs.empty(); });
+			if (jobs.empty())
+			{
+				return;
+			}
+			job = std::move(jobs.front());
+			jobs.pop_front();
+			activeJobs++;
+		}
+
+		{
+			RvHeapScope scope(job.category);
+			job.run();
+		}
+
+		//Nothing a finished job allocated from the worker arena is still in use
+		RvFrameArena::local().reset();
+
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			activeJobs--;
+			if (jobs.empty() && activeJobs == 0)
+			{
+				jobsDone.notify_all();
+			}
+		}
+	}
+}
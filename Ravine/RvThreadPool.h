@@ -0,0 +1,78 @@
+#ifndef RV_THREAD_POOL_H
+#define RV_THREAD_POOL_H
+
+//EASTL Includes
+#include <eastl/vector.h>
+#include <eastl/deque.h>
+
+using eastl::vector;
+using eastl::deque;
+
+//STD Includes
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+//Ravine Includes
+#include "RvHeap.h"
+
+/**
+ * \brief Fixed set of worker threads consuming a shared job queue.
+ */
+class RvThreadPool
+{
+public:
+
+	/**
+	 * \brief Spawns the worker threads.
+	 * \param threadsCount Amount of workers, zero picks one per hardware thread minus the calling one.
+	 */
+	explicit RvThreadPool(uint32_t threadsCount = 0);
+
+	/**
+	 * \brief Finishes queued jobs and joins every worker.
+	 */
+	~RvThreadPool();
+
+	/**
+	 * \brief Queues a job to run on any worker.
+	 */
+	void submit(std::function<void()> job);
+
+	/**
+	 * \brief Runs job(i) for every i in [0, count) and returns once all of them are done.
+	 * The calling thread takes part in the work, so it's safe to use with no workers or from inside a job.
+	 */
+	void parallelFor(uint32_t count, const std::function<void(uint32_t)>& job);
+
+	/**
+	 * \brief Blocks until the queue is empty and no job is running.
+	 */
+	void wait();
+
+	/**
+	 * \brief Amount of worker threads.
+	 */
+	uint32_t size() const;
+
+private:
+	//Jobs allocate under the heap category of the thread that queued them
+	struct RvJob
+	{
+		std::function<void()> run;
+		RvHeapCategory category;
+	};
+
+	void workerLoop();
+
+	vector<std::thread> workers;
+	deque<RvJob> jobs;
+	std::mutex mutex;
+	std::condition_variable jobAvailable;
+	std::condition_variable jobsDone;
+	uint32_t activeJobs = 0;
+	bool stopping = false;
+};
+
+#endif
@@ -1,11 +1,11 @@
 ﻿#include "RvTools.h"
+#include "RvUploadContext.h"
 
 //EASTL Includes
 #include <eastl/algorithm.h>
 
 //STD Includes
 #include <stdexcept>
-#include <fstream>
 
 //FMT Includes
 #include <fmt/printf.h>
@@ -29,35 +29,37 @@ namespace rvTools {
 		return format == VK_FORMAT_D32_SFLOAT_S8_UINT || format == VK_FORMAT_D24_UNORM_S8_UINT;
 	}
 
-	RvTexture createTexture(RvDevice* device, void* pixels, uint32_t width, uint32_t height, VkFormat format)
+	RvTexture createTexture(RvDevice* device, const void* pixels, uint32_t width, uint32_t height, VkFormat format)
+	{
+		//Staging, transition, copy and mip generation in a single submission
+		RvUploadContext upload(*device);
+		RvTexture texture = upload.createTexture(pixels, width, height, format);
+		upload.wait();
+		return texture;
+	}
+
+	RvTexture createTexture(RvDevice* device, VkBuffer source, VkDeviceSize sourceOffset, uint32_t width, uint32_t height, VkFormat format)
+	{
+		//Waits for completion, so the source can be released afterwards
+		RvUploadContext upload(*device);
+		RvTexture texture = upload.createTexture(source, sourceOffset, width, height, format);
+		upload.wait();
+		return texture;
+	}
+
+	RvTexture createTextureImage(RvDevice* device, uint32_t width, uint32_t height, VkFormat format)
 	{
 		//Create ravine texture instance
 		RvTexture texture;
 		texture.extent.width = width;
 		texture.extent.height = height;
 
-		//TODO: Change to a proper Log operation and return null
-		if (!pixels) {
-			throw std::runtime_error("Failed to load texture image!");
-		}
-
-		//Staging buffer
-		size_t dataSize = width * height * 4; //Size * 4 channels (RGBA)
-		RvDynamicBuffer stagingBuffer = device->createDynamicBuffer(dataSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-			(VkMemoryPropertyFlagBits)(VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)
-		);
-
-		//Transfering image data
-		void* data;
-		vkMapMemory(device->handle, stagingBuffer.memory, 0, dataSize, 0, &data);
-		memcpy(data, pixels, dataSize);
-		vkUnmapMemory(device->handle, stagingBuffer.memory);
-
 		//Hold data size for copy-back
-		texture.dataSize = dataSize;
+		texture.dataSize = width * height * 4; //Size * 4 channels (RGBA)
 
 		//Assign this device as the texture holder
 		texture.device = device->handle;
+		texture.allocator = device->allocator;
 
 		//Mip levels calculation
 		/*
@@ -75,29 +77,15 @@ namespace rvTools {
 			format, VK_IMAGE_TILING_OPTIMAL,
 			VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
 			VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT,
-			texture.handle, texture.memory);
+			texture.handle, texture.allocation);
 
 		//Assign mipLevel
 		texture.mipLevels = mipLevels;
 
-		//Setting image layout for transfering to image object
-		transitionImageLayout(*device, texture.handle, format, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, mipLevels);
-
-		//Transfering buffer data to image object
-		copyBufferToImage(device, stagingBuffer.handle, texture.handle, static_cast<uint32_t>(width), static_cast<uint32_t>(height));
-
-		//Clearing staging buffer
-		vkDestroyBuffer(device->handle, stagingBuffer.handle, nullptr);
-		vkFreeMemory(device->handle, stagingBuffer.memory, nullptr);
-
-		//Transitioned to VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL while generating mipmaps
-		generateMipmap(device, texture.handle, format, width, height, mipLevels);
-
 		//Create ImageView for this texture
 		texture.view = createImageView(device->handle, texture.handle, format, VK_IMAGE_ASPECT_COLOR_BIT, texture.mipLevels);
 
 		return texture;
-
 	}
 
 	void generateMipmap(RvDevice* device, VkImage image, VkFormat imageFormat, uint32_t texWidth, uint32_t texHeight, uint32_t mipLevels)
@@ -110,7 +98,12 @@ namespace rvTools {
 		}
 
 		VkCommandBuffer commandBuffer = device->beginSingleTimeCommands();
+		generateMipmap(commandBuffer, image, texWidth, texHeight, mipLevels);
+		device->endSingleTimeCommands(commandBuffer);
+	}
 
+	void generateMipmap(VkCommandBuffer commandBuffer, VkImage image, uint32_t texWidth, uint32_t texHeight, uint32_t mipLevels)
+	{
 		VkImageMemoryBarrier barrier = {};
 		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
 		barrier.image = image;
@@ -195,16 +188,19 @@ namespace rvTools {
 			0, nullptr,
 			0, nullptr,
 			1, &barrier);
-
-		device->endSingleTimeCommands(commandBuffer);
 	}
 
-	void copyBufferToImage(RvDevice* device, VkBuffer buffer, VkImage image, uint32_t width, uint32_t height)
+	void copyBufferToImage(RvDevice* device, VkBuffer buffer, VkImage image, uint32_t width, uint32_t height, VkDeviceSize bufferOffset)
 	{
 		VkCommandBuffer commandBuffer = device->beginSingleTimeCommands();
+		copyBufferToImage(commandBuffer, buffer, image, width, height, bufferOffset);
+		device->endSingleTimeCommands(commandBuffer);
+	}
 
+	void copyBufferToImage(VkCommandBuffer commandBuffer, VkBuffer buffer, VkImage image, uint32_t width, uint32_t height, VkDeviceSize bufferOffset)
+	{
 		VkBufferImageCopy region = {};
-		region.bufferOffset = 0;
+		region.bufferOffset = bufferOffset;
 		region.bufferRowLength = 0;
 		region.bufferImageHeight = 0;
 
@@ -228,8 +224,6 @@ namespace rvTools {
 			1,
 			&region
 		);
-
-		device->endSingleTimeCommands(commandBuffer);
 	}
 
 	VkImageView createImageView(VkDevice device, VkImage image, VkFormat format, VkImageAspectFlags aspectFlags, uint32_t mipLevels)
@@ -321,27 +315,19 @@ namespace rvTools {
 		return details;
 	}
 
-	vector<char> readFile(const string& filename)
+	RvFileView readFile(const string& filename)
 	{
-		std::ifstream file(filename.c_str(), std::ios::ate | std::ios::binary);
+		RvFileView file = RvFileSystem::map(filename);
 
-		if (!file.is_open()) {
+		if (!file.isValid()) {
 			string error("Failed to open file at " + filename);
 			throw std::runtime_error(error.c_str());
 		}
 
-		size_t fileSize = (size_t)file.tellg();
-		vector<char> buffer(fileSize);
-
-		file.seekg(0);
-		file.read(buffer.data(), fileSize);
-
-		file.close();
-
-		return buffer;
+		return file;
 	}
 
-	vector<char> compileShaderText(const string& shaderName, const vector<char>& shaderText, shaderc_shader_kind shaderKind, const char* entryPoint)
+	vector<char> compileShaderText(const string& shaderName, const RvFileView& shaderText, shaderc_shader_kind shaderKind, const char* entryPoint)
 	{
 		//Use ShaderC to compile a SPIR-V shader
 		shaderc_compiler_t compiler = shaderc_compiler_initialize();
@@ -373,7 +359,12 @@ namespace rvTools {
 	void transitionImageLayout(RvDevice device, VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t mipLevels)
 	{
 		VkCommandBuffer commandBuffer = device.beginSingleTimeCommands();
+		transitionImageLayout(commandBuffer, image, format, oldLayout, newLayout, mipLevels);
+		device.endSingleTimeCommands(commandBuffer);
+	}
 
+	void transitionImageLayout(VkCommandBuffer commandBuffer, VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t mipLevels)
+	{
 		VkImageMemoryBarrier barrier = {};
 		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
 		barrier.oldLayout = oldLayout;
@@ -448,32 +439,29 @@ namespace rvTools {
 			0, nullptr,
 			1, &barrier
 		);
-
-		device.endSingleTimeCommands(commandBuffer);
 	}
 
-	void copyBuffer(RvDevice& device, VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size)
+	void copyBuffer(RvDevice& device, VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size, VkDeviceSize dstOffset)
 	{
 		VkCommandBuffer commandBuffer = device.beginSingleTimeCommands();
+		copyBuffer(commandBuffer, srcBuffer, dstBuffer, size, dstOffset);
+		device.endSingleTimeCommands(commandBuffer);
+	}
 
+	void copyBuffer(VkCommandBuffer commandBuffer, VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size, VkDeviceSize dstOffset, VkDeviceSize srcOffset)
+	{
 		VkBufferCopy copyRegion = {};
 		copyRegion.size = size;
+		copyRegion.srcOffset = srcOffset;
+		copyRegion.dstOffset = dstOffset;
 		vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
-
-		device.endSingleTimeCommands(commandBuffer);
 	}
 
-	void copyToMemory(RvDevice& device, char* data, const VkDeviceMemory dstMemory, const VkDeviceSize size)
+	void copyToMemory(RvDevice& device, char* data, const RvAllocation& dstMemory, const VkDeviceSize size)
 	{
-		char* gpuBuffer = nullptr;
-		vkMapMemory(device.handle, dstMemory, 0, size, 0, reinterpret_cast<void**>(&gpuBuffer));
-        memcpy(gpuBuffer, data, size);
-		VkMappedMemoryRange range = {};
-		range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-		range.memory = dstMemory;
-		range.size = VK_WHOLE_SIZE;
-		vkFlushMappedMemoryRanges(device.handle, 1, &range);
-		vkUnmapMemory(device.handle, dstMemory);
+		//Host visible allocations are persistently mapped
+		memcpy(dstMemory.mapped, data, size);
+		device.allocator->flush(dstMemory);
 	}
 
 	VkShaderModule createShaderModule(VkDevice device, const vector<char>& code)
@@ -498,9 +486,14 @@ namespace rvTools {
 	{
 		RvFramebufferAttachment newAttachment = {};
 		device.createImage(createInfo.extent, createInfo.mipLevels, device.sampleCount, createInfo.format, createInfo.tilling, createInfo.usage,
-			createInfo.memoryProperties, createInfo.createFlag, newAttachment.image, newAttachment.memory);
+			createInfo.memoryProperties, createInfo.createFlag, newAttachment.image, newAttachment.allocation);
 		newAttachment.imageView = createImageView(device.handle, newAttachment.image, createInfo.format, createInfo.aspectFlag, createInfo.mipLevels);
-		transitionImageLayout(device, newAttachment.image, createInfo.format, createInfo.initialLayout, createInfo.finalLayout, createInfo.mipLevels);
+
+		//Render passes start transient attachments from an undefined layout, transitioning them would only touch lazily allocated memory
+		if (!(createInfo.usage & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT))
+		{
+			transitionImageLayout(device, newAttachment.image, createInfo.format, createInfo.initialLayout, createInfo.finalLayout, createInfo.mipLevels);
+		}
 
 		return newAttachment;
 	}
@@ -16,6 +16,7 @@
 #include "RvDevice.h"
 #include "RvTexture.h"
 #include "RvFramebufferAttachment.h"
+#include "RvFileSystem.h"
 
 struct RvSwapChainSupportDetails;
 using eastl::string;
@@ -26,12 +27,22 @@ namespace rvTools
 
 	bool hasStencilComponent(VkFormat format);
 
-	RvTexture createTexture(RvDevice* device, void *pixels, uint32_t width, uint32_t height, VkFormat format);
+	RvTexture createTexture(RvDevice* device, const void *pixels, uint32_t width, uint32_t height, VkFormat format);
+
+	//Creates a texture from RGBA8 pixels already in a transfer source buffer
+	RvTexture createTexture(RvDevice* device, VkBuffer source, VkDeviceSize sourceOffset, uint32_t width, uint32_t height, VkFormat format);
+
+	//Creates the image (with room for every mip level) and view of a texture, its contents are left undefined
+	RvTexture createTextureImage(RvDevice* device, uint32_t width, uint32_t height, VkFormat format);
 
 	void generateMipmap(RvDevice* device, VkImage image, VkFormat imageFormat, uint32_t texWidth, uint32_t texHeight, uint32_t mipLevels = 1);
 
+	//Records the mip chain blits, the format must support linear blitting
+	void generateMipmap(VkCommandBuffer commandBuffer, VkImage image, uint32_t texWidth, uint32_t texHeight, uint32_t mipLevels);
+
 	//Transfer buffer's data to an image
-	void copyBufferToImage(RvDevice* device, VkBuffer buffer, VkImage image, uint32_t width, uint32_t height);
+	void copyBufferToImage(RvDevice* device, VkBuffer buffer, VkImage image, uint32_t width, uint32_t height, VkDeviceSize bufferOffset = 0);
+	void copyBufferToImage(VkCommandBuffer commandBuffer, VkBuffer buffer, VkImage image, uint32_t width, uint32_t height, VkDeviceSize bufferOffset = 0);
 
 	VkImageView createImageView(VkDevice device, VkImage image, VkFormat format, VkImageAspectFlags aspectFlags, uint32_t mipLevels = 1);
 
@@ -53,15 +64,18 @@ namespace rvTools
 
 	RvSwapChainSupportDetails querySupport(VkPhysicalDevice device, VkSurfaceKHR surface);
 
-	vector<char> readFile(const string& filename);
+	//Maps the file through RvFileSystem, throws if it can't be opened
+	RvFileView readFile(const string& filename);
 	
-	vector<char> compileShaderText(const string& shaderName, const vector<char>& shaderText, shaderc_shader_kind shaderKind, const char* entryPoint);
+	vector<char> compileShaderText(const string& shaderName, const RvFileView& shaderText, shaderc_shader_kind shaderKind, const char* entryPoint);
 
 	void transitionImageLayout(RvDevice device, VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t mipLevels);
+	void transitionImageLayout(VkCommandBuffer commandBuffer, VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t mipLevels);
 
-	void copyBuffer(RvDevice& device, VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size);
+	void copyBuffer(RvDevice& device, VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size, VkDeviceSize dstOffset = 0);
+	void copyBuffer(VkCommandBuffer commandBuffer, VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size, VkDeviceSize dstOffset = 0, VkDeviceSize srcOffset = 0);
 
-	void copyToMemory(RvDevice& device, char* data, const VkDeviceMemory dstMemory, const VkDeviceSize size);
+	void copyToMemory(RvDevice& device, char* data, const RvAllocation& dstMemory, const VkDeviceSize size);
 
 	VkShaderModule createShaderModule(VkDevice device, const vector<char>& code);
 
@@ -0,0 +1,59 @@
+#include "RvUniformRing.h"
+
+//EASTL Includes
+#include <eastl/algorithm.h>
+
+//STD Includes
+#include <stdexcept>
+
+RvUniformRing::RvUniformRing(RvDevice& device, uint32_t framesCount, VkDeviceSize frameCapacity, VkBufferUsageFlags usage) :
+	framesCount(framesCount), alignment(device.deviceProperties.limits.minUniformBufferOffsetAlignment), device(&device)
+{
+	//Dynamic offsets of storage descriptors have their own alignment
+	if (usage & VK_BUFFER_USAGE_STORAGE_BUFFER_BIT)
+	{
+		alignment = eastl::max(alignment, device.deviceProperties.limits.minStorageBufferOffsetAlignment);
+	}
+
+	//Frame ranges start aligned as well
+	this->frameCapacity = alignedSize(frameCapacity);
+
+	buffer = device.createDynamicBuffer(this->frameCapacity * framesCount, static_cast<VkBufferUsageFlagBits>(usage),
+		static_cast<VkMemoryPropertyFlagBits>(VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT));
+
+	//Host visible allocations stay mapped for their whole lifetime, coherent memory needs no flushes
+	mapped = buffer.allocation.mapped;
+}
+
+RvUniformRing::~RvUniformRing()
+= default;
+
+void RvUniformRing::begin(uint32_t frameIndex)
+{
+	head = frameIndex * frameCapacity;
+	frameEnd = head + frameCapacity;
+}
+
+VkDeviceSize RvUniformRing::allocate(VkDeviceSize size, void*& data)
+{
+	if (head + size > frameEnd) {
+		throw std::runtime_error("Uniform ring frame capacity exceeded!");
+	}
+
+	const VkDeviceSize offset = head;
+	head += alignedSize(size);
+	data = mapped + offset;
+	return offset;
+}
+
+VkDeviceSize RvUniformRing::alignedSize(VkDeviceSize size) const
+{
+	return (size + alignment - 1) / alignment * alignment;
+}
+
+void RvUniformRing::clear()
+{
+	vkDestroyBuffer(device->handle, buffer.handle, nullptr);
+	device->allocator->free(buffer.allocation);
+	mapped = nullptr;
+}
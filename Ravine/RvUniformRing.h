@@ -0,0 +1,73 @@
+#ifndef RV_UNIFORM_RING_H
+#define RV_UNIFORM_RING_H
+
+//STD Includes
+#include <cstring>
+
+//Ravine Includes
+#include "RvDevice.h"
+#include "RvDynamicBuffer.h"
+
+/**
+ * \brief Persistently mapped host coherent buffer holding the constants of every frame in flight, one range per frame.
+ * Constants are written with a bump pointer into the range of the frame being recorded and referenced by their offset,
+ * so adding draws adds neither buffers nor map calls.
+ * Offsets are meant to be bound as dynamic offsets of VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC
+ * (or VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC when created with storage usage) descriptors.
+ */
+class RvUniformRing
+{
+public:
+	RvUniformRing(RvDevice& device, uint32_t framesCount, VkDeviceSize frameCapacity, VkBufferUsageFlags usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT);
+	~RvUniformRing();
+
+	RvDynamicBuffer buffer;
+
+	//Bytes reserved for each frame (multiple of the alignment)
+	VkDeviceSize frameCapacity;
+	uint32_t framesCount;
+
+	//Offsets handed out are multiples of minUniformBufferOffsetAlignment (and minStorageBufferOffsetAlignment for storage usage)
+	VkDeviceSize alignment;
+
+	/**
+	 * \brief Rewinds the bump pointer to the start of the frame range, the frame must no longer be read by the GPU.
+	 */
+	void begin(uint32_t frameIndex);
+
+	/**
+	 * \brief Reserves size bytes of the current frame.
+	 * \return The offset of the reservation inside the buffer.
+	 */
+	VkDeviceSize allocate(VkDeviceSize size, void*& data);
+
+	/**
+	 * \brief Copies a value to the current frame, returning its offset inside the buffer.
+	 */
+	template<typename T>
+	VkDeviceSize push(const T& value)
+	{
+		void* data;
+		const VkDeviceSize offset = allocate(sizeof(T), data);
+		memcpy(data, &value, sizeof(T));
+		return offset;
+	}
+
+	//Size a reservation takes in the frame range
+	VkDeviceSize alignedSize(VkDeviceSize size) const;
+
+	/**
+	 * \brief Should be used instead of destroying in destructor
+	 */
+	void clear();
+
+private:
+	RvDevice* device;
+	char* mapped = nullptr;
+
+	//Bump pointer and end of the current frame range
+	VkDeviceSize head = 0;
+	VkDeviceSize frameEnd = 0;
+};
+
+#endif
@@ -17,6 +17,9 @@ struct RvMaterialBufferObject {
 
 struct RvModelBufferObject {
 	glm::mat4 model;
+	//Dequantization of packed positions (pos * scale + offset)
+	glm::vec4 positionScale;
+	glm::vec4 positionOffset;
 };
 
 struct RvBoneBufferObject {
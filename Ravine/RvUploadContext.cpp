@@ -0,0 +1,230 @@
+#include "RvUploadContext.h"
+
+//EASTL Includes
+#include <eastl/algorithm.h>
+
+//STD Includes
+#include <stdexcept>
+
+//Ravine Includes
+#include "RvTools.h"
+
+#pragma region RvStagingRing
+
+RvStagingRing::RvStagingRing(RvDevice& device, VkDeviceSize capacity) : device(&device), capacity(capacity)
+{
+	buffer = device.createDynamicBuffer(capacity, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+		static_cast<VkMemoryPropertyFlagBits>(VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT));
+
+	//Host visible allocations stay mapped for their whole lifetime, coherent memory needs no flushes
+	mapped = buffer.allocation.mapped;
+}
+
+RvStagingRing::~RvStagingRing()
+= default;
+
+bool RvStagingRing::allocate(VkDeviceSize size, VkDeviceSize& offset, char*& data)
+{
+	VkDeviceSize begin = (head + RV_STAGING_ALIGNMENT - 1) & ~static_cast<VkDeviceSize>(RV_STAGING_ALIGNMENT - 1);
+
+	//Copies read a contiguous range, so the end of the ring is skipped when the allocation doesn't fit before it
+	if (begin % capacity + size > capacity)
+	{
+		begin += capacity - begin % capacity;
+	}
+	if (begin + size - tail > capacity)
+	{
+		return false;
+	}
+
+	head = begin + size;
+	offset = begin % capacity;
+	data = mapped + offset;
+	return true;
+}
+
+void RvStagingRing::release(VkDeviceSize position)
+{
+	//Submissions on the same queue finish in order, a later position covers earlier ones
+	tail = eastl::max(tail, position);
+}
+
+void RvStagingRing::clear()
+{
+	vkDestroyBuffer(device->handle, buffer.handle, nullptr);
+	device->allocator->free(buffer.allocation);
+	mapped = nullptr;
+	head = tail = 0;
+}
+
+#pragma endregion
+
+#pragma region RvUploadContext
+
+RvUploadContext::RvUploadContext(RvDevice& device) : device(&device)
+{
+	VkCommandBufferAllocateInfo allocInfo = {};
+	allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+	allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	allocInfo.commandPool = device.commandPool;
+	allocInfo.commandBufferCount = 1;
+	if (vkAllocateCommandBuffers(device.handle, &allocInfo, &commandBuffer) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to allocate upload command buffer!");
+	}
+
+	VkCommandBufferBeginInfo beginInfo = {};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+	vkBeginCommandBuffer(commandBuffer, &beginInfo);
+}
+
+RvUploadContext::~RvUploadContext()
+{
+	wait();
+}
+
+void RvUploadContext::stage(const void* data, VkDeviceSize size, VkBuffer& buffer, VkDeviceSize& offset)
+{
+	char* stagingData;
+	if (device->stagingRing->allocate(size, offset, stagingData))
+	{
+		memcpy(stagingData, data, static_cast<size_t>(size));
+		buffer = device->stagingRing->buffer.handle;
+		return;
+	}
+
+	//Ring is full (or too small), this one gets its own staging buffer instead of waiting for space
+	RvDynamicBuffer stagingBuffer = device->createDynamicBuffer(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+		static_cast<VkMemoryPropertyFlagBits>(VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT));
+	memcpy(stagingBuffer.allocation.mapped, data, static_cast<size_t>(size));
+	keepAlive(stagingBuffer);
+
+	buffer = stagingBuffer.handle;
+	offset = 0;
+}
+
+void RvUploadContext::uploadBuffer(const void* data, VkDeviceSize size, VkBuffer dstBuffer, VkDeviceSize dstOffset)
+{
+	if (size == 0)
+	{
+		return;
+	}
+
+	VkBuffer stagingBuffer;
+	VkDeviceSize stagingOffset;
+	stage(data, size, stagingBuffer, stagingOffset);
+	rvTools::copyBuffer(commandBuffer, stagingBuffer, dstBuffer, size, dstOffset, stagingOffset);
+	recordedBufferCopies = true;
+}
+
+RvTexture RvUploadContext::createTexture(const void* pixels, uint32_t width, uint32_t height, VkFormat format)
+{
+	//TODO: Change to a proper Log operation and return null
+	if (!pixels) {
+		throw std::runtime_error("Failed to load texture image!");
+	}
+
+	VkBuffer stagingBuffer;
+	VkDeviceSize stagingOffset;
+	stage(pixels, static_cast<VkDeviceSize>(width) * height * 4, stagingBuffer, stagingOffset); //Size * 4 channels (RGBA)
+	return createTexture(stagingBuffer, stagingOffset, width, height, format);
+}
+
+RvTexture RvUploadContext::createTexture(VkBuffer source, VkDeviceSize sourceOffset, uint32_t width, uint32_t height, VkFormat format)
+{
+	//Checking device support for linear blitting
+	if (!(device->getFormatProperties(format).optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT)) {
+		throw std::runtime_error("Texture image format does not support linear blitting!");
+	}
+
+	RvTexture texture = rvTools::createTextureImage(device, width, height, format);
+
+	//Transition, copy and mip chain blits (ends in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL) in the same command buffer
+	rvTools::transitionImageLayout(commandBuffer, texture.handle, format, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, texture.mipLevels);
+	rvTools::copyBufferToImage(commandBuffer, source, texture.handle, width, height, sourceOffset);
+	rvTools::generateMipmap(commandBuffer, texture.handle, width, height, texture.mipLevels);
+
+	return texture;
+}
+
+void RvUploadContext::keepAlive(const RvDynamicBuffer& buffer)
+{
+	transientBuffers.push_back(buffer);
+}
+
+void RvUploadContext::submit()
+{
+	if (submitted)
+	{
+		return;
+	}
+
+	//Buffers are read by commands submitted after the context was waited on (textures are transitioned by their mip generation)
+	if (recordedBufferCopies)
+	{
+		VkMemoryBarrier barrier = {};
+		barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+		vkCmdPipelineBarrier(commandBuffer,
+			VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
+			1, &barrier,
+			0, nullptr,
+			0, nullptr);
+	}
+
+	vkEndCommandBuffer(commandBuffer);
+
+	VkFenceCreateInfo fenceInfo = {};
+	fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+	if (vkCreateFence(device->handle, &fenceInfo, nullptr, &fence) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create upload fence!");
+	}
+
+	VkSubmitInfo submitInfo = {};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &commandBuffer;
+
+	//The graphics queue implictly has a transfer queue
+	if (vkQueueSubmit(device->graphicsQueue, 1, &submitInfo, fence) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to submit upload command buffer!");
+	}
+
+	stagingPosition = device->stagingRing->position();
+	submitted = true;
+}
+
+bool RvUploadContext::isComplete() const
+{
+	return submitted && vkGetFenceStatus(device->handle, fence) == VK_SUCCESS;
+}
+
+void RvUploadContext::wait()
+{
+	if (released)
+	{
+		return;
+	}
+
+	submit();
+	vkWaitForFences(device->handle, 1, &fence, VK_TRUE, UINT64_MAX);
+	release();
+}
+
+void RvUploadContext::release()
+{
+	for (RvDynamicBuffer& buffer : transientBuffers)
+	{
+		vkDestroyBuffer(device->handle, buffer.handle, nullptr);
+		device->allocator->free(buffer.allocation);
+	}
+	transientBuffers.clear();
+	device->stagingRing->release(stagingPosition);
+
+	vkDestroyFence(device->handle, fence, nullptr);
+	vkFreeCommandBuffers(device->handle, device->commandPool, 1, &commandBuffer);
+	released = true;
+}
+
+#pragma endregion
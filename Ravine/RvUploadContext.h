@@ -0,0 +1,127 @@
+#ifndef RV_UPLOAD_CONTEXT_H
+#define RV_UPLOAD_CONTEXT_H
+
+//EASTL Includes
+#include <eastl/vector.h>
+
+using eastl::vector;
+
+//Ravine Includes
+#include "RvDevice.h"
+#include "RvTexture.h"
+#include "RvDynamicBuffer.h"
+
+//Offsets handed out by the staging ring are multiples of this (covers texel and optimal copy offset alignments)
+#define RV_STAGING_ALIGNMENT 16
+
+/**
+ * \brief Persistently mapped host visible buffer that staging data is written to, reused by every upload.
+ * Space is handed out in order and given back once the submissions reading it have finished.
+ */
+class RvStagingRing
+{
+public:
+	RvStagingRing(RvDevice& device, VkDeviceSize capacity);
+	~RvStagingRing();
+
+	RvDynamicBuffer buffer;
+
+	/**
+	 * \brief Reserves size bytes at the head of the ring (allocations never wrap around its end).
+	 * \return False if the space is still being read by submissions in flight, or the ring is too small.
+	 */
+	bool allocate(VkDeviceSize size, VkDeviceSize& offset, char*& data);
+
+	/**
+	 * \brief Current head, pass it to release once everything allocated until now was read.
+	 */
+	VkDeviceSize position() const { return head; }
+
+	/**
+	 * \brief Gives back every allocation made before the position was taken.
+	 */
+	void release(VkDeviceSize position);
+
+	/**
+	 * \brief Should be used instead of destroying in destructor
+	 */
+	void clear();
+
+private:
+	RvDevice* device;
+	char* mapped = nullptr;
+	VkDeviceSize capacity;
+
+	//Running byte counts, their difference is the space in use
+	VkDeviceSize head = 0;
+	VkDeviceSize tail = 0;
+};
+
+/**
+ * \brief Records every copy, layout transition and mip generation of a batch of uploads into one command buffer,
+ * staged through the device staging ring and submitted with a single fence.
+ * Contexts are recorded one at a time, the staging they used is released when their fence is waited on.
+ */
+class RvUploadContext
+{
+public:
+	RvUploadContext(RvDevice& device);
+	~RvUploadContext();
+
+	RvUploadContext(const RvUploadContext&) = delete;
+	RvUploadContext& operator=(const RvUploadContext&) = delete;
+
+	VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+
+	/**
+	 * \brief Copies data into a region of a device local buffer.
+	 */
+	void uploadBuffer(const void* data, VkDeviceSize size, VkBuffer dstBuffer, VkDeviceSize dstOffset);
+
+	/**
+	 * \brief Creates a mipmapped texture from RGBA8 pixels, it can be sampled once the context was waited on.
+	 */
+	RvTexture createTexture(const void* pixels, uint32_t width, uint32_t height, VkFormat format = VK_FORMAT_R8G8B8A8_UNORM);
+
+	/**
+	 * \brief Same as above with pixels already in a transfer source buffer (it must be kept alive until the context is waited on).
+	 */
+	RvTexture createTexture(VkBuffer source, VkDeviceSize sourceOffset, uint32_t width, uint32_t height, VkFormat format = VK_FORMAT_R8G8B8A8_UNORM);
+
+	/**
+	 * \brief Destroys a buffer (and frees its memory) once the uploads reading it have finished.
+	 */
+	void keepAlive(const RvDynamicBuffer& buffer);
+
+	/**
+	 * \brief Ends recording and submits the batch, nothing can be recorded afterwards.
+	 */
+	void submit();
+
+	//The batch was submitted and has finished executing
+	bool isComplete() const;
+
+	/**
+	 * \brief Waits for the batch fence (submitting first if needed) and releases its staging.
+	 */
+	void wait();
+
+private:
+	RvDevice* device;
+	VkFence fence = VK_NULL_HANDLE;
+
+	//Staging that didn't fit in the ring, and buffers handed over with keepAlive
+	vector<RvDynamicBuffer> transientBuffers;
+
+	//Ring head when the batch was submitted
+	VkDeviceSize stagingPosition = 0;
+
+	bool recordedBufferCopies = false;
+	bool submitted = false;
+	bool released = false;
+
+	void stage(const void* data, VkDeviceSize size, VkBuffer& buffer, VkDeviceSize& offset);
+	void release();
+};
+
+#endif
@@ -0,0 +1,200 @@
+#include "RvUploadScheduler.h"
+
+//STD Includes
+#include <chrono>
+#include <stdexcept>
+
+RvUploadScheduler::RvUploadScheduler(RvDevice& device, VkDeviceSize bytesPerFrame, double millisecondsPerFrame) :
+	bytesPerFrame(bytesPerFrame), millisecondsPerFrame(millisecondsPerFrame), device(&device)
+{
+}
+
+RvUploadScheduler::~RvUploadScheduler()
+= default;
+
+void RvUploadScheduler::uploadBuffer(vector<char>&& data, VkBuffer dstBuffer, VkDeviceSize dstOffset, std::function<void()> onResident)
+{
+	RvUploadRequest request;
+	request.type = RV_UPLOAD_BUFFER;
+	request.size = data.size();
+	request.data = eastl::move(data);
+	request.dstBuffer = dstBuffer;
+	request.dstOffset = dstOffset;
+	request.onBufferResident = eastl::move(onResident);
+	enqueue(eastl::move(request));
+}
+
+void RvUploadScheduler::uploadBuffer(const void* data, VkDeviceSize size, VkBuffer dstBuffer, VkDeviceSize dstOffset, std::function<void()> onResident)
+{
+	const char* bytes = static_cast<const char*>(data);
+	uploadBuffer(vector<char>(bytes, bytes + size), dstBuffer, dstOffset, eastl::move(onResident));
+}
+
+void RvUploadScheduler::uploadTexture(vector<char>&& pixels, uint32_t width, uint32_t height, VkFormat format, std::function<void(const RvTexture&)> onResident)
+{
+	RvUploadRequest request;
+	request.type = RV_UPLOAD_TEXTURE;
+	request.size = static_cast<VkDeviceSize>(width) * height * 4; //Size * 4 channels (RGBA)
+	request.data = eastl::move(pixels);
+	request.width = width;
+	request.height = height;
+	request.format = format;
+	request.onTextureResident = eastl::move(onResident);
+	enqueue(eastl::move(request));
+}
+
+void RvUploadScheduler::uploadTexture(RvFileView&& file, size_t offset, uint32_t width, uint32_t height, VkFormat format, std::function<void(const RvTexture&)> onResident)
+{
+	RvUploadRequest request;
+	request.type = RV_UPLOAD_TEXTURE;
+	request.size = static_cast<VkDeviceSize>(width) * height * 4; //Size * 4 channels (RGBA)
+	request.file = eastl::move(file);
+	request.fileOffset = offset;
+	request.width = width;
+	request.height = height;
+	request.format = format;
+	request.onTextureResident = eastl::move(onResident);
+	enqueue(eastl::move(request));
+}
+
+void RvUploadScheduler::notify(std::function<void()> onResident)
+{
+	//Empty buffer upload, it only takes a place in the queue
+	uploadBuffer(vector<char>(), VK_NULL_HANDLE, 0, eastl::move(onResident));
+}
+
+void RvUploadScheduler::enqueue(RvUploadRequest&& request)
+{
+	//Mip chains are blitted, fail when queued rather than frames later
+	if (request.type == RV_UPLOAD_TEXTURE &&
+		!(device->getFormatProperties(request.format).optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT)) {
+		throw std::runtime_error("Texture image format does not support linear blitting!");
+	}
+
+	pending.push_back(eastl::move(request));
+}
+
+void RvUploadScheduler::update()
+{
+	retire();
+	if (pending.empty())
+	{
+		return;
+	}
+
+	const std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+	//Record requests in order until either budget runs out
+	RvUploadBatch batch;
+	batch.upload = new RvUploadContext(*device);
+	VkDeviceSize recordedBytes = 0;
+	while (!pending.empty())
+	{
+		RvUploadRequest& request = pending.front();
+
+		//The first request is always taken, so the ones larger than the budget still get through
+		if (!batch.requests.empty())
+		{
+			const double elapsed = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+			if (recordedBytes + request.size > bytesPerFrame || elapsed >= millisecondsPerFrame)
+			{
+				break;
+			}
+		}
+
+		record(*batch.upload, request);
+		recordedBytes += request.size;
+		batch.requests.push_back(eastl::move(request));
+		pending.pop_front();
+	}
+
+	batch.upload->submit();
+	inFlight.push_back(eastl::move(batch));
+}
+
+void RvUploadScheduler::record(RvUploadContext& upload, RvUploadRequest& request)
+{
+	if (request.size == 0)
+	{
+		return;
+	}
+
+	if (request.type == RV_UPLOAD_BUFFER)
+	{
+		upload.uploadBuffer(request.data.data(), request.size, request.dstBuffer, request.dstOffset);
+		request.data = vector<char>();
+		return;
+	}
+
+	//Mapped file pages are copied from directly when the device can import them (texel aligned offsets only)
+	RvDynamicBuffer importedBuffer;
+	VkDeviceSize importedOffset;
+	if (request.file.isValid() && request.fileOffset % 4 == 0 &&
+		device->importHostMemory(request.file, request.fileOffset, request.size, importedBuffer, importedOffset))
+	{
+		//Imported pages must stay mapped, the file is released with the request
+		upload.keepAlive(importedBuffer);
+		request.texture = upload.createTexture(importedBuffer.handle, importedOffset, request.width, request.height, request.format);
+		return;
+	}
+
+	//Pixels are copied into the staging ring, so the source is released right away
+	const char* pixels = request.file.isValid() ? request.file.data() + request.fileOffset : request.data.data();
+	request.texture = upload.createTexture(pixels, request.width, request.height, request.format);
+	request.data = vector<char>();
+	request.file = RvFileView();
+}
+
+void RvUploadScheduler::retire()
+{
+	//Batches were submitted in order to the same queue, so they finish in order too
+	while (!inFlight.empty() && inFlight.front().upload->isComplete())
+	{
+		RvUploadBatch batch = eastl::move(inFlight.front());
+		inFlight.pop_front();
+		delete batch.upload;
+
+		//Owners may queue new uploads from their callbacks
+		for (RvUploadRequest& request : batch.requests)
+		{
+			if (request.type == RV_UPLOAD_BUFFER && request.onBufferResident)
+			{
+				request.onBufferResident();
+			}
+			else if (request.type == RV_UPLOAD_TEXTURE && request.onTextureResident)
+			{
+				request.onTextureResident(request.texture);
+			}
+		}
+	}
+}
+
+bool RvUploadScheduler::isIdle() const
+{
+	return pending.empty() && inFlight.empty();
+}
+
+size_t RvUploadScheduler::pendingCount() const
+{
+	return pending.size();
+}
+
+void RvUploadScheduler::clear()
+{
+	for (RvUploadBatch& batch : inFlight)
+	{
+		//Contexts wait for their fence when deleted
+		delete batch.upload;
+
+		//Nobody took ownership of these textures
+		for (RvUploadRequest& request : batch.requests)
+		{
+			if (request.type == RV_UPLOAD_TEXTURE && request.size > 0)
+			{
+				request.texture.free();
+			}
+		}
+	}
+	inFlight.clear();
+	pending.clear();
+}
@@ -0,0 +1,127 @@
+#ifndef RV_UPLOAD_SCHEDULER_H
+#define RV_UPLOAD_SCHEDULER_H
+
+//EASTL Includes
+#include <eastl/vector.h>
+#include <eastl/deque.h>
+
+using eastl::vector;
+using eastl::deque;
+
+//STD Includes
+#include <functional>
+
+//Ravine Includes
+#include "RvDevice.h"
+#include "RvTexture.h"
+#include "RvUploadContext.h"
+#include "RvFileSystem.h"
+
+enum RvUploadType
+{
+	//Copy into a region of an existing buffer
+	RV_UPLOAD_BUFFER,
+	//RGBA8 pixels into a new mipmapped texture
+	RV_UPLOAD_TEXTURE
+};
+
+/**
+ * \brief Upload waiting for its frame, it owns (or keeps mapped) the source bytes until it is resident.
+ */
+struct RvUploadRequest
+{
+	RvUploadType type;
+
+	//Source bytes, either owned or read in place from a mapped file
+	vector<char> data;
+	RvFileView file;
+	size_t fileOffset = 0;
+	VkDeviceSize size = 0;
+
+	//Buffer destination
+	VkBuffer dstBuffer = VK_NULL_HANDLE;
+	VkDeviceSize dstOffset = 0;
+	std::function<void()> onBufferResident;
+
+	//Texture destination, the image is created when the request is recorded
+	uint32_t width = 0;
+	uint32_t height = 0;
+	VkFormat format = VK_FORMAT_R8G8B8A8_UNORM;
+	RvTexture texture = {};
+	std::function<void(const RvTexture&)> onTextureResident;
+};
+
+/**
+ * \brief Uploads recorded on one frame, retired once its context has finished.
+ */
+struct RvUploadBatch
+{
+	RvUploadContext* upload = nullptr;
+	vector<RvUploadRequest> requests;
+};
+
+/**
+ * \brief Accepts uploads at any time and executes them over the following frames, within a byte and time budget per frame.
+ * Each frame's uploads are recorded into one upload context, its fence is polled on later frames (the queue is never waited on),
+ * owners are notified once their resources are resident, in the order the requests were made.
+ */
+class RvUploadScheduler
+{
+public:
+	RvUploadScheduler(RvDevice& device, VkDeviceSize bytesPerFrame, double millisecondsPerFrame);
+	~RvUploadScheduler();
+
+	//Budget of each update (a single request larger than it still goes through, alone)
+	VkDeviceSize bytesPerFrame;
+	double millisecondsPerFrame;
+
+	/**
+	 * \brief Queues a copy of data into a region of a device local buffer.
+	 * \param onResident Called once the region can be read by later submissions (may be empty).
+	 */
+	void uploadBuffer(vector<char>&& data, VkBuffer dstBuffer, VkDeviceSize dstOffset, std::function<void()> onResident);
+	void uploadBuffer(const void* data, VkDeviceSize size, VkBuffer dstBuffer, VkDeviceSize dstOffset, std::function<void()> onResident);
+
+	/**
+	 * \brief Queues the creation of a mipmapped texture from RGBA8 pixels, the owner receives the texture once it can be sampled.
+	 */
+	void uploadTexture(vector<char>&& pixels, uint32_t width, uint32_t height, VkFormat format, std::function<void(const RvTexture&)> onResident);
+
+	/**
+	 * \brief Same as above with pixels stored in a mapped file, its pages are used as the transfer source when they can be imported.
+	 */
+	void uploadTexture(RvFileView&& file, size_t offset, uint32_t width, uint32_t height, VkFormat format, std::function<void(const RvTexture&)> onResident);
+
+	/**
+	 * \brief Calls back once every upload queued before it is resident.
+	 */
+	void notify(std::function<void()> onResident);
+
+	/**
+	 * \brief Called once per frame: notifies owners of finished uploads, then records and submits the next ones within budget.
+	 */
+	void update();
+
+	//Nothing is queued or in flight
+	bool isIdle() const;
+
+	//Requests still waiting for a frame
+	size_t pendingCount() const;
+
+	/**
+	 * \brief Waits for uploads in flight and drops queued ones (no owner is notified), used on teardown.
+	 */
+	void clear();
+
+private:
+	RvDevice* device;
+
+	deque<RvUploadRequest> pending;
+	deque<RvUploadBatch> inFlight;
+
+	void enqueue(RvUploadRequest&& request);
+	void record(RvUploadContext& upload, RvUploadRequest& request);
+	void retire();
+};
+
+#endif
@@ -9,7 +9,7 @@
 //STD Include
 #include <stdexcept>
 
-RvWireframePipeline::RvWireframePipeline(RvDevice& device, VkExtent2D extent, VkSampleCountFlagBits sampleCount, VkDescriptorSetLayout* descriptorSetLayout, size_t descriptorSetLayoutCount, VkRenderPass renderPass, const vector<char>& vertShaderCode, const vector<char>& fragShaderCode) : device(&device)
+RvWireframePipeline::RvWireframePipeline(RvDevice& device, VkExtent2D extent, VkSampleCountFlagBits sampleCount, VkDescriptorSetLayout* descriptorSetLayout, size_t descriptorSetLayoutCount, VkRenderPass renderPass, const RvVertexInputDescription& vertexInput, const RvFileView& vertShaderCode, const RvFileView& fragShaderCode) : device(&device)
 {
 	//ShaderModules
 	vector<char> vertexShader = rvTools::compileShaderText("Wireframe Vertex Shader", vertShaderCode,
@@ -38,12 +38,10 @@ RvWireframePipeline::RvWireframePipeline(RvDevice& device, VkExtent2D extent, Vk
 	//Reference: https://vulkan-tutorial.com/Drawing_a_triangle/Graphics_pipeline_basics/Fixed_functions#page_Vertex_input
 	VkPipelineVertexInputStateCreateInfo vertexInputInfo = {};
 	vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-	auto bindingDescription = RvSkinnedVertexColored::getBindingDescription();
-	auto attributeDescriptions = RvSkinnedVertexColored::getAttributeDescriptions();
 	vertexInputInfo.vertexBindingDescriptionCount = 1;
-	vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
-	vertexInputInfo.pVertexBindingDescriptions = &bindingDescription;
-	vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
+	vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(vertexInput.attributes.size());
+	vertexInputInfo.pVertexBindingDescriptions = &vertexInput.binding;
+	vertexInputInfo.pVertexAttributeDescriptions = vertexInput.attributes.data();
 
 	//Input Assembly (describes what kind of geometry will be drawn from the vertices and if primitive restart should be enabled).
 	//Reference: https://vulkan-tutorial.com/Drawing_a_triangle/Graphics_pipeline_basics/Fixed_functions#page_Input_assembly
@@ -127,9 +125,9 @@ RvWireframePipeline::RvWireframePipeline(RvDevice& device, VkExtent2D extent, Vk
 
 	//Dynamic State (Defines the states that can be changed without recreating the graphics pipeline)
 	//Reference: https://vulkan-tutorial.com/Drawing_a_triangle/Graphics_pipeline_basics/Fixed_functions#page_Dynamic_state
+	//Viewport and scissor follow the swapchain extent, so resizing doesn't recreate the pipeline
 	VkDynamicState dynamicStates[] = {
 		VK_DYNAMIC_STATE_VIEWPORT,
-		VK_DYNAMIC_STATE_LINE_WIDTH,
 		VK_DYNAMIC_STATE_SCISSOR
 	};
 
@@ -166,7 +164,7 @@ RvWireframePipeline::RvWireframePipeline(RvDevice& device, VkExtent2D extent, Vk
 	pipelineInfo.pMultisampleState = &multisampling;
 	pipelineInfo.pDepthStencilState = nullptr; // Optional
 	pipelineInfo.pColorBlendState = &colorBlending;
-	pipelineInfo.pDynamicState = nullptr; // Optional
+	pipelineInfo.pDynamicState = &dynamicState;
 
 	//The uniforms layout
 	pipelineInfo.layout = layout;
@@ -0,0 +1,45 @@
+#version 450
+
+layout(set=0, binding = 0) uniform UniformBufferObject {
+    mat4 view;
+    mat4 proj;
+	vec4 lightColor;
+	vec4 camPos;
+};
+
+layout(set=2, binding = 0) uniform ModelBufferObject {
+	mat4 model;
+	vec4 positionScale;
+	vec4 positionOffset;
+};
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inColor;
+layout(location = 2) in vec2 inTexCoord;
+layout(location = 3) in vec2 inOctNorm;
+
+layout(location = 0) out vec2 fragTexCoord;
+layout(location = 1) out vec3 fragNorm;
+layout(location = 2) out vec3 fragPos;
+layout(location = 3) out vec3 fragColor;
+
+out gl_PerVertex {
+    vec4 gl_Position;
+};
+
+vec3 decodeNormal(vec2 oct) {
+	vec3 norm = vec3(oct, 1.0 - abs(oct.x) - abs(oct.y));
+	float fold = clamp(-norm.z, 0.0, 1.0);
+	norm.xy += mix(vec2(fold), vec2(-fold), greaterThanEqual(norm.xy, vec2(0.0)));
+	return normalize(norm);
+}
+
+void main() {
+	vec3 position = inPosition * positionScale.xyz + positionOffset.xyz;
+	vec4 PosL = model * vec4(position, 1.0);
+    gl_Position = proj * view * PosL;
+    fragColor = inColor;
+    fragTexCoord = inTexCoord;
+	fragNorm = mat3(transpose(inverse(model))) * decodeNormal(inOctNorm);
+	fragPos = PosL.xyz;
+}
\ No newline at end of file
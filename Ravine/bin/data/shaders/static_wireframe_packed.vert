@@ -0,0 +1,22 @@
+#version 450
+
+layout(set=0, binding = 0) uniform UniformBufferObject {
+    mat4 view;
+    mat4 proj;
+	vec4 lightColor;
+	vec4 camPos;
+};
+
+layout(set=2, binding = 0) uniform ModelBufferObject {
+	mat4 model;
+	vec4 positionScale;
+	vec4 positionOffset;
+};
+
+layout(location = 0) in vec3 inPosition;
+
+void main()
+{
+	vec3 position = inPosition * positionScale.xyz + positionOffset.xyz;
+    gl_Position = proj * view * model * vec4(position, 1.0);
+}
\ No newline at end of file
@@ -1,8 +1,181 @@
 #include <fmt/printf.h>
 #include "Ravine.h"
+#include "RvArchive.h"
+#include "RvGltfLoader.h"
+#include "RvConversionTools.h"
 
-int main()
+//Assimp Includes
+#include <assimp/Importer.hpp>
+
+//STD Includes
+#include <chrono>
+#include <cstring>
+
+int packArchive(const string& archivePath, const string& directory)
+{
+	vector<string> files;
+	if (!RvFileSystem::listFiles(directory, files))
+	{
+		fmt::print(stderr, "Failed to list files at {0}!\n", directory.c_str());
+		return EXIT_FAILURE;
+	}
+
+	//Cooked files are rewritten at runtime and archives aren't nested
+	files.erase(eastl::remove_if(files.begin(), files.end(), [](const string& filePath)
+	{
+		return filePath.compare(0, 6, "cache/") == 0 || (filePath.size() >= 6 && filePath.compare(filePath.size() - 6, 6, ".rvpak") == 0);
+	}), files.end());
+
+	RvThreadPool threadPool;
+	if (!RvArchive::pack(archivePath, directory, files, threadPool))
+	{
+		return EXIT_FAILURE;
+	}
+	fmt::print(stdout, "Packed {0} files into {1}\n", files.size(), archivePath.c_str());
+	return EXIT_SUCCESS;
+}
+
+//Reads every file from the archive and from the loose directory, the first pass is only cold if the OS file cache was flushed
+int benchmarkArchive(const string& archivePath, const string& directory)
 {
+	vector<string> files;
+	RvArchive archive;
+	if (!RvFileSystem::listFiles(directory, files) || !archive.open(archivePath))
+	{
+		fmt::print(stderr, "Failed to open {0} or {1}!\n", archivePath.c_str(), directory.c_str());
+		return EXIT_FAILURE;
+	}
+
+	const string root = directory.back() == '/' || directory.back() == '\\' ? directory : directory + "/";
+	RvThreadPool threadPool;
+	vector<char> staging;
+	for (uint32_t pass = 0; pass < 2; pass++)
+	{
+		//Loose files are read through their mappings, touching every page
+		uint64_t looseBytes = 0;
+		uint64_t checksum = 0;
+		auto start = std::chrono::high_resolution_clock::now();
+		for (const string& filePath : files)
+		{
+			const RvFileView view = RvFileSystem::map(root + filePath);
+			for (size_t offset = 0; offset < view.size(); offset += 4096)
+			{
+				checksum += view.data()[offset];
+			}
+			looseBytes += view.size();
+		}
+		const double looseTime = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+		uint64_t archiveBytes = 0;
+		uint32_t missing = 0;
+		start = std::chrono::high_resolution_clock::now();
+		for (const string& filePath : files)
+		{
+			const RvArchiveEntry* entry = archive.find(filePath);
+			if (!entry)
+			{
+				missing++;
+				continue;
+			}
+			staging.resize(static_cast<size_t>(entry->size));
+			archive.read(*entry, staging.data(), &threadPool);
+			archiveBytes += entry->size;
+		}
+		const double archiveTime = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+		fmt::print(stdout, "Pass {0}: loose {1} files, {2} bytes in {3:.3f}ms | archive {4} files, {5} bytes in {6:.3f}ms ({7} missing)\n",
+			pass, files.size(), looseBytes, looseTime * 1000.0, files.size() - missing, archiveBytes, archiveTime * 1000.0, missing);
+		(void)checksum;
+	}
+	return EXIT_SUCCESS;
+}
+
+//Loads a glTF file through Assimp (import and vertex conversion) and through the native loader, the last run of each reports its steps
+int benchmarkGltf(const string& filePath)
+{
+	const RvImportProfile& profile = RvImportProfile::get(RV_IMPORT_PROFILE_SKINNED_CHARACTER);
+	const uint32_t runs = 5;
+	double assimpTime = 0.0;
+	double nativeTime = 0.0;
+	for (uint32_t run = 0; run < runs; run++)
+	{
+		const bool lastRun = run + 1 == runs;
+		auto start = std::chrono::high_resolution_clock::now();
+		{
+			RvImportTimer timer;
+			Assimp::Importer importer;
+			const aiScene* scene = profile.readScene(importer, filePath, timer);
+			if (!scene)
+			{
+				fmt::print(stderr, "Assimp failed to import {0}!\n", filePath.c_str());
+				return EXIT_FAILURE;
+			}
+			for (uint32_t i = 0; i < scene->mNumMeshes; i++)
+			{
+				vector<RvSkinnedVertexColored> vertices(scene->mMeshes[i]->mNumVertices);
+				vector<uint32_t> indices(scene->mMeshes[i]->mNumFaces * 3);
+				rvTools::conversion::convertVertices(scene->mMeshes[i], vertices.data(), profile.vertexAttributes);
+				rvTools::conversion::convertIndices(scene->mMeshes[i], indices.data());
+			}
+			timer.lap("Convert vertices");
+			if (lastRun)
+			{
+				timer.print(filePath);
+			}
+		}
+		assimpTime += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+		start = std::chrono::high_resolution_clock::now();
+		RvImportTimer timer;
+		RvSkinnedMeshColored* meshes = nullptr;
+		uint32_t meshesCount = 0;
+		vector<string> texturePaths;
+		if (!RvGltfLoader::load(filePath, profile, meshes, meshesCount, texturePaths, timer))
+		{
+			return EXIT_FAILURE;
+		}
+		nativeTime += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+		if (lastRun)
+		{
+			timer.print(filePath);
+		}
+
+		for (uint32_t i = 0; i < meshesCount; i++)
+		{
+			delete[] meshes[i].vertices;
+			delete[] meshes[i].indices;
+			delete[] meshes[i].textureIds;
+		}
+		for (RvAnimation* animation : meshes[0].animations)
+		{
+			delete animation->aiAnim;
+			delete animation;
+		}
+		delete meshes[0].rootNode;
+		delete[] meshes;
+	}
+
+	fmt::print(stdout, "Assimp {0:.3f}ms | native {1:.3f}ms | {2:.2f}x faster (average of {3} runs)\n",
+		assimpTime * 1000.0 / runs, nativeTime * 1000.0 / runs, assimpTime / nativeTime, runs);
+	return EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[])
+{
+	//Asset tools: "-pack <archive> <directory>", "-bench <archive> <directory>" and "-bench-gltf <file>"
+	if (argc == 4 && strcmp(argv[1], "-pack") == 0)
+	{
+		return packArchive(argv[2], argv[3]);
+	}
+	if (argc == 4 && strcmp(argv[1], "-bench") == 0)
+	{
+		return benchmarkArchive(argv[2], argv[3]);
+	}
+	if (argc == 3 && strcmp(argv[1], "-bench-gltf") == 0)
+	{
+		return benchmarkGltf(argv[2]);
+	}
+
 	Ravine app;
 
 	//try {